@@ -19,7 +19,7 @@ DESCRIPTION     := A fast implementation of probabilities using logarithms
 # =======
 CPPFLAGS        := # Precompiler Flags
 CXXFLAGS        := -std=c++17 -Wall -Wextra -Wpedantic -Wshadow -O3
-LDFLAGS         := # Linker flags
+LDFLAGS         := -pthread # Linker flags
 
 # Makeball list
 # ===============
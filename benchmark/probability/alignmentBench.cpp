@@ -0,0 +1,123 @@
+/******************************************************************************/
+/*  Probability - A fast implementation of probabilities using logarithms     */
+/*  Copyright (C) 2016 Renato Cordeiro Ferreira                               */
+/*                                                                            */
+/*  This program is free software: you can redistribute it and/or modify      */
+/*  it under the terms of the GNU General Public License as published by      */
+/*  the Free Software Foundation, either version 3 of the License, or         */
+/*  (at your option) any later version.                                       */
+/*                                                                            */
+/*  This program is distributed in the hope that it will be useful,           */
+/*  but WITHOUT ANY WARRANTY; without even the implied warranty of            */
+/*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             */
+/*  GNU General Public License for more details.                              */
+/*                                                                            */
+/*  You should have received a copy of the GNU General Public License         */
+/*  along with this program.  If not, see <www.gnu.org/licenses>.             */
+/******************************************************************************/
+
+// Standard headers
+#include <string>
+#include <thread>
+#include <vector>
+#include <cstddef>
+#include <algorithm>
+
+// External headers
+#include "benchmark/benchmark.h"
+
+// Probability headers
+#include "probability/alignment.hpp"
+
+static const double error_rate = 0.01;
+static const double open_rate = 0.001;
+static const double extension_rate = 0.1;
+
+static std::string make_sequence(std::size_t size, std::size_t seed) {
+  std::string result;
+  for (std::size_t i = 0; i < size; i++)
+    result += "ACGT"[(i * i + seed * i + 7 * seed) / 3 % 4];
+  return result;
+}
+
+static void Threads(benchmark::internal::Benchmark* benchmark) {
+  auto cores = static_cast<int>(
+      std::max(1u, std::thread::hardware_concurrency()));
+  for (int threads = 1; threads <= cores; threads *= 2)
+    benchmark->Args({ 2048, threads });
+}
+
+// Forward algorithm written by hand with the operators of probability_t,
+// filling the tables row by row
+static void BM_PairHmmWithOperators(benchmark::State& state) {
+  using probability::probability_t;
+
+  auto size = static_cast<std::size_t>(state.range(0));
+  auto read = make_sequence(size, 1), haplotype = make_sequence(size, 2);
+  std::size_t cols = size + 1;
+
+  probability_t one(1), error(error_rate), open(open_rate),
+                extension(extension_rate);
+  auto match_prior = one - error;
+  auto mismatch_prior = probability_t(error_rate / 3);
+  auto match_to_match = one - open - open, gap_to_match = one - extension;
+
+  while (state.KeepRunning()) {
+    std::vector<probability_t> m(cols * cols), x(cols * cols), y(cols * cols);
+    for (std::size_t j = 0; j < cols; j++)
+      y[j] = probability_t(1.0 / size);
+
+    for (std::size_t i = 1; i < cols; i++) {
+      for (std::size_t j = 1; j < cols; j++) {
+        std::size_t c = i * cols + j, up = c - cols, left = c - 1;
+        auto prior = read[i-1] == haplotype[j-1] ? match_prior
+                                                 : mismatch_prior;
+        m[c] = prior * (match_to_match * m[up-1]
+                        + gap_to_match * (x[up-1] + y[up-1]));
+        x[c] = open * m[up] + extension * x[up];
+        y[c] = open * m[left] + extension * y[left];
+      }
+    }
+
+    probability_t likelihood;
+    for (std::size_t j = 1; j < cols; j++)
+      likelihood += m[size * cols + j] + x[size * cols + j];
+    benchmark::DoNotOptimize(likelihood);
+  }
+  state.SetItemsProcessed(state.iterations() * size * size);
+}
+BENCHMARK(BM_PairHmmWithOperators)->Arg(256)->Arg(2048);
+
+// Kernels are vectorized only with branch-free math types
+using branch_free_pair_hmm_t = probability::PairHMM<
+    double, probability::BranchFreeMath<double>::ulp,
+    probability::ProbabilityChecker<
+      double, probability::BranchFreeMath<double>::ulp>,
+    probability::BranchFreeMath<double>>;
+
+template<typename HMM>
+static void BM_PairHmmWavefront(benchmark::State& state) {
+  auto size = static_cast<std::size_t>(state.range(0));
+  auto read = make_sequence(size, 1), haplotype = make_sequence(size, 2);
+  HMM hmm(error_rate, open_rate, extension_rate);
+
+  while (state.KeepRunning())
+    benchmark::DoNotOptimize(hmm.likelihood(read, haplotype));
+  state.SetItemsProcessed(state.iterations() * size * size);
+}
+BENCHMARK_TEMPLATE(BM_PairHmmWavefront, probability::pair_hmm_t)
+  ->Arg(256)->Arg(2048);
+BENCHMARK_TEMPLATE(BM_PairHmmWavefront, branch_free_pair_hmm_t)
+  ->Arg(256)->Arg(2048);
+
+static void BM_PairHmmWavefrontInTiles(benchmark::State& state) {
+  auto size = static_cast<std::size_t>(state.range(0));
+  auto read = make_sequence(size, 1), haplotype = make_sequence(size, 2);
+  probability::pair_hmm_t hmm(error_rate, open_rate, extension_rate);
+  probability::ThreadPool pool(state.range(1));
+
+  while (state.KeepRunning())
+    benchmark::DoNotOptimize(hmm.likelihood(pool, read, haplotype));
+  state.SetItemsProcessed(state.iterations() * size * size);
+}
+BENCHMARK(BM_PairHmmWavefrontInTiles)->Apply(Threads)->UseRealTime();
@@ -0,0 +1,145 @@
+/******************************************************************************/
+/*  Probability - A fast implementation of probabilities using logarithms     */
+/*  Copyright (C) 2016 Renato Cordeiro Ferreira                               */
+/*                                                                            */
+/*  This program is free software: you can redistribute it and/or modify      */
+/*  it under the terms of the GNU General Public License as published by      */
+/*  the Free Software Foundation, either version 3 of the License, or         */
+/*  (at your option) any later version.                                       */
+/*                                                                            */
+/*  This program is distributed in the hope that it will be useful,           */
+/*  but WITHOUT ANY WARRANTY; without even the implied warranty of            */
+/*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             */
+/*  GNU General Public License for more details.                              */
+/*                                                                            */
+/*  You should have received a copy of the GNU General Public License         */
+/*  along with this program.  If not, see <www.gnu.org/licenses>.             */
+/******************************************************************************/
+
+// Standard headers
+#include <cmath>
+#include <vector>
+#include <cstddef>
+
+// External headers
+#include "benchmark/benchmark.h"
+
+// Probability headers
+#include "probability/beam.hpp"
+
+static const std::size_t states = 1024;
+static const std::size_t symbols = 20;
+
+// Most probable symbol of each state (a hash, so that states differ)
+static std::size_t symbol_of(std::size_t i) {
+  return (i * 2654435761u >> 7) % symbols;
+}
+
+// Left-to-right model, like profile HMMs: each state goes to itself and
+// to the next three states (wrapping around), emitting mostly one symbol
+static probability::hmm_t make_hmm() {
+  auto initial = probability::probability_vector_t(states, 1.0 / states);
+
+  auto transitions = probability::probability_matrix_t(states, states);
+  for (std::size_t i = 0; i < states; i++) {
+    transitions(i, i) = 0.1;
+    transitions(i, (i + 1) % states) = 0.7;
+    transitions(i, (i + 2) % states) = 0.15;
+    transitions(i, (i + 3) % states) = 0.05;
+  }
+
+  auto emissions = probability::probability_matrix_t(states, symbols);
+  for (std::size_t i = 0; i < states; i++)
+    for (std::size_t k = 0; k < symbols; k++)
+      emissions(i, k) = symbol_of(i) == k ? 0.62 : 0.02;
+
+  return probability::hmm_t(initial, transitions, emissions);
+}
+
+// Symbols emitted along the most probable states, from state 100, with
+// a different symbol every 7 positions
+static probability::hmm_t::sequence_type make_sequence() {
+  probability::hmm_t::sequence_type sequence;
+  for (std::size_t t = 0, i = 100; t < 500; t++, i = (i + 1) % states)
+    sequence.push_back(t % 7 == 0 ? (symbol_of(i) + 1) % symbols
+                                  : symbol_of(i));
+  return sequence;
+}
+
+static void BM_HmmLikelihoodWithoutBeam(benchmark::State& state) {
+  auto hmm = make_hmm();
+  auto sequence = make_sequence();
+
+  while (state.KeepRunning())
+    benchmark::DoNotOptimize(hmm.likelihood(sequence));
+  state.SetItemsProcessed(state.iterations() * sequence.size());
+}
+BENCHMARK(BM_HmmLikelihoodWithoutBeam);
+
+static void BM_HmmScaledLikelihoodWithoutBeam(benchmark::State& state) {
+  auto hmm = make_hmm();
+  auto sequence = make_sequence();
+
+  while (state.KeepRunning())
+    benchmark::DoNotOptimize(hmm.scaled_likelihood(sequence));
+  state.SetItemsProcessed(state.iterations() * sequence.size());
+}
+BENCHMARK(BM_HmmScaledLikelihoodWithoutBeam);
+
+// Beam keeping the states within 10^-range(0) of the maximum
+static void BM_BeamLikelihood(benchmark::State& state) {
+  auto hmm = make_hmm();
+  auto sequence = make_sequence();
+  auto exact = hmm.likelihood(sequence).data();
+
+  probability::Beam<double> beam(probability::LogThreshold<double>(
+      std::pow(10.0, -static_cast<double>(state.range(0)))));
+  probability::beam_search_t search(hmm, beam);
+
+  probability::BeamReport report;
+  while (state.KeepRunning())
+    benchmark::DoNotOptimize(search.likelihood(sequence, report));
+
+  state.counters["active_states"] = report.mean_active_states();
+  state.counters["pruned_mass"] = report.pruned_mass;
+  state.counters["log_error"] = exact - report.log_likelihood;
+  state.SetItemsProcessed(state.iterations() * sequence.size());
+}
+BENCHMARK(BM_BeamLikelihood)->Arg(3)->Arg(6)->Arg(12)->Arg(24);
+
+// Beam keeping the range(0) most probable states
+static void BM_BeamLikelihoodTopK(benchmark::State& state) {
+  auto hmm = make_hmm();
+  auto sequence = make_sequence();
+  auto exact = hmm.likelihood(sequence).data();
+
+  probability::Beam<double> beam(static_cast<std::size_t>(state.range(0)));
+  probability::beam_search_t search(hmm, beam);
+
+  probability::BeamReport report;
+  while (state.KeepRunning())
+    benchmark::DoNotOptimize(search.likelihood(sequence, report));
+
+  state.counters["active_states"] = report.mean_active_states();
+  state.counters["pruned_mass"] = report.pruned_mass;
+  state.counters["log_error"] = exact - report.log_likelihood;
+  state.SetItemsProcessed(state.iterations() * sequence.size());
+}
+BENCHMARK(BM_BeamLikelihoodTopK)->Arg(8)->Arg(64)->Arg(256);
+
+static void BM_BeamViterbi(benchmark::State& state) {
+  auto hmm = make_hmm();
+  auto sequence = make_sequence();
+
+  probability::Beam<double> beam(probability::LogThreshold<double>(
+      std::pow(10.0, -static_cast<double>(state.range(0)))));
+  probability::beam_search_t search(hmm, beam);
+
+  probability::BeamReport report;
+  while (state.KeepRunning())
+    benchmark::DoNotOptimize(search.viterbi(sequence, report));
+
+  state.counters["active_states"] = report.mean_active_states();
+  state.SetItemsProcessed(state.iterations() * sequence.size());
+}
+BENCHMARK(BM_BeamViterbi)->Arg(6)->Arg(12);
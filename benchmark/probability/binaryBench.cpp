@@ -0,0 +1,86 @@
+/******************************************************************************/
+/*  Probability - A fast implementation of probabilities using logarithms     */
+/*  Copyright (C) 2016 Renato Cordeiro Ferreira                               */
+/*                                                                            */
+/*  This program is free software: you can redistribute it and/or modify      */
+/*  it under the terms of the GNU General Public License as published by      */
+/*  the Free Software Foundation, either version 3 of the License, or         */
+/*  (at your option) any later version.                                       */
+/*                                                                            */
+/*  This program is distributed in the hope that it will be useful,           */
+/*  but WITHOUT ANY WARRANTY; without even the implied warranty of            */
+/*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             */
+/*  GNU General Public License for more details.                              */
+/*                                                                            */
+/*  You should have received a copy of the GNU General Public License         */
+/*  along with this program.  If not, see <www.gnu.org/licenses>.             */
+/******************************************************************************/
+
+// Standard headers
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <fstream>
+
+// External headers
+#include "benchmark/benchmark.h"
+
+// Probability headers
+#include "probability/binary.hpp"
+
+static std::vector<probability::probability_t> make_model(std::size_t size) {
+  std::vector<probability::probability_t> model(size);
+  for (std::size_t i = 0; i < size; i++)
+    model[i] = 1.0 / (size + i);
+  return model;
+}
+
+static void BM_LoadTextFile(benchmark::State& state) {
+  std::string path = "/tmp/probability_bench_model.txt";
+  {
+    std::ofstream file(path);
+    file.precision(17);
+    for (const auto& value : make_model(state.range(0)))
+      file << value.data() << '\n';
+  }
+
+  while (state.KeepRunning()) {
+    std::vector<probability::probability_t> model;
+    std::ifstream file(path);
+    for (double log_value; file >> log_value; )
+      model.push_back(probability::probability_t::from_log(log_value));
+    benchmark::DoNotOptimize(model.data());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+  std::remove(path.c_str());
+}
+BENCHMARK(BM_LoadTextFile)->Range(1 << 10, 1 << 20);
+
+static void BM_LoadBinaryFile(benchmark::State& state) {
+  std::string path = "/tmp/probability_bench_model.bin";
+  probability::write_binary(path, make_model(state.range(0)));
+
+  while (state.KeepRunning()) {
+    probability::probability_span_view_t model(path);
+    double total = 0;
+    for (const auto& value : model) total += value.data();
+    benchmark::DoNotOptimize(total);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+  std::remove(path.c_str());
+}
+BENCHMARK(BM_LoadBinaryFile)->Range(1 << 10, 1 << 20);
+
+static void BM_OpenBinaryFile(benchmark::State& state) {
+  std::string path = "/tmp/probability_bench_model.bin";
+  probability::write_binary(path, make_model(state.range(0)));
+
+  while (state.KeepRunning()) {
+    probability::probability_span_view_t model(path);
+    benchmark::DoNotOptimize(model.data());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+  std::remove(path.c_str());
+}
+BENCHMARK(BM_OpenBinaryFile)->Range(1 << 10, 1 << 20);
@@ -0,0 +1,69 @@
+/******************************************************************************/
+/*  Probability - A fast implementation of probabilities using logarithms     */
+/*  Copyright (C) 2016 Renato Cordeiro Ferreira                               */
+/*                                                                            */
+/*  This program is free software: you can redistribute it and/or modify      */
+/*  it under the terms of the GNU General Public License as published by      */
+/*  the Free Software Foundation, either version 3 of the License, or         */
+/*  (at your option) any later version.                                       */
+/*                                                                            */
+/*  This program is distributed in the hope that it will be useful,           */
+/*  but WITHOUT ANY WARRANTY; without even the implied warranty of            */
+/*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             */
+/*  GNU General Public License for more details.                              */
+/*                                                                            */
+/*  You should have received a copy of the GNU General Public License         */
+/*  along with this program.  If not, see <www.gnu.org/licenses>.             */
+/******************************************************************************/
+
+// Standard headers
+#include <vector>
+#include <cstddef>
+
+// External headers
+#include "benchmark/benchmark.h"
+
+// Probability headers
+#include "probability/expression.hpp"
+
+using probability::lazy;
+using probability::probability_t;
+
+static std::vector<probability_t> make_factors(std::size_t size) {
+  std::vector<probability_t> factors(size);
+  for (std::size_t i = 0; i < size; i++)
+    factors[i] = 1.0 / (2.0 + static_cast<double>(i % 17));
+  return factors;
+}
+
+static void BM_ScoreWithOperators(benchmark::State& state) {
+  auto f = make_factors(1 << 12);
+
+  while (state.KeepRunning()) {
+    for (std::size_t i = 0; i + 12 <= f.size(); i += 12) {
+      probability_t score = f[i] * f[i+1] * f[i+2]
+                          + f[i+3] * f[i+4] * f[i+5]
+                          + f[i+6] * f[i+7] * f[i+8]
+                          + f[i+9] * f[i+10] * f[i+11];
+      benchmark::DoNotOptimize(score);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * (f.size() / 12));
+}
+BENCHMARK(BM_ScoreWithOperators);
+
+static void BM_ScoreWithExpression(benchmark::State& state) {
+  auto f = make_factors(1 << 12);
+
+  while (state.KeepRunning()) {
+    for (std::size_t i = 0; i + 12 <= f.size(); i += 12) {
+      probability_t score = lazy(f[i]) * f[i+1] * f[i+2]
+                          + lazy(f[i+3]) * f[i+4] * f[i+5]
+                          + lazy(f[i+6]) * f[i+7] * f[i+8]
+                          + lazy(f[i+9]) * f[i+10] * f[i+11];
+      benchmark::DoNotOptimize(score);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * (f.size() / 12));
+}
+BENCHMARK(BM_ScoreWithExpression);
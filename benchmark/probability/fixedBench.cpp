@@ -0,0 +1,103 @@
+/******************************************************************************/
+/*  Probability - A fast implementation of probabilities using logarithms     */
+/*  Copyright (C) 2016 Renato Cordeiro Ferreira                               */
+/*                                                                            */
+/*  This program is free software: you can redistribute it and/or modify      */
+/*  it under the terms of the GNU General Public License as published by      */
+/*  the Free Software Foundation, either version 3 of the License, or         */
+/*  (at your option) any later version.                                       */
+/*                                                                            */
+/*  This program is distributed in the hope that it will be useful,           */
+/*  but WITHOUT ANY WARRANTY; without even the implied warranty of            */
+/*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             */
+/*  GNU General Public License for more details.                              */
+/*                                                                            */
+/*  You should have received a copy of the GNU General Public License         */
+/*  along with this program.  If not, see <www.gnu.org/licenses>.             */
+/******************************************************************************/
+
+// Standard headers
+#include <vector>
+#include <cstddef>
+#include <algorithm>
+
+// External headers
+#include "benchmark/benchmark.h"
+
+// Probability headers
+#include "probability/fixed.hpp"
+
+template<typename Number>
+static std::vector<Number> make_transitions(std::size_t states) {
+  auto transitions = std::vector<Number>(states * states);
+  for (std::size_t i = 0; i < states; i++)
+    for (std::size_t j = 0; j < states; j++)
+      transitions[i * states + j]
+        = Number((i == j ? 1.0 + states : 1.0) / (2.0 * states));
+  return transitions;
+}
+
+template<typename Number>
+static void BM_ForwardStep(benchmark::State& state) {
+  auto states = static_cast<std::size_t>(state.range(0));
+  auto transitions = make_transitions<Number>(states);
+  auto emission = Number(0.25);
+
+  while (state.KeepRunning()) {
+    auto alpha = std::vector<Number>(states, Number(1.0 / states));
+    auto next = std::vector<Number>(states);
+
+    for (std::size_t t = 1; t < 100; t++) {
+      for (std::size_t j = 0; j < states; j++) {
+        next[j] = alpha[0] * transitions[j];
+        for (std::size_t i = 1; i < states; i++)
+          next[j] += alpha[i] * transitions[i * states + j];
+        next[j] *= emission;
+      }
+      alpha.swap(next);
+    }
+    benchmark::DoNotOptimize(alpha.data());
+  }
+  state.SetItemsProcessed(state.iterations() * 100 * states * states);
+}
+BENCHMARK_TEMPLATE(BM_ForwardStep, probability::log_double_t)
+    ->RangeMultiplier(4)->Range(16, 256);
+BENCHMARK_TEMPLATE(BM_ForwardStep, probability::table_log_double_t)
+    ->RangeMultiplier(4)->Range(16, 256);
+BENCHMARK_TEMPLATE(BM_ForwardStep, probability::log_fixed32_t)
+    ->RangeMultiplier(4)->Range(16, 256);
+BENCHMARK_TEMPLATE(BM_ForwardStep, probability::log_fixed16_t)
+    ->RangeMultiplier(4)->Range(16, 256);
+
+template<typename Number>
+static void BM_ViterbiStep(benchmark::State& state) {
+  auto states = static_cast<std::size_t>(state.range(0));
+  auto transitions = make_transitions<Number>(states);
+  auto emission = Number(0.25);
+
+  using std::max;  // or the overload of the Number, by ADL
+
+  while (state.KeepRunning()) {
+    auto delta = std::vector<Number>(states, Number(1.0 / states));
+    auto next = std::vector<Number>(states);
+
+    for (std::size_t t = 1; t < 100; t++) {
+      for (std::size_t j = 0; j < states; j++) next[j] = Number();
+      for (std::size_t i = 0; i < states; i++)
+        for (std::size_t j = 0; j < states; j++)
+          next[j] = max(next[j], delta[i] * transitions[i * states + j]);
+      for (std::size_t j = 0; j < states; j++) next[j] *= emission;
+      delta.swap(next);
+    }
+    benchmark::DoNotOptimize(delta.data());
+  }
+  state.SetItemsProcessed(state.iterations() * 100 * states * states);
+}
+BENCHMARK_TEMPLATE(BM_ViterbiStep, probability::log_double_t)
+    ->RangeMultiplier(4)->Range(16, 256);
+BENCHMARK_TEMPLATE(BM_ViterbiStep, probability::log_float_t)
+    ->RangeMultiplier(4)->Range(16, 256);
+BENCHMARK_TEMPLATE(BM_ViterbiStep, probability::log_fixed32_t)
+    ->RangeMultiplier(4)->Range(16, 256);
+BENCHMARK_TEMPLATE(BM_ViterbiStep, probability::log_fixed16_t)
+    ->RangeMultiplier(4)->Range(16, 256);
@@ -0,0 +1,111 @@
+/******************************************************************************/
+/*  Probability - A fast implementation of probabilities using logarithms     */
+/*  Copyright (C) 2016 Renato Cordeiro Ferreira                               */
+/*                                                                            */
+/*  This program is free software: you can redistribute it and/or modify      */
+/*  it under the terms of the GNU General Public License as published by      */
+/*  the Free Software Foundation, either version 3 of the License, or         */
+/*  (at your option) any later version.                                       */
+/*                                                                            */
+/*  This program is distributed in the hope that it will be useful,           */
+/*  but WITHOUT ANY WARRANTY; without even the implied warranty of            */
+/*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             */
+/*  GNU General Public License for more details.                              */
+/*                                                                            */
+/*  You should have received a copy of the GNU General Public License         */
+/*  along with this program.  If not, see <www.gnu.org/licenses>.             */
+/******************************************************************************/
+
+// Standard headers
+#include <cmath>
+#include <vector>
+#include <cstddef>
+#include <algorithm>
+
+// External headers
+#include "benchmark/benchmark.h"
+
+// Probability headers
+#include "probability/half.hpp"
+
+static constexpr std::size_t chunk_size = 4096;
+
+static std::vector<float> make_table(std::size_t size) {
+  std::vector<float> table(size);
+  for (std::size_t i = 0; i < size; i++)
+    table[i] = std::log(1.0f / (size + (i * 2654435761u) % size));
+  return table;
+}
+
+// Reports the relative error of a score against one calculated in double
+static void report_error(benchmark::State& state, float score) {
+  auto table = make_table(state.range(0));
+  probability::LogAccumulator<double> exact;
+  for (float value : table) exact.add(static_cast<double>(value));
+
+  state.counters["relative_error"]
+    = std::expm1(std::fabs(score - exact.value<probability::log_double_t>()
+                                     .data()));
+}
+
+static void BM_ScoreTableOfFloats(benchmark::State& state) {
+  auto table = make_table(state.range(0));
+
+  float score = 0;
+  while (state.KeepRunning()) {
+    probability::LogAccumulator<float> accumulator;
+    accumulator.add(table.data(), table.size());
+    score = accumulator.value().data();
+    benchmark::DoNotOptimize(score);
+  }
+  state.SetBytesProcessed(state.iterations() * state.range(0) * 4);
+  report_error(state, score);
+}
+BENCHMARK(BM_ScoreTableOfFloats)->Range(1 << 16, 1 << 24);
+
+template<typename Storage>
+static void BM_ScoreTableOfStorage(benchmark::State& state) {
+  auto floats = make_table(state.range(0));
+  auto table = std::vector<Storage>(floats.size());
+  for (std::size_t i = 0; i < floats.size(); i++)
+    table[i] = probability::log_float_t::from_log(floats[i]);
+  auto buffer = std::vector<probability::log_float_t>(chunk_size);
+
+  float score = 0;
+  while (state.KeepRunning()) {
+    probability::LogAccumulator<float> accumulator;
+    for (std::size_t i = 0; i < table.size(); i += chunk_size) {
+      auto n = std::min(chunk_size, table.size() - i);
+      probability::widen(table.data() + i, table.data() + i + n,
+                         buffer.data());
+      accumulator.add(buffer.data(), buffer.data() + n);
+    }
+    score = accumulator.value().data();
+    benchmark::DoNotOptimize(score);
+  }
+  state.SetBytesProcessed(state.iterations() * state.range(0) * 2);
+  report_error(state, score);
+}
+BENCHMARK_TEMPLATE(BM_ScoreTableOfStorage, probability::log_half_t)
+  ->Range(1 << 16, 1 << 24);
+BENCHMARK_TEMPLATE(BM_ScoreTableOfStorage, probability::log_bfloat16_t)
+  ->Range(1 << 16, 1 << 24);
+
+template<typename Storage>
+static void BM_NarrowTable(benchmark::State& state) {
+  auto floats = make_table(state.range(0));
+  auto values = std::vector<probability::log_float_t>(floats.size());
+  probability::from_log(floats.data(), floats.data() + floats.size(),
+                        values.data());
+  auto table = std::vector<Storage>(values.size());
+
+  while (state.KeepRunning()) {
+    probability::narrow(values, table);
+    benchmark::DoNotOptimize(table.data());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK_TEMPLATE(BM_NarrowTable, probability::log_half_t)
+  ->Range(1 << 16, 1 << 24);
+BENCHMARK_TEMPLATE(BM_NarrowTable, probability::log_bfloat16_t)
+  ->Range(1 << 16, 1 << 24);
@@ -0,0 +1,200 @@
+/******************************************************************************/
+/*  Probability - A fast implementation of probabilities using logarithms     */
+/*  Copyright (C) 2016 Renato Cordeiro Ferreira                               */
+/*                                                                            */
+/*  This program is free software: you can redistribute it and/or modify      */
+/*  it under the terms of the GNU General Public License as published by      */
+/*  the Free Software Foundation, either version 3 of the License, or         */
+/*  (at your option) any later version.                                       */
+/*                                                                            */
+/*  This program is distributed in the hope that it will be useful,           */
+/*  but WITHOUT ANY WARRANTY; without even the implied warranty of            */
+/*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             */
+/*  GNU General Public License for more details.                              */
+/*                                                                            */
+/*  You should have received a copy of the GNU General Public License         */
+/*  along with this program.  If not, see <www.gnu.org/licenses>.             */
+/******************************************************************************/
+
+// Standard headers
+#include <vector>
+#include <cstddef>
+
+// External headers
+#include "benchmark/benchmark.h"
+
+// Probability headers
+#include "probability/hmm.hpp"
+
+static probability::hmm_t make_hmm(std::size_t states, std::size_t symbols) {
+  auto initial = probability::probability_vector_t(states, 1.0 / states);
+
+  auto transitions = probability::probability_matrix_t(states, states);
+  for (std::size_t i = 0; i < states; i++)
+    for (std::size_t j = 0; j < states; j++)
+      transitions(i, j) = (i == j ? 1.0 + states : 1.0) / (2.0 * states);
+
+  auto emissions = probability::probability_matrix_t(states, symbols);
+  for (std::size_t i = 0; i < states; i++)
+    for (std::size_t k = 0; k < symbols; k++)
+      emissions(i, k) = (i % symbols == k ? 1.0 + symbols : 1.0)
+                      / (2.0 * symbols);
+
+  return probability::hmm_t(initial, transitions, emissions);
+}
+
+static probability::hmm_t::sequence_type make_sequence(std::size_t size,
+                                                       std::size_t symbols) {
+  probability::hmm_t::sequence_type sequence(size);
+  for (std::size_t t = 0; t < size; t++)
+    sequence[t] = (t * t + 7 * t) % symbols;
+  return sequence;
+}
+
+static void BM_HmmNaiveLikelihood(benchmark::State& state) {
+  auto states = static_cast<std::size_t>(state.range(0));
+  auto symbols = 4;
+
+  auto hmm = make_hmm(states, symbols);
+  auto sequence = make_sequence(1000, symbols);
+
+  auto transitions = std::vector<std::vector<probability::probability_t>>(
+      states, std::vector<probability::probability_t>(states));
+  for (std::size_t i = 0; i < states; i++)
+    for (std::size_t j = 0; j < states; j++)
+      transitions[i][j] = (i == j ? 1.0 + states : 1.0) / (2.0 * states);
+
+  auto emission = probability::probability_t(0.25);
+
+  while (state.KeepRunning()) {
+    auto alpha = std::vector<probability::probability_t>(
+        states, probability::probability_t(1.0 / states) * emission);
+    auto next = std::vector<probability::probability_t>(states);
+
+    for (std::size_t t = 1; t < sequence.size(); t++) {
+      for (std::size_t j = 0; j < states; j++) {
+        next[j] = alpha[0] * transitions[0][j];
+        for (std::size_t i = 1; i < states; i++)
+          next[j] += alpha[i] * transitions[i][j];
+        next[j] *= emission;
+      }
+      alpha.swap(next);
+    }
+
+    probability::probability_t likelihood;
+    for (const auto& value : alpha) likelihood += value;
+    benchmark::DoNotOptimize(likelihood);
+  }
+  state.SetItemsProcessed(state.iterations() * sequence.size());
+}
+BENCHMARK(BM_HmmNaiveLikelihood)->RangeMultiplier(4)->Range(4, 256);
+
+static void BM_HmmLikelihood(benchmark::State& state) {
+  auto states = static_cast<std::size_t>(state.range(0));
+  auto hmm = make_hmm(states, 4);
+  auto sequence = make_sequence(1000, 4);
+
+  while (state.KeepRunning()) {
+    auto likelihood = hmm.likelihood(sequence);
+    benchmark::DoNotOptimize(likelihood);
+  }
+  state.SetItemsProcessed(state.iterations() * sequence.size());
+}
+BENCHMARK(BM_HmmLikelihood)->RangeMultiplier(4)->Range(4, 1024);
+
+static void BM_HmmScaledLikelihood(benchmark::State& state) {
+  auto states = static_cast<std::size_t>(state.range(0));
+  auto hmm = make_hmm(states, 4);
+  auto sequence = make_sequence(1000, 4);
+
+  while (state.KeepRunning()) {
+    auto likelihood = hmm.scaled_likelihood(sequence);
+    benchmark::DoNotOptimize(likelihood);
+  }
+  state.SetItemsProcessed(state.iterations() * sequence.size());
+}
+BENCHMARK(BM_HmmScaledLikelihood)->RangeMultiplier(4)->Range(4, 1024);
+
+static void BM_HmmForward(benchmark::State& state) {
+  auto states = static_cast<std::size_t>(state.range(0));
+  auto hmm = make_hmm(states, 4);
+  auto sequence = make_sequence(1000, 4);
+
+  while (state.KeepRunning()) {
+    auto alpha = hmm.forward(sequence);
+    benchmark::DoNotOptimize(alpha.data());
+  }
+  state.SetItemsProcessed(state.iterations() * sequence.size());
+}
+BENCHMARK(BM_HmmForward)->RangeMultiplier(4)->Range(4, 1024);
+
+static void BM_HmmScaledForward(benchmark::State& state) {
+  auto states = static_cast<std::size_t>(state.range(0));
+  auto hmm = make_hmm(states, 4);
+  auto sequence = make_sequence(1000, 4);
+
+  while (state.KeepRunning()) {
+    auto alpha = hmm.scaled_forward(sequence);
+    benchmark::DoNotOptimize(alpha.data());
+  }
+  state.SetItemsProcessed(state.iterations() * sequence.size());
+}
+BENCHMARK(BM_HmmScaledForward)->RangeMultiplier(4)->Range(4, 1024);
+
+static void BM_HmmBackward(benchmark::State& state) {
+  auto states = static_cast<std::size_t>(state.range(0));
+  auto hmm = make_hmm(states, 4);
+  auto sequence = make_sequence(1000, 4);
+
+  while (state.KeepRunning()) {
+    auto beta = hmm.backward(sequence);
+    benchmark::DoNotOptimize(beta.data());
+  }
+  state.SetItemsProcessed(state.iterations() * sequence.size());
+}
+BENCHMARK(BM_HmmBackward)->RangeMultiplier(4)->Range(4, 1024);
+
+static void BM_HmmPosteriorDecoding(benchmark::State& state) {
+  auto states = static_cast<std::size_t>(state.range(0));
+  auto hmm = make_hmm(states, 4);
+  auto sequence = make_sequence(1000, 4);
+
+  while (state.KeepRunning()) {
+    auto path = hmm.posterior_decoding(sequence);
+    benchmark::DoNotOptimize(path.data());
+  }
+  state.SetItemsProcessed(state.iterations() * sequence.size());
+}
+BENCHMARK(BM_HmmPosteriorDecoding)->RangeMultiplier(4)->Range(4, 1024);
+
+static void BM_HmmLikelihoodOfEachSequence(benchmark::State& state) {
+  auto states = static_cast<std::size_t>(state.range(0));
+  auto hmm = make_hmm(states, 4);
+  auto batch = std::vector<probability::hmm_t::sequence_type>();
+  for (std::size_t b = 0; b < 64; b++)
+    batch.push_back(make_sequence(200 + b, 4));
+
+  while (state.KeepRunning()) {
+    for (const auto& sequence : batch) {
+      auto likelihood = hmm.likelihood(sequence);
+      benchmark::DoNotOptimize(likelihood);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * batch.size());
+}
+BENCHMARK(BM_HmmLikelihoodOfEachSequence)->RangeMultiplier(4)->Range(4, 256);
+
+static void BM_HmmLikelihoodOfBatch(benchmark::State& state) {
+  auto states = static_cast<std::size_t>(state.range(0));
+  auto hmm = make_hmm(states, 4);
+  auto batch = std::vector<probability::hmm_t::sequence_type>();
+  for (std::size_t b = 0; b < 64; b++)
+    batch.push_back(make_sequence(200 + b, 4));
+
+  while (state.KeepRunning()) {
+    auto likelihoods = hmm.likelihood(batch);
+    benchmark::DoNotOptimize(likelihoods.data());
+  }
+  state.SetItemsProcessed(state.iterations() * batch.size());
+}
+BENCHMARK(BM_HmmLikelihoodOfBatch)->RangeMultiplier(4)->Range(4, 256);
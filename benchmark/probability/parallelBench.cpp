@@ -0,0 +1,65 @@
+/******************************************************************************/
+/*  Probability - A fast implementation of probabilities using logarithms     */
+/*  Copyright (C) 2016 Renato Cordeiro Ferreira                               */
+/*                                                                            */
+/*  This program is free software: you can redistribute it and/or modify      */
+/*  it under the terms of the GNU General Public License as published by      */
+/*  the Free Software Foundation, either version 3 of the License, or         */
+/*  (at your option) any later version.                                       */
+/*                                                                            */
+/*  This program is distributed in the hope that it will be useful,           */
+/*  but WITHOUT ANY WARRANTY; without even the implied warranty of            */
+/*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             */
+/*  GNU General Public License for more details.                              */
+/*                                                                            */
+/*  You should have received a copy of the GNU General Public License         */
+/*  along with this program.  If not, see <www.gnu.org/licenses>.             */
+/******************************************************************************/
+
+// Standard headers
+#include <thread>
+#include <vector>
+#include <cstddef>
+#include <algorithm>
+
+// External headers
+#include "benchmark/benchmark.h"
+
+// Probability headers
+#include "probability/parallel.hpp"
+
+static std::vector<probability::log_double_t> make_terms(std::size_t size) {
+  std::vector<probability::log_double_t> terms(size);
+  for (std::size_t i = 0; i < size; i++)
+    terms[i] = 1.0 / (size + i);
+  return terms;
+}
+
+static void ThreadsAndSizes(benchmark::internal::Benchmark* benchmark) {
+  auto cores = static_cast<int>(
+      std::max(1u, std::thread::hardware_concurrency()));
+  for (int size = 1 << 16; size <= 1 << 24; size <<= 4)
+    for (int threads = 1; threads <= cores; threads *= 2)
+      benchmark->Args({ size, threads });
+}
+
+static void BM_SumSerially(benchmark::State& state) {
+  auto terms = make_terms(state.range(0));
+
+  while (state.KeepRunning()) {
+    benchmark::DoNotOptimize(probability::sum(terms));
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_SumSerially)->Range(1 << 16, 1 << 24);
+
+static void BM_Reduce(benchmark::State& state) {
+  auto terms = make_terms(state.range(0));
+  probability::ThreadPool pool(state.range(1));
+
+  while (state.KeepRunning()) {
+    benchmark::DoNotOptimize(probability::reduce(pool, terms));
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_Reduce)->Apply(ThreadsAndSizes)->UseRealTime();
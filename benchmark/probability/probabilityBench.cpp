@@ -19,12 +19,17 @@
 // Standard headers
 #include <vector>
 #include <cmath>
+#include <algorithm>
 
 // External headers
 #include "benchmark/benchmark.h"
 
-// Probability header
+// Probability headers
 #include "probability/probability.hpp"
+#include "probability/numeric.hpp"
+#include "probability/vector.hpp"
+#include "probability/matrix.hpp"
+#include "probability/scaled.hpp"
 
 double log_sum(double log_a, double log_b) {
   if (log_a > log_b) {
@@ -92,10 +97,544 @@ static void BM_ForwardAlgorithmWithProbability(benchmark::State& state) {
       }
     }
 
-    double sum =  alpha[0][sequence_size-1];
+    probability::probability_t sum =  alpha[0][sequence_size-1];
     for (int k = 1; k < state_alphabet_size; k++) {
       sum += alpha[k][sequence_size-1];
     }
   }
 }
 BENCHMARK(BM_ForwardAlgorithmWithProbability)->Range(1 << 10, 1 << 22);
+
+static void BM_ForwardAlgorithmWithFastProbability(benchmark::State& state) {
+  while (state.KeepRunning()) {
+    auto state_alphabet_size = 10;
+    auto sequence_size = state.range(0);
+
+    auto alpha = std::vector<std::vector<probability::fast_probability_t>>(
+        state_alphabet_size,
+        std::vector<probability::fast_probability_t>(sequence_size));
+
+    probability::fast_probability_t prob(0.000000000005);
+
+    for (int k = 0; k < state_alphabet_size; k++)
+      alpha[k][0] = prob * prob;
+
+    for (int t = 0; t < sequence_size - 1; t++) {
+      for (int i = 0; i < state_alphabet_size; i++) {
+        alpha[i][t+1] = alpha[0][t] * prob;
+        for (int j = 1; j < state_alphabet_size; j++) {
+          alpha[i][t+1] += alpha[j][t] * prob;
+        }
+        alpha[i][t+1] *= prob;
+      }
+    }
+
+    probability::fast_probability_t sum =  alpha[0][sequence_size-1];
+    for (int k = 1; k < state_alphabet_size; k++) {
+      sum += alpha[k][sequence_size-1];
+    }
+  }
+}
+BENCHMARK(BM_ForwardAlgorithmWithFastProbability)->Range(1 << 10, 1 << 22);
+
+static void BM_ForwardAlgorithmWithTableProbability(benchmark::State& state) {
+  while (state.KeepRunning()) {
+    auto state_alphabet_size = 10;
+    auto sequence_size = state.range(0);
+
+    auto alpha = std::vector<std::vector<probability::table_probability_t>>(
+        state_alphabet_size,
+        std::vector<probability::table_probability_t>(sequence_size));
+
+    probability::table_probability_t prob(0.000000000005);
+
+    for (int k = 0; k < state_alphabet_size; k++)
+      alpha[k][0] = prob * prob;
+
+    for (int t = 0; t < sequence_size - 1; t++) {
+      for (int i = 0; i < state_alphabet_size; i++) {
+        alpha[i][t+1] = alpha[0][t] * prob;
+        for (int j = 1; j < state_alphabet_size; j++) {
+          alpha[i][t+1] += alpha[j][t] * prob;
+        }
+        alpha[i][t+1] *= prob;
+      }
+    }
+
+    probability::table_probability_t sum =  alpha[0][sequence_size-1];
+    for (int k = 1; k < state_alphabet_size; k++) {
+      sum += alpha[k][sequence_size-1];
+    }
+  }
+}
+BENCHMARK(BM_ForwardAlgorithmWithTableProbability)->Range(1 << 10, 1 << 22);
+
+static void BM_ForwardAlgorithmWithBranchFreeProbability(
+    benchmark::State& state) {
+  while (state.KeepRunning()) {
+    auto state_alphabet_size = 10;
+    auto sequence_size = state.range(0);
+
+    using Probability = probability::branch_free_probability_t;
+    auto alpha = std::vector<std::vector<Probability>>(
+        state_alphabet_size, std::vector<Probability>(sequence_size));
+
+    Probability prob(0.000000000005);
+
+    for (int k = 0; k < state_alphabet_size; k++)
+      alpha[k][0] = prob * prob;
+
+    for (int t = 0; t < sequence_size - 1; t++) {
+      for (int i = 0; i < state_alphabet_size; i++) {
+        alpha[i][t+1] = alpha[0][t] * prob;
+        for (int j = 1; j < state_alphabet_size; j++) {
+          alpha[i][t+1] += alpha[j][t] * prob;
+        }
+        alpha[i][t+1] *= prob;
+      }
+    }
+
+    Probability sum =  alpha[0][sequence_size-1];
+    for (int k = 1; k < state_alphabet_size; k++) {
+      sum += alpha[k][sequence_size-1];
+    }
+  }
+}
+BENCHMARK(BM_ForwardAlgorithmWithBranchFreeProbability)
+  ->Range(1 << 10, 1 << 22);
+
+static void BM_ForwardAlgorithmWithMaxProbability(benchmark::State& state) {
+  while (state.KeepRunning()) {
+    auto state_alphabet_size = 10;
+    auto sequence_size = state.range(0);
+
+    auto alpha = std::vector<std::vector<probability::max_probability_t>>(
+        state_alphabet_size,
+        std::vector<probability::max_probability_t>(sequence_size));
+
+    probability::max_probability_t prob(0.000000000005);
+
+    for (int k = 0; k < state_alphabet_size; k++)
+      alpha[k][0] = prob * prob;
+
+    for (int t = 0; t < sequence_size - 1; t++) {
+      for (int i = 0; i < state_alphabet_size; i++) {
+        alpha[i][t+1] = alpha[0][t] * prob;
+        for (int j = 1; j < state_alphabet_size; j++) {
+          alpha[i][t+1] += alpha[j][t] * prob;
+        }
+        alpha[i][t+1] *= prob;
+      }
+    }
+
+    probability::max_probability_t sum =  alpha[0][sequence_size-1];
+    for (int k = 1; k < state_alphabet_size; k++) {
+      sum += alpha[k][sequence_size-1];
+    }
+  }
+}
+BENCHMARK(BM_ForwardAlgorithmWithMaxProbability)->Range(1 << 10, 1 << 22);
+
+static void BM_ForwardAlgorithmWithProbabilitySum(benchmark::State& state) {
+  while (state.KeepRunning()) {
+    auto state_alphabet_size = 10;
+    auto sequence_size = state.range(0);
+
+    auto alpha = std::vector<std::vector<probability::probability_t>>(
+        state_alphabet_size,
+        std::vector<probability::probability_t>(sequence_size));
+
+    auto terms = std::vector<probability::probability_t>(state_alphabet_size);
+
+    probability::probability_t prob(0.000000000005);
+
+    for (int k = 0; k < state_alphabet_size; k++)
+      alpha[k][0] = prob * prob;
+
+    for (int t = 0; t < sequence_size - 1; t++) {
+      for (int i = 0; i < state_alphabet_size; i++) {
+        for (int j = 0; j < state_alphabet_size; j++) {
+          terms[j] = alpha[j][t] * prob;
+        }
+        alpha[i][t+1] = probability::sum(terms) * prob;
+      }
+    }
+
+    for (int k = 0; k < state_alphabet_size; k++)
+      terms[k] = alpha[k][sequence_size-1];
+
+    benchmark::DoNotOptimize(probability::sum(terms));
+  }
+}
+BENCHMARK(BM_ForwardAlgorithmWithProbabilitySum)->Range(1 << 10, 1 << 22);
+
+static void BM_ForwardAlgorithmWithScaledProbability(benchmark::State& state) {
+  while (state.KeepRunning()) {
+    auto state_alphabet_size = 10;
+    auto sequence_size = state.range(0);
+
+    auto alpha = std::vector<probability::scaled_probability_column_t>(
+        sequence_size,
+        probability::scaled_probability_column_t(state_alphabet_size));
+
+    double prob = 0.000000000005;
+
+    for (int k = 0; k < state_alphabet_size; k++)
+      alpha[0].data()[k] = prob * prob;
+    alpha[0].rescale();
+
+    for (int t = 0; t < sequence_size - 1; t++) {
+      const double* current = alpha[t].data();
+      double* next = alpha[t+1].data();
+      for (int i = 0; i < state_alphabet_size; i++) {
+        next[i] = current[0] * prob;
+        for (int j = 1; j < state_alphabet_size; j++) {
+          next[i] += current[j] * prob;
+        }
+        next[i] *= prob;
+      }
+      alpha[t+1].log_scale() = alpha[t].log_scale();
+      alpha[t+1].rescale();
+    }
+
+    benchmark::DoNotOptimize(alpha[sequence_size-1].sum());
+  }
+}
+BENCHMARK(BM_ForwardAlgorithmWithScaledProbability)->Range(1 << 10, 1 << 22);
+
+static void BM_SumWithOperator(benchmark::State& state) {
+  auto terms = std::vector<probability::probability_t>(state.range(0));
+  for (std::size_t i = 0; i < terms.size(); i++)
+    terms[i] = 1.0 / (terms.size() + i);
+
+  while (state.KeepRunning()) {
+    probability::probability_t sum;
+    for (const auto& term : terms) sum += term;
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_SumWithOperator)->Range(8, 1 << 10);
+
+static void BM_SumWithLogSumExp(benchmark::State& state) {
+  auto terms = std::vector<probability::probability_t>(state.range(0));
+  for (std::size_t i = 0; i < terms.size(); i++)
+    terms[i] = 1.0 / (terms.size() + i);
+
+  while (state.KeepRunning()) {
+    benchmark::DoNotOptimize(probability::sum(terms));
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_SumWithLogSumExp)->Range(8, 1 << 10);
+
+template<typename Accumulator>
+static void BM_SumWithAccumulator(benchmark::State& state) {
+  auto terms = std::vector<probability::probability_t>(state.range(0));
+  for (std::size_t i = 0; i < terms.size(); i++)
+    terms[i] = 1.0 / (terms.size() + i);
+
+  while (state.KeepRunning()) {
+    Accumulator accumulator;
+    for (const auto& term : terms) accumulator += term;
+    benchmark::DoNotOptimize(accumulator.data());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK_TEMPLATE(BM_SumWithAccumulator, probability::LogAccumulator<double>)
+  ->Range(8, 1 << 10);
+BENCHMARK_TEMPLATE(BM_SumWithAccumulator,
+                   probability::CompensatedLogAccumulator<double>)
+  ->Range(8, 1 << 10);
+
+template<typename Accumulator>
+static void BM_SumWithAccumulatorOverRange(benchmark::State& state) {
+  auto terms = std::vector<probability::probability_t>(state.range(0));
+  for (std::size_t i = 0; i < terms.size(); i++)
+    terms[i] = 1.0 / (terms.size() + i);
+
+  while (state.KeepRunning()) {
+    Accumulator accumulator;
+    accumulator.add(terms.data(), terms.data() + terms.size());
+    benchmark::DoNotOptimize(accumulator.data());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK_TEMPLATE(BM_SumWithAccumulatorOverRange,
+                   probability::LogAccumulator<double>)
+  ->Range(8, 1 << 10);
+BENCHMARK_TEMPLATE(BM_SumWithAccumulatorOverRange,
+                   probability::CompensatedLogAccumulator<double>)
+  ->Range(8, 1 << 10);
+
+template<typename Probability>
+static void BM_ElementwiseAddition(benchmark::State& state) {
+  auto lhs = std::vector<Probability>(state.range(0));
+  auto rhs = std::vector<Probability>(state.range(0));
+  auto result = std::vector<Probability>(state.range(0));
+  for (std::size_t i = 0; i < lhs.size(); i++) {
+    lhs[i] = 1.0 / (2.0 + i);
+    rhs[i] = 1.0 / (2.0 + 3.0 * i);
+  }
+
+  while (state.KeepRunning()) {
+    for (std::size_t i = 0; i < result.size(); i++)
+      result[i] = lhs[i] + rhs[i];
+    benchmark::DoNotOptimize(result.data());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK_TEMPLATE(BM_ElementwiseAddition, probability::probability_t)
+  ->Range(8, 1 << 12);
+BENCHMARK_TEMPLATE(BM_ElementwiseAddition, probability::fast_probability_t)
+  ->Range(8, 1 << 12);
+BENCHMARK_TEMPLATE(BM_ElementwiseAddition, probability::table_probability_t)
+  ->Range(8, 1 << 12);
+BENCHMARK_TEMPLATE(BM_ElementwiseAddition,
+                   probability::branch_free_probability_t)
+  ->Range(8, 1 << 12);
+BENCHMARK_TEMPLATE(BM_ElementwiseAddition,
+                   probability::counting_probability_t)
+  ->Range(8, 1 << 12);
+
+template<typename Probability>
+static void BM_ElementwiseAdditionOfMixedValues(benchmark::State& state) {
+  auto lhs = std::vector<Probability>(state.range(0));
+  auto rhs = std::vector<Probability>(state.range(0));
+  auto result = std::vector<Probability>(state.range(0));
+  for (std::size_t i = 0; i < lhs.size(); i++) {
+    // Zeros and both orderings, in a pattern hard to predict
+    auto kind = (i * 2654435761u) >> 7;
+    lhs[i] = kind % 4 == 0 ? 0.0 : 1.0 / (2.0 + (kind % 5) * i);
+    rhs[i] = kind % 3 == 0 ? 0.0 : 1.0 / (2.0 + (kind % 7) * i);
+  }
+
+  while (state.KeepRunning()) {
+    for (std::size_t i = 0; i < result.size(); i++)
+      result[i] = lhs[i] + rhs[i];
+    benchmark::DoNotOptimize(result.data());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK_TEMPLATE(BM_ElementwiseAdditionOfMixedValues,
+                   probability::probability_t)
+  ->Range(8, 1 << 12);
+BENCHMARK_TEMPLATE(BM_ElementwiseAdditionOfMixedValues,
+                   probability::branch_free_probability_t)
+  ->Range(8, 1 << 12);
+
+// Not inlined, as a comparison in another translation unit
+template<typename Threshold>
+__attribute__((noinline)) static bool is_pruned(
+    const probability::probability_t& value, const Threshold& threshold) {
+  return value < threshold;
+}
+
+template<typename Threshold>
+static void BM_PruningByThreshold(benchmark::State& state) {
+  auto values = std::vector<probability::probability_t>(state.range(0));
+  for (std::size_t i = 0; i < values.size(); i++)
+    values[i] = std::pow(0.5, static_cast<double>(i % 64));
+  const auto threshold = Threshold(1e-9);
+
+  while (state.KeepRunning()) {
+    std::size_t pruned = 0;
+    for (const auto& value : values)
+      pruned += is_pruned(value, threshold);
+    benchmark::DoNotOptimize(pruned);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK_TEMPLATE(BM_PruningByThreshold, double)
+  ->Range(8, 1 << 12);
+BENCHMARK_TEMPLATE(BM_PruningByThreshold, probability::LogThreshold<double>)
+  ->Range(8, 1 << 12);
+
+template<typename Vector>
+static void BM_LogVectorAddition(benchmark::State& state) {
+  auto lhs = Vector(state.range(0));
+  auto rhs = Vector(state.range(0));
+  auto result = Vector(state.range(0));
+  for (std::size_t i = 0; i < lhs.size(); i++) {
+    lhs[i] = 1.0 / (2.0 + i);
+    rhs[i] = 1.0 / (2.0 + 3.0 * i);
+  }
+
+  while (state.KeepRunning()) {
+    result = lhs;
+    result += rhs;
+    benchmark::DoNotOptimize(result.data());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK_TEMPLATE(BM_LogVectorAddition, probability::log_double_vector_t)
+  ->Range(8, 1 << 12);
+BENCHMARK_TEMPLATE(BM_LogVectorAddition, probability::probability_vector_t)
+  ->Range(8, 1 << 12);
+
+static void BM_ElementwiseMultiplication(benchmark::State& state) {
+  auto lhs = std::vector<probability::probability_t>(state.range(0), 0.5);
+  auto rhs = std::vector<probability::probability_t>(state.range(0), 0.25);
+  auto result = std::vector<probability::probability_t>(state.range(0));
+
+  while (state.KeepRunning()) {
+    for (std::size_t i = 0; i < result.size(); i++)
+      result[i] = lhs[i] * rhs[i];
+    benchmark::DoNotOptimize(result.data());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_ElementwiseMultiplication)->Range(8, 1 << 12);
+
+static void BM_LogVectorMultiplication(benchmark::State& state) {
+  auto result = probability::log_double_vector_t(state.range(0), 0.5);
+  auto rhs = probability::log_double_vector_t(state.range(0), 1.0);
+
+  while (state.KeepRunning()) {
+    result *= rhs;
+    benchmark::DoNotOptimize(result.data());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_LogVectorMultiplication)->Range(8, 1 << 12);
+
+static void BM_ForwardAlgorithmWithLogMatrix(benchmark::State& state) {
+  while (state.KeepRunning()) {
+    auto state_alphabet_size = 10;
+    auto sequence_size = state.range(0);
+
+    probability::probability_t prob(0.000000000005);
+
+    auto transitions = probability::probability_matrix_t(
+        state_alphabet_size, state_alphabet_size, prob);
+
+    auto alpha = std::vector<probability::probability_vector_t>(
+        sequence_size, probability::probability_vector_t(state_alphabet_size));
+
+    alpha[0].fill(prob * prob);
+
+    for (int t = 0; t < sequence_size - 1; t++) {
+      probability::gevm(alpha[t], transitions, alpha[t+1]);
+      alpha[t+1] *= prob;
+    }
+
+    probability::probability_t sum = probability::sum(alpha[sequence_size-1]);
+    benchmark::DoNotOptimize(sum);
+  }
+}
+BENCHMARK(BM_ForwardAlgorithmWithLogMatrix)->Range(1 << 10, 1 << 22);
+
+static void BM_ForwardStepWithProbability(benchmark::State& state) {
+  auto states = state.range(0);
+
+  auto transitions = std::vector<std::vector<probability::probability_t>>(
+      states, std::vector<probability::probability_t>(states, 1.0 / states));
+  auto alpha = std::vector<probability::probability_t>(states, 1.0 / states);
+  auto next = std::vector<probability::probability_t>(states);
+
+  while (state.KeepRunning()) {
+    for (int j = 0; j < states; j++) {
+      next[j] = alpha[0] * transitions[0][j];
+      for (int i = 1; i < states; i++)
+        next[j] += alpha[i] * transitions[i][j];
+    }
+    benchmark::DoNotOptimize(next.data());
+  }
+  state.SetItemsProcessed(state.iterations() * states * states);
+}
+BENCHMARK(BM_ForwardStepWithProbability)->Range(16, 2048);
+
+static void BM_ForwardStepWithMultiplyAdd(benchmark::State& state) {
+  auto states = state.range(0);
+
+  auto transitions = std::vector<std::vector<probability::probability_t>>(
+      states, std::vector<probability::probability_t>(states, 1.0 / states));
+  auto alpha = std::vector<probability::probability_t>(states, 1.0 / states);
+  auto next = std::vector<probability::probability_t>(states);
+
+  while (state.KeepRunning()) {
+    for (int j = 0; j < states; j++) {
+      next[j] = alpha[0] * transitions[0][j];
+      for (int i = 1; i < states; i++)
+        probability::fma(next[j], alpha[i], transitions[i][j]);
+    }
+    benchmark::DoNotOptimize(next.data());
+  }
+  state.SetItemsProcessed(state.iterations() * states * states);
+}
+BENCHMARK(BM_ForwardStepWithMultiplyAdd)->Range(16, 2048);
+
+static void BM_ForwardStepWithRangeMultiplyAdd(benchmark::State& state) {
+  auto states = state.range(0);
+
+  auto transitions = std::vector<std::vector<probability::probability_t>>(
+      states, std::vector<probability::probability_t>(states, 1.0 / states));
+  auto alpha = std::vector<probability::probability_t>(states, 1.0 / states);
+  auto next = std::vector<probability::probability_t>(states);
+
+  while (state.KeepRunning()) {
+    std::fill(next.begin(), next.end(), probability::probability_t(0.0));
+    for (int i = 0; i < states; i++)
+      probability::fma(next, transitions[i], alpha[i]);
+    benchmark::DoNotOptimize(next.data());
+  }
+  state.SetItemsProcessed(state.iterations() * states * states);
+}
+BENCHMARK(BM_ForwardStepWithRangeMultiplyAdd)->Range(16, 2048);
+
+static void BM_ForwardStepWithLogMatrix(benchmark::State& state) {
+  auto states = state.range(0);
+
+  auto transitions = probability::probability_matrix_t(
+      states, states, 1.0 / states);
+  auto alpha = probability::probability_vector_t(states, 1.0 / states);
+  auto next = probability::probability_vector_t(states);
+
+  while (state.KeepRunning()) {
+    probability::gevm(alpha, transitions, next);
+    benchmark::DoNotOptimize(next.data());
+  }
+  state.SetItemsProcessed(state.iterations() * states * states);
+}
+BENCHMARK(BM_ForwardStepWithLogMatrix)->Range(16, 2048);
+
+static void BM_LoadLogarithmsWithConstructor(benchmark::State& state) {
+  auto logs = std::vector<double>(state.range(0));
+  for (std::size_t i = 0; i < logs.size(); i++) logs[i] = -1.0 - i % 64;
+  auto values = std::vector<probability::probability_t>(logs.size());
+
+  while (state.KeepRunning()) {
+    for (std::size_t i = 0; i < logs.size(); i++)
+      values[i] = probability::probability_t(std::exp(logs[i]));
+    benchmark::DoNotOptimize(values.data());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_LoadLogarithmsWithConstructor)->Range(1 << 10, 1 << 20);
+
+static void BM_LoadLogarithmsWithFromLog(benchmark::State& state) {
+  auto logs = std::vector<double>(state.range(0));
+  for (std::size_t i = 0; i < logs.size(); i++) logs[i] = -1.0 - i % 64;
+  auto values = std::vector<probability::probability_t>(logs.size());
+
+  while (state.KeepRunning()) {
+    for (std::size_t i = 0; i < logs.size(); i++)
+      values[i] = probability::probability_t::from_log(logs[i]);
+    benchmark::DoNotOptimize(values.data());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_LoadLogarithmsWithFromLog)->Range(1 << 10, 1 << 20);
+
+static void BM_LoadLogarithmsInBulk(benchmark::State& state) {
+  auto logs = std::vector<double>(state.range(0));
+  for (std::size_t i = 0; i < logs.size(); i++) logs[i] = -1.0 - i % 64;
+  auto values = std::vector<probability::probability_t>(logs.size());
+
+  while (state.KeepRunning()) {
+    probability::from_log_unchecked(logs, values);
+    benchmark::DoNotOptimize(values.data());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_LoadLogarithmsInBulk)->Range(1 << 10, 1 << 20);
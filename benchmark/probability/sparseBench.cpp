@@ -0,0 +1,148 @@
+/******************************************************************************/
+/*  Probability - A fast implementation of probabilities using logarithms     */
+/*  Copyright (C) 2016 Renato Cordeiro Ferreira                               */
+/*                                                                            */
+/*  This program is free software: you can redistribute it and/or modify      */
+/*  it under the terms of the GNU General Public License as published by      */
+/*  the Free Software Foundation, either version 3 of the License, or         */
+/*  (at your option) any later version.                                       */
+/*                                                                            */
+/*  This program is distributed in the hope that it will be useful,           */
+/*  but WITHOUT ANY WARRANTY; without even the implied warranty of            */
+/*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             */
+/*  GNU General Public License for more details.                              */
+/*                                                                            */
+/*  You should have received a copy of the GNU General Public License         */
+/*  along with this program.  If not, see <www.gnu.org/licenses>.             */
+/******************************************************************************/
+
+// Standard headers
+#include <vector>
+#include <cstddef>
+
+// External headers
+#include "benchmark/benchmark.h"
+
+// Probability headers
+#include "probability/sparse.hpp"
+
+static const std::size_t states = 1024;
+
+using max_checker_t = probability::ProbabilityChecker<double, 0>;
+using max_math_t = probability::MaxMath<double>;
+using max_vector_t
+  = probability::LogVector<double, 0, max_checker_t, max_math_t>;
+using max_matrix_t
+  = probability::LogMatrix<double, 0, max_checker_t, max_math_t>;
+using max_sparse_matrix_t
+  = probability::LogSparseMatrix<double, 0, max_checker_t, max_math_t>;
+
+// Transitions from each state to the next nonzeros states (wrapping
+// around), as in left-to-right models
+template<typename Matrix>
+static Matrix make_transitions(std::size_t nonzeros) {
+  Matrix transitions(states, states);
+  for (std::size_t i = 0; i < states; i++)
+    for (std::size_t s = 0; s < nonzeros; s++)
+      transitions(i, (i + s) % states) = 1.0 / nonzeros;
+  return transitions;
+}
+
+template<typename Vector>
+static Vector make_alpha() {
+  return Vector(states, 1.0 / states);
+}
+
+static void Densities(benchmark::internal::Benchmark* benchmark) {
+  for (int nonzeros : { 4, 8, 16, 64, 256, 1024 })
+    benchmark->Arg(nonzeros);
+}
+
+static void BM_DenseForwardStep(benchmark::State& state) {
+  auto transitions
+    = make_transitions<probability::probability_matrix_t>(state.range(0));
+  auto alpha = make_alpha<probability::probability_vector_t>();
+  probability::probability_vector_t next(states);
+
+  while (state.KeepRunning()) {
+    probability::gevm(alpha, transitions, next);
+    benchmark::DoNotOptimize(next.data());
+  }
+  state.SetItemsProcessed(state.iterations() * states);
+}
+BENCHMARK(BM_DenseForwardStep)->Apply(Densities);
+
+// Vector-matrix product, scattering each nonzero entry into the result
+static void BM_SparseForwardStep(benchmark::State& state) {
+  probability::probability_sparse_matrix_t transitions(
+      make_transitions<probability::probability_matrix_t>(state.range(0)));
+  auto alpha = make_alpha<probability::probability_vector_t>();
+  probability::probability_vector_t next(states);
+
+  while (state.KeepRunning()) {
+    probability::gevm(alpha, transitions, next);
+    benchmark::DoNotOptimize(next.data());
+  }
+  state.SetItemsProcessed(state.iterations() * states);
+}
+BENCHMARK(BM_SparseForwardStep)->Apply(Densities);
+
+// Matrix-vector product with the transposed transitions (CSC layout),
+// gathering the entries of the vector
+static void BM_SparseForwardStepTransposed(benchmark::State& state) {
+  auto transposed = probability::probability_sparse_matrix_t(
+      make_transitions<probability::probability_matrix_t>(state.range(0)))
+    .transpose();
+  auto alpha = make_alpha<probability::probability_vector_t>();
+  probability::probability_vector_t next(states);
+
+  while (state.KeepRunning()) {
+    probability::gemv(transposed, alpha, next);
+    benchmark::DoNotOptimize(next.data());
+  }
+  state.SetItemsProcessed(state.iterations() * states);
+}
+BENCHMARK(BM_SparseForwardStepTransposed)->Apply(Densities);
+
+// Vector-matrix product by diagonals, with a max-shifted log-sum-exp
+static void BM_BandedForwardStep(benchmark::State& state) {
+  auto nonzeros = static_cast<std::size_t>(state.range(0));
+  probability::probability_banded_matrix_t transitions(
+      states, states, 0, nonzeros - 1, 1.0 / nonzeros);
+  auto alpha = make_alpha<probability::probability_vector_t>();
+  probability::probability_vector_t next(states);
+
+  while (state.KeepRunning()) {
+    probability::gevm(alpha, transitions, next);
+    benchmark::DoNotOptimize(next.data());
+  }
+  state.SetItemsProcessed(state.iterations() * states);
+}
+BENCHMARK(BM_BandedForwardStep)->Apply(Densities);
+
+static void BM_DenseViterbiStep(benchmark::State& state) {
+  auto transitions = make_transitions<max_matrix_t>(state.range(0));
+  auto alpha = make_alpha<max_vector_t>();
+  max_vector_t next(states);
+
+  while (state.KeepRunning()) {
+    probability::gevm(alpha, transitions, next);
+    benchmark::DoNotOptimize(next.data());
+  }
+  state.SetItemsProcessed(state.iterations() * states);
+}
+BENCHMARK(BM_DenseViterbiStep)->Apply(Densities);
+
+static void BM_SparseViterbiStepTransposed(benchmark::State& state) {
+  auto transposed = max_sparse_matrix_t(
+      make_transitions<max_matrix_t>(state.range(0))).transpose();
+  auto alpha = make_alpha<max_vector_t>();
+  max_vector_t next(states);
+
+  while (state.KeepRunning()) {
+    probability::gemv(transposed, alpha, next);
+    benchmark::DoNotOptimize(next.data());
+  }
+  state.SetItemsProcessed(state.iterations() * states);
+}
+BENCHMARK(BM_SparseViterbiStepTransposed)->Apply(Densities);
@@ -0,0 +1,135 @@
+/******************************************************************************/
+/*  Probability - A fast implementation of probabilities using logarithms     */
+/*  Copyright (C) 2016 Renato Cordeiro Ferreira                               */
+/*                                                                            */
+/*  This program is free software: you can redistribute it and/or modify      */
+/*  it under the terms of the GNU General Public License as published by      */
+/*  the Free Software Foundation, either version 3 of the License, or         */
+/*  (at your option) any later version.                                       */
+/*                                                                            */
+/*  This program is distributed in the hope that it will be useful,           */
+/*  but WITHOUT ANY WARRANTY; without even the implied warranty of            */
+/*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             */
+/*  GNU General Public License for more details.                              */
+/*                                                                            */
+/*  You should have received a copy of the GNU General Public License         */
+/*  along with this program.  If not, see <www.gnu.org/licenses>.             */
+/******************************************************************************/
+
+// Standard headers
+#include <thread>
+#include <vector>
+#include <cstddef>
+#include <algorithm>
+
+// External headers
+#include "benchmark/benchmark.h"
+
+// Probability headers
+#include "probability/training.hpp"
+
+static probability::hmm_t make_hmm(std::size_t states, std::size_t symbols) {
+  auto initial = probability::probability_vector_t(states, 1.0 / states);
+
+  auto transitions = probability::probability_matrix_t(states, states);
+  for (std::size_t i = 0; i < states; i++)
+    for (std::size_t j = 0; j < states; j++)
+      transitions(i, j) = (i == j ? 1.0 + states : 1.0) / (2.0 * states);
+
+  auto emissions = probability::probability_matrix_t(states, symbols);
+  for (std::size_t i = 0; i < states; i++)
+    for (std::size_t k = 0; k < symbols; k++)
+      emissions(i, k) = (i % symbols == k ? 1.0 + symbols : 1.0)
+                      / (2.0 * symbols);
+
+  return probability::hmm_t(initial, transitions, emissions);
+}
+
+static std::vector<probability::hmm_t::sequence_type> make_batch(
+    std::size_t symbols) {
+  std::vector<probability::hmm_t::sequence_type> batch(256);
+  for (std::size_t b = 0; b < batch.size(); b++)
+    for (std::size_t t = 0; t < 200; t++)
+      batch[b].push_back((t * t + b * t + 7 * b) % symbols);
+  return batch;
+}
+
+static void Threads(benchmark::internal::Benchmark* benchmark) {
+  auto cores = static_cast<int>(
+      std::max(1u, std::thread::hardware_concurrency()));
+  for (int threads = 1; threads <= cores; threads *= 2)
+    benchmark->Arg(threads);
+}
+
+// E-step written by hand with the operators of probability_t
+static void BM_ExpectationWithOperators(benchmark::State& state) {
+  auto hmm = make_hmm(16, 4);
+  auto batch = make_batch(4);
+
+  auto states = hmm.states(), symbols = hmm.symbols();
+  auto transitions = hmm.transition_probabilities();
+  auto emissions = hmm.emission_probabilities();
+
+  using matrix_t = probability::probability_matrix_t;
+
+  while (state.KeepRunning()) {
+    matrix_t transition_counts(states, states);
+    matrix_t emission_counts(states, symbols);
+
+    for (const auto& sequence : batch) {
+      auto alpha = hmm.forward(sequence);
+      auto beta = hmm.backward(sequence);
+
+      probability::probability_t likelihood;
+      for (std::size_t i = 0; i < states; i++)
+        likelihood += alpha(sequence.size() - 1, i);
+
+      for (std::size_t t = 0; t < sequence.size(); t++) {
+        for (std::size_t i = 0; i < states; i++) {
+          emission_counts(i, sequence[t])
+            += alpha(t, i) * beta(t, i) / likelihood;
+          if (t + 1 == sequence.size()) continue;
+          for (std::size_t j = 0; j < states; j++)
+            transition_counts(i, j)
+              += alpha(t, i) * transitions(i, j)
+               * emissions(j, sequence[t+1]) * beta(t+1, j) / likelihood;
+        }
+      }
+    }
+
+    benchmark::DoNotOptimize(transition_counts.data());
+    benchmark::DoNotOptimize(emission_counts.data());
+  }
+  state.SetItemsProcessed(state.iterations() * batch.size());
+}
+BENCHMARK(BM_ExpectationWithOperators);
+
+static void BM_Expectation(benchmark::State& state) {
+  auto hmm = make_hmm(16, 4);
+  auto batch = make_batch(4);
+  probability::ThreadPool pool(state.range(0));
+  probability::baum_welch_t baum_welch(pool);
+
+  while (state.KeepRunning()) {
+    auto counts = baum_welch.expectation(hmm, batch);
+    benchmark::DoNotOptimize(counts.log_likelihood());
+  }
+  state.SetItemsProcessed(state.iterations() * batch.size());
+}
+BENCHMARK(BM_Expectation)->Apply(Threads)->UseRealTime();
+
+static void BM_BaumWelchIteration(benchmark::State& state) {
+  auto batch = make_batch(4);
+  probability::ThreadPool pool(state.range(0));
+  probability::baum_welch_t baum_welch(pool);
+
+  double sequences_per_second = 0;
+  while (state.KeepRunning()) {
+    auto hmm = make_hmm(16, 4);
+    sequences_per_second = baum_welch.iterate(hmm, batch)
+                                     .sequences_per_second();
+  }
+  state.counters["sequences_per_second"] = sequences_per_second;
+  state.SetItemsProcessed(state.iterations() * batch.size());
+}
+BENCHMARK(BM_BaumWelchIteration)->Apply(Threads)->UseRealTime();
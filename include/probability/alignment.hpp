@@ -0,0 +1,324 @@
+/******************************************************************************/
+/*  Probability - A fast implementation of probabilities using logarithms     */
+/*  Copyright (C) 2016 Renato Cordeiro Ferreira                               */
+/*                                                                            */
+/*  This program is free software: you can redistribute it and/or modify      */
+/*  it under the terms of the GNU General Public License as published by      */
+/*  the Free Software Foundation, either version 3 of the License, or         */
+/*  (at your option) any later version.                                       */
+/*                                                                            */
+/*  This program is distributed in the hope that it will be useful,           */
+/*  but WITHOUT ANY WARRANTY; without even the implied warranty of            */
+/*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             */
+/*  GNU General Public License for more details.                              */
+/*                                                                            */
+/*  You should have received a copy of the GNU General Public License         */
+/*  along with this program.  If not, see <www.gnu.org/licenses>.             */
+/******************************************************************************/
+
+#ifndef PROBABILITY_ALIGNMENT_
+#define PROBABILITY_ALIGNMENT_
+
+// Standard headers
+#include <cmath>
+#include <string>
+#include <vector>
+#include <cassert>
+#include <cstddef>
+
+// Internal headers
+#include "probability/numeric.hpp"
+#include "probability/dispatch.hpp"
+#include "probability/parallel.hpp"
+#include "probability/wavefront.hpp"
+#include "probability/probability.hpp"
+
+namespace probability {
+
+/*----------------------------------------------------------------------------*/
+/*                            FORWARD DECLARATIONS                            */
+/*----------------------------------------------------------------------------*/
+
+template<typename T, std::size_t ulp = 0,
+         typename C = ProbabilityChecker<T, ulp>,
+         typename M = StandardMath<T>>
+class PairHMM;
+
+/*----------------------------------------------------------------------------*/
+/*                              DIAGONAL KERNELS                              */
+/*----------------------------------------------------------------------------*/
+
+namespace detail {
+
+/**
+ * Arguments of the kernels for an anti-diagonal of the pair-HMM: raw
+ * logarithms of the match, insertion and deletion tables, indexed by row,
+ * in the anti-diagonal d and in the two previous ones, and the characters
+ * read[i-1] and haplotype[d-i-1] aligned in row i. The haplotype is
+ * reversed, so both are contiguous in i, and starts in the first row of
+ * the kernel (it would point before the haplotype in lower diagonals if
+ * it were indexed by row). Characters are converted to T, to compare
+ * them in the same SIMD lanes as the cells.
+ */
+template<typename T>
+struct PairHmmDiagonal {
+  T* match;
+  T* insertion;
+  T* deletion;
+  const T* match_1;
+  const T* insertion_1;
+  const T* deletion_1;
+  const T* match_2;
+  const T* insertion_2;
+  const T* deletion_2;
+  const T* read;
+  const T* haplotype;
+  T prior_match, prior_mismatch;
+  T match_to_match, match_to_gap;
+  T gap_to_match, gap_to_gap;
+};
+
+/*----------------------------------------------------------------------------*/
+
+/**
+ * Cells [first, last) of an anti-diagonal of the pair-HMM. There are no
+ * dependencies between cells, so the loops are vectorized.
+ */
+template<typename T, typename M>
+[[gnu::always_inline]] inline void pair_hmm_diagonal_generic(
+    const PairHmmDiagonal<T>& a, std::size_t first, std::size_t last) {
+  // Copied into locals, as stores into the tables could alias them
+  T* match = a.match;
+  T* insertion = a.insertion;
+  T* deletion = a.deletion;
+  const T* match_1 = a.match_1;
+  const T* insertion_1 = a.insertion_1;
+  const T* deletion_1 = a.deletion_1;
+  const T* match_2 = a.match_2;
+  const T* insertion_2 = a.insertion_2;
+  const T* deletion_2 = a.deletion_2;
+  const T* read = a.read;
+  const T* haplotype = a.haplotype;
+  const T prior_match = a.prior_match, prior_mismatch = a.prior_mismatch;
+  const T mm = a.match_to_match, mg = a.match_to_gap;
+  const T gm = a.gap_to_match, gg = a.gap_to_gap;
+
+  // Separate loops for each table, as a single one would need too many
+  // checks of aliasing between the tables to be vectorized
+  for (std::size_t i = first; i < last; i++) {
+    T prior = read[i-1] == haplotype[i-first] ? prior_match : prior_mismatch;
+    T from_gap = log_add_value<T, M>(gm + insertion_2[i-1],
+                                     gm + deletion_2[i-1]);
+    match[i] = prior + log_add_value<T, M>(mm + match_2[i-1], from_gap);
+  }
+  for (std::size_t i = first; i < last; i++)
+    insertion[i] = log_add_value<T, M>(mg + match_1[i-1],
+                                       gg + insertion_1[i-1]);
+  for (std::size_t i = first; i < last; i++)
+    deletion[i] = log_add_value<T, M>(mg + match_1[i], gg + deletion_1[i]);
+}
+
+/*----------------------------------------------------------------------------*/
+
+#if (defined(__GNUC__) || defined(__clang__)) \
+    && (defined(__x86_64__) || defined(__i386__))
+#define PROBABILITY_TARGET(isa) [[gnu::target(isa)]]
+#else
+#define PROBABILITY_TARGET(isa)
+#endif
+
+template<typename T, typename M>
+PROBABILITY_TARGET("avx2,fma")
+void pair_hmm_diagonal_avx2(const PairHmmDiagonal<T>& args,
+                            std::size_t first, std::size_t last) {
+  pair_hmm_diagonal_generic<T, M>(args, first, last);
+}
+
+template<typename T, typename M>
+PROBABILITY_TARGET("avx512f")
+void pair_hmm_diagonal_avx512(const PairHmmDiagonal<T>& args,
+                              std::size_t first, std::size_t last) {
+  pair_hmm_diagonal_generic<T, M>(args, first, last);
+}
+
+template<typename T, typename M>
+void pair_hmm_diagonal_default(const PairHmmDiagonal<T>& args,
+                               std::size_t first, std::size_t last) {
+  pair_hmm_diagonal_generic<T, M>(args, first, last);
+}
+
+#undef PROBABILITY_TARGET
+
+/*----------------------------------------------------------------------------*/
+
+template<typename T, typename M>
+auto pair_hmm_diagonal_kernel(InstructionSet set) noexcept {
+  return select_kernel<T>(set, &pair_hmm_diagonal_default<T, M>,
+                               &pair_hmm_diagonal_avx2<T, M>,
+                               &pair_hmm_diagonal_avx512<T, M>);
+}
+
+}  // namespace detail
+
+/*----------------------------------------------------------------------------*/
+/*                                  PAIR HMM                                  */
+/*----------------------------------------------------------------------------*/
+
+/**
+ * @class PairHMM
+ * @tparam T Value type, used for internal store
+ * @tparam ulp Units in the last place, defining the accuracy
+ * @tparam C Checker type, used to inject methods that verify consistency
+ * @tparam M Math type, used to implement logarithms, exponentials and sums
+ * @brief Pair hidden Markov model aligning a read to a haplotype, with
+ *        match, insertion and deletion states and affine gap penalties
+ *
+ * The forward algorithm fills the match, insertion and deletion tables
+ * in anti-diagonals (see wavefront), with the cells of each one computed
+ * in SIMD lanes. The alignment may start and end in any position of the
+ * haplotype, but must cover the whole read. With MaxMath, likelihoods
+ * are the probabilities of the most probable alignments.
+ */
+template<typename T, std::size_t ulp, typename C, typename M>
+class PairHMM {
+ public:
+  // Aliases
+  using probability_type = LogFloatingPoint<T, ulp, C, M>;
+  using table_type = AntiDiagonalTable<T, ulp, EmptyChecker<T>, M>;
+  using size_type = std::size_t;
+  using sequence_type = std::string;
+
+  // Constructors
+  /**
+   * @param base_error Probability of a mismatch between the read and
+   *                   the haplotype, divided between 3 other bases
+   * @param gap_open Probability of going from a match to an insertion
+   *                 (and the same to a deletion)
+   * @param gap_extension Probability of staying in an insertion or a
+   *                      deletion
+   */
+  PairHMM(const probability_type& base_error,
+          const probability_type& gap_open,
+          const probability_type& gap_extension) {
+    prior_match = std::log1p(-static_cast<T>(base_error));
+    prior_mismatch = base_error.data() - std::log(T(3));
+    match_to_match = std::log1p(-2 * static_cast<T>(gap_open));
+    match_to_gap = gap_open.data();
+    gap_to_match = std::log1p(-static_cast<T>(gap_extension));
+    gap_to_gap = gap_extension.data();
+  }
+
+  // Concrete methods
+  /**
+   * Probability of the read given the haplotype, summed over all their
+   * alignments.
+   */
+  probability_type likelihood(const sequence_type& read,
+                              const sequence_type& haplotype) const {
+    Workspace workspace(*this, read, haplotype);
+    wavefront(read.size(), haplotype.size(),
+              [&](size_type d, size_type first, size_type last) {
+                workspace.diagonal(d, first, last);
+              });
+    return workspace.result();
+  }
+
+  /**
+   * Same as above, running tiles of tile x tile cells of the tables in
+   * parallel in the thread pool.
+   */
+  probability_type likelihood(ThreadPool& pool,
+                              const sequence_type& read,
+                              const sequence_type& haplotype,
+                              size_type tile = 256) const {
+    Workspace workspace(*this, read, haplotype);
+    wavefront(pool, read.size(), haplotype.size(),
+              [&](size_type d, size_type first, size_type last) {
+                workspace.diagonal(d, first, last);
+              }, tile);
+    return workspace.result();
+  }
+
+ private:
+  /**
+   * Tables of the forward algorithm, with (read.size() + 1) x
+   * (haplotype.size() + 1) cells: row 0 and column 0 are the initial
+   * conditions, and cell (a, b) of the wavefront is cell (a + 1, b + 1).
+   */
+  class Workspace {
+   public:
+    Workspace(const PairHMM& model, const sequence_type& read,
+              const sequence_type& haplotype)
+        : hmm(model), x(read.begin(), read.end()),
+          y(haplotype.rbegin(), haplotype.rend()),
+          match(read.size() + 1, haplotype.size() + 1),
+          insertion(read.size() + 1, haplotype.size() + 1),
+          deletion(read.size() + 1, haplotype.size() + 1) {
+      // Alignments start in any position of the haplotype
+      if (haplotype.empty()) return;
+      auto start = -std::log(static_cast<T>(haplotype.size()));
+      for (size_type j = 0; j <= haplotype.size(); j++)
+        deletion.diagonal(j)[0] = start;
+    }
+
+    void diagonal(size_type d, size_type first, size_type last) {
+      d += 2;
+      first += 1;
+      last += 1;
+
+      // Row i aligns haplotype[d-i-1], i.e., y[y.size() - d + i]
+      assert(y.size() + first >= d && y.size() + first - d < y.size());
+      detail::PairHmmDiagonal<T> args {
+        match.diagonal(d), insertion.diagonal(d), deletion.diagonal(d),
+        match.diagonal(d-1), insertion.diagonal(d-1), deletion.diagonal(d-1),
+        match.diagonal(d-2), insertion.diagonal(d-2), deletion.diagonal(d-2),
+        x.data(), y.data() + (y.size() + first - d),
+        hmm.prior_match, hmm.prior_mismatch,
+        hmm.match_to_match, hmm.match_to_gap,
+        hmm.gap_to_match, hmm.gap_to_gap
+      };
+
+      static const auto kernel =
+          detail::pair_hmm_diagonal_kernel<T, M>(instruction_set());
+      kernel(args, first, last);
+    }
+
+    probability_type result() const {
+      // Alignments end in a match or an insertion in the last row
+      std::vector<T> ends;
+      ends.reserve(2 * y.size());
+      for (size_type j = 1; j <= y.size(); j++) {
+        ends.push_back(match(x.size(), j).data());
+        ends.push_back(insertion(x.size(), j).data());
+      }
+      return probability_type::from_log(
+          detail::log_sum<T, M>(ends.data(), ends.size()));
+    }
+
+   private:
+    const PairHMM& hmm;
+    std::vector<T> x, y;
+    table_type match, insertion, deletion;
+  };
+
+  // Instance variables
+  T prior_match, prior_mismatch;
+  T match_to_match, match_to_gap;
+  T gap_to_match, gap_to_gap;
+};
+
+/*----------------------------------------------------------------------------*/
+/*                                  ALIASES                                   */
+/*----------------------------------------------------------------------------*/
+
+using pair_hmm_float_t = PairHMM<float>;
+using pair_hmm_double_t = PairHMM<double>;
+using pair_hmm_long_double_t = PairHMM<long double>;
+
+using pair_hmm_t = pair_hmm_double_t;
+
+/*----------------------------------------------------------------------------*/
+
+}  // namespace probability
+
+#endif  // PROBABILITY_ALIGNMENT_
@@ -0,0 +1,430 @@
+/******************************************************************************/
+/*  Probability - A fast implementation of probabilities using logarithms     */
+/*  Copyright (C) 2016 Renato Cordeiro Ferreira                               */
+/*                                                                            */
+/*  This program is free software: you can redistribute it and/or modify      */
+/*  it under the terms of the GNU General Public License as published by      */
+/*  the Free Software Foundation, either version 3 of the License, or         */
+/*  (at your option) any later version.                                       */
+/*                                                                            */
+/*  This program is distributed in the hope that it will be useful,           */
+/*  but WITHOUT ANY WARRANTY; without even the implied warranty of            */
+/*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             */
+/*  GNU General Public License for more details.                              */
+/*                                                                            */
+/*  You should have received a copy of the GNU General Public License         */
+/*  along with this program.  If not, see <www.gnu.org/licenses>.             */
+/******************************************************************************/
+
+#ifndef PROBABILITY_BEAM_
+#define PROBABILITY_BEAM_
+
+// Standard headers
+#include <cmath>
+#include <limits>
+#include <vector>
+#include <cassert>
+#include <cstddef>
+#include <algorithm>
+
+// Internal headers
+#include "probability/hmm.hpp"
+#include "probability/numeric.hpp"
+#include "probability/sparse.hpp"
+#include "probability/probability.hpp"
+
+namespace probability {
+
+/*----------------------------------------------------------------------------*/
+/*                            FORWARD DECLARATIONS                            */
+/*----------------------------------------------------------------------------*/
+
+template<typename T, std::size_t ulp = 0,
+         typename C = ProbabilityChecker<T, ulp>,
+         typename M = StandardMath<T>>
+class BeamSearch;
+
+/*----------------------------------------------------------------------------*/
+/*                                    BEAM                                    */
+/*----------------------------------------------------------------------------*/
+
+/**
+ * @class Beam
+ * @tparam T Value type, used for internal store
+ * @brief Pruning rule of a beam search: states are kept in a column only
+ *        if their probability is at least ratio times the maximum of the
+ *        column, and only the max_states most probable ones
+ *
+ * The ratio is a LogThreshold, so states are pruned by comparing their
+ * raw logarithms with the logarithm of the maximum plus a constant.
+ */
+template<typename T>
+class Beam {
+ public:
+  // Aliases
+  using value_type = T;
+  using size_type = std::size_t;
+
+  // Constructors
+  constexpr explicit Beam(LogThreshold<T> ratio,
+                          size_type max_states = unlimited)
+      : log_ratio_value(ratio.data()), max_states_value(max_states) {
+    assert(max_states > 0);
+  }
+
+  constexpr explicit Beam(size_type max_states)
+      : log_ratio_value(-std::numeric_limits<T>::infinity()),
+        max_states_value(max_states) {
+    assert(max_states > 0);
+  }
+
+  // Concrete methods
+  constexpr T log_ratio() const noexcept {
+    return log_ratio_value;
+  }
+
+  constexpr size_type max_states() const noexcept {
+    return max_states_value;
+  }
+
+  // Class constants
+  static constexpr size_type unlimited = std::numeric_limits<size_type>::max();
+
+ private:
+  // Instance variables
+  T log_ratio_value;
+  size_type max_states_value;
+};
+
+/*----------------------------------------------------------------------------*/
+/*                                BEAM REPORT                                 */
+/*----------------------------------------------------------------------------*/
+
+/**
+ * @class BeamReport
+ * @brief Log-likelihood of a beam search, with the number of states kept
+ *        and pruned, and the probability mass that was pruned
+ */
+struct BeamReport {
+  // Instance variables
+  std::size_t columns = 0;
+  std::size_t active_states = 0;
+  std::size_t pruned_states = 0;
+  double pruned_mass = 0;
+  double log_likelihood = -std::numeric_limits<double>::infinity();
+
+  // Concrete methods
+  /**
+   * Average number of states kept in each column.
+   */
+  double mean_active_states() const noexcept {
+    return columns > 0
+         ? static_cast<double>(active_states) / static_cast<double>(columns)
+         : 0;
+  }
+};
+
+/*----------------------------------------------------------------------------*/
+/*                                BEAM SEARCH                                 */
+/*----------------------------------------------------------------------------*/
+
+/**
+ * @class BeamSearch
+ * @tparam T Value type, used for internal store
+ * @tparam ulp Units in the last place, defining the accuracy
+ * @tparam C Checker type, used to inject methods that verify consistency
+ * @tparam M Math type, used to implement logarithms, exponentials and sums
+ * @brief Forward algorithm and Viterbi decoding of a HiddenMarkovModel
+ *        visiting only the states kept by a Beam in each column
+ *
+ * Columns are compact lists of active states (sorted by state), and each
+ * step scatters them through the nonzero transitions only (stored in a
+ * LogSparseMatrix), so the cost of a column is proportional to the
+ * number of active states times their number of successors.
+ *
+ * The pruned mass of a column is the fraction of its probability in the
+ * states that were pruned; their sum over all columns (pruned_mass in
+ * the BeamReport) estimates the relative error of the likelihood.
+ */
+template<typename T, std::size_t ulp, typename C, typename M>
+class BeamSearch {
+ public:
+  // Aliases
+  using hmm_type = HiddenMarkovModel<T, ulp, C, M>;
+  using probability_type = LogFloatingPoint<T, ulp, C, M>;
+  using beam_type = Beam<T>;
+  using size_type = std::size_t;
+  using sequence_type = typename hmm_type::sequence_type;
+  using path_type = typename hmm_type::path_type;
+
+  // Constructors
+  BeamSearch(const hmm_type& hmm, const beam_type& beam)
+      : n_states(hmm.states()), n_symbols(hmm.symbols()), rule(beam),
+        initial(hmm.initial_probabilities()),
+        transitions(hmm.transition_probabilities()),
+        emissions(hmm.symbols() * hmm.states()) {
+    // Emissions are stored by symbol, to read them contiguously
+    auto by_state = hmm.emission_probabilities();
+    for (size_type i = 0; i < n_states; i++)
+      for (size_type k = 0; k < n_symbols; k++)
+        emissions[k * n_states + i] = by_state(i, k).data();
+  }
+
+  // Concrete methods
+  const beam_type& beam() const noexcept {
+    return rule;
+  }
+
+  /**
+   * Probability of a sequence, as HiddenMarkovModel::likelihood(), summed
+   * only over the paths through the states kept in each column.
+   */
+  probability_type likelihood(const sequence_type& sequence) const {
+    BeamReport report;
+    Workspace workspace(n_states);
+    return probability_type::from_log(
+        search<false, false>(sequence, workspace, report));
+  }
+
+  probability_type likelihood(const sequence_type& sequence,
+                              BeamReport& report) const {
+    Workspace workspace(n_states);
+    return probability_type::from_log(
+        search<false, true>(sequence, workspace, report));
+  }
+
+  /**
+   * Most probable path of states for a sequence (the Viterbi path, with
+   * maximums instead of sums regardless of the math type), among the
+   * states kept in each column (empty if there is no such path).
+   */
+  path_type viterbi(const sequence_type& sequence) const {
+    BeamReport report;
+    return viterbi<false>(sequence, report);
+  }
+
+  path_type viterbi(const sequence_type& sequence, BeamReport& report) const {
+    return viterbi<true>(sequence, report);
+  }
+
+ private:
+  /**
+   * Active states of a column, with their raw logarithms and, in Viterbi,
+   * their predecessors.
+   */
+  struct Column {
+    std::vector<size_type> states;
+    std::vector<T> values;
+    std::vector<size_type> back;
+  };
+
+  /**
+   * Dense scratch column (reset only in the states touched by each step)
+   * and, in Viterbi, the columns kept for the back pointers.
+   */
+  struct Workspace {
+    explicit Workspace(size_type size)
+        : scores(size), back(size), marked(size) {
+    }
+
+    std::vector<T> scores;
+    std::vector<size_type> back;
+    std::vector<char> marked;
+    std::vector<size_type> touched;
+    std::vector<Column> columns;
+    Column current;
+    size_type last_state = 0;
+  };
+
+  /**
+   * Viterbi search, followed by the back pointers of the best last state.
+   */
+  template<bool reported>
+  path_type viterbi(const sequence_type& sequence, BeamReport& report) const {
+    Workspace workspace(n_states);
+    search<true, reported>(sequence, workspace, report);
+
+    if (sequence.empty() || report.log_likelihood == -infinity()) return {};
+    path_type path(sequence.size());
+
+    // Follows the back pointers of the states in the path
+    path.back() = workspace.last_state;
+    for (size_type t = sequence.size() - 1; t > 0; t--) {
+      const auto& column = workspace.columns[t];
+      auto it = std::lower_bound(column.states.begin(), column.states.end(),
+                                 path[t]);
+      assert(it != column.states.end() && *it == path[t]);
+      path[t-1] = column.back[it - column.states.begin()];
+    }
+
+    return path;
+  }
+
+  /**
+   * Runs the search, filling the report (with the pruned mass, which
+   * costs exponentials in every column, only if it is reported).
+   */
+  template<bool viterbi, bool reported>
+  T search(const sequence_type& sequence, Workspace& w,
+           BeamReport& report) const {
+    report = BeamReport();
+    report.columns = sequence.size();
+    if (sequence.empty()) {
+      report.log_likelihood = detail::log_sum<T, M>(initial.data(), n_states);
+      return report.log_likelihood;
+    }
+    if constexpr (viterbi) w.columns.resize(sequence.size());
+
+    start(sequence[0], w);
+    for (size_type t = 1; t < sequence.size(); t++) {
+      prune<reported>(w, report);
+      if constexpr (viterbi) w.columns[t-1] = w.current;
+      transit<viterbi>(sequence[t], w);
+    }
+
+    // The last column is not pruned
+    T result = zero();
+    for (auto j : w.touched) {
+      T score = w.scores[j];
+      if (viterbi && score > result) w.last_state = j;
+      result = viterbi ? std::max(result, score)
+                       : detail::log_add_value<T, M>(result, score);
+    }
+    if constexpr (viterbi) {
+      auto& last = w.columns.back();
+      last.states = w.touched;
+      std::sort(last.states.begin(), last.states.end());
+      for (auto j : last.states) last.back.push_back(w.back[j]);
+    }
+
+    report.active_states += w.touched.size();
+    report.log_likelihood = static_cast<double>(result);
+    return result;
+  }
+
+  void start(size_type s, Workspace& w) const {
+    assert(s < n_symbols);
+    const T* emission = emissions.data() + s * n_states;
+    w.touched.clear();
+    for (size_type i = 0; i < n_states; i++) {
+      if (initial.data()[i] == zero()) continue;
+      w.scores[i] = initial.data()[i] + emission[i];
+      w.back[i] = i;
+      w.marked[i] = 1;
+      w.touched.push_back(i);
+    }
+  }
+
+  /**
+   * Keeps in the current column the touched states within the beam,
+   * resetting the scratch column.
+   */
+  template<bool reported>
+  void prune(Workspace& w, BeamReport& report) const {
+    T max = zero();
+    for (auto j : w.touched) max = std::max(max, w.scores[j]);
+    T threshold = max + rule.log_ratio();
+
+    auto& kept = w.current.states;
+    kept.clear();
+    for (auto j : w.touched)
+      if (w.scores[j] > zero() && w.scores[j] >= threshold) kept.push_back(j);
+
+    if (kept.size() > rule.max_states()) {
+      std::nth_element(kept.begin(), kept.begin() + rule.max_states(),
+                       kept.end(), [&](size_type i, size_type j) {
+                         return w.scores[i] > w.scores[j];
+                       });
+      kept.resize(rule.max_states());
+    }
+    std::sort(kept.begin(), kept.end());
+
+    // Pruned mass, relative to the maximum of the column
+    T total = 0, remaining = 0;
+    if (reported && max > zero()) {
+      for (auto j : w.touched) total += std::exp(w.scores[j] - max);
+      for (auto j : kept) remaining += std::exp(w.scores[j] - max);
+      report.pruned_mass += static_cast<double>((total - remaining) / total);
+    }
+    report.active_states += kept.size();
+    report.pruned_states += w.touched.size() - kept.size();
+
+    w.current.values.clear();
+    w.current.back.clear();
+    for (auto j : kept) {
+      w.current.values.push_back(w.scores[j]);
+      w.current.back.push_back(w.back[j]);
+    }
+    for (auto j : w.touched) w.marked[j] = 0;
+  }
+
+  /**
+   * Scatters the active states of the current column through their
+   * transitions into the scratch column, and emits the symbol s.
+   */
+  template<bool viterbi>
+  void transit(size_type s, Workspace& w) const {
+    assert(s < n_symbols);
+    const auto* offsets = transitions.row_offsets();
+    const auto* indices = transitions.column_indices();
+    const T* values = transitions.data();
+
+    w.touched.clear();
+    for (size_type k = 0; k < w.current.states.size(); k++) {
+      size_type i = w.current.states[k];
+      T value = w.current.values[k];
+      for (size_type e = offsets[i]; e < offsets[i+1]; e++) {
+        size_type j = indices[e];
+        T score = value + values[e];
+        if (!w.marked[j]) {
+          w.marked[j] = 1;
+          w.touched.push_back(j);
+          w.scores[j] = score;
+          w.back[j] = i;
+        } else if constexpr (viterbi) {
+          if (score > w.scores[j]) {
+            w.scores[j] = score;
+            w.back[j] = i;
+          }
+        } else {
+          w.scores[j] = detail::log_add_value<T, M>(w.scores[j], score);
+        }
+      }
+    }
+
+    const T* emission = emissions.data() + s * n_states;
+    for (auto j : w.touched) w.scores[j] += emission[j];
+  }
+
+  static constexpr T zero() noexcept {
+    return -std::numeric_limits<T>::infinity();
+  }
+
+  static constexpr double infinity() noexcept {
+    return std::numeric_limits<double>::infinity();
+  }
+
+  // Instance variables
+  size_type n_states;
+  size_type n_symbols;
+  beam_type rule;
+  LogVector<T, ulp, C, M> initial;
+  LogSparseMatrix<T, ulp, C, M> transitions;
+  std::vector<T> emissions;  // symbols x states
+};
+
+/*----------------------------------------------------------------------------*/
+/*                                  ALIASES                                   */
+/*----------------------------------------------------------------------------*/
+
+using beam_search_float_t = BeamSearch<float>;
+using beam_search_double_t = BeamSearch<double>;
+using beam_search_long_double_t = BeamSearch<long double>;
+
+using beam_search_t = beam_search_double_t;
+
+/*----------------------------------------------------------------------------*/
+
+}  // namespace probability
+
+#endif  // PROBABILITY_BEAM_
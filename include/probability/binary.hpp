@@ -0,0 +1,482 @@
+/******************************************************************************/
+/*  Probability - A fast implementation of probabilities using logarithms     */
+/*  Copyright (C) 2016 Renato Cordeiro Ferreira                               */
+/*                                                                            */
+/*  This program is free software: you can redistribute it and/or modify      */
+/*  it under the terms of the GNU General Public License as published by      */
+/*  the Free Software Foundation, either version 3 of the License, or         */
+/*  (at your option) any later version.                                       */
+/*                                                                            */
+/*  This program is distributed in the hope that it will be useful,           */
+/*  but WITHOUT ANY WARRANTY; without even the implied warranty of            */
+/*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             */
+/*  GNU General Public License for more details.                              */
+/*                                                                            */
+/*  You should have received a copy of the GNU General Public License         */
+/*  along with this program.  If not, see <www.gnu.org/licenses>.             */
+/******************************************************************************/
+
+#ifndef PROBABILITY_BINARY_
+#define PROBABILITY_BINARY_
+
+// Standard headers
+#include <array>
+#include <cmath>
+#include <limits>
+#include <string>
+#include <cerrno>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <utility>
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
+
+// System headers
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+// Internal headers
+#include "probability/numeric.hpp"
+#include "probability/probability.hpp"
+
+namespace probability {
+
+/*----------------------------------------------------------------------------*/
+/*                               BINARY FORMAT                                */
+/*----------------------------------------------------------------------------*/
+
+/**
+ * @class BinaryFormatError
+ * @brief Error reading, writing or validating a binary file of
+ *        LogFloatingPoint
+ */
+class BinaryFormatError : public std::runtime_error {
+ public:
+  using std::runtime_error::runtime_error;
+};
+
+/*----------------------------------------------------------------------------*/
+
+/**
+ * @class BinaryHeader
+ * @brief Header of a binary file of LogFloatingPoint
+ *
+ * A binary file has this 64-byte header followed by the raw logarithms of
+ * the values, in the byte order of the machine that wrote them. The header
+ * records the value type, the units in the last place and the checker
+ * type, so that files are only read as the same type of LogFloatingPoint
+ * that wrote them (the math type is not recorded: it does not change the
+ * meaning of the logarithms).
+ */
+struct BinaryHeader {
+  // Static variables
+  static constexpr std::array<char, 8> magic_number
+    = {{ 'P', 'R', 'O', 'B', 'L', 'O', 'G', '\0' }};
+  static constexpr std::uint32_t current_version = 1;
+  static constexpr std::uint32_t byte_order_mark = 0x01020304;
+
+  // Instance variables
+  std::array<char, 8> magic;
+  std::uint32_t version;
+  std::uint32_t byte_order;
+  std::uint32_t value_type;
+  std::uint32_t value_size;
+  std::uint32_t ulp;
+  std::uint32_t checker;
+  std::uint64_t size;
+  std::array<char, 24> reserved;
+};
+
+static_assert(sizeof(BinaryHeader) == 64,
+    "Binary header must have 64 bytes, to align the values after it");
+
+/*----------------------------------------------------------------------------*/
+
+/**
+ * Identifier of value types in binary files.
+ */
+template<typename T>
+struct binary_value_type;
+
+template<>
+struct binary_value_type<float>
+  : std::integral_constant<std::uint32_t, 1> {};
+
+template<>
+struct binary_value_type<double>
+  : std::integral_constant<std::uint32_t, 2> {};
+
+template<>
+struct binary_value_type<long double>
+  : std::integral_constant<std::uint32_t, 3> {};
+
+template<typename T>
+constexpr std::uint32_t binary_value_type_v = binary_value_type<T>::value;
+
+/*----------------------------------------------------------------------------*/
+
+/**
+ * Identifier of checker types in binary files (which may be specialized
+ * for other checkers).
+ */
+template<typename C>
+struct binary_checker : std::integral_constant<std::uint32_t, 0xFF> {};
+
+template<typename T>
+struct binary_checker<EmptyChecker<T>>
+  : std::integral_constant<std::uint32_t, 0> {};
+
+template<typename T, std::size_t ulp>
+struct binary_checker<ProbabilityChecker<T, ulp>>
+  : std::integral_constant<std::uint32_t, 1> {};
+
+template<typename T, std::size_t ulp>
+struct binary_checker<CountingChecker<T, ulp>>
+  : std::integral_constant<std::uint32_t, 2> {};
+
+template<typename C>
+constexpr std::uint32_t binary_checker_v = binary_checker<C>::value;
+
+/*----------------------------------------------------------------------------*/
+
+/**
+ * Checker types whose values must be probabilities (i.e., logarithms
+ * not above 0, up to the units in the last place of the type).
+ */
+template<typename C>
+struct is_probability_checker : std::false_type {};
+
+template<typename T, std::size_t ulp>
+struct is_probability_checker<ProbabilityChecker<T, ulp>> : std::true_type {};
+
+template<typename T, std::size_t ulp>
+struct is_probability_checker<CountingChecker<T, ulp>> : std::true_type {};
+
+template<typename C>
+constexpr bool is_probability_checker_v = is_probability_checker<C>::value;
+
+/*----------------------------------------------------------------------------*/
+
+/**
+ * Header of a binary file with size values of type
+ * LogFloatingPoint<T, ulp, C, M>.
+ */
+template<typename T, std::size_t ulp, typename C, typename M>
+BinaryHeader make_binary_header(std::uint64_t size) noexcept {
+  BinaryHeader header {};
+  header.magic = BinaryHeader::magic_number;
+  header.version = BinaryHeader::current_version;
+  header.byte_order = BinaryHeader::byte_order_mark;
+  header.value_type = binary_value_type_v<T>;
+  header.value_size = sizeof(T);
+  header.ulp = ulp;
+  header.checker = binary_checker_v<C>;
+  header.size = size;
+  return header;
+}
+
+/*----------------------------------------------------------------------------*/
+
+/**
+ * Verifies that a header (of a file with file_size bytes) describes a
+ * binary file of LogFloatingPoint<T, ulp, C, M>, throwing a
+ * BinaryFormatError otherwise.
+ */
+template<typename T, std::size_t ulp, typename C, typename M>
+void validate_binary_header(const BinaryHeader& header,
+                            std::uint64_t file_size) {
+  auto expected = make_binary_header<T, ulp, C, M>(header.size);
+
+  if (header.magic != expected.magic)
+    throw BinaryFormatError("Not a binary file of LogFloatingPoint");
+  if (header.byte_order != expected.byte_order)
+    throw BinaryFormatError("Binary file has a different byte order");
+  if (header.version != expected.version)
+    throw BinaryFormatError("Unsupported version of binary file: "
+                            + std::to_string(header.version));
+  if (header.value_type != expected.value_type
+      || header.value_size != expected.value_size)
+    throw BinaryFormatError("Binary file has a different value type");
+  if (header.ulp != expected.ulp)
+    throw BinaryFormatError("Binary file has different units in the "
+                            "last place: " + std::to_string(header.ulp));
+  if (header.checker != expected.checker)
+    throw BinaryFormatError("Binary file has a different checker type");
+  // Compares counts rather than byte sizes, so that a corrupted header
+  // cannot make header.size * sizeof(T) wrap around to the file size
+  auto payload = file_size < sizeof(BinaryHeader)
+    ? std::uint64_t { 0 } : file_size - sizeof(BinaryHeader);
+  if (file_size < sizeof(BinaryHeader) || payload % sizeof(T) != 0
+      || header.size != payload / sizeof(T))
+    throw BinaryFormatError("Binary file has " + std::to_string(file_size)
+                            + " bytes, but its header has "
+                            + std::to_string(header.size) + " values");
+}
+
+/*----------------------------------------------------------------------------*/
+/*                                   WRITER                                   */
+/*----------------------------------------------------------------------------*/
+
+/**
+ * Writes a contiguous range of LogFloatingPoint to a binary file (a header
+ * followed by the raw logarithms), throwing a BinaryFormatError if the
+ * file cannot be written.
+ */
+template<typename T, std::size_t ulp, typename C, typename M>
+void write_binary(const std::string& path,
+                  const LogFloatingPoint<T, ulp, C, M>* first,
+                  const LogFloatingPoint<T, ulp, C, M>* last) {
+  assert(first <= last);
+  auto size = static_cast<std::size_t>(last - first);
+  auto header = make_binary_header<T, ulp, C, M>(size);
+
+  std::ofstream file(path, std::ios::binary | std::ios::trunc);
+  file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  file.write(reinterpret_cast<const char*>(detail::raw_data(first)),
+             static_cast<std::streamsize>(size * sizeof(T)));
+  file.close();
+
+  if (!file) throw BinaryFormatError("Cannot write binary file " + path);
+}
+
+/*----------------------------------------------------------------------------*/
+
+template<typename Container,
+  typename VT = typename Container::value_type,
+  typename std::enable_if_t<is_log_floating_point_v<VT>
+    && std::is_same_v<decltype(std::data(std::declval<const Container&>())),
+                      const VT*>,
+  void>* = nullptr>
+void write_binary(const std::string& path, const Container& container) {
+  const VT* first = std::data(container);
+  write_binary(path, first, first + std::size(container));
+}
+
+/*----------------------------------------------------------------------------*/
+/*                                 VALIDATOR                                  */
+/*----------------------------------------------------------------------------*/
+
+namespace detail {
+
+/**
+ * RAII wrapper of a POSIX file descriptor.
+ */
+class FileDescriptor {
+ public:
+  // Constructors
+  explicit FileDescriptor(const std::string& path)
+      : descriptor(::open(path.c_str(), O_RDONLY)) {
+    if (descriptor < 0)
+      throw BinaryFormatError("Cannot open binary file " + path + ": "
+                              + std::strerror(errno));
+  }
+
+  FileDescriptor(const FileDescriptor&) = delete;
+  FileDescriptor& operator=(const FileDescriptor&) = delete;
+
+  // Destructor
+  ~FileDescriptor() {
+    ::close(descriptor);
+  }
+
+  // Concrete methods
+  int get() const noexcept {
+    return descriptor;
+  }
+
+  std::uint64_t file_size() const {
+    struct stat status;
+    if (::fstat(descriptor, &status) != 0)
+      throw BinaryFormatError(std::string("Cannot read binary file: ")
+                              + std::strerror(errno));
+    return static_cast<std::uint64_t>(status.st_size);
+  }
+
+  BinaryHeader header() const {
+    BinaryHeader result {};
+    auto bytes = ::pread(descriptor, &result, sizeof(result), 0);
+    if (bytes != static_cast<ssize_t>(sizeof(result)))
+      throw BinaryFormatError("Binary file is too small for its header");
+    return result;
+  }
+
+ private:
+  // Instance variables
+  int descriptor;
+};
+
+}  // namespace detail
+
+/*----------------------------------------------------------------------------*/
+
+/**
+ * Verifies that a file is a binary file of the LogFloatingPoint Number,
+ * and that none of its values is NaN (or above 1, for checkers of
+ * probabilities), throwing a BinaryFormatError otherwise. The values are
+ * verified explicitly, as ProbabilityChecker only asserts (and so does
+ * nothing in release builds). Valid values are also passed to the checker
+ * of Number (as when building them with from_log).
+ */
+template<typename Number,
+  typename std::enable_if_t<is_log_floating_point_v<Number>, void>* = nullptr>
+void validate_binary(const std::string& path) {
+  using T = typename Number::value_type;
+  using C = typename Number::checker_type;
+  using M = typename Number::math_type;
+
+  detail::FileDescriptor file(path);
+  validate_binary_header<T, Number::ULP, C, M>(file.header(),
+                                               file.file_size());
+
+  constexpr T limit = is_probability_checker_v<C>
+    ? std::numeric_limits<T>::epsilon() * detail::pow2<T>(Number::ULP)
+    : std::numeric_limits<T>::infinity();
+
+  std::ifstream values(path, std::ios::binary);
+  values.seekg(sizeof(BinaryHeader));
+  std::uint64_t index = 0;
+  for (T value; values.read(reinterpret_cast<char*>(&value), sizeof(T)); ) {
+    if (std::isnan(value) || value > limit)
+      throw BinaryFormatError("Binary file has an invalid value at index "
+                              + std::to_string(index));
+    C::check_range(value);
+    index++;
+  }
+}
+
+/*----------------------------------------------------------------------------*/
+/*                               LOG SPAN VIEW                                */
+/*----------------------------------------------------------------------------*/
+
+/**
+ * @class LogSpanView
+ * @tparam T Value type, used for internal store
+ * @tparam ulp Units in the last place, defining the accuracy
+ * @tparam C Checker type, used to inject methods that verify consistency
+ * @tparam M Math type, used to implement logarithms, exponentials and sums
+ * @brief Read-only view of a binary file of LogFloatingPoint, mapped
+ *        into memory
+ *
+ * The file is mapped with mmap and its values are read in place, with no
+ * copies or conversions: opening a view only reads and validates its
+ * header, and the pages with the values are loaded on demand by the
+ * operating system (and shared between processes that map the same file).
+ */
+template<typename T, std::size_t ulp = 0, typename C = EmptyChecker<T>,
+         typename M = StandardMath<T>>
+class LogSpanView {
+ public:
+  // Aliases
+  using value_type = LogFloatingPoint<T, ulp, C, M>;
+  using size_type = std::size_t;
+  using difference_type = std::ptrdiff_t;
+  using const_reference = const value_type&;
+  using const_pointer = const value_type*;
+  using const_iterator = const value_type*;
+
+  // Constructors
+  explicit LogSpanView(const std::string& path) {
+    detail::FileDescriptor file(path);
+    auto file_size = file.file_size();
+    auto header = file.header();
+    validate_binary_header<T, ulp, C, M>(header, file_size);
+
+    void* mapping = ::mmap(nullptr, file_size, PROT_READ, MAP_SHARED,
+                           file.get(), 0);
+    if (mapping == MAP_FAILED)
+      throw BinaryFormatError("Cannot map binary file " + path + ": "
+                              + std::strerror(errno));
+
+    address = static_cast<const char*>(mapping);
+    length = file_size;
+    count = header.size;
+  }
+
+  LogSpanView(LogSpanView&& other) noexcept
+      : address(std::exchange(other.address, nullptr)),
+        length(std::exchange(other.length, 0)),
+        count(std::exchange(other.count, 0)) {
+  }
+
+  LogSpanView(const LogSpanView&) = delete;
+
+  // Destructor
+  ~LogSpanView() {
+    if (address) ::munmap(const_cast<char*>(address), length);
+  }
+
+  // Operator overloads
+  LogSpanView& operator=(LogSpanView&& other) noexcept {
+    std::swap(address, other.address);
+    std::swap(length, other.length);
+    std::swap(count, other.count);
+    return *this;
+  }
+
+  LogSpanView& operator=(const LogSpanView&) = delete;
+
+  const_reference operator[](size_type i) const noexcept {
+    assert(i < count);
+    return data()[i];
+  }
+
+  // Concrete methods
+  const_pointer data() const noexcept {
+    static_assert(sizeof(value_type) == sizeof(T),
+        "LogFloatingPoint must have the same size of its value type");
+    static_assert(std::is_standard_layout_v<value_type>,
+        "LogFloatingPoint must have standard layout");
+    return reinterpret_cast<const_pointer>(address + sizeof(BinaryHeader));
+  }
+
+  size_type size() const noexcept {
+    return count;
+  }
+
+  bool empty() const noexcept {
+    return count == 0;
+  }
+
+  const_iterator begin() const noexcept {
+    return data();
+  }
+
+  const_iterator end() const noexcept {
+    return data() + count;
+  }
+
+ private:
+  // Instance variables
+  const char* address = nullptr;
+  size_type length = 0;
+  size_type count = 0;
+};
+
+/*----------------------------------------------------------------------------*/
+/*                                  ALIASES                                   */
+/*----------------------------------------------------------------------------*/
+
+using log_float_span_view_t = LogSpanView<float>;
+using log_double_span_view_t = LogSpanView<double>;
+using log_long_double_span_view_t = LogSpanView<long double>;
+
+template<typename T, std::size_t ulp = 0>
+using ProbabilitySpanView = LogSpanView<T, ulp, ProbabilityChecker<T, ulp>>;
+
+using probability_float_span_view_t = ProbabilitySpanView<float>;
+using probability_double_span_view_t = ProbabilitySpanView<double>;
+using probability_long_double_span_view_t = ProbabilitySpanView<long double>;
+
+using probability_span_view_t = probability_double_span_view_t;
+
+/*----------------------------------------------------------------------------*/
+
+}  // namespace probability
+
+#endif  // PROBABILITY_BINARY_
@@ -0,0 +1,193 @@
+/******************************************************************************/
+/*  Probability - A fast implementation of probabilities using logarithms     */
+/*  Copyright (C) 2016 Renato Cordeiro Ferreira                               */
+/*                                                                            */
+/*  This program is free software: you can redistribute it and/or modify      */
+/*  it under the terms of the GNU General Public License as published by      */
+/*  the Free Software Foundation, either version 3 of the License, or         */
+/*  (at your option) any later version.                                       */
+/*                                                                            */
+/*  This program is distributed in the hope that it will be useful,           */
+/*  but WITHOUT ANY WARRANTY; without even the implied warranty of            */
+/*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             */
+/*  GNU General Public License for more details.                              */
+/*                                                                            */
+/*  You should have received a copy of the GNU General Public License         */
+/*  along with this program.  If not, see <www.gnu.org/licenses>.             */
+/******************************************************************************/
+
+#ifndef PROBABILITY_DISPATCH_
+#define PROBABILITY_DISPATCH_
+
+// Standard headers
+#include <cstdlib>
+#include <cstring>
+#include <cstdint>
+
+// Internal headers
+#include "probability/probability.hpp"
+
+#if (defined(__GNUC__) || defined(__clang__)) \
+    && (defined(__x86_64__) || defined(__i386__))
+#define PROBABILITY_X86_DISPATCH
+#include <cpuid.h>
+#endif
+
+namespace probability {
+
+/*----------------------------------------------------------------------------*/
+/*                              INSTRUCTION SETS                              */
+/*----------------------------------------------------------------------------*/
+
+/**
+ * Instruction sets with versions of the bulk kernels, from the narrowest
+ * to the widest: each one requires all features of the previous ones.
+ */
+enum class InstructionSet {
+  generic = 0,  // Compiler flags only (SSE2 on x86-64)
+  avx2 = 1,     // AVX2, FMA and F16C (x86-64-v3)
+  avx512 = 2,   // AVX-512F
+};
+
+/*----------------------------------------------------------------------------*/
+
+constexpr const char* to_string(InstructionSet set) noexcept {
+  switch (set) {
+    case InstructionSet::avx2: return "avx2";
+    case InstructionSet::avx512: return "avx512";
+    default: return "generic";
+  }
+}
+
+/*----------------------------------------------------------------------------*/
+
+namespace detail {
+
+/**
+ * Converts the name of an instruction set (as given by to_string) into
+ * the instruction set, returning false if there is none with this name.
+ */
+inline bool parse_instruction_set(const char* name,
+                                  InstructionSet* set) noexcept {
+  for (auto candidate : { InstructionSet::generic,
+                          InstructionSet::avx2,
+                          InstructionSet::avx512 }) {
+    if (std::strcmp(name, to_string(candidate)) == 0) {
+      *set = candidate;
+      return true;
+    }
+  }
+  return false;
+}
+
+/*----------------------------------------------------------------------------*/
+
+/**
+ * Widest instruction set supported by the running CPU and enabled by the
+ * operating system (which must save the AVX and AVX-512 registers in
+ * context switches), detected with cpuid and xgetbv.
+ */
+inline InstructionSet detect_instruction_set() noexcept {
+#ifdef PROBABILITY_X86_DISPATCH
+  unsigned eax = 0, ebx = 0, ecx = 0, edx = 0;
+
+  if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx))
+    return InstructionSet::generic;
+
+  bool osxsave = ecx & bit_OSXSAVE;
+  bool avx = ecx & bit_AVX, fma = ecx & bit_FMA, f16c = ecx & bit_F16C;
+  if (!osxsave || !avx) return InstructionSet::generic;
+
+  unsigned xcr0_low = 0, xcr0_high = 0;
+  __asm__("xgetbv" : "=a"(xcr0_low), "=d"(xcr0_high) : "c"(0));
+  bool avx_state = (xcr0_low & 0x06) == 0x06;      // SSE and AVX registers
+  bool avx512_state = (xcr0_low & 0xE0) == 0xE0;   // Masks and ZMM registers
+  if (!avx_state) return InstructionSet::generic;
+
+  if (!__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx))
+    return InstructionSet::generic;
+
+  bool avx2 = ebx & bit_AVX2, avx512f = ebx & bit_AVX512F;
+  if (!avx2 || !fma || !f16c) return InstructionSet::generic;
+  if (!avx512f || !avx512_state) return InstructionSet::avx2;
+  return InstructionSet::avx512;
+#else
+  return InstructionSet::generic;
+#endif
+}
+
+/*----------------------------------------------------------------------------*/
+
+/**
+ * Instruction set used by the bulk kernels: the one requested by name, if
+ * any, limited to the supported one (so that overrides can only narrow
+ * the instruction set). Unknown names are ignored.
+ */
+inline InstructionSet select_instruction_set(InstructionSet supported,
+                                             const char* name) noexcept {
+  InstructionSet requested;
+  if (name == nullptr || !parse_instruction_set(name, &requested))
+    return supported;
+  return requested < supported ? requested : supported;
+}
+
+}  // namespace detail
+
+/*----------------------------------------------------------------------------*/
+
+/**
+ * Widest instruction set supported by the running CPU (detected once).
+ */
+inline InstructionSet supported_instruction_set() noexcept {
+  static const auto set = detail::detect_instruction_set();
+  return set;
+}
+
+/*----------------------------------------------------------------------------*/
+
+/**
+ * Instruction set used by the bulk kernels (selected once): the supported
+ * one, unless narrowed by the environment variable PROBABILITY_ISA (with
+ * values generic, avx2 or avx512), to test each version of the kernels.
+ */
+inline InstructionSet instruction_set() noexcept {
+  static const auto set = detail::select_instruction_set(
+      supported_instruction_set(), std::getenv("PROBABILITY_ISA"));
+  return set;
+}
+
+/*----------------------------------------------------------------------------*/
+/*                              KERNEL SELECTION                              */
+/*----------------------------------------------------------------------------*/
+
+namespace detail {
+
+/**
+ * Chooses, among the versions of a kernel, the one for an instruction
+ * set. Kernels of types without IEEE 754 traits are not vectorized, and
+ * have a single version.
+ */
+template<typename T, typename Kernel>
+Kernel select_kernel(InstructionSet set,
+                     Kernel fallback,
+                     [[maybe_unused]] Kernel avx2,
+                     [[maybe_unused]] Kernel avx512) noexcept {
+  if constexpr (has_ieee754_traits_v<T>) {
+    switch (set) {
+      case InstructionSet::avx512: return avx512;
+      case InstructionSet::avx2: return avx2;
+      default: return fallback;
+    }
+  }
+  return fallback;
+}
+
+}  // namespace detail
+
+/*----------------------------------------------------------------------------*/
+
+}  // namespace probability
+
+#undef PROBABILITY_X86_DISPATCH
+
+#endif  // PROBABILITY_DISPATCH_
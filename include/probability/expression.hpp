@@ -0,0 +1,397 @@
+/******************************************************************************/
+/*  Probability - A fast implementation of probabilities using logarithms     */
+/*  Copyright (C) 2016 Renato Cordeiro Ferreira                               */
+/*                                                                            */
+/*  This program is free software: you can redistribute it and/or modify      */
+/*  it under the terms of the GNU General Public License as published by      */
+/*  the Free Software Foundation, either version 3 of the License, or         */
+/*  (at your option) any later version.                                       */
+/*                                                                            */
+/*  This program is distributed in the hope that it will be useful,           */
+/*  but WITHOUT ANY WARRANTY; without even the implied warranty of            */
+/*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             */
+/*  GNU General Public License for more details.                              */
+/*                                                                            */
+/*  You should have received a copy of the GNU General Public License         */
+/*  along with this program.  If not, see <www.gnu.org/licenses>.             */
+/******************************************************************************/
+
+#ifndef PROBABILITY_EXPRESSION_
+#define PROBABILITY_EXPRESSION_
+
+// Standard headers
+#include <array>
+#include <cmath>
+#include <limits>
+#include <cstddef>
+#include <type_traits>
+
+// Internal headers
+#include "probability/numeric.hpp"
+#include "probability/probability.hpp"
+
+namespace probability {
+
+/*----------------------------------------------------------------------------*/
+/*                            FORWARD DECLARATIONS                            */
+/*----------------------------------------------------------------------------*/
+
+template<typename T, std::size_t ulp, typename C, typename M>
+class LogProduct;
+
+template<typename T, std::size_t ulp, typename C, typename M, std::size_t N>
+class LogSum;
+
+/*----------------------------------------------------------------------------*/
+/*                                LOG PRODUCT                                 */
+/*----------------------------------------------------------------------------*/
+
+/**
+ * @class LogProduct
+ * @tparam T Value type, used for internal store
+ * @tparam ulp Units in the last place, defining the accuracy
+ * @tparam C Checker type, used to inject methods that verify consistency
+ * @tparam M Math type, used to implement logarithms, exponentials and sums
+ * @brief Unevaluated product of LogFloatingPoint, kept as the sum of the
+ *        logarithms of its factors
+ *
+ * Its range is checked only when it is converted to a LogFloatingPoint.
+ */
+template<typename T, std::size_t ulp, typename C, typename M>
+class LogProduct {
+ public:
+  // Aliases
+  using value_type = LogFloatingPoint<T, ulp, C, M>;
+
+  // Constructors
+  explicit LogProduct(T log_value) noexcept : value(log_value) {
+  }
+
+  // Operator overloads
+  operator value_type() const {
+    return value_type::from_log(value);
+  }
+
+  // Concrete methods
+  T data() const noexcept {
+    return value;
+  }
+
+ private:
+  // Instance variables
+  T value;
+};
+
+/*----------------------------------------------------------------------------*/
+/*                                  LOG SUM                                   */
+/*----------------------------------------------------------------------------*/
+
+/**
+ * @class LogSum
+ * @tparam T Value type, used for internal store
+ * @tparam ulp Units in the last place, defining the accuracy
+ * @tparam C Checker type, used to inject methods that verify consistency
+ * @tparam M Math type, used to implement logarithms, exponentials and sums
+ * @tparam N Number of terms
+ * @brief Unevaluated sum of N terms (each one a product, kept as the sum of
+ *        the logarithms of its factors)
+ *
+ * It is evaluated, when converted to a LogFloatingPoint, with a single
+ * range check. With StandardMath, the terms are summed with a single
+ * max-shifted log-sum-exp (i.e., N exponentials and one logarithm, instead
+ * of N - 1 calls to M::add). With MaxMath, it is the maximum of the terms.
+ * Other math types are approximations defined by their M::add, so the
+ * terms are folded with it, giving the same result as the eager sum.
+ */
+template<typename T, std::size_t ulp, typename C, typename M, std::size_t N>
+class LogSum {
+ public:
+  // Aliases
+  using value_type = LogFloatingPoint<T, ulp, C, M>;
+  using terms_type = std::array<T, N>;
+
+  // Constructors
+  explicit LogSum(const terms_type& log_terms) noexcept : terms(log_terms) {
+  }
+
+  // Operator overloads
+  operator value_type() const {
+    return value_type::from_log(data());
+  }
+
+  // Concrete methods
+  T data() const noexcept {
+    if constexpr (std::is_same_v<M, StandardMath<T>> || is_max_math_v<M>) {
+      T max = terms[0];
+      for (std::size_t i = 1; i < N; i++)
+        max = terms[i] > max ? terms[i] : max;
+
+      if constexpr (is_max_math_v<M>) {
+        return max;
+      } else {
+        if (max == -infinity || max == infinity) return max;
+
+        T sum = 0;
+        for (std::size_t i = 0; i < N; i++) sum += std::exp(terms[i] - max);
+        return max + std::log(sum);
+      }
+    } else {
+      T sum = terms[0];
+      for (std::size_t i = 1; i < N; i++) sum = M::add(sum, terms[i]);
+      return sum;
+    }
+  }
+
+  const terms_type& log_terms() const noexcept {
+    return terms;
+  }
+
+  LogSum scaled(T log_factor) const noexcept {
+    terms_type result = terms;
+    for (auto& term : result) term += log_factor;
+    return LogSum(result);
+  }
+
+ private:
+  // Static variables
+  static constexpr auto infinity = std::numeric_limits<T>::infinity();
+
+  // Instance variables
+  terms_type terms;
+};
+
+/*----------------------------------------------------------------------------*/
+/*                                  HELPERS                                   */
+/*----------------------------------------------------------------------------*/
+
+/**
+ * Starts a lazy expression from a LogFloatingPoint: products and sums
+ * involving it are only evaluated when converted to a LogFloatingPoint.
+ */
+template<typename T, std::size_t ulp, typename C, typename M>
+inline LogProduct<T, ulp, C, M>
+lazy(const LogFloatingPoint<T, ulp, C, M>& value) noexcept {
+  return LogProduct<T, ulp, C, M>(value.data());
+}
+
+/*----------------------------------------------------------------------------*/
+
+/**
+ * Evaluates a lazy expression (or returns a LogFloatingPoint as is).
+ */
+template<typename Expression>
+inline typename Expression::value_type evaluate(const Expression& expression) {
+  return expression;
+}
+
+/*----------------------------------------------------------------------------*/
+
+namespace detail {
+
+template<typename T, std::size_t N, std::size_t K>
+std::array<T, N + K> concatenate(const std::array<T, N>& lhs,
+                                 const std::array<T, K>& rhs) noexcept {
+  std::array<T, N + K> result {};
+  for (std::size_t i = 0; i < N; i++) result[i] = lhs[i];
+  for (std::size_t i = 0; i < K; i++) result[N + i] = rhs[i];
+  return result;
+}
+
+}  // namespace detail
+
+/*----------------------------------------------------------------------------*/
+/*                                 OPERATOR*                                  */
+/*----------------------------------------------------------------------------*/
+
+template<typename T, std::size_t ulp, typename C, typename M>
+inline LogProduct<T, ulp, C, M>
+operator*(const LogProduct<T, ulp, C, M>& lhs,
+          const LogProduct<T, ulp, C, M>& rhs) noexcept {
+  return LogProduct<T, ulp, C, M>(lhs.data() + rhs.data());
+}
+
+template<typename T, std::size_t ulp, typename C, typename M>
+inline LogProduct<T, ulp, C, M>
+operator*(const LogProduct<T, ulp, C, M>& lhs,
+          const LogFloatingPoint<T, ulp, C, M>& rhs) noexcept {
+  return LogProduct<T, ulp, C, M>(lhs.data() + rhs.data());
+}
+
+template<typename T, std::size_t ulp, typename C, typename M>
+inline LogProduct<T, ulp, C, M>
+operator*(const LogFloatingPoint<T, ulp, C, M>& lhs,
+          const LogProduct<T, ulp, C, M>& rhs) noexcept {
+  return LogProduct<T, ulp, C, M>(lhs.data() + rhs.data());
+}
+
+/*----------------------------------------------------------------------------*/
+
+template<typename T, std::size_t ulp, typename C, typename M, std::size_t N>
+inline LogSum<T, ulp, C, M, N>
+operator*(const LogSum<T, ulp, C, M, N>& lhs,
+          const LogProduct<T, ulp, C, M>& rhs) noexcept {
+  return lhs.scaled(rhs.data());
+}
+
+template<typename T, std::size_t ulp, typename C, typename M, std::size_t N>
+inline LogSum<T, ulp, C, M, N>
+operator*(const LogProduct<T, ulp, C, M>& lhs,
+          const LogSum<T, ulp, C, M, N>& rhs) noexcept {
+  return rhs.scaled(lhs.data());
+}
+
+template<typename T, std::size_t ulp, typename C, typename M, std::size_t N>
+inline LogSum<T, ulp, C, M, N>
+operator*(const LogSum<T, ulp, C, M, N>& lhs,
+          const LogFloatingPoint<T, ulp, C, M>& rhs) noexcept {
+  return lhs.scaled(rhs.data());
+}
+
+template<typename T, std::size_t ulp, typename C, typename M, std::size_t N>
+inline LogSum<T, ulp, C, M, N>
+operator*(const LogFloatingPoint<T, ulp, C, M>& lhs,
+          const LogSum<T, ulp, C, M, N>& rhs) noexcept {
+  return rhs.scaled(lhs.data());
+}
+
+template<typename T, std::size_t ulp, typename C, typename M,
+         std::size_t N, std::size_t K>
+inline LogSum<T, ulp, C, M, N>
+operator*(const LogSum<T, ulp, C, M, N>& lhs,
+          const LogSum<T, ulp, C, M, K>& rhs) noexcept {
+  return lhs.scaled(rhs.data());  // Evaluates rhs (without checking it)
+}
+
+/*----------------------------------------------------------------------------*/
+/*                                 OPERATOR/                                  */
+/*----------------------------------------------------------------------------*/
+
+template<typename T, std::size_t ulp, typename C, typename M>
+inline LogProduct<T, ulp, C, M>
+operator/(const LogProduct<T, ulp, C, M>& lhs,
+          const LogProduct<T, ulp, C, M>& rhs) noexcept {
+  return LogProduct<T, ulp, C, M>(lhs.data() - rhs.data());
+}
+
+template<typename T, std::size_t ulp, typename C, typename M>
+inline LogProduct<T, ulp, C, M>
+operator/(const LogProduct<T, ulp, C, M>& lhs,
+          const LogFloatingPoint<T, ulp, C, M>& rhs) noexcept {
+  return LogProduct<T, ulp, C, M>(lhs.data() - rhs.data());
+}
+
+template<typename T, std::size_t ulp, typename C, typename M, std::size_t N>
+inline LogSum<T, ulp, C, M, N>
+operator/(const LogSum<T, ulp, C, M, N>& lhs,
+          const LogProduct<T, ulp, C, M>& rhs) noexcept {
+  return lhs.scaled(-rhs.data());
+}
+
+template<typename T, std::size_t ulp, typename C, typename M, std::size_t N>
+inline LogSum<T, ulp, C, M, N>
+operator/(const LogSum<T, ulp, C, M, N>& lhs,
+          const LogFloatingPoint<T, ulp, C, M>& rhs) noexcept {
+  return lhs.scaled(-rhs.data());
+}
+
+/*----------------------------------------------------------------------------*/
+/*                                 OPERATOR+                                  */
+/*----------------------------------------------------------------------------*/
+
+template<typename T, std::size_t ulp, typename C, typename M>
+inline LogSum<T, ulp, C, M, 2>
+operator+(const LogProduct<T, ulp, C, M>& lhs,
+          const LogProduct<T, ulp, C, M>& rhs) noexcept {
+  return LogSum<T, ulp, C, M, 2>({ lhs.data(), rhs.data() });
+}
+
+template<typename T, std::size_t ulp, typename C, typename M>
+inline LogSum<T, ulp, C, M, 2>
+operator+(const LogProduct<T, ulp, C, M>& lhs,
+          const LogFloatingPoint<T, ulp, C, M>& rhs) noexcept {
+  return LogSum<T, ulp, C, M, 2>({ lhs.data(), rhs.data() });
+}
+
+template<typename T, std::size_t ulp, typename C, typename M>
+inline LogSum<T, ulp, C, M, 2>
+operator+(const LogFloatingPoint<T, ulp, C, M>& lhs,
+          const LogProduct<T, ulp, C, M>& rhs) noexcept {
+  return LogSum<T, ulp, C, M, 2>({ lhs.data(), rhs.data() });
+}
+
+/*----------------------------------------------------------------------------*/
+
+template<typename T, std::size_t ulp, typename C, typename M, std::size_t N>
+inline LogSum<T, ulp, C, M, N + 1>
+operator+(const LogSum<T, ulp, C, M, N>& lhs,
+          const LogProduct<T, ulp, C, M>& rhs) noexcept {
+  return LogSum<T, ulp, C, M, N + 1>(detail::concatenate(
+      lhs.log_terms(), std::array<T, 1> { rhs.data() }));
+}
+
+template<typename T, std::size_t ulp, typename C, typename M, std::size_t N>
+inline LogSum<T, ulp, C, M, N + 1>
+operator+(const LogProduct<T, ulp, C, M>& lhs,
+          const LogSum<T, ulp, C, M, N>& rhs) noexcept {
+  return rhs + lhs;
+}
+
+template<typename T, std::size_t ulp, typename C, typename M, std::size_t N>
+inline LogSum<T, ulp, C, M, N + 1>
+operator+(const LogSum<T, ulp, C, M, N>& lhs,
+          const LogFloatingPoint<T, ulp, C, M>& rhs) noexcept {
+  return lhs + lazy(rhs);
+}
+
+template<typename T, std::size_t ulp, typename C, typename M, std::size_t N>
+inline LogSum<T, ulp, C, M, N + 1>
+operator+(const LogFloatingPoint<T, ulp, C, M>& lhs,
+          const LogSum<T, ulp, C, M, N>& rhs) noexcept {
+  return rhs + lazy(lhs);
+}
+
+template<typename T, std::size_t ulp, typename C, typename M,
+         std::size_t N, std::size_t K>
+inline LogSum<T, ulp, C, M, N + K>
+operator+(const LogSum<T, ulp, C, M, N>& lhs,
+          const LogSum<T, ulp, C, M, K>& rhs) noexcept {
+  return LogSum<T, ulp, C, M, N + K>(
+      detail::concatenate(lhs.log_terms(), rhs.log_terms()));
+}
+
+/*----------------------------------------------------------------------------*/
+/*                                 OPERATOR+=                                 */
+/*----------------------------------------------------------------------------*/
+
+/**
+ * Accumulates a lazy product (e.g., acc += lazy(a) * b) as a fused
+ * multiply-add, with a single range check.
+ */
+template<typename T, std::size_t ulp, typename C, typename M>
+inline LogFloatingPoint<T, ulp, C, M>&
+operator+=(LogFloatingPoint<T, ulp, C, M>& lhs,
+           const LogProduct<T, ulp, C, M>& rhs) noexcept {
+  lhs.data() = M::add(lhs.data(), rhs.data());
+  C::check_range(lhs.data());
+  return lhs;
+}
+
+/*----------------------------------------------------------------------------*/
+
+/**
+ * Accumulates a lazy sum, with a single log-sum-exp over its terms and
+ * the accumulator.
+ */
+template<typename T, std::size_t ulp, typename C, typename M, std::size_t N>
+inline LogFloatingPoint<T, ulp, C, M>&
+operator+=(LogFloatingPoint<T, ulp, C, M>& lhs,
+           const LogSum<T, ulp, C, M, N>& rhs) {
+  lhs = rhs + lhs;
+  return lhs;
+}
+
+/*----------------------------------------------------------------------------*/
+
+}  // namespace probability
+
+#endif  // PROBABILITY_EXPRESSION_
@@ -0,0 +1,574 @@
+/******************************************************************************/
+/*  Probability - A fast implementation of probabilities using logarithms     */
+/*  Copyright (C) 2016 Renato Cordeiro Ferreira                               */
+/*                                                                            */
+/*  This program is free software: you can redistribute it and/or modify      */
+/*  it under the terms of the GNU General Public License as published by      */
+/*  the Free Software Foundation, either version 3 of the License, or         */
+/*  (at your option) any later version.                                       */
+/*                                                                            */
+/*  This program is distributed in the hope that it will be useful,           */
+/*  but WITHOUT ANY WARRANTY; without even the implied warranty of            */
+/*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             */
+/*  GNU General Public License for more details.                              */
+/*                                                                            */
+/*  You should have received a copy of the GNU General Public License         */
+/*  along with this program.  If not, see <www.gnu.org/licenses>.             */
+/******************************************************************************/
+
+#ifndef PROBABILITY_FIXED_
+#define PROBABILITY_FIXED_
+
+// Standard headers
+#include <array>
+#include <cmath>
+#include <limits>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+// Internal headers
+#include "probability/probability.hpp"
+
+namespace probability {
+
+/*----------------------------------------------------------------------------*/
+/*                            FORWARD DECLARATIONS                            */
+/*----------------------------------------------------------------------------*/
+
+template<typename Int, std::size_t FracBits>
+class LogFixedPoint;
+
+/*----------------------------------------------------------------------------*/
+/*                                  HELPERS                                   */
+/*----------------------------------------------------------------------------*/
+
+template<typename>
+struct is_log_fixed_point : std::false_type {};
+
+template<typename Int, std::size_t FracBits>
+struct is_log_fixed_point<LogFixedPoint<Int, FracBits>> : std::true_type {};
+
+template<typename T>
+constexpr bool is_log_fixed_point_v = is_log_fixed_point<T>::value;
+
+/*----------------------------------------------------------------------------*/
+
+namespace detail {
+
+/**
+ * Table of round(2^FracBits * log1p(exp(-d))), with 2^resolution_bits
+ * entries per unit of d (interpolated linearly, if FracBits is bigger),
+ * up to the cutoff (FracBits + 1) * ln(2), where the correction rounds to
+ * zero. The last two entries are zero, so that indices are clamped to
+ * them instead of compared with the cutoff.
+ */
+template<typename Int, std::size_t FracBits>
+struct fixed_log1p_exp_table {
+  // Static variables
+  static constexpr std::size_t resolution_bits = FracBits < 8 ? FracBits : 8;
+  static constexpr std::size_t shift = FracBits - resolution_bits;
+  static constexpr std::size_t size
+    = static_cast<std::size_t>((FracBits + 1) * 0.6931471805599453
+                               * pow2<double>(resolution_bits)) + 2;
+
+  // Aliases
+  using wide_type
+    = std::conditional_t<(sizeof(Int) < 4), std::int32_t, std::int64_t>;
+  using entries_type = std::array<wide_type, size>;
+
+  // Static methods
+  static constexpr entries_type make_entries() {
+    entries_type entries {};
+
+    long double scale = pow2<long double>(FracBits);
+    long double step = 1.0L / pow2<long double>(resolution_bits);
+    for (std::size_t i = 0; i + 2 < size; i++) {
+      long double y = constexpr_exp(-step * static_cast<long double>(i));
+      entries[i] = static_cast<wide_type>(scale * constexpr_log1p(y) + 0.5L);
+    }
+
+    return entries;
+  }
+
+  static constexpr entries_type entries = make_entries();
+};
+
+}  // namespace detail
+
+/*----------------------------------------------------------------------------*/
+/*                              LOG FIXED POINT                               */
+/*----------------------------------------------------------------------------*/
+
+/**
+ * @class LogFixedPoint
+ * @tparam Int Signed integer type of at most 32 bits, used for internal store
+ * @tparam FracBits Number of fractional bits of the logarithm
+ * @brief Logarithms in fixed point, for deterministic (bit-reproducible)
+ *        and integer SIMD-friendly calculations
+ *
+ * The logarithm is stored as round(log(v) * 2^FracBits), and the lowest
+ * integer represents zero (-infinity). Products and divisions are integer
+ * sums and subtractions, saturated at the limits of Int (so underflows
+ * become zero); sums are the maximum plus a correction from a table of
+ * integers, generated at compile time. All of them give the same results
+ * in every compiler and instruction set. Subtractions are calculated in
+ * floating point, and are only as reproducible as the standard library.
+ */
+template<typename Int, std::size_t FracBits>
+class LogFixedPoint {
+ public:
+  // Aliases
+  using value_type = Int;
+
+  // Static variables
+  static constexpr std::size_t fraction_bits = FracBits;
+
+  // Constructors
+  constexpr LogFixedPoint() = default;
+
+  constexpr LogFixedPoint(double v)
+      : value(to_fixed(StandardMath<double>::log(v))) {
+    assert(v >= 0.0);
+  }
+
+  template<typename Value,
+    typename std::enable_if_t<
+      std::is_arithmetic_v<Value> && !std::is_same_v<Value, double>,
+    void>* = nullptr>
+  constexpr LogFixedPoint(const Value& v)
+      : LogFixedPoint(static_cast<double>(v)) {
+  }
+
+  template<typename T, std::size_t ulp, typename C, typename M>
+  constexpr explicit LogFixedPoint(const LogFloatingPoint<T, ulp, C, M>& v)
+      : value(to_fixed(static_cast<double>(v.data()))) {
+  }
+
+  // Static methods
+  static constexpr LogFixedPoint from_log(double log_value) {
+    return from_raw(to_fixed(log_value));
+  }
+
+  static constexpr LogFixedPoint from_raw(value_type raw) noexcept {
+    LogFixedPoint result;
+    result.value = raw;
+    return result;
+  }
+
+  // Operator overloads
+  constexpr explicit operator double() const {
+    return StandardMath<double>::exp(to_log());
+  }
+
+  constexpr LogFixedPoint& operator+=(const LogFixedPoint& rhs) noexcept {
+    value = add(value, rhs.value);
+    return *this;
+  }
+
+  constexpr LogFixedPoint& operator-=(const LogFixedPoint& rhs) {
+    assert(value >= rhs.value);
+    if (rhs.value != zero) {
+      double lhs_log = to_log(), rhs_log = rhs.to_log();
+      value = to_fixed(lhs_log + std::log1p(-std::exp(rhs_log - lhs_log)));
+    }
+    return *this;
+  }
+
+  constexpr LogFixedPoint& operator*=(const LogFixedPoint& rhs) noexcept {
+    // Bitwise or (without short-circuit) keeps loops of products vectorizable
+    value = ((value == zero) | (rhs.value == zero))
+          ? zero : saturate(wide_type(value) + wide_type(rhs.value));
+    return *this;
+  }
+
+  constexpr LogFixedPoint& operator/=(const LogFixedPoint& rhs) noexcept {
+    assert(rhs.value != zero);
+    value = value == zero
+          ? zero : saturate(wide_type(value) - wide_type(rhs.value));
+    return *this;
+  }
+
+  // Concrete methods
+  constexpr value_type& data() noexcept {
+    return value;
+  }
+
+  constexpr const value_type& data() const noexcept {
+    return value;
+  }
+
+  constexpr double to_log() const noexcept {
+    return value == zero ? -std::numeric_limits<double>::infinity()
+                         : static_cast<double>(value) / scale;
+  }
+
+ private:
+  // Validation
+  static_assert(std::is_integral_v<value_type>
+                && std::is_signed_v<value_type>,
+      "LogFixedPoint must be stored in a signed integer type");
+
+  static_assert(sizeof(value_type) <= 4,
+      "LogFixedPoint must be stored in at most 32 bits, so that sums and "
+      "products do not overflow its wider intermediate type");
+
+  static_assert(FracBits + 2 < std::numeric_limits<value_type>::digits,
+      "LogFixedPoint must have at least one integer bit");
+
+  // Aliases
+  using table = detail::fixed_log1p_exp_table<value_type, FracBits>;
+  using wide_type = typename table::wide_type;
+
+  // Static variables
+  static constexpr value_type zero = std::numeric_limits<value_type>::min();
+  static constexpr value_type highest
+    = std::numeric_limits<value_type>::max();
+  static constexpr double scale = detail::pow2<double>(FracBits);
+
+  // Instance variables
+  value_type value = zero;
+
+  // Static methods
+  static constexpr value_type saturate(wide_type v) noexcept {
+    v = v > zero ? v : zero;
+    v = v < highest ? v : highest;
+    return static_cast<value_type>(v);
+  }
+
+  static constexpr value_type to_fixed(double log_value) {
+    assert(log_value == log_value);
+    double scaled = log_value * scale;
+    if (scaled <= zero) return zero;
+    if (scaled >= highest) return highest;
+    return static_cast<value_type>(scaled < 0 ? scaled - 0.5 : scaled + 0.5);
+  }
+
+  static constexpr value_type add(value_type lhs, value_type rhs) noexcept {
+    wide_type max = lhs > rhs ? lhs : rhs;
+    wide_type min = lhs > rhs ? rhs : lhs;
+    // Adding zero (the lowest value) returns the other operand unchanged
+    wide_type difference = min == zero ? wide_type(0) : max - min;
+
+    wide_type last = static_cast<wide_type>(table::size - 2);
+    wide_type index = difference >> table::shift;
+    index = index < last ? index : last;
+    wide_type fraction = difference - (index << table::shift);
+
+    wide_type lo = table::entries[index], hi = table::entries[index + 1];
+    wide_type correction = lo - (((lo - hi) * fraction) >> table::shift);
+
+    return min == zero ? static_cast<value_type>(max)
+                       : saturate(max + correction);
+  }
+};
+
+/*----------------------------------------------------------------------------*/
+/*                                 OPERATOR+                                  */
+/*----------------------------------------------------------------------------*/
+
+template<typename Int, std::size_t FracBits>
+constexpr LogFixedPoint<Int, FracBits> operator+(
+    LogFixedPoint<Int, FracBits> lhs, const LogFixedPoint<Int, FracBits>& rhs) {
+  return lhs += rhs;
+}
+
+/*----------------------------------------------------------------------------*/
+
+template<typename Int, std::size_t FracBits, typename Value,
+  typename std::enable_if_t<std::is_arithmetic_v<Value>, void>* = nullptr>
+constexpr LogFixedPoint<Int, FracBits> operator+(
+    LogFixedPoint<Int, FracBits> lhs, const Value& rhs) {
+  return lhs += LogFixedPoint<Int, FracBits>(rhs);
+}
+
+/*----------------------------------------------------------------------------*/
+
+template<typename Int, std::size_t FracBits, typename Value,
+  typename std::enable_if_t<std::is_arithmetic_v<Value>, void>* = nullptr>
+constexpr LogFixedPoint<Int, FracBits> operator+(
+    const Value& lhs, const LogFixedPoint<Int, FracBits>& rhs) {
+  return LogFixedPoint<Int, FracBits>(lhs) += rhs;
+}
+
+/*----------------------------------------------------------------------------*/
+/*                                 OPERATOR-                                  */
+/*----------------------------------------------------------------------------*/
+
+template<typename Int, std::size_t FracBits>
+constexpr LogFixedPoint<Int, FracBits> operator-(
+    LogFixedPoint<Int, FracBits> lhs, const LogFixedPoint<Int, FracBits>& rhs) {
+  return lhs -= rhs;
+}
+
+/*----------------------------------------------------------------------------*/
+
+template<typename Int, std::size_t FracBits, typename Value,
+  typename std::enable_if_t<std::is_arithmetic_v<Value>, void>* = nullptr>
+constexpr LogFixedPoint<Int, FracBits> operator-(
+    LogFixedPoint<Int, FracBits> lhs, const Value& rhs) {
+  return lhs -= LogFixedPoint<Int, FracBits>(rhs);
+}
+
+/*----------------------------------------------------------------------------*/
+
+template<typename Int, std::size_t FracBits, typename Value,
+  typename std::enable_if_t<std::is_arithmetic_v<Value>, void>* = nullptr>
+constexpr LogFixedPoint<Int, FracBits> operator-(
+    const Value& lhs, const LogFixedPoint<Int, FracBits>& rhs) {
+  return LogFixedPoint<Int, FracBits>(lhs) -= rhs;
+}
+
+/*----------------------------------------------------------------------------*/
+/*                                 OPERATOR*                                  */
+/*----------------------------------------------------------------------------*/
+
+template<typename Int, std::size_t FracBits>
+constexpr LogFixedPoint<Int, FracBits> operator*(
+    LogFixedPoint<Int, FracBits> lhs, const LogFixedPoint<Int, FracBits>& rhs) {
+  return lhs *= rhs;
+}
+
+/*----------------------------------------------------------------------------*/
+
+template<typename Int, std::size_t FracBits, typename Value,
+  typename std::enable_if_t<std::is_arithmetic_v<Value>, void>* = nullptr>
+constexpr LogFixedPoint<Int, FracBits> operator*(
+    LogFixedPoint<Int, FracBits> lhs, const Value& rhs) {
+  return lhs *= LogFixedPoint<Int, FracBits>(rhs);
+}
+
+/*----------------------------------------------------------------------------*/
+
+template<typename Int, std::size_t FracBits, typename Value,
+  typename std::enable_if_t<std::is_arithmetic_v<Value>, void>* = nullptr>
+constexpr LogFixedPoint<Int, FracBits> operator*(
+    const Value& lhs, const LogFixedPoint<Int, FracBits>& rhs) {
+  return LogFixedPoint<Int, FracBits>(lhs) *= rhs;
+}
+
+/*----------------------------------------------------------------------------*/
+/*                                 OPERATOR/                                  */
+/*----------------------------------------------------------------------------*/
+
+template<typename Int, std::size_t FracBits>
+constexpr LogFixedPoint<Int, FracBits> operator/(
+    LogFixedPoint<Int, FracBits> lhs, const LogFixedPoint<Int, FracBits>& rhs) {
+  return lhs /= rhs;
+}
+
+/*----------------------------------------------------------------------------*/
+
+template<typename Int, std::size_t FracBits, typename Value,
+  typename std::enable_if_t<std::is_arithmetic_v<Value>, void>* = nullptr>
+constexpr LogFixedPoint<Int, FracBits> operator/(
+    LogFixedPoint<Int, FracBits> lhs, const Value& rhs) {
+  return lhs /= LogFixedPoint<Int, FracBits>(rhs);
+}
+
+/*----------------------------------------------------------------------------*/
+
+template<typename Int, std::size_t FracBits, typename Value,
+  typename std::enable_if_t<std::is_arithmetic_v<Value>, void>* = nullptr>
+constexpr LogFixedPoint<Int, FracBits> operator/(
+    const Value& lhs, const LogFixedPoint<Int, FracBits>& rhs) {
+  return LogFixedPoint<Int, FracBits>(lhs) /= rhs;
+}
+
+/*----------------------------------------------------------------------------*/
+/*                                 OPERATOR==                                 */
+/*----------------------------------------------------------------------------*/
+
+template<typename Int, std::size_t FracBits>
+constexpr bool operator==(const LogFixedPoint<Int, FracBits>& lhs,
+                          const LogFixedPoint<Int, FracBits>& rhs) noexcept {
+  return lhs.data() == rhs.data();
+}
+
+/*----------------------------------------------------------------------------*/
+
+template<typename Int, std::size_t FracBits, typename Value,
+  typename std::enable_if_t<std::is_arithmetic_v<Value>, void>* = nullptr>
+constexpr bool operator==(const LogFixedPoint<Int, FracBits>& lhs,
+                          const Value& rhs) {
+  return lhs == LogFixedPoint<Int, FracBits>(rhs);
+}
+
+/*----------------------------------------------------------------------------*/
+
+template<typename Int, std::size_t FracBits, typename Value,
+  typename std::enable_if_t<std::is_arithmetic_v<Value>, void>* = nullptr>
+constexpr bool operator==(const Value& lhs,
+                          const LogFixedPoint<Int, FracBits>& rhs) {
+  return LogFixedPoint<Int, FracBits>(lhs) == rhs;
+}
+
+/*----------------------------------------------------------------------------*/
+/*                                 OPERATOR!=                                 */
+/*----------------------------------------------------------------------------*/
+
+template<typename Int, std::size_t FracBits>
+constexpr bool operator!=(const LogFixedPoint<Int, FracBits>& lhs,
+                          const LogFixedPoint<Int, FracBits>& rhs) noexcept {
+  return lhs.data() != rhs.data();
+}
+
+/*----------------------------------------------------------------------------*/
+
+template<typename Int, std::size_t FracBits, typename Value,
+  typename std::enable_if_t<std::is_arithmetic_v<Value>, void>* = nullptr>
+constexpr bool operator!=(const LogFixedPoint<Int, FracBits>& lhs,
+                          const Value& rhs) {
+  return lhs != LogFixedPoint<Int, FracBits>(rhs);
+}
+
+/*----------------------------------------------------------------------------*/
+
+template<typename Int, std::size_t FracBits, typename Value,
+  typename std::enable_if_t<std::is_arithmetic_v<Value>, void>* = nullptr>
+constexpr bool operator!=(const Value& lhs,
+                          const LogFixedPoint<Int, FracBits>& rhs) {
+  return LogFixedPoint<Int, FracBits>(lhs) != rhs;
+}
+
+/*----------------------------------------------------------------------------*/
+/*                                 OPERATOR<                                  */
+/*----------------------------------------------------------------------------*/
+
+template<typename Int, std::size_t FracBits>
+constexpr bool operator<(const LogFixedPoint<Int, FracBits>& lhs,
+                          const LogFixedPoint<Int, FracBits>& rhs) noexcept {
+  return lhs.data() < rhs.data();
+}
+
+/*----------------------------------------------------------------------------*/
+
+template<typename Int, std::size_t FracBits, typename Value,
+  typename std::enable_if_t<std::is_arithmetic_v<Value>, void>* = nullptr>
+constexpr bool operator<(const LogFixedPoint<Int, FracBits>& lhs,
+                          const Value& rhs) {
+  return lhs < LogFixedPoint<Int, FracBits>(rhs);
+}
+
+/*----------------------------------------------------------------------------*/
+
+template<typename Int, std::size_t FracBits, typename Value,
+  typename std::enable_if_t<std::is_arithmetic_v<Value>, void>* = nullptr>
+constexpr bool operator<(const Value& lhs,
+                          const LogFixedPoint<Int, FracBits>& rhs) {
+  return LogFixedPoint<Int, FracBits>(lhs) < rhs;
+}
+
+/*----------------------------------------------------------------------------*/
+/*                                 OPERATOR<=                                 */
+/*----------------------------------------------------------------------------*/
+
+template<typename Int, std::size_t FracBits>
+constexpr bool operator<=(const LogFixedPoint<Int, FracBits>& lhs,
+                          const LogFixedPoint<Int, FracBits>& rhs) noexcept {
+  return lhs.data() <= rhs.data();
+}
+
+/*----------------------------------------------------------------------------*/
+
+template<typename Int, std::size_t FracBits, typename Value,
+  typename std::enable_if_t<std::is_arithmetic_v<Value>, void>* = nullptr>
+constexpr bool operator<=(const LogFixedPoint<Int, FracBits>& lhs,
+                          const Value& rhs) {
+  return lhs <= LogFixedPoint<Int, FracBits>(rhs);
+}
+
+/*----------------------------------------------------------------------------*/
+
+template<typename Int, std::size_t FracBits, typename Value,
+  typename std::enable_if_t<std::is_arithmetic_v<Value>, void>* = nullptr>
+constexpr bool operator<=(const Value& lhs,
+                          const LogFixedPoint<Int, FracBits>& rhs) {
+  return LogFixedPoint<Int, FracBits>(lhs) <= rhs;
+}
+
+/*----------------------------------------------------------------------------*/
+/*                                 OPERATOR>                                  */
+/*----------------------------------------------------------------------------*/
+
+template<typename Int, std::size_t FracBits>
+constexpr bool operator>(const LogFixedPoint<Int, FracBits>& lhs,
+                          const LogFixedPoint<Int, FracBits>& rhs) noexcept {
+  return lhs.data() > rhs.data();
+}
+
+/*----------------------------------------------------------------------------*/
+
+template<typename Int, std::size_t FracBits, typename Value,
+  typename std::enable_if_t<std::is_arithmetic_v<Value>, void>* = nullptr>
+constexpr bool operator>(const LogFixedPoint<Int, FracBits>& lhs,
+                          const Value& rhs) {
+  return lhs > LogFixedPoint<Int, FracBits>(rhs);
+}
+
+/*----------------------------------------------------------------------------*/
+
+template<typename Int, std::size_t FracBits, typename Value,
+  typename std::enable_if_t<std::is_arithmetic_v<Value>, void>* = nullptr>
+constexpr bool operator>(const Value& lhs,
+                          const LogFixedPoint<Int, FracBits>& rhs) {
+  return LogFixedPoint<Int, FracBits>(lhs) > rhs;
+}
+
+/*----------------------------------------------------------------------------*/
+/*                                 OPERATOR>=                                 */
+/*----------------------------------------------------------------------------*/
+
+template<typename Int, std::size_t FracBits>
+constexpr bool operator>=(const LogFixedPoint<Int, FracBits>& lhs,
+                          const LogFixedPoint<Int, FracBits>& rhs) noexcept {
+  return lhs.data() >= rhs.data();
+}
+
+/*----------------------------------------------------------------------------*/
+
+template<typename Int, std::size_t FracBits, typename Value,
+  typename std::enable_if_t<std::is_arithmetic_v<Value>, void>* = nullptr>
+constexpr bool operator>=(const LogFixedPoint<Int, FracBits>& lhs,
+                          const Value& rhs) {
+  return lhs >= LogFixedPoint<Int, FracBits>(rhs);
+}
+
+/*----------------------------------------------------------------------------*/
+
+template<typename Int, std::size_t FracBits, typename Value,
+  typename std::enable_if_t<std::is_arithmetic_v<Value>, void>* = nullptr>
+constexpr bool operator>=(const Value& lhs,
+                          const LogFixedPoint<Int, FracBits>& rhs) {
+  return LogFixedPoint<Int, FracBits>(lhs) >= rhs;
+}
+
+/*----------------------------------------------------------------------------*/
+/*                                  MAXIMUM                                   */
+/*----------------------------------------------------------------------------*/
+
+/**
+ * Maximum of two LogFixedPoint, by value, so that loops of maximums (as in
+ * Viterbi) are vectorized; found by argument-dependent lookup before the
+ * std::max that selects references.
+ */
+template<typename Int, std::size_t FracBits>
+constexpr LogFixedPoint<Int, FracBits> max(
+    LogFixedPoint<Int, FracBits> lhs, LogFixedPoint<Int, FracBits> rhs) {
+  return LogFixedPoint<Int, FracBits>::from_raw(
+      lhs.data() > rhs.data() ? lhs.data() : rhs.data());
+}
+
+/*----------------------------------------------------------------------------*/
+/*                                  ALIASES                                   */
+/*----------------------------------------------------------------------------*/
+
+using log_fixed16_t = LogFixedPoint<std::int16_t, 6>;
+using log_fixed32_t = LogFixedPoint<std::int32_t, 16>;
+
+/*----------------------------------------------------------------------------*/
+
+}  // namespace probability
+
+#endif  // PROBABILITY_FIXED_
@@ -0,0 +1,572 @@
+/******************************************************************************/
+/*  Probability - A fast implementation of probabilities using logarithms     */
+/*  Copyright (C) 2016 Renato Cordeiro Ferreira                               */
+/*                                                                            */
+/*  This program is free software: you can redistribute it and/or modify      */
+/*  it under the terms of the GNU General Public License as published by      */
+/*  the Free Software Foundation, either version 3 of the License, or         */
+/*  (at your option) any later version.                                       */
+/*                                                                            */
+/*  This program is distributed in the hope that it will be useful,           */
+/*  but WITHOUT ANY WARRANTY; without even the implied warranty of            */
+/*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             */
+/*  GNU General Public License for more details.                              */
+/*                                                                            */
+/*  You should have received a copy of the GNU General Public License         */
+/*  along with this program.  If not, see <www.gnu.org/licenses>.             */
+/******************************************************************************/
+
+#ifndef PROBABILITY_HALF_
+#define PROBABILITY_HALF_
+
+// Standard headers
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <utility>
+#include <type_traits>
+
+// Internal headers
+#include "probability/dispatch.hpp"
+#include "probability/numeric.hpp"
+#include "probability/probability.hpp"
+
+#if (defined(__GNUC__) || defined(__clang__)) \
+    && (defined(__x86_64__) || defined(__i386__))
+#define PROBABILITY_X86_DISPATCH
+#define PROBABILITY_TARGET(isa) [[gnu::target(isa)]]
+#include <immintrin.h>
+#else
+#define PROBABILITY_TARGET(isa)
+#endif
+
+namespace probability {
+
+/*----------------------------------------------------------------------------*/
+/*                                  KERNELS                                   */
+/*----------------------------------------------------------------------------*/
+
+namespace detail {
+
+inline std::uint32_t float_bits(float value) noexcept {
+  std::uint32_t bits;
+  std::memcpy(&bits, &value, sizeof(bits));
+  return bits;
+}
+
+inline float float_from_bits(std::uint32_t bits) noexcept {
+  float value;
+  std::memcpy(&value, &bits, sizeof(value));
+  return value;
+}
+
+/*----------------------------------------------------------------------------*/
+
+/**
+ * Rounds a float to the nearest IEEE 754 half (binary16), with ties to
+ * even; values too big become infinities and NaNs stay NaNs.
+ */
+inline std::uint16_t float_to_half(float value) noexcept {
+  std::uint32_t bits = float_bits(value);
+  std::uint32_t sign = (bits >> 16) & 0x8000;
+  std::uint32_t abs = bits & 0x7FFFFFFF;
+
+  if (abs >= 0x7F800000)  // Infinity or NaN (keeping it quiet)
+    return static_cast<std::uint16_t>(
+        sign | 0x7C00
+        | (abs > 0x7F800000 ? 0x200 | ((abs >> 13) & 0x3FF) : 0));
+
+  if (abs >= 0x477FF000)  // Rounds to infinity (>= 65520)
+    return static_cast<std::uint16_t>(sign | 0x7C00);
+
+  if (abs <= 0x33000000)  // Rounds to zero (<= 2^-25)
+    return static_cast<std::uint16_t>(sign);
+
+  std::uint32_t result, remainder, halfway;
+  if (abs < 0x38800000) {  // Subnormal half (< 2^-14)
+    std::uint32_t shift = 126 - (abs >> 23);
+    std::uint32_t mantissa = (abs & 0x7FFFFF) | 0x800000;
+    result = mantissa >> shift;
+    remainder = mantissa & ((1u << shift) - 1);
+    halfway = 1u << (shift - 1);
+  } else {  // Normal half: rebias the exponent from 127 to 15
+    result = (abs - 0x38000000) >> 13;
+    remainder = abs & 0x1FFF;
+    halfway = 0x1000;
+  }
+  if (remainder > halfway || (remainder == halfway && (result & 1)))
+    result++;
+  return static_cast<std::uint16_t>(sign | result);
+}
+
+/**
+ * Converts an IEEE 754 half (binary16) to float, exactly.
+ */
+inline float half_to_float(std::uint16_t half) noexcept {
+  std::uint32_t sign = static_cast<std::uint32_t>(half & 0x8000) << 16;
+  std::uint32_t exponent = (half >> 10) & 0x1F;
+  std::uint32_t mantissa = half & 0x3FF;
+
+  if (exponent == 0x1F)  // Infinity or NaN
+    return float_from_bits(sign | 0x7F800000 | (mantissa << 13));
+  if (exponent != 0)  // Normal: rebias the exponent from 15 to 127
+    return float_from_bits(sign | ((exponent + 112) << 23) | (mantissa << 13));
+
+  float subnormal = static_cast<float>(mantissa) * 5.9604644775390625e-8f;
+  return sign ? -subnormal : subnormal;  // mantissa * 2^-24
+}
+
+/*----------------------------------------------------------------------------*/
+
+/**
+ * Rounds a float to the nearest bfloat16 (the 16 most significant bits of
+ * a float), with ties to even; NaNs stay NaNs. Branch-free, so that loops
+ * of conversions are vectorized.
+ */
+inline std::uint16_t float_to_bfloat16(float value) noexcept {
+  std::uint32_t bits = float_bits(value);
+  std::uint32_t rounded = (bits + 0x7FFF + ((bits >> 16) & 1)) >> 16;
+  std::uint32_t nan = (bits >> 16) | 0x40;
+  return static_cast<std::uint16_t>(
+      (bits & 0x7FFFFFFF) > 0x7F800000 ? nan : rounded);
+}
+
+/**
+ * Converts a bfloat16 to float, exactly.
+ */
+inline float bfloat16_to_float(std::uint16_t bfloat16) noexcept {
+  return float_from_bits(static_cast<std::uint32_t>(bfloat16) << 16);
+}
+
+/*----------------------------------------------------------------------------*/
+
+[[gnu::always_inline]] inline void narrow_half_generic(
+    const float* values, std::uint16_t* halves, std::size_t size) noexcept {
+  for (std::size_t i = 0; i < size; i++)
+    halves[i] = float_to_half(values[i]);
+}
+
+[[gnu::always_inline]] inline void widen_half_generic(
+    const std::uint16_t* halves, float* values, std::size_t size) noexcept {
+  for (std::size_t i = 0; i < size; i++)
+    values[i] = half_to_float(halves[i]);
+}
+
+[[gnu::always_inline]] inline void narrow_bfloat16_generic(
+    const float* values, std::uint16_t* bfloat16s, std::size_t size) noexcept {
+  for (std::size_t i = 0; i < size; i++)
+    bfloat16s[i] = float_to_bfloat16(values[i]);
+}
+
+[[gnu::always_inline]] inline void widen_bfloat16_generic(
+    const std::uint16_t* bfloat16s, float* values, std::size_t size) noexcept {
+  for (std::size_t i = 0; i < size; i++)
+    values[i] = bfloat16_to_float(bfloat16s[i]);
+}
+
+/*----------------------------------------------------------------------------*/
+
+// Conversions of halves use the F16C instructions (present in every CPU
+// with AVX2) and their AVX-512 versions; conversions of bfloat16 are
+// vectorized by the compiler from the generic loops.
+
+#ifdef PROBABILITY_X86_DISPATCH
+
+PROBABILITY_TARGET("avx2,fma,f16c")
+inline void narrow_half_avx2(const float* values, std::uint16_t* halves,
+                             std::size_t size) noexcept {
+  std::size_t i = 0;
+  for (; i + 8 <= size; i += 8) {
+    __m128i packed = _mm256_cvtps_ph(_mm256_loadu_ps(values + i),
+                                     _MM_FROUND_TO_NEAREST_INT);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(halves + i), packed);
+  }
+  narrow_half_generic(values + i, halves + i, size - i);
+}
+
+PROBABILITY_TARGET("avx2,fma,f16c")
+inline void widen_half_avx2(const std::uint16_t* halves, float* values,
+                            std::size_t size) noexcept {
+  std::size_t i = 0;
+  for (; i + 8 <= size; i += 8) {
+    __m128i packed
+      = _mm_loadu_si128(reinterpret_cast<const __m128i*>(halves + i));
+    _mm256_storeu_ps(values + i, _mm256_cvtph_ps(packed));
+  }
+  widen_half_generic(halves + i, values + i, size - i);
+}
+
+PROBABILITY_TARGET("avx512f")
+inline void narrow_half_avx512(const float* values, std::uint16_t* halves,
+                               std::size_t size) noexcept {
+  std::size_t i = 0;
+  for (; i + 16 <= size; i += 16) {
+    __m256i packed = _mm512_maskz_cvtps_ph(0xFFFF,
+                                           _mm512_loadu_ps(values + i),
+                                           _MM_FROUND_TO_NEAREST_INT);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(halves + i), packed);
+  }
+  narrow_half_generic(values + i, halves + i, size - i);
+}
+
+PROBABILITY_TARGET("avx512f")
+inline void widen_half_avx512(const std::uint16_t* halves, float* values,
+                              std::size_t size) noexcept {
+  std::size_t i = 0;
+  for (; i + 16 <= size; i += 16) {
+    __m256i packed
+      = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(halves + i));
+    _mm512_storeu_ps(values + i, _mm512_maskz_cvtph_ps(0xFFFF, packed));
+  }
+  widen_half_generic(halves + i, values + i, size - i);
+}
+
+#else
+
+inline void narrow_half_avx2(const float* values, std::uint16_t* halves,
+                             std::size_t size) noexcept {
+  narrow_half_generic(values, halves, size);
+}
+
+inline void widen_half_avx2(const std::uint16_t* halves, float* values,
+                            std::size_t size) noexcept {
+  widen_half_generic(halves, values, size);
+}
+
+inline void narrow_half_avx512(const float* values, std::uint16_t* halves,
+                               std::size_t size) noexcept {
+  narrow_half_generic(values, halves, size);
+}
+
+inline void widen_half_avx512(const std::uint16_t* halves, float* values,
+                              std::size_t size) noexcept {
+  widen_half_generic(halves, values, size);
+}
+
+#endif
+
+PROBABILITY_TARGET("avx2,fma")
+inline void narrow_bfloat16_avx2(const float* values,
+                                 std::uint16_t* bfloat16s,
+                                 std::size_t size) noexcept {
+  narrow_bfloat16_generic(values, bfloat16s, size);
+}
+
+PROBABILITY_TARGET("avx2,fma")
+inline void widen_bfloat16_avx2(const std::uint16_t* bfloat16s,
+                                float* values, std::size_t size) noexcept {
+  widen_bfloat16_generic(bfloat16s, values, size);
+}
+
+PROBABILITY_TARGET("avx512f")
+inline void narrow_bfloat16_avx512(const float* values,
+                                   std::uint16_t* bfloat16s,
+                                   std::size_t size) noexcept {
+  narrow_bfloat16_generic(values, bfloat16s, size);
+}
+
+PROBABILITY_TARGET("avx512f")
+inline void widen_bfloat16_avx512(const std::uint16_t* bfloat16s,
+                                  float* values, std::size_t size) noexcept {
+  widen_bfloat16_generic(bfloat16s, values, size);
+}
+
+#undef PROBABILITY_TARGET
+#undef PROBABILITY_X86_DISPATCH
+
+inline void narrow_half_default(const float* values, std::uint16_t* halves,
+                                std::size_t size) noexcept {
+  narrow_half_generic(values, halves, size);
+}
+
+inline void widen_half_default(const std::uint16_t* halves, float* values,
+                               std::size_t size) noexcept {
+  widen_half_generic(halves, values, size);
+}
+
+inline void narrow_bfloat16_default(const float* values,
+                                    std::uint16_t* bfloat16s,
+                                    std::size_t size) noexcept {
+  narrow_bfloat16_generic(values, bfloat16s, size);
+}
+
+inline void widen_bfloat16_default(const std::uint16_t* bfloat16s,
+                                   float* values, std::size_t size) noexcept {
+  widen_bfloat16_generic(bfloat16s, values, size);
+}
+
+/*----------------------------------------------------------------------------*/
+
+// Versions of each kernel for an instruction set, which can be run in
+// tests against the generic version regardless of instruction_set()
+
+inline auto narrow_half_kernel(InstructionSet set) noexcept {
+  return select_kernel<float>(set, &narrow_half_default,
+                                   &narrow_half_avx2,
+                                   &narrow_half_avx512);
+}
+
+inline auto widen_half_kernel(InstructionSet set) noexcept {
+  return select_kernel<float>(set, &widen_half_default,
+                                   &widen_half_avx2,
+                                   &widen_half_avx512);
+}
+
+inline auto narrow_bfloat16_kernel(InstructionSet set) noexcept {
+  return select_kernel<float>(set, &narrow_bfloat16_default,
+                                   &narrow_bfloat16_avx2,
+                                   &narrow_bfloat16_avx512);
+}
+
+inline auto widen_bfloat16_kernel(InstructionSet set) noexcept {
+  return select_kernel<float>(set, &widen_bfloat16_default,
+                                   &widen_bfloat16_avx2,
+                                   &widen_bfloat16_avx512);
+}
+
+}  // namespace detail
+
+/*----------------------------------------------------------------------------*/
+/*                                  FORMATS                                   */
+/*----------------------------------------------------------------------------*/
+
+/**
+ * @class Half
+ * @brief IEEE 754 half precision (binary16) storage for logarithms: 11
+ *        significant bits, for a relative error of at most 2^-11 in the
+ *        logarithm, and logarithms down to -65504
+ */
+struct Half {
+  // Aliases
+  using storage_type = std::uint16_t;
+
+  // Static variables
+  static constexpr storage_type negative_infinity = 0xFC00;
+
+  // Static methods
+  static storage_type narrow(float value) noexcept {
+    return detail::float_to_half(value);
+  }
+
+  static float widen(storage_type bits) noexcept {
+    return detail::half_to_float(bits);
+  }
+
+  static void narrow(const float* values, storage_type* bits,
+                     std::size_t size) noexcept {
+    static const auto kernel = detail::narrow_half_kernel(instruction_set());
+    kernel(values, bits, size);
+  }
+
+  static void widen(const storage_type* bits, float* values,
+                    std::size_t size) noexcept {
+    static const auto kernel = detail::widen_half_kernel(instruction_set());
+    kernel(bits, values, size);
+  }
+};
+
+/*----------------------------------------------------------------------------*/
+
+/**
+ * @class BFloat16
+ * @brief Brain floating point (bfloat16) storage for logarithms: the 16
+ *        most significant bits of a float, with 8 significant bits (for a
+ *        relative error of at most 2^-8 in the logarithm) and the range
+ *        of a float
+ */
+struct BFloat16 {
+  // Aliases
+  using storage_type = std::uint16_t;
+
+  // Static variables
+  static constexpr storage_type negative_infinity = 0xFF80;
+
+  // Static methods
+  static storage_type narrow(float value) noexcept {
+    return detail::float_to_bfloat16(value);
+  }
+
+  static float widen(storage_type bits) noexcept {
+    return detail::bfloat16_to_float(bits);
+  }
+
+  static void narrow(const float* values, storage_type* bits,
+                     std::size_t size) noexcept {
+    static const auto kernel
+      = detail::narrow_bfloat16_kernel(instruction_set());
+    kernel(values, bits, size);
+  }
+
+  static void widen(const storage_type* bits, float* values,
+                    std::size_t size) noexcept {
+    static const auto kernel = detail::widen_bfloat16_kernel(instruction_set());
+    kernel(bits, values, size);
+  }
+};
+
+/*----------------------------------------------------------------------------*/
+/*                                LOG STORAGE                                 */
+/*----------------------------------------------------------------------------*/
+
+/**
+ * @class LogStorage
+ * @tparam Format Storage format (Half or BFloat16)
+ * @tparam Number LogFloatingPoint with value type float, used for
+ *         calculations
+ * @brief Storage-only LogFloatingPoint, whose logarithm is kept in 16 bits
+ *
+ * Values are narrowed (rounded to the nearest) on store and widened to
+ * Number (exactly) on load, halving the memory of tables of float. All
+ * operations convert their operands to Number, and return a Number;
+ * ranges are converted with the vectorized widen and narrow.
+ */
+template<typename Format, typename Number = log_float_t>
+class LogStorage {
+ public:
+  // Aliases
+  using format_type = Format;
+  using value_type = Number;
+  using storage_type = typename Format::storage_type;
+
+  // Constructors
+  LogStorage() = default;
+
+  LogStorage(const value_type& v) noexcept
+      : bits(format_type::narrow(v.data())) {
+  }
+
+  template<typename Value,
+    typename std::enable_if_t<
+      std::is_convertible_v<Value, value_type>
+        && !std::is_same_v<Value, value_type>, void>* = nullptr>
+  LogStorage(const Value& v) : LogStorage(value_type(v)) {
+  }
+
+  // Operator overloads
+  operator value_type() const noexcept {
+    return value_type::from_log_unchecked(format_type::widen(bits));
+  }
+
+  // Concrete methods
+  storage_type& data() noexcept {
+    return bits;
+  }
+
+  const storage_type& data() const noexcept {
+    return bits;
+  }
+
+ private:
+  // Validation
+  static_assert(std::is_same_v<typename value_type::value_type, float>,
+      "LogStorage must be loaded as a LogFloatingPoint of float");
+
+  // Instance variables
+  storage_type bits = format_type::negative_infinity;
+};
+
+/*----------------------------------------------------------------------------*/
+/*                                CONVERSIONS                                 */
+/*----------------------------------------------------------------------------*/
+
+namespace detail {
+
+template<typename Format, typename Number>
+const typename Format::storage_type*
+raw_data(const LogStorage<Format, Number>* values) noexcept {
+  static_assert(sizeof(LogStorage<Format, Number>)
+                  == sizeof(typename Format::storage_type),
+      "LogStorage must have the same size of its storage type");
+  static_assert(std::is_standard_layout_v<LogStorage<Format, Number>>,
+      "LogStorage must have standard layout");
+  return reinterpret_cast<const typename Format::storage_type*>(values);
+}
+
+template<typename Format, typename Number>
+typename Format::storage_type*
+raw_data(LogStorage<Format, Number>* values) noexcept {
+  return const_cast<typename Format::storage_type*>(
+      raw_data(static_cast<const LogStorage<Format, Number>*>(values)));
+}
+
+}  // namespace detail
+
+/*----------------------------------------------------------------------------*/
+
+/**
+ * Widens a contiguous range of LogStorage into Number, with vectorized
+ * conversions. Returns the end of the converted range, as std::copy.
+ */
+template<typename Format, typename Number>
+Number* widen(const LogStorage<Format, Number>* first,
+              const LogStorage<Format, Number>* last,
+              Number* d_first) noexcept {
+  assert(first <= last);
+  auto size = static_cast<std::size_t>(last - first);
+  Format::widen(detail::raw_data(first), detail::raw_data(d_first), size);
+  return d_first + size;
+}
+
+/*----------------------------------------------------------------------------*/
+
+/**
+ * Narrows a contiguous range of Number into LogStorage, with vectorized
+ * conversions. Returns the end of the converted range, as std::copy.
+ */
+template<typename Format, typename Number>
+LogStorage<Format, Number>* narrow(const Number* first, const Number* last,
+                                   LogStorage<Format, Number>* d_first)
+    noexcept {
+  assert(first <= last);
+  auto size = static_cast<std::size_t>(last - first);
+  Format::narrow(detail::raw_data(first), detail::raw_data(d_first), size);
+  return d_first + size;
+}
+
+/*----------------------------------------------------------------------------*/
+
+template<typename Storages, typename Numbers,
+  typename VT = typename Storages::value_type,
+  typename VTVT = typename VT::value_type,
+  typename std::enable_if_t<
+    std::is_same_v<VT, LogStorage<typename VT::format_type, VTVT>>
+      && std::is_same_v<decltype(std::data(std::declval<Numbers&>())), VTVT*>,
+  void>* = nullptr>
+void widen(const Storages& storages, Numbers& numbers) noexcept {
+  assert(std::size(storages) == std::size(numbers));
+  const VT* first = std::data(storages);
+  widen(first, first + std::size(storages), std::data(numbers));
+}
+
+/*----------------------------------------------------------------------------*/
+
+template<typename Numbers, typename Storages,
+  typename VT = typename Storages::value_type,
+  typename VTVT = typename VT::value_type,
+  typename std::enable_if_t<
+    std::is_same_v<VT, LogStorage<typename VT::format_type, VTVT>>
+      && std::is_same_v<decltype(std::data(std::declval<Storages&>())), VT*>,
+  void>* = nullptr>
+void narrow(const Numbers& numbers, Storages& storages) noexcept {
+  assert(std::size(numbers) == std::size(storages));
+  const VTVT* first = std::data(numbers);
+  narrow(first, first + std::size(numbers), std::data(storages));
+}
+
+/*----------------------------------------------------------------------------*/
+/*                                  ALIASES                                   */
+/*----------------------------------------------------------------------------*/
+
+using log_half_t = LogStorage<Half>;
+using log_bfloat16_t = LogStorage<BFloat16>;
+
+using probability_half_t = LogStorage<Half, probability_float_t>;
+using probability_bfloat16_t = LogStorage<BFloat16, probability_float_t>;
+
+/*----------------------------------------------------------------------------*/
+
+}  // namespace probability
+
+#endif  // PROBABILITY_HALF_
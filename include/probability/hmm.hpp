@@ -0,0 +1,483 @@
+/******************************************************************************/
+/*  Probability - A fast implementation of probabilities using logarithms     */
+/*  Copyright (C) 2016 Renato Cordeiro Ferreira                               */
+/*                                                                            */
+/*  This program is free software: you can redistribute it and/or modify      */
+/*  it under the terms of the GNU General Public License as published by      */
+/*  the Free Software Foundation, either version 3 of the License, or         */
+/*  (at your option) any later version.                                       */
+/*                                                                            */
+/*  This program is distributed in the hope that it will be useful,           */
+/*  but WITHOUT ANY WARRANTY; without even the implied warranty of            */
+/*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             */
+/*  GNU General Public License for more details.                              */
+/*                                                                            */
+/*  You should have received a copy of the GNU General Public License         */
+/*  along with this program.  If not, see <www.gnu.org/licenses>.             */
+/******************************************************************************/
+
+#ifndef PROBABILITY_HMM_
+#define PROBABILITY_HMM_
+
+// Standard headers
+#include <cmath>
+#include <limits>
+#include <vector>
+#include <cassert>
+#include <cstddef>
+#include <numeric>
+#include <utility>
+#include <algorithm>
+
+// Internal headers
+#include "probability/matrix.hpp"
+#include "probability/numeric.hpp"
+#include "probability/vector.hpp"
+#include "probability/scaled.hpp"
+#include "probability/probability.hpp"
+
+namespace probability {
+
+/*----------------------------------------------------------------------------*/
+/*                            FORWARD DECLARATIONS                            */
+/*----------------------------------------------------------------------------*/
+
+template<typename T, std::size_t ulp = 0,
+         typename C = ProbabilityChecker<T, ulp>,
+         typename M = StandardMath<T>>
+class HiddenMarkovModel;
+
+/*----------------------------------------------------------------------------*/
+/*                            HIDDEN MARKOV MODEL                             */
+/*----------------------------------------------------------------------------*/
+
+/**
+ * @class HiddenMarkovModel
+ * @tparam T Value type, used for internal store
+ * @tparam ulp Units in the last place, defining the accuracy
+ * @tparam C Checker type, used to inject methods that verify consistency
+ * @tparam M Math type, used to implement logarithms, exponentials and sums
+ * @brief Discrete hidden Markov model, with forward, backward and
+ *        posterior decoding computed with log-semiring matrix products
+ *
+ * With MaxMath, all sums become maximums: likelihoods are the probabilities
+ * of the most probable paths (as calculated by the Viterbi algorithm).
+ * The scaled_* methods calculate the same probabilities in linear space,
+ * with columns rescaled in each position (see ScaledProbabilityColumn).
+ */
+template<typename T, std::size_t ulp, typename C, typename M>
+class HiddenMarkovModel {
+ public:
+  // Aliases
+  using probability_type = LogFloatingPoint<T, ulp, C, M>;
+  using vector_type = LogVector<T, ulp, C, M>;
+  using matrix_type = LogMatrix<T, ulp, C, M>;
+  using column_type = ScaledProbabilityColumn<T, ulp, C, M>;
+  using size_type = std::size_t;
+  using symbol_type = std::size_t;
+  using sequence_type = std::vector<symbol_type>;
+  using path_type = std::vector<size_type>;
+
+  // Constructors
+  /**
+   * @param initial_probabilities Probability of starting in each state
+   * @param transition_probabilities Probability of going from i to j
+   * @param emission_probabilities Probability of emitting k in state i
+   */
+  HiddenMarkovModel(vector_type initial_probabilities,
+                    matrix_type transition_probabilities,
+                    const matrix_type& emission_probabilities)
+      : initial(std::move(initial_probabilities)),
+        transitions(std::move(transition_probabilities)),
+        emissions(emission_probabilities.cols(),
+                  emission_probabilities.rows()) {
+    assert(transitions.rows() == states());
+    assert(transitions.cols() == states());
+    assert(emission_probabilities.rows() == states());
+
+    // Emissions are stored by symbol, to read them contiguously
+    for (size_type i = 0; i < states(); i++)
+      for (size_type k = 0; k < symbols(); k++)
+        emissions(k, i) = emission_probabilities(i, k);
+
+    // Linear copies, for the scaled algorithms
+    linear_transitions.resize(transitions.rows() * transitions.cols());
+    for (size_type i = 0; i < linear_transitions.size(); i++)
+      linear_transitions[i] = std::exp(transitions.data()[i]);
+
+    linear_emissions.resize(emissions.rows() * emissions.cols());
+    for (size_type i = 0; i < linear_emissions.size(); i++)
+      linear_emissions[i] = std::exp(emissions.data()[i]);
+  }
+
+  // Concrete methods
+  size_type states() const noexcept {
+    return initial.size();
+  }
+
+  size_type symbols() const noexcept {
+    return emissions.rows();
+  }
+
+  const vector_type& initial_probabilities() const noexcept {
+    return initial;
+  }
+
+  const matrix_type& transition_probabilities() const noexcept {
+    return transitions;
+  }
+
+  /**
+   * Probability of emitting k in state i (copied, as emissions are
+   * stored by symbol).
+   */
+  matrix_type emission_probabilities() const {
+    matrix_type result(states(), symbols());
+    for (size_type i = 0; i < states(); i++)
+      for (size_type k = 0; k < symbols(); k++)
+        result(i, k) = emissions(k, i);
+    return result;
+  }
+
+  /**
+   * Transition probabilities in linear space (states x states), as used
+   * by the scaled algorithms.
+   */
+  const std::vector<T>& linear_transition_probabilities() const noexcept {
+    return linear_transitions;
+  }
+
+  /**
+   * Emission probabilities in linear space, stored by symbol (symbols x
+   * states), as used by the scaled algorithms.
+   */
+  const std::vector<T>& linear_emission_probabilities() const noexcept {
+    return linear_emissions;
+  }
+
+  /**
+   * Probability of a sequence, keeping only two columns of the forward
+   * algorithm at a time.
+   */
+  probability_type likelihood(const sequence_type& sequence) const {
+    if (sequence.empty()) return sum(initial);
+
+    vector_type current(states()), next(states());
+
+    start(sequence[0], current.data());
+    for (size_type t = 1; t < sequence.size(); t++) {
+      detail::log_gevm<T, M>(current.data(), transitions.data(),
+                       states(), states(), next.data());
+      emit(sequence[t], next.data());
+      std::swap(current, next);
+    }
+
+    return sum(current);
+  }
+
+  /**
+   * Probability of each sequence of a batch. All sequences advance
+   * together, so that each step is a single matrix-matrix product.
+   */
+  std::vector<probability_type>
+  likelihood(const std::vector<sequence_type>& batch) const {
+    std::vector<probability_type> result(batch.size());
+
+    // Longest sequences first, so that active ones are a prefix
+    std::vector<size_type> order(batch.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(),
+        [&batch](size_type lhs, size_type rhs) {
+          return batch[lhs].size() > batch[rhs].size();
+        });
+
+    size_type active = 0;
+    while (active < batch.size() && !batch[order[active]].empty()) active++;
+    for (size_type r = active; r < batch.size(); r++)
+      result[order[r]] = sum(initial);
+
+    matrix_type current(active, states()), next(active, states());
+
+    for (size_type r = 0; r < active; r++)
+      start(batch[order[r]][0], row(current, r));
+
+    for (size_type t = 1; active > 0; t++) {
+      while (active > 0 && batch[order[active-1]].size() == t) {
+        active--;
+        result[order[active]] = LogFloatingPoint<T, ulp, C, M>::from_log(
+            detail::log_sum<T, M>(row(current, active), states()));
+      }
+      if (active == 0) break;
+
+      detail::log_gemm<T, M>(current.data(), active, states(),
+                       transitions.data(), states(), next.data());
+      for (size_type r = 0; r < active; r++)
+        emit(batch[order[r]][t], row(next, r));
+
+      std::swap(current, next);
+    }
+
+    return result;
+  }
+
+  /**
+   * Forward probabilities: alpha(t, i) is the probability of the first
+   * t + 1 symbols of the sequence, ending in state i.
+   */
+  matrix_type forward(const sequence_type& sequence) const {
+    matrix_type alpha(sequence.size(), states());
+    if (sequence.empty()) return alpha;
+
+    start(sequence[0], row(alpha, 0));
+    for (size_type t = 1; t < sequence.size(); t++) {
+      detail::log_gevm<T, M>(row(alpha, t-1), transitions.data(),
+                       states(), states(), row(alpha, t));
+      emit(sequence[t], row(alpha, t));
+    }
+
+    check_range(alpha);
+    return alpha;
+  }
+
+  /**
+   * Backward probabilities: beta(t, i) is the probability of the symbols
+   * of the sequence after position t, given state i in position t.
+   */
+  matrix_type backward(const sequence_type& sequence) const {
+    matrix_type beta(sequence.size(), states());
+    if (sequence.empty()) return beta;
+
+    std::vector<T> next(states());
+
+    T* last = row(beta, sequence.size() - 1);
+    for (size_type i = 0; i < states(); i++) last[i] = 0;
+
+    for (size_type t = sequence.size() - 1; t > 0; t--) {
+      const T* emission = row(emissions, symbol(sequence[t]));
+      const T* previous = row(beta, t);
+      for (size_type j = 0; j < states(); j++)
+        next[j] = emission[j] + previous[j];
+      detail::log_gemv<T, M>(transitions.data(), states(), states(),
+                       next.data(), row(beta, t-1));
+    }
+
+    check_range(beta);
+    return beta;
+  }
+
+  /**
+   * Probability of a sequence, as likelihood(), but with the forward
+   * algorithm in linear space, rescaling each column.
+   */
+  probability_type scaled_likelihood(const sequence_type& sequence) const {
+    if (sequence.empty()) return sum(initial);
+
+    column_type current(initial), next(states());
+    scaled_emit(sequence[0], current);
+    for (size_type t = 1; t < sequence.size(); t++) {
+      scaled_transit(current, next);
+      scaled_emit(sequence[t], next);
+      std::swap(current, next);
+    }
+
+    return current.sum();
+  }
+
+  /**
+   * Forward probabilities, as forward(), but in linear space: column t
+   * is alpha(t, .) divided by its sum, with the logarithm of the sum as
+   * its scale (so the scale of the last column is the log-likelihood).
+   */
+  std::vector<column_type> scaled_forward(const sequence_type& sequence) const {
+    std::vector<column_type> alpha;
+    if (sequence.empty()) return alpha;
+
+    alpha.reserve(sequence.size());
+    alpha.emplace_back(initial);
+    scaled_emit(sequence[0], alpha.back());
+
+    for (size_type t = 1; t < sequence.size(); t++) {
+      alpha.emplace_back(states());
+      scaled_transit(alpha[t-1], alpha[t]);
+      scaled_emit(sequence[t], alpha[t]);
+    }
+
+    return alpha;
+  }
+
+  /**
+   * Backward probabilities, as backward(), but in linear space: column t
+   * is beta(t, .) divided by its sum, with the logarithm of the sum as
+   * its scale.
+   */
+  std::vector<column_type>
+  scaled_backward(const sequence_type& sequence) const {
+    std::vector<column_type> beta(sequence.size(), column_type(states()));
+    if (sequence.empty()) return beta;
+
+    std::vector<T> next(states());
+
+    column_type& last = beta.back();
+    for (size_type i = 0; i < states(); i++) last.data()[i] = 1;
+
+    for (size_type t = sequence.size() - 1; t > 0; t--) {
+      const T* emission = linear_row(linear_emissions, symbol(sequence[t]));
+      const T* previous = beta[t].data();
+      for (size_type j = 0; j < states(); j++)
+        next[j] = emission[j] * previous[j];
+
+      T* values = beta[t-1].data();
+      for (size_type i = 0; i < states(); i++) {
+        const T* transition = linear_row(linear_transitions, i);
+        T value = 0;
+        for (size_type j = 0; j < states(); j++)
+          value = accumulate(value, transition[j] * next[j]);
+        values[i] = value;
+      }
+
+      beta[t-1].log_scale() = beta[t].log_scale();
+      beta[t-1].rescale();
+    }
+
+    return beta;
+  }
+
+  /**
+   * Posterior probabilities: gamma(t, i) is the probability of being
+   * in state i in position t, given the whole sequence.
+   */
+  matrix_type posterior(const sequence_type& sequence) const {
+    matrix_type gamma = forward(sequence);
+    if (sequence.empty()) return gamma;
+
+    matrix_type beta = backward(sequence);
+    T total = detail::log_sum<T, M>(row(gamma, sequence.size() - 1),
+                                    states());
+
+    // Sequences with probability zero have no posteriors to normalize
+    if (total == -std::numeric_limits<T>::infinity()) {
+      gamma.fill(probability_type());
+      return gamma;
+    }
+
+    for (size_type t = 0; t < sequence.size(); t++) {
+      T* values = row(gamma, t);
+      const T* backward_values = row(beta, t);
+      for (size_type i = 0; i < states(); i++) {
+        // Rounding may take the biggest posteriors slightly above 1
+        values[i] = std::min(values[i] + backward_values[i] - total, T(0));
+      }
+    }
+
+    check_range(gamma);
+    return gamma;
+  }
+
+  /**
+   * Most probable state in each position of the sequence, given the
+   * whole sequence (i.e., maximizing the expected number of right states).
+   */
+  path_type posterior_decoding(const sequence_type& sequence) const {
+    matrix_type gamma = posterior(sequence);
+
+    path_type path(sequence.size());
+    for (size_type t = 0; t < sequence.size(); t++) {
+      const T* values = row(gamma, t);
+      path[t] = static_cast<size_type>(
+          std::max_element(values, values + states()) - values);
+    }
+
+    return path;
+  }
+
+ private:
+  // Instance variables
+  vector_type initial;
+  matrix_type transitions;
+  matrix_type emissions;  // symbols x states
+  std::vector<T> linear_transitions;
+  std::vector<T> linear_emissions;  // symbols x states
+
+  // Concrete methods
+  symbol_type symbol(symbol_type s) const noexcept {
+    assert(s < symbols());
+    return s;
+  }
+
+  void start(symbol_type s, T* values) const noexcept {
+    const T* emission = row(emissions, symbol(s));
+    for (size_type i = 0; i < states(); i++)
+      values[i] = initial.data()[i] + emission[i];
+  }
+
+  void emit(symbol_type s, T* values) const noexcept {
+    const T* emission = row(emissions, symbol(s));
+    for (size_type i = 0; i < states(); i++) values[i] += emission[i];
+  }
+
+  void scaled_emit(symbol_type s, column_type& column) const noexcept {
+    const T* emission = linear_row(linear_emissions, symbol(s));
+    T* values = column.data();
+    for (size_type i = 0; i < states(); i++) values[i] *= emission[i];
+    column.rescale();
+  }
+
+  void scaled_transit(const column_type& current,
+                      column_type& next) const noexcept {
+    T* values = next.data();
+    for (size_type j = 0; j < states(); j++) values[j] = 0;
+
+    // By rows of the transitions, to read them contiguously
+    for (size_type i = 0; i < states(); i++) {
+      const T* transition = linear_row(linear_transitions, i);
+      T value = current.data()[i];
+      for (size_type j = 0; j < states(); j++)
+        values[j] = accumulate(values[j], value * transition[j]);
+    }
+
+    next.log_scale() = current.log_scale();
+  }
+
+  const T* linear_row(const std::vector<T>& matrix,
+                      size_type i) const noexcept {
+    return matrix.data() + i * states();
+  }
+
+  // Static methods
+  static T accumulate(T lhs, T rhs) noexcept {
+    if constexpr (is_max_math_v<M>) {
+      return lhs > rhs ? lhs : rhs;
+    } else {
+      return lhs + rhs;
+    }
+  }
+
+  static T* row(matrix_type& matrix, size_type i) noexcept {
+    return matrix.data() + i * matrix.cols();
+  }
+
+  static const T* row(const matrix_type& matrix, size_type i) noexcept {
+    return matrix.data() + i * matrix.cols();
+  }
+
+  static void check_range(const matrix_type& matrix) {
+    for (size_type i = 0; i < matrix.rows() * matrix.cols(); i++)
+      C::check_range(matrix.data()[i]);
+  }
+};
+
+/*----------------------------------------------------------------------------*/
+/*                                  ALIASES                                   */
+/*----------------------------------------------------------------------------*/
+
+using hmm_float_t = HiddenMarkovModel<float>;
+using hmm_double_t = HiddenMarkovModel<double>;
+using hmm_long_double_t = HiddenMarkovModel<long double>;
+
+using hmm_t = hmm_double_t;
+
+/*----------------------------------------------------------------------------*/
+
+}  // namespace probability
+
+#endif  // PROBABILITY_HMM_
@@ -0,0 +1,248 @@
+/******************************************************************************/
+/*  Probability - A fast implementation of probabilities using logarithms     */
+/*  Copyright (C) 2016 Renato Cordeiro Ferreira                               */
+/*                                                                            */
+/*  This program is free software: you can redistribute it and/or modify      */
+/*  it under the terms of the GNU General Public License as published by      */
+/*  the Free Software Foundation, either version 3 of the License, or         */
+/*  (at your option) any later version.                                       */
+/*                                                                            */
+/*  This program is distributed in the hope that it will be useful,           */
+/*  but WITHOUT ANY WARRANTY; without even the implied warranty of            */
+/*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             */
+/*  GNU General Public License for more details.                              */
+/*                                                                            */
+/*  You should have received a copy of the GNU General Public License         */
+/*  along with this program.  If not, see <www.gnu.org/licenses>.             */
+/******************************************************************************/
+
+#ifndef PROBABILITY_MATRIX_
+#define PROBABILITY_MATRIX_
+
+// Standard headers
+#include <vector>
+#include <cassert>
+#include <cstddef>
+#include <initializer_list>
+
+// Internal headers
+#include "probability/numeric.hpp"
+#include "probability/vector.hpp"
+#include "probability/probability.hpp"
+
+namespace probability {
+
+/*----------------------------------------------------------------------------*/
+/*                            FORWARD DECLARATIONS                            */
+/*----------------------------------------------------------------------------*/
+
+template<typename T, std::size_t ulp = 0, typename C = EmptyChecker<T>,
+         typename M = StandardMath<T>>
+class LogMatrix;
+
+/*----------------------------------------------------------------------------*/
+/*                                 LOG MATRIX                                 */
+/*----------------------------------------------------------------------------*/
+
+/**
+ * @class LogMatrix
+ * @tparam T Value type, used for internal store
+ * @tparam ulp Units in the last place, defining the accuracy
+ * @tparam C Checker type, used to inject methods that verify consistency
+ * @tparam M Math type, used to implement logarithms, exponentials and sums
+ * @brief Dense row-major matrix of LogFloatingPoint, stored as raw
+ *        logarithms in cache-aligned memory, with products in the
+ *        log semiring (log-sum-exp as sum, + as product), or in the
+ *        max-plus semiring for MaxMath
+ */
+template<typename T, std::size_t ulp, typename C, typename M>
+class LogMatrix {
+ public:
+  // Aliases
+  using value_type = LogFloatingPoint<T, ulp, C, M>;
+  using raw_type = T;
+  using checker_type = C;
+  using math_type = M;
+  using allocator_type = AlignedAllocator<T>;
+  using size_type = std::size_t;
+  using reference = LogReference<T, ulp, C, M>;
+  using const_reference = value_type;
+  using vector_type = LogVector<T, ulp, C, M>;
+
+  // Constructors
+  LogMatrix() = default;
+
+  LogMatrix(size_type rows, size_type cols,
+            const value_type& v = value_type())
+      : n_rows(rows), n_cols(cols), values(rows * cols, v.data()) {
+  }
+
+  LogMatrix(std::initializer_list<std::initializer_list<value_type>> list)
+      : n_rows(list.size()), n_cols(list.size() ? list.begin()->size() : 0) {
+    values.reserve(n_rows * n_cols);
+    for (const auto& row : list) {
+      assert(row.size() == n_cols);
+      for (const auto& v : row) values.push_back(v.data());
+    }
+  }
+
+  // Operator overloads
+  reference operator()(size_type i, size_type j) noexcept {
+    assert(i < n_rows && j < n_cols);
+    return reference(values[i * n_cols + j]);
+  }
+
+  const_reference operator()(size_type i, size_type j) const noexcept {
+    assert(i < n_rows && j < n_cols);
+    return value_type::from_log_unchecked(values[i * n_cols + j]);
+  }
+
+  // Concrete methods
+  size_type rows() const noexcept {
+    return n_rows;
+  }
+
+  size_type cols() const noexcept {
+    return n_cols;
+  }
+
+  void fill(const value_type& v) noexcept {
+    for (auto& value : values) value = v.data();
+  }
+
+  T* data() noexcept {
+    return values.data();
+  }
+
+  const T* data() const noexcept {
+    return values.data();
+  }
+
+ private:
+  // Instance variables
+  size_type n_rows = 0;
+  size_type n_cols = 0;
+  std::vector<T, allocator_type> values;
+};
+
+/*----------------------------------------------------------------------------*/
+/*                                  ALIASES                                   */
+/*----------------------------------------------------------------------------*/
+
+using log_float_matrix_t = LogMatrix<float>;
+using log_double_matrix_t = LogMatrix<double>;
+using log_long_double_matrix_t = LogMatrix<long double>;
+
+template<typename T, std::size_t ulp = 0>
+using ProbabilityMatrix = LogMatrix<T, ulp, ProbabilityChecker<T, ulp>>;
+
+using probability_float_matrix_t = ProbabilityMatrix<float>;
+using probability_double_matrix_t = ProbabilityMatrix<double>;
+using probability_long_double_matrix_t = ProbabilityMatrix<long double>;
+
+using probability_matrix_t = probability_double_matrix_t;
+
+/*----------------------------------------------------------------------------*/
+/*                                  PRODUCTS                                  */
+/*----------------------------------------------------------------------------*/
+
+/**
+ * Matrix-vector product (result[i] = sum_j matrix(i, j) * vector[j]),
+ * written to a preallocated vector, which must not be the input vector.
+ */
+template<typename T, std::size_t ulp, typename C, typename M>
+void gemv(const LogMatrix<T, ulp, C, M>& matrix,
+          const LogVector<T, ulp, C, M>& vector,
+          LogVector<T, ulp, C, M>& result) {
+  assert(matrix.cols() == vector.size());
+  assert(&result != &vector);
+
+  result.resize(matrix.rows());
+  detail::log_gemv<T, M>(matrix.data(), matrix.rows(), matrix.cols(),
+                   vector.data(), result.data());
+
+  for (std::size_t i = 0; i < result.size(); i++)
+    C::check_range(result.data()[i]);
+}
+
+/*----------------------------------------------------------------------------*/
+
+/**
+ * Vector-matrix product (result[j] = sum_i vector[i] * matrix(i, j)),
+ * written to a preallocated vector, which must not be the input vector.
+ * This is the step of the forward algorithm, for a transition matrix.
+ */
+template<typename T, std::size_t ulp, typename C, typename M>
+void gevm(const LogVector<T, ulp, C, M>& vector,
+          const LogMatrix<T, ulp, C, M>& matrix,
+          LogVector<T, ulp, C, M>& result) {
+  assert(matrix.rows() == vector.size());
+  assert(&result != &vector);
+
+  result.resize(matrix.cols());
+  detail::log_gevm<T, M>(vector.data(), matrix.data(), matrix.rows(),
+                   matrix.cols(), result.data());
+
+  for (std::size_t j = 0; j < result.size(); j++)
+    C::check_range(result.data()[j]);
+}
+
+/*----------------------------------------------------------------------------*/
+
+/**
+ * Matrix-matrix product (result(i, k) = sum_j lhs(i, j) * rhs(j, k)),
+ * written to a matrix, which must not be one of the operands.
+ */
+template<typename T, std::size_t ulp, typename C, typename M>
+void gemm(const LogMatrix<T, ulp, C, M>& lhs,
+          const LogMatrix<T, ulp, C, M>& rhs,
+          LogMatrix<T, ulp, C, M>& result) {
+  assert(lhs.cols() == rhs.rows());
+  assert(&result != &lhs && &result != &rhs);
+
+  if (result.rows() != lhs.rows() || result.cols() != rhs.cols())
+    result = LogMatrix<T, ulp, C, M>(lhs.rows(), rhs.cols());
+
+  detail::log_gemm<T, M>(lhs.data(), lhs.rows(), lhs.cols(),
+                   rhs.data(), rhs.cols(), result.data());
+
+  for (std::size_t i = 0; i < result.rows() * result.cols(); i++)
+    C::check_range(result.data()[i]);
+}
+
+/*----------------------------------------------------------------------------*/
+/*                                 OPERATOR*                                  */
+/*----------------------------------------------------------------------------*/
+
+template<typename T, std::size_t ulp, typename C, typename M>
+inline LogVector<T, ulp, C, M>
+operator*(const LogMatrix<T, ulp, C, M>& lhs,
+          const LogVector<T, ulp, C, M>& rhs) {
+  LogVector<T, ulp, C, M> result(lhs.rows());
+  gemv(lhs, rhs, result);
+  return result;
+}
+
+template<typename T, std::size_t ulp, typename C, typename M>
+inline LogVector<T, ulp, C, M>
+operator*(const LogVector<T, ulp, C, M>& lhs,
+          const LogMatrix<T, ulp, C, M>& rhs) {
+  LogVector<T, ulp, C, M> result(rhs.cols());
+  gevm(lhs, rhs, result);
+  return result;
+}
+
+template<typename T, std::size_t ulp, typename C, typename M>
+inline LogMatrix<T, ulp, C, M>
+operator*(const LogMatrix<T, ulp, C, M>& lhs,
+          const LogMatrix<T, ulp, C, M>& rhs) {
+  LogMatrix<T, ulp, C, M> result(lhs.rows(), rhs.cols());
+  gemm(lhs, rhs, result);
+  return result;
+}
+
+/*----------------------------------------------------------------------------*/
+
+}  // namespace probability
+
+#endif  // PROBABILITY_MATRIX_
@@ -0,0 +1,1130 @@
+/******************************************************************************/
+/*  Probability - A fast implementation of probabilities using logarithms     */
+/*  Copyright (C) 2016 Renato Cordeiro Ferreira                               */
+/*                                                                            */
+/*  This program is free software: you can redistribute it and/or modify      */
+/*  it under the terms of the GNU General Public License as published by      */
+/*  the Free Software Foundation, either version 3 of the License, or         */
+/*  (at your option) any later version.                                       */
+/*                                                                            */
+/*  This program is distributed in the hope that it will be useful,           */
+/*  but WITHOUT ANY WARRANTY; without even the implied warranty of            */
+/*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             */
+/*  GNU General Public License for more details.                              */
+/*                                                                            */
+/*  You should have received a copy of the GNU General Public License         */
+/*  along with this program.  If not, see <www.gnu.org/licenses>.             */
+/******************************************************************************/
+
+#ifndef PROBABILITY_NUMERIC_
+#define PROBABILITY_NUMERIC_
+
+// Standard headers
+#include <cmath>
+#include <limits>
+#include <cassert>
+#include <cstddef>
+#include <cstring>
+#include <algorithm>
+#include <iterator>
+#include <utility>
+#include <type_traits>
+
+// Internal headers
+#include "probability/dispatch.hpp"
+#include "probability/probability.hpp"
+
+namespace probability {
+
+/*----------------------------------------------------------------------------*/
+/*                                   KERNELS                                  */
+/*----------------------------------------------------------------------------*/
+
+namespace detail {
+
+/**
+ * Maximum of raw logarithms, using independent lanes to allow vectorization.
+ */
+template<typename T>
+[[gnu::always_inline]] inline T log_max(const T* values,
+                                        std::size_t size) noexcept {
+  constexpr auto infinity = std::numeric_limits<T>::infinity();
+  constexpr std::size_t lanes = 64 / sizeof(T);
+
+  std::size_t i = 0;
+
+  T lane_max[lanes];
+  for (auto& m : lane_max) m = -infinity;
+  for (; i + lanes <= size; i += lanes)
+    for (std::size_t j = 0; j < lanes; j++)
+      lane_max[j] = values[i+j] > lane_max[j] ? values[i+j] : lane_max[j];
+
+  T max = -infinity;
+  for (auto m : lane_max) max = m > max ? m : max;
+  for (; i < size; i++) max = values[i] > max ? values[i] : max;
+
+  return max;
+}
+
+/*----------------------------------------------------------------------------*/
+
+/**
+ * Sum of raw logarithms (i.e., the product of the values they represent),
+ * using independent lanes to allow vectorization.
+ */
+template<typename T>
+[[gnu::always_inline]] inline T log_product(const T* values,
+                                            std::size_t size) noexcept {
+  constexpr std::size_t lanes = 64 / sizeof(T);
+
+  std::size_t i = 0;
+
+  T lane_sum[lanes] = {};
+  for (; i + lanes <= size; i += lanes)
+    for (std::size_t j = 0; j < lanes; j++)
+      lane_sum[j] += values[i+j];
+
+  T sum = 0;
+  for (auto s : lane_sum) sum += s;
+  for (; i < size; i++) sum += values[i];
+
+  return sum;
+}
+
+/*----------------------------------------------------------------------------*/
+
+/**
+ * Exponential of x <= 0 (or NaN, from -infinity minus -infinity, which
+ * is considered -infinity), as used in shifted log-sum-exps.
+ */
+template<typename T>
+[[gnu::always_inline]] inline T shifted_exp(T x) noexcept {
+  if constexpr (has_ieee754_traits_v<T>) {
+    return vectorizable_exp(x);
+  } else {
+    return x == x ? std::exp(x) : T(0);
+  }
+}
+
+/*----------------------------------------------------------------------------*/
+
+/**
+ * Sum of exp(x - shift) for raw logarithms x, using independent lanes
+ * to allow vectorization.
+ */
+template<typename T>
+[[gnu::always_inline]] inline T sum_shifted_exp(const T* values,
+                                                std::size_t size,
+                                                T shift) noexcept {
+  constexpr std::size_t lanes = 64 / sizeof(T);
+
+  std::size_t i = 0;
+  T lane_sum[lanes] = {};
+
+  for (; i + lanes <= size; i += lanes)
+    for (std::size_t j = 0; j < lanes; j++)
+      lane_sum[j] += shifted_exp(values[i+j] - shift);
+
+  T sum = 0;
+  for (auto s : lane_sum) sum += s;
+  for (; i < size; i++) sum += shifted_exp(values[i] - shift);
+
+  return sum;
+}
+
+/*----------------------------------------------------------------------------*/
+
+/**
+ * Log-sum-exp of raw logarithms: one pass to find the maximum and another
+ * to accumulate exp(x - max), using independent lanes to allow vectorization.
+ */
+template<typename T>
+[[gnu::always_inline]] inline T log_sum_exp_generic(const T* values,
+                                                    std::size_t size) noexcept {
+  constexpr auto infinity = std::numeric_limits<T>::infinity();
+
+  T max = log_max(values, size);
+
+  if (max == -infinity || max == infinity) return max;
+
+  return max + std::log(sum_shifted_exp(values, size, max));
+}
+
+/*----------------------------------------------------------------------------*/
+
+/**
+ * Error-free addition (Knuth's TwoSum): adds term to sum, accumulating
+ * the rounding error in compensation. It is a branch-free alternative to
+ * Neumaier's compensation (which needs to compare magnitudes).
+ */
+template<typename T>
+[[gnu::always_inline]] inline void two_sum(T& sum, T& compensation,
+                                           T term) noexcept {
+  T total = sum + term;
+  T rounded_term = total - sum;
+  compensation += (sum - (total - rounded_term)) + (term - rounded_term);
+  sum = total;
+}
+
+/*----------------------------------------------------------------------------*/
+
+/**
+ * Accumulates exp(x - shift) for raw logarithms x into sum (and, when
+ * compensated, the rounding errors into compensation), using independent
+ * lanes to allow vectorization.
+ */
+template<typename T, bool compensated>
+[[gnu::always_inline]] inline void accumulate_shifted_exp_generic(
+    const T* values, std::size_t size, T shift,
+    T* sum, T* compensation) noexcept {
+  constexpr std::size_t lanes = 64 / sizeof(T);
+
+  std::size_t i = 0;
+  T lane_sum[lanes] = {};
+  T lane_compensation[lanes] = {};
+
+  for (; i + lanes <= size; i += lanes) {
+    for (std::size_t j = 0; j < lanes; j++) {
+      T term = shifted_exp(values[i+j] - shift);
+      if constexpr (compensated) {
+        two_sum(lane_sum[j], lane_compensation[j], term);
+      } else {
+        lane_sum[j] += term;
+      }
+    }
+  }
+
+  for (; i < size; i++) {
+    T term = shifted_exp(values[i] - shift);
+    if constexpr (compensated) {
+      two_sum(lane_sum[0], lane_compensation[0], term);
+    } else {
+      lane_sum[0] += term;
+    }
+  }
+
+  for (std::size_t j = 0; j < lanes; j++) {
+    if constexpr (compensated) {
+      two_sum(*sum, *compensation, lane_sum[j]);
+      *compensation += lane_compensation[j];
+    } else {
+      *sum += lane_sum[j];
+    }
+  }
+}
+
+/*----------------------------------------------------------------------------*/
+
+/**
+ * Matrix-vector product in the log semiring, for a row-major matrix:
+ * result[i] = log(sum_j exp(matrix[i][j] + vector[j])). Each row is
+ * processed in blocks that fit the L1 cache, rescaling the running sum
+ * whenever a block has a bigger maximum, so that there is one exponential
+ * per element and one logarithm per output. With MaxMath, only the
+ * maximums are calculated (max-plus semiring).
+ */
+template<typename T, typename M>
+[[gnu::always_inline]] inline void log_gemv_generic(const T* matrix,
+                                                    std::size_t rows,
+                                                    std::size_t cols,
+                                                    const T* vector,
+                                                    T* result) noexcept {
+  constexpr auto infinity = std::numeric_limits<T>::infinity();
+  constexpr std::size_t block = 256;
+
+  T values[block];
+
+  for (std::size_t i = 0; i < rows; i++) {
+    const T* row = matrix + i * cols;
+
+    T max = -infinity, sum = 0;
+    for (std::size_t jb = 0; jb < cols; jb += block) {
+      std::size_t width = std::min(block, cols - jb);
+      for (std::size_t j = 0; j < width; j++)
+        values[j] = row[jb+j] + vector[jb+j];
+
+      T block_max = log_max(values, width);
+      T new_max = block_max > max ? block_max : max;
+      if constexpr (!is_max_math_v<M>) {
+        sum = sum * shifted_exp(max - new_max)
+            + sum_shifted_exp(values, width, new_max);
+      }
+      max = new_max;
+    }
+
+    result[i] = (is_max_math_v<M> || max == -infinity || max == infinity)
+              ? max : max + std::log(sum);
+  }
+}
+
+/*----------------------------------------------------------------------------*/
+
+/**
+ * Vector-matrix product in the log semiring, for a row-major matrix:
+ * result[j] = log(sum_i exp(vector[i] + matrix[i][j])). Columns are
+ * processed in blocks (vectorized along the rows of the matrix), and the
+ * running sums are rescaled once per block of rows, so that there is one
+ * exponential per element and one logarithm per output. With MaxMath,
+ * only the maximums are calculated (max-plus semiring).
+ */
+template<typename T, typename M>
+[[gnu::always_inline]] inline void log_gevm_generic(const T* vector,
+                                                    const T* matrix,
+                                                    std::size_t rows,
+                                                    std::size_t cols,
+                                                    T* result) noexcept {
+  constexpr auto infinity = std::numeric_limits<T>::infinity();
+  constexpr std::size_t row_block = 8;
+  constexpr std::size_t col_block = 256;
+
+  T max[col_block], sum[col_block], block_max[col_block];
+
+  for (std::size_t jb = 0; jb < cols; jb += col_block) {
+    std::size_t width = std::min(col_block, cols - jb);
+
+    for (std::size_t j = 0; j < width; j++) {
+      max[j] = -infinity;
+      sum[j] = 0;
+    }
+
+    for (std::size_t ib = 0; ib < rows; ib += row_block) {
+      std::size_t height = std::min(row_block, rows - ib);
+
+      for (std::size_t j = 0; j < width; j++) block_max[j] = max[j];
+      for (std::size_t i = ib; i < ib + height; i++) {
+        const T* row = matrix + i * cols + jb;
+        for (std::size_t j = 0; j < width; j++) {
+          T value = vector[i] + row[j];
+          block_max[j] = value > block_max[j] ? value : block_max[j];
+        }
+      }
+
+      if constexpr (!is_max_math_v<M>) {
+        for (std::size_t j = 0; j < width; j++)
+          sum[j] *= shifted_exp(max[j] - block_max[j]);
+
+        for (std::size_t i = ib; i < ib + height; i++) {
+          const T* row = matrix + i * cols + jb;
+          for (std::size_t j = 0; j < width; j++)
+            sum[j] += shifted_exp(vector[i] + row[j] - block_max[j]);
+        }
+      }
+
+      for (std::size_t j = 0; j < width; j++) max[j] = block_max[j];
+    }
+
+    for (std::size_t j = 0; j < width; j++)
+      result[jb+j] = (is_max_math_v<M>
+                      || max[j] == -infinity || max[j] == infinity)
+                   ? max[j] : max[j] + std::log(sum[j]);
+  }
+}
+
+/*----------------------------------------------------------------------------*/
+
+/**
+ * Range [lo, hi) of outputs in [begin, end) with a term in the diagonal o
+ * of a banded matrix with rows x cols entries, where the output p has the
+ * row p - shift (shift is 0 for gbmv, and o for gbvm).
+ */
+inline std::pair<std::ptrdiff_t, std::ptrdiff_t> banded_range(
+    std::ptrdiff_t o, std::ptrdiff_t rows, std::ptrdiff_t cols,
+    std::ptrdiff_t shift, std::ptrdiff_t begin, std::ptrdiff_t end) noexcept {
+  std::ptrdiff_t first = std::max<std::ptrdiff_t>(0, -o);
+  std::ptrdiff_t last = std::min(rows, cols - o);
+  return { std::max(first + shift, begin), std::min(last + shift, end) };
+}
+
+/*----------------------------------------------------------------------------*/
+
+/**
+ * Product of a banded matrix, stored by diagonal (the diagonal o, from
+ * -lower to upper, has rows entries indexed by row, starting at
+ * diagonals + (o + lower) * rows), with a vector in the semiring of the
+ * math type: result[i] = log(sum_o exp(diagonal(o)[i] + vector[i+o]))
+ * or, if transposed, result[j] = log(sum_o exp(vector[j-o] +
+ * diagonal(o)[j-o])). As in log_gemv, outputs are processed in blocks
+ * that fit the L1 cache, with one pass over the diagonals for their
+ * maximums and another for their shifted exponentials, so that there is
+ * one exponential per entry and one logarithm per output, and the loops
+ * along each diagonal are vectorized. With MaxMath, only the maximums are
+ * calculated (max-plus semiring).
+ */
+template<typename T, typename M, bool transposed>
+[[gnu::always_inline]] inline void log_banded_product_generic(
+    const T* diagonals, std::size_t rows, std::size_t cols,
+    std::size_t lower, std::size_t upper,
+    const T* vector, T* result) noexcept {
+  constexpr auto infinity = std::numeric_limits<T>::infinity();
+  constexpr std::size_t block = 256;
+
+  T max[block], sum[block];
+
+  auto n_rows = static_cast<std::ptrdiff_t>(rows);
+  auto n_cols = static_cast<std::ptrdiff_t>(cols);
+  auto n_lower = static_cast<std::ptrdiff_t>(lower);
+  auto n_upper = static_cast<std::ptrdiff_t>(upper);
+  auto size = transposed ? n_cols : n_rows;
+
+  for (std::ptrdiff_t pb = 0; pb < size; pb += block) {
+    auto pe = std::min(pb + static_cast<std::ptrdiff_t>(block), size);
+
+    for (std::ptrdiff_t p = 0; p < pe - pb; p++) {
+      max[p] = -infinity;
+      sum[p] = 0;
+    }
+
+    for (auto o = -n_lower; o <= n_upper; o++) {
+      auto shift = transposed ? o : 0;
+      auto [lo, hi] = banded_range(o, n_rows, n_cols, shift, pb, pe);
+      if (lo >= hi) continue;
+
+      const T* d = diagonals + (o + n_lower) * n_rows + (lo - shift);
+      const T* v = vector + (transposed ? lo - o : lo + o);
+      T* m = max + (lo - pb);
+      for (std::ptrdiff_t k = 0; k < hi - lo; k++) {
+        T value = d[k] + v[k];
+        m[k] = value > m[k] ? value : m[k];
+      }
+    }
+
+    if constexpr (!is_max_math_v<M>) {
+      for (auto o = -n_lower; o <= n_upper; o++) {
+        auto shift = transposed ? o : 0;
+        auto [lo, hi] = banded_range(o, n_rows, n_cols, shift, pb, pe);
+        if (lo >= hi) continue;
+
+        const T* d = diagonals + (o + n_lower) * n_rows + (lo - shift);
+        const T* v = vector + (transposed ? lo - o : lo + o);
+        const T* m = max + (lo - pb);
+        T* s = sum + (lo - pb);
+        for (std::ptrdiff_t k = 0; k < hi - lo; k++)
+          s[k] += shifted_exp(d[k] + v[k] - m[k]);
+      }
+    }
+
+    for (std::ptrdiff_t p = 0; p < pe - pb; p++)
+      result[pb+p] = (is_max_math_v<M> || max[p] == -infinity
+                      || max[p] == infinity)
+                   ? max[p] : max[p] + std::log(sum[p]);
+  }
+}
+
+/*----------------------------------------------------------------------------*/
+
+/**
+ * Log-add of two raw logarithms, with the math type (so that StandardMath
+ * stays exact). Loops calling it are vectorized with the branch-free math
+ * types, BranchFreeMath and FastMath.
+ */
+template<typename T, typename M>
+[[gnu::always_inline]] inline T log_add_value(T lhs, T rhs) noexcept {
+  return M::add(lhs, rhs);
+}
+
+/*----------------------------------------------------------------------------*/
+
+/**
+ * Element-wise log-add of raw logarithms.
+ */
+template<typename T, typename M>
+[[gnu::always_inline]] inline void log_add_generic(const T* lhs,
+                                                   const T* rhs,
+                                                   T* result,
+                                                   std::size_t size) noexcept {
+  for (std::size_t i = 0; i < size; i++)
+    result[i] = log_add_value<T, M>(lhs[i], rhs[i]);
+}
+
+/*----------------------------------------------------------------------------*/
+
+/**
+ * Element-wise fused multiply-add of raw logarithms (acc += lhs * rhs),
+ * where rhs is either an array or, if scalar, a single value.
+ */
+template<typename T, typename M, bool scalar>
+[[gnu::always_inline]] inline void log_fma_generic(T* acc,
+                                                   const T* lhs,
+                                                   const T* rhs,
+                                                   std::size_t size) noexcept {
+  for (std::size_t i = 0; i < size; i++)
+    acc[i] = log_add_value<T, M>(acc[i], lhs[i] + rhs[scalar ? 0 : i]);
+}
+
+/*----------------------------------------------------------------------------*/
+
+#if (defined(__GNUC__) || defined(__clang__)) \
+    && (defined(__x86_64__) || defined(__i386__))
+#define PROBABILITY_TARGET(isa) [[gnu::target(isa)]]
+#else
+#define PROBABILITY_TARGET(isa)
+#endif
+
+template<typename T>
+PROBABILITY_TARGET("avx2,fma")
+T log_sum_exp_avx2(const T* values, std::size_t size) noexcept {
+  return log_sum_exp_generic(values, size);
+}
+
+template<typename T>
+PROBABILITY_TARGET("avx512f")
+T log_sum_exp_avx512(const T* values, std::size_t size) noexcept {
+  return log_sum_exp_generic(values, size);
+}
+
+template<typename T>
+T log_sum_exp_default(const T* values, std::size_t size) noexcept {
+  return log_sum_exp_generic(values, size);
+}
+
+template<typename T, typename M>
+PROBABILITY_TARGET("avx2,fma")
+void log_add_avx2(const T* lhs, const T* rhs, T* result,
+                  std::size_t size) noexcept {
+  log_add_generic<T, M>(lhs, rhs, result, size);
+}
+
+template<typename T, typename M>
+PROBABILITY_TARGET("avx512f")
+void log_add_avx512(const T* lhs, const T* rhs, T* result,
+                    std::size_t size) noexcept {
+  log_add_generic<T, M>(lhs, rhs, result, size);
+}
+
+template<typename T, typename M>
+void log_add_default(const T* lhs, const T* rhs, T* result,
+                     std::size_t size) noexcept {
+  log_add_generic<T, M>(lhs, rhs, result, size);
+}
+
+template<typename T, typename M, bool scalar>
+PROBABILITY_TARGET("avx2,fma")
+void log_fma_avx2(T* acc, const T* lhs, const T* rhs,
+                  std::size_t size) noexcept {
+  log_fma_generic<T, M, scalar>(acc, lhs, rhs, size);
+}
+
+template<typename T, typename M, bool scalar>
+PROBABILITY_TARGET("avx512f")
+void log_fma_avx512(T* acc, const T* lhs, const T* rhs,
+                    std::size_t size) noexcept {
+  log_fma_generic<T, M, scalar>(acc, lhs, rhs, size);
+}
+
+template<typename T, typename M, bool scalar>
+void log_fma_default(T* acc, const T* lhs, const T* rhs,
+                     std::size_t size) noexcept {
+  log_fma_generic<T, M, scalar>(acc, lhs, rhs, size);
+}
+
+template<typename T, typename M>
+PROBABILITY_TARGET("avx2,fma")
+void log_gemv_avx2(const T* matrix, std::size_t rows, std::size_t cols,
+                   const T* vector, T* result) noexcept {
+  log_gemv_generic<T, M>(matrix, rows, cols, vector, result);
+}
+
+template<typename T, typename M>
+PROBABILITY_TARGET("avx512f")
+void log_gemv_avx512(const T* matrix, std::size_t rows, std::size_t cols,
+                     const T* vector, T* result) noexcept {
+  log_gemv_generic<T, M>(matrix, rows, cols, vector, result);
+}
+
+template<typename T, typename M>
+void log_gemv_default(const T* matrix, std::size_t rows, std::size_t cols,
+                      const T* vector, T* result) noexcept {
+  log_gemv_generic<T, M>(matrix, rows, cols, vector, result);
+}
+
+template<typename T, typename M>
+PROBABILITY_TARGET("avx2,fma")
+void log_gevm_avx2(const T* vector, const T* matrix, std::size_t rows,
+                   std::size_t cols, T* result) noexcept {
+  log_gevm_generic<T, M>(vector, matrix, rows, cols, result);
+}
+
+template<typename T, typename M>
+PROBABILITY_TARGET("avx512f")
+void log_gevm_avx512(const T* vector, const T* matrix, std::size_t rows,
+                     std::size_t cols, T* result) noexcept {
+  log_gevm_generic<T, M>(vector, matrix, rows, cols, result);
+}
+
+template<typename T, typename M>
+void log_gevm_default(const T* vector, const T* matrix, std::size_t rows,
+                      std::size_t cols, T* result) noexcept {
+  log_gevm_generic<T, M>(vector, matrix, rows, cols, result);
+}
+
+template<typename T, typename M, bool transposed>
+PROBABILITY_TARGET("avx2,fma")
+void log_banded_product_avx2(const T* diagonals, std::size_t rows,
+                             std::size_t cols, std::size_t lower,
+                             std::size_t upper, const T* vector,
+                             T* result) noexcept {
+  log_banded_product_generic<T, M, transposed>(
+      diagonals, rows, cols, lower, upper, vector, result);
+}
+
+template<typename T, typename M, bool transposed>
+PROBABILITY_TARGET("avx512f")
+void log_banded_product_avx512(const T* diagonals, std::size_t rows,
+                               std::size_t cols, std::size_t lower,
+                               std::size_t upper, const T* vector,
+                               T* result) noexcept {
+  log_banded_product_generic<T, M, transposed>(
+      diagonals, rows, cols, lower, upper, vector, result);
+}
+
+template<typename T, typename M, bool transposed>
+void log_banded_product_default(const T* diagonals, std::size_t rows,
+                                std::size_t cols, std::size_t lower,
+                                std::size_t upper, const T* vector,
+                                T* result) noexcept {
+  log_banded_product_generic<T, M, transposed>(
+      diagonals, rows, cols, lower, upper, vector, result);
+}
+
+template<typename T, bool compensated>
+PROBABILITY_TARGET("avx2,fma")
+void accumulate_shifted_exp_avx2(const T* values, std::size_t size, T shift,
+                                 T* sum, T* compensation) noexcept {
+  accumulate_shifted_exp_generic<T, compensated>(
+      values, size, shift, sum, compensation);
+}
+
+template<typename T, bool compensated>
+PROBABILITY_TARGET("avx512f")
+void accumulate_shifted_exp_avx512(const T* values, std::size_t size, T shift,
+                                   T* sum, T* compensation) noexcept {
+  accumulate_shifted_exp_generic<T, compensated>(
+      values, size, shift, sum, compensation);
+}
+
+template<typename T, bool compensated>
+void accumulate_shifted_exp_default(const T* values, std::size_t size,
+                                    T shift, T* sum, T* compensation) noexcept {
+  accumulate_shifted_exp_generic<T, compensated>(
+      values, size, shift, sum, compensation);
+}
+
+#undef PROBABILITY_TARGET
+
+/*----------------------------------------------------------------------------*/
+
+// Versions of each kernel for an instruction set, which can be run in
+// tests against the generic version regardless of instruction_set()
+
+template<typename T>
+auto log_sum_exp_kernel(InstructionSet set) noexcept {
+  return select_kernel<T>(set, &log_sum_exp_default<T>,
+                               &log_sum_exp_avx2<T>,
+                               &log_sum_exp_avx512<T>);
+}
+
+template<typename T, typename M>
+auto log_add_kernel(InstructionSet set) noexcept {
+  return select_kernel<T>(set, &log_add_default<T, M>,
+                               &log_add_avx2<T, M>,
+                               &log_add_avx512<T, M>);
+}
+
+template<typename T, typename M, bool scalar>
+auto log_fma_kernel(InstructionSet set) noexcept {
+  return select_kernel<T>(set, &log_fma_default<T, M, scalar>,
+                               &log_fma_avx2<T, M, scalar>,
+                               &log_fma_avx512<T, M, scalar>);
+}
+
+template<typename T, typename M>
+auto log_gemv_kernel(InstructionSet set) noexcept {
+  return select_kernel<T>(set, &log_gemv_default<T, M>,
+                               &log_gemv_avx2<T, M>,
+                               &log_gemv_avx512<T, M>);
+}
+
+template<typename T, typename M>
+auto log_gevm_kernel(InstructionSet set) noexcept {
+  return select_kernel<T>(set, &log_gevm_default<T, M>,
+                               &log_gevm_avx2<T, M>,
+                               &log_gevm_avx512<T, M>);
+}
+
+template<typename T, typename M, bool transposed>
+auto log_banded_product_kernel(InstructionSet set) noexcept {
+  return select_kernel<T>(set, &log_banded_product_default<T, M, transposed>,
+                               &log_banded_product_avx2<T, M, transposed>,
+                               &log_banded_product_avx512<T, M, transposed>);
+}
+
+template<typename T, bool compensated>
+auto accumulate_shifted_exp_kernel(InstructionSet set) noexcept {
+  return select_kernel<T>(set,
+                          &accumulate_shifted_exp_default<T, compensated>,
+                          &accumulate_shifted_exp_avx2<T, compensated>,
+                          &accumulate_shifted_exp_avx512<T, compensated>);
+}
+
+/*----------------------------------------------------------------------------*/
+
+/**
+ * Log-sum-exp of raw logarithms, using the version of the kernel for
+ * instruction_set() (selected once, in the first call).
+ */
+template<typename T>
+T log_sum_exp(const T* values, std::size_t size) noexcept {
+  static const auto kernel = log_sum_exp_kernel<T>(instruction_set());
+  return kernel(values, size);
+}
+
+/*----------------------------------------------------------------------------*/
+
+/**
+ * Element-wise log-add of raw logarithms (result may alias lhs or rhs),
+ * using the version of the kernel for instruction_set().
+ */
+template<typename T, typename M>
+void log_add(const T* lhs, const T* rhs, T* result, std::size_t size) noexcept {
+  static const auto kernel = log_add_kernel<T, M>(instruction_set());
+  kernel(lhs, rhs, result, size);
+}
+
+/*----------------------------------------------------------------------------*/
+
+/**
+ * Element-wise fused multiply-add of raw logarithms (acc += lhs * rhs, where
+ * rhs is a single value if scalar), using the version of the kernel for
+ * instruction_set().
+ */
+template<typename T, typename M, bool scalar = false>
+void log_fma(T* acc, const T* lhs, const T* rhs, std::size_t size) noexcept {
+  static const auto kernel = log_fma_kernel<T, M, scalar>(instruction_set());
+  kernel(acc, lhs, rhs, size);
+}
+
+/*----------------------------------------------------------------------------*/
+
+/**
+ * Matrix-vector product in the semiring of the math type (result must not
+ * alias the vector), using the version of the kernel for
+ * instruction_set().
+ */
+template<typename T, typename M>
+void log_gemv(const T* matrix, std::size_t rows, std::size_t cols,
+              const T* vector, T* result) noexcept {
+  static const auto kernel = log_gemv_kernel<T, M>(instruction_set());
+  kernel(matrix, rows, cols, vector, result);
+}
+
+/*----------------------------------------------------------------------------*/
+
+/**
+ * Vector-matrix product in the semiring of the math type (result must not
+ * alias the vector), using the version of the kernel for
+ * instruction_set().
+ */
+template<typename T, typename M>
+void log_gevm(const T* vector, const T* matrix, std::size_t rows,
+              std::size_t cols, T* result) noexcept {
+  static const auto kernel = log_gevm_kernel<T, M>(instruction_set());
+  kernel(vector, matrix, rows, cols, result);
+}
+
+/*----------------------------------------------------------------------------*/
+
+/**
+ * Banded matrix-vector product in the semiring of the math type, for a
+ * matrix stored by diagonal (result must not alias the vector), using the
+ * version of the kernel for instruction_set().
+ */
+template<typename T, typename M>
+void log_gbmv(const T* diagonals, std::size_t rows, std::size_t cols,
+              std::size_t lower, std::size_t upper,
+              const T* vector, T* result) noexcept {
+  static const auto kernel
+    = log_banded_product_kernel<T, M, false>(instruction_set());
+  kernel(diagonals, rows, cols, lower, upper, vector, result);
+}
+
+/*----------------------------------------------------------------------------*/
+
+/**
+ * Banded vector-matrix product in the semiring of the math type, for a
+ * matrix stored by diagonal (result must not alias the vector), using the
+ * version of the kernel for instruction_set().
+ */
+template<typename T, typename M>
+void log_gbvm(const T* vector, const T* diagonals, std::size_t rows,
+              std::size_t cols, std::size_t lower, std::size_t upper,
+              T* result) noexcept {
+  static const auto kernel
+    = log_banded_product_kernel<T, M, true>(instruction_set());
+  kernel(diagonals, rows, cols, lower, upper, vector, result);
+}
+
+/*----------------------------------------------------------------------------*/
+
+/**
+ * Matrix-matrix product in the semiring of the math type, for row-major
+ * matrices (result must not alias the operands): each row of the result
+ * is the vector-matrix product of the corresponding row of lhs with rhs.
+ */
+template<typename T, typename M>
+void log_gemm(const T* lhs, std::size_t rows, std::size_t inner,
+              const T* rhs, std::size_t cols, T* result) noexcept {
+  for (std::size_t i = 0; i < rows; i++)
+    log_gevm<T, M>(lhs + i * inner, rhs, inner, cols, result + i * cols);
+}
+
+/*----------------------------------------------------------------------------*/
+
+/**
+ * Accumulates exp(x - shift) for raw logarithms x, using the version of
+ * the kernel for instruction_set().
+ */
+template<typename T, bool compensated>
+void accumulate_shifted_exp(const T* values, std::size_t size, T shift,
+                            T* sum, T* compensation) noexcept {
+  static const auto kernel
+    = accumulate_shifted_exp_kernel<T, compensated>(instruction_set());
+  kernel(values, size, shift, sum, compensation);
+}
+
+/*----------------------------------------------------------------------------*/
+
+/**
+ * Sum of raw logarithms in the semiring of the math type: a maximum
+ * with MaxMath, and a log-sum-exp otherwise.
+ */
+template<typename T, typename M>
+T log_sum(const T* values, std::size_t size) noexcept {
+  if constexpr (is_max_math_v<M>) {
+    return log_max(values, size);
+  } else {
+    return log_sum_exp(values, size);
+  }
+}
+
+/*----------------------------------------------------------------------------*/
+
+template<typename T, std::size_t ulp, typename C, typename M>
+const T* raw_data(const LogFloatingPoint<T, ulp, C, M>* values) noexcept {
+  static_assert(sizeof(LogFloatingPoint<T, ulp, C, M>) == sizeof(T),
+      "LogFloatingPoint must have the same size of its value type");
+  static_assert(std::is_standard_layout_v<LogFloatingPoint<T, ulp, C, M>>,
+      "LogFloatingPoint must have standard layout");
+  return reinterpret_cast<const T*>(values);
+}
+
+template<typename T, std::size_t ulp, typename C, typename M>
+T* raw_data(LogFloatingPoint<T, ulp, C, M>* values) noexcept {
+  return const_cast<T*>(
+      raw_data(static_cast<const LogFloatingPoint<T, ulp, C, M>*>(values)));
+}
+
+}  // namespace detail
+
+/*----------------------------------------------------------------------------*/
+/*                                    SUM                                     */
+/*----------------------------------------------------------------------------*/
+
+/**
+ * Sums a contiguous range of LogFloatingPoint with a single log-sum-exp,
+ * i.e., N exponentials (vectorized) and one logarithm instead of N calls
+ * to LogFloatingPoint::operator+= (or with a maximum, for MaxMath).
+ */
+template<typename T, std::size_t ulp, typename C, typename M>
+LogFloatingPoint<T, ulp, C, M> sum(const LogFloatingPoint<T, ulp, C, M>* first,
+                                const LogFloatingPoint<T, ulp, C, M>* last) {
+  assert(first <= last);
+  auto size = static_cast<std::size_t>(last - first);
+  return LogFloatingPoint<T, ulp, C, M>::from_log(
+      detail::log_sum<T, M>(detail::raw_data(first), size));
+}
+
+/*----------------------------------------------------------------------------*/
+
+template<typename Container,
+  typename VT = typename Container::value_type,
+  typename std::enable_if_t<is_log_floating_point_v<VT>, void>* = nullptr>
+VT sum(const Container& container) {
+  const VT* first = std::data(container);
+  return sum(first, first + std::size(container));
+}
+
+/*----------------------------------------------------------------------------*/
+/*                                CONVERSIONS                                 */
+/*----------------------------------------------------------------------------*/
+
+/**
+ * Converts a contiguous range of logarithms into LogFloatingPoint with a
+ * single copy (no exponentials or logarithms), checking the range of each
+ * element. Returns the end of the converted range, as std::copy.
+ */
+template<typename T, std::size_t ulp, typename C, typename M>
+LogFloatingPoint<T, ulp, C, M>*
+from_log(const T* first, const T* last,
+         LogFloatingPoint<T, ulp, C, M>* d_first) {
+  auto d_last = from_log_unchecked(first, last, d_first);
+  for (auto it = d_first; it != d_last; ++it) C::check_range(it->data());
+  return d_last;
+}
+
+/*----------------------------------------------------------------------------*/
+
+/**
+ * Same as from_log, without any checks (i.e., a memcpy).
+ */
+template<typename T, std::size_t ulp, typename C, typename M>
+LogFloatingPoint<T, ulp, C, M>*
+from_log_unchecked(const T* first, const T* last,
+                   LogFloatingPoint<T, ulp, C, M>* d_first) noexcept {
+  assert(first <= last);
+  auto size = static_cast<std::size_t>(last - first);
+  if (size > 0)
+    std::memcpy(detail::raw_data(d_first), first, size * sizeof(T));
+  return d_first + size;
+}
+
+/*----------------------------------------------------------------------------*/
+
+/**
+ * Copies the logarithms of a contiguous range of LogFloatingPoint (i.e., a
+ * memcpy). Returns the end of the copied range, as std::copy.
+ */
+template<typename T, std::size_t ulp, typename C, typename M>
+T* to_log(const LogFloatingPoint<T, ulp, C, M>* first,
+          const LogFloatingPoint<T, ulp, C, M>* last, T* d_first) noexcept {
+  assert(first <= last);
+  auto size = static_cast<std::size_t>(last - first);
+  if (size > 0)
+    std::memcpy(d_first, detail::raw_data(first), size * sizeof(T));
+  return d_first + size;
+}
+
+/*----------------------------------------------------------------------------*/
+
+template<typename Raw, typename Container,
+  typename VT = typename Container::value_type,
+  typename std::enable_if_t<is_log_floating_point_v<VT>
+    && std::is_same_v<decltype(std::data(std::declval<Container&>())), VT*>
+    && std::is_convertible_v<decltype(std::data(std::declval<const Raw&>())),
+                             const typename VT::value_type*>,
+  void>* = nullptr>
+void from_log(const Raw& logs, Container& values) {
+  assert(std::size(logs) == std::size(values));
+  const typename VT::value_type* first = std::data(logs);
+  from_log(first, first + std::size(logs), std::data(values));
+}
+
+/*----------------------------------------------------------------------------*/
+
+template<typename Raw, typename Container,
+  typename VT = typename Container::value_type,
+  typename std::enable_if_t<is_log_floating_point_v<VT>
+    && std::is_same_v<decltype(std::data(std::declval<Container&>())), VT*>
+    && std::is_convertible_v<decltype(std::data(std::declval<const Raw&>())),
+                             const typename VT::value_type*>,
+  void>* = nullptr>
+void from_log_unchecked(const Raw& logs, Container& values) noexcept {
+  assert(std::size(logs) == std::size(values));
+  const typename VT::value_type* first = std::data(logs);
+  from_log_unchecked(first, first + std::size(logs), std::data(values));
+}
+
+/*----------------------------------------------------------------------------*/
+
+template<typename Container, typename Raw,
+  typename VT = typename Container::value_type,
+  typename std::enable_if_t<is_log_floating_point_v<VT>
+    && std::is_same_v<decltype(std::data(std::declval<Raw&>())),
+                      typename VT::value_type*>,
+  void>* = nullptr>
+void to_log(const Container& values, Raw& logs) noexcept {
+  assert(std::size(values) == std::size(logs));
+  const VT* first = std::data(values);
+  to_log(first, first + std::size(values), std::data(logs));
+}
+
+/*----------------------------------------------------------------------------*/
+/*                                MULTIPLY-ADD                                */
+/*----------------------------------------------------------------------------*/
+
+/**
+ * Fused multiply-add over contiguous ranges of LogFloatingPoint: for each
+ * position i, acc[i] += a[i] * b[i] (or acc[i] += a[i] * b, for a single
+ * value b), in one vectorized pass and with one range check per element.
+ */
+template<typename T, std::size_t ulp, typename C, typename M>
+void fma(LogFloatingPoint<T, ulp, C, M>* acc_first,
+         LogFloatingPoint<T, ulp, C, M>* acc_last,
+         const LogFloatingPoint<T, ulp, C, M>* a_first,
+         const LogFloatingPoint<T, ulp, C, M>* b_first) {
+  assert(acc_first <= acc_last);
+  auto size = static_cast<std::size_t>(acc_last - acc_first);
+  detail::log_fma<T, M>(detail::raw_data(acc_first),
+                        detail::raw_data(a_first),
+                        detail::raw_data(b_first), size);
+  for (auto it = acc_first; it != acc_last; ++it) C::check_range(it->data());
+}
+
+/*----------------------------------------------------------------------------*/
+
+template<typename T, std::size_t ulp, typename C, typename M>
+void fma(LogFloatingPoint<T, ulp, C, M>* acc_first,
+         LogFloatingPoint<T, ulp, C, M>* acc_last,
+         const LogFloatingPoint<T, ulp, C, M>* a_first,
+         const LogFloatingPoint<T, ulp, C, M>& b) {
+  assert(acc_first <= acc_last);
+  auto size = static_cast<std::size_t>(acc_last - acc_first);
+  detail::log_fma<T, M, true>(detail::raw_data(acc_first),
+                              detail::raw_data(a_first),
+                              detail::raw_data(&b), size);
+  for (auto it = acc_first; it != acc_last; ++it) C::check_range(it->data());
+}
+
+/*----------------------------------------------------------------------------*/
+
+template<typename Container,
+  typename VT = typename Container::value_type,
+  typename std::enable_if_t<is_log_floating_point_v<VT>
+    && std::is_same_v<decltype(std::data(std::declval<Container&>())), VT*>,
+  void>* = nullptr>
+void fma(Container& acc, const Container& a, const Container& b) {
+  assert(std::size(a) == std::size(acc) && std::size(b) == std::size(acc));
+  VT* first = std::data(acc);
+  fma(first, first + std::size(acc), std::data(a), std::data(b));
+}
+
+/*----------------------------------------------------------------------------*/
+
+template<typename Container,
+  typename VT = typename Container::value_type,
+  typename std::enable_if_t<is_log_floating_point_v<VT>
+    && std::is_same_v<decltype(std::data(std::declval<Container&>())), VT*>,
+  void>* = nullptr>
+void fma(Container& acc, const Container& a, const VT& b) {
+  assert(std::size(a) == std::size(acc));
+  VT* first = std::data(acc);
+  fma(first, first + std::size(acc), std::data(a), b);
+}
+
+/*----------------------------------------------------------------------------*/
+/*                                ACCUMULATOR                                 */
+/*----------------------------------------------------------------------------*/
+
+/**
+ * @class LogAccumulator
+ * @tparam T Value type, used for internal store
+ * @tparam compensated Whether to compensate rounding errors of the sum
+ * @brief Streaming log-sum-exp, which keeps the running maximum and the
+ *        sum of all terms in linear space, scaled by that maximum
+ *
+ * Each term costs one exponential (and, when it is a new maximum, one
+ * rescaling), and the reduction costs one logarithm, when converted to
+ * a LogFloatingPoint. Ranges are accumulated with vectorized kernels.
+ * When compensated, rounding errors of the linear sum are accumulated
+ * separately (with Knuth's TwoSum) and added back at the end.
+ */
+template<typename T, bool compensated = false>
+class LogAccumulator {
+ public:
+  // Aliases
+  using value_type = T;
+  static constexpr bool COMPENSATED = compensated;
+
+  // Constructors
+  LogAccumulator() = default;
+
+  // Operator overloads
+  template<std::size_t ulp, typename C, typename M>
+  LogAccumulator& operator+=(
+      const LogFloatingPoint<T, ulp, C, M>& rhs) noexcept {
+    add(rhs.data());
+    return *this;
+  }
+
+  LogAccumulator& operator+=(const LogAccumulator& rhs) noexcept {
+    if (rhs.max_log > max_log) rescale(rhs.max_log);
+    T scale = detail::shifted_exp(rhs.max_log - max_log);
+    accumulate(rhs.scaled_sum * scale);
+    if constexpr (compensated) accumulate(rhs.compensation * scale);
+    return *this;
+  }
+
+  template<std::size_t ulp, typename C, typename M>
+  operator LogFloatingPoint<T, ulp, C, M>() const {
+    return LogFloatingPoint<T, ulp, C, M>::from_log(data());
+  }
+
+  // Concrete methods
+  void add(T log_value) noexcept {
+    if (log_value > max_log) rescale(log_value);
+    accumulate(detail::shifted_exp(log_value - max_log));
+  }
+
+  void add(const T* log_values, std::size_t size) noexcept {
+    T block_max = detail::log_max(log_values, size);
+    if (block_max > max_log) rescale(block_max);
+    detail::accumulate_shifted_exp<T, compensated>(
+        log_values, size, max_log, &scaled_sum, &compensation);
+  }
+
+  template<std::size_t ulp, typename C, typename M>
+  void add(const LogFloatingPoint<T, ulp, C, M>* first,
+           const LogFloatingPoint<T, ulp, C, M>* last) noexcept {
+    assert(first <= last);
+    add(detail::raw_data(first), static_cast<std::size_t>(last - first));
+  }
+
+  template<typename LFP = LogFloatingPoint<T>>
+  LFP value() const {
+    return *this;
+  }
+
+  T data() const noexcept {
+    if (max_log == -infinity || max_log == infinity) return max_log;
+    return max_log + std::log(scaled_sum + compensation);
+  }
+
+  void clear() noexcept {
+    *this = LogAccumulator();
+  }
+
+ private:
+  // Static variables
+  static constexpr auto infinity = std::numeric_limits<T>::infinity();
+
+  // Instance variables
+  T max_log = -infinity;
+  T scaled_sum = 0;
+  T compensation = 0;
+
+  // Concrete methods
+  void rescale(T new_max) noexcept {
+    T scale = detail::shifted_exp(max_log - new_max);
+    scaled_sum *= scale;
+    compensation *= scale;
+    max_log = new_max;
+  }
+
+  void accumulate(T term) noexcept {
+    if constexpr (compensated) {
+      detail::two_sum(scaled_sum, compensation, term);
+    } else {
+      scaled_sum += term;
+    }
+  }
+};
+
+/*----------------------------------------------------------------------------*/
+
+template<typename T>
+using CompensatedLogAccumulator = LogAccumulator<T, true>;
+
+/*----------------------------------------------------------------------------*/
+
+}  // namespace probability
+
+#endif  // PROBABILITY_NUMERIC_
@@ -0,0 +1,308 @@
+/******************************************************************************/
+/*  Probability - A fast implementation of probabilities using logarithms     */
+/*  Copyright (C) 2016 Renato Cordeiro Ferreira                               */
+/*                                                                            */
+/*  This program is free software: you can redistribute it and/or modify      */
+/*  it under the terms of the GNU General Public License as published by      */
+/*  the Free Software Foundation, either version 3 of the License, or         */
+/*  (at your option) any later version.                                       */
+/*                                                                            */
+/*  This program is distributed in the hope that it will be useful,           */
+/*  but WITHOUT ANY WARRANTY; without even the implied warranty of            */
+/*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             */
+/*  GNU General Public License for more details.                              */
+/*                                                                            */
+/*  You should have received a copy of the GNU General Public License         */
+/*  along with this program.  If not, see <www.gnu.org/licenses>.             */
+/******************************************************************************/
+
+#ifndef PROBABILITY_PARALLEL_
+#define PROBABILITY_PARALLEL_
+
+// Standard headers
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <utility>
+#include <cassert>
+#include <cstddef>
+#include <iterator>
+#include <algorithm>
+#include <execution>
+#include <exception>
+#include <functional>
+#include <type_traits>
+#include <condition_variable>
+
+// Internal headers
+#include "probability/vector.hpp"
+#include "probability/numeric.hpp"
+#include "probability/probability.hpp"
+
+namespace probability {
+
+/*----------------------------------------------------------------------------*/
+/*                                THREAD POOL                                 */
+/*----------------------------------------------------------------------------*/
+
+/**
+ * @class ThreadPool
+ * @brief Fixed set of worker threads, which run indexed tasks together
+ *        with the calling thread
+ */
+class ThreadPool {
+ public:
+  // Constructors
+  explicit ThreadPool(
+      std::size_t size = std::max(1u, std::thread::hardware_concurrency())) {
+    assert(size > 0);
+    for (std::size_t i = 1; i < size; i++)
+      workers.emplace_back([this, i] { work(i); });
+  }
+
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  ~ThreadPool() {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      stopping = true;
+    }
+    wake.notify_all();
+    for (auto& worker : workers) worker.join();
+  }
+
+  // Concrete methods
+  std::size_t size() const noexcept {
+    return workers.size() + 1;
+  }
+
+  /**
+   * Calls task(i) for every i in [0, tasks), distributing the calls
+   * among the workers and the calling thread, and waits for all of them.
+   * If a task throws, the tasks not started yet are skipped, and the
+   * first exception is rethrown in the calling thread once all threads
+   * have finished. Tasks must not call for_each on the same pool (which
+   * is not reentrant, and would deadlock).
+   */
+  template<typename Task>
+  void for_each(std::size_t tasks, Task task) {
+    for_each_in_worker(tasks, [&task](std::size_t i, std::size_t) {
+      task(i);
+    });
+  }
+
+  /**
+   * Same as above, but calls task(i, worker), where worker (in [0, size()),
+   * with 0 for the calling thread) identifies the thread running the task.
+   * Tasks with the same worker never run concurrently, so they may share
+   * per-thread state without synchronization.
+   */
+  template<typename Task>
+  void for_each_in_worker(std::size_t tasks, Task task) {
+    std::lock_guard<std::mutex> run_lock(run_mutex);
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      current_task = std::ref(task);
+      total_tasks = tasks;
+      next_task.store(0, std::memory_order_relaxed);
+      running_workers = workers.size();
+      generation++;
+    }
+    wake.notify_all();
+
+    run_tasks(0);
+
+    std::unique_lock<std::mutex> lock(mutex);
+    done.wait(lock, [this] { return running_workers == 0; });
+    current_task = nullptr;
+    if (error) std::rethrow_exception(std::exchange(error, nullptr));
+  }
+
+ private:
+  // Instance variables
+  std::vector<std::thread> workers;
+
+  std::mutex run_mutex;
+  std::mutex mutex;
+  std::condition_variable wake;
+  std::condition_variable done;
+
+  std::function<void(std::size_t, std::size_t)> current_task;
+  std::size_t total_tasks = 0;
+  std::atomic<std::size_t> next_task { 0 };
+  std::size_t running_workers = 0;
+  std::size_t generation = 0;
+  std::exception_ptr error;
+  bool stopping = false;
+
+  // Concrete methods
+  void run_tasks(std::size_t worker) noexcept {
+    for (auto i = next_task.fetch_add(1, std::memory_order_relaxed);
+         i < total_tasks;
+         i = next_task.fetch_add(1, std::memory_order_relaxed)) {
+      try {
+        current_task(i, worker);
+      } catch (...) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!error) error = std::current_exception();
+        next_task.store(total_tasks, std::memory_order_relaxed);
+      }
+    }
+  }
+
+  void work(std::size_t worker) {
+    std::size_t seen_generation = 0;
+    while (true) {
+      {
+        std::unique_lock<std::mutex> lock(mutex);
+        wake.wait(lock, [&] {
+          return stopping || generation != seen_generation;
+        });
+        if (stopping) return;
+        seen_generation = generation;
+      }
+
+      run_tasks(worker);
+
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        running_workers--;
+      }
+      done.notify_one();
+    }
+  }
+};
+
+/*----------------------------------------------------------------------------*/
+
+/**
+ * Thread pool used by the parallel execution policies, with one thread
+ * per core, created on first use.
+ */
+inline ThreadPool& default_thread_pool() {
+  static ThreadPool pool;
+  return pool;
+}
+
+/*----------------------------------------------------------------------------*/
+/*                                   REDUCE                                   */
+/*----------------------------------------------------------------------------*/
+
+namespace detail {
+
+template<typename T, typename M>
+T log_reduce(ThreadPool& pool, const T* values, std::size_t size) {
+  constexpr std::size_t min_chunk_size = 1 << 16;
+
+  auto chunks = std::clamp<std::size_t>(size / min_chunk_size, 1, pool.size());
+  if (chunks == 1) return log_sum<T, M>(values, size);
+  auto chunk_size = (size + chunks - 1) / chunks;
+
+  auto chunk = [&](std::size_t i) {
+    auto begin = std::min(i * chunk_size, size);
+    auto end = std::min(begin + chunk_size, size);
+    return std::make_pair(values + begin, end - begin);
+  };
+
+  if constexpr (is_max_math_v<M>) {
+    std::vector<T> partials(chunks);
+    pool.for_each(chunks, [&](std::size_t i) {
+      auto [chunk_values, chunk_length] = chunk(i);
+      partials[i] = log_max(chunk_values, chunk_length);
+    });
+    return log_max(partials.data(), chunks);
+  } else {
+    std::vector<LogAccumulator<T>> partials(chunks);
+    pool.for_each(chunks, [&](std::size_t i) {
+      auto [chunk_values, chunk_length] = chunk(i);
+      partials[i].add(chunk_values, chunk_length);
+    });
+    for (std::size_t i = 1; i < chunks; i++) partials[0] += partials[i];
+    return partials[0].data();
+  }
+}
+
+}  // namespace detail
+
+/*----------------------------------------------------------------------------*/
+
+/**
+ * Sums a contiguous range of LogFloatingPoint in parallel: each task
+ * accumulates a chunk with a local max-shifted sum (see LogAccumulator),
+ * and the partial sums are merged in the calling thread (or with maximums,
+ * for MaxMath). Small ranges are summed with sum(first, last) by the
+ * calling thread only.
+ */
+template<typename T, std::size_t ulp, typename C, typename M>
+LogFloatingPoint<T, ulp, C, M> reduce(
+    ThreadPool& pool,
+    const LogFloatingPoint<T, ulp, C, M>* first,
+    const LogFloatingPoint<T, ulp, C, M>* last) {
+  assert(first <= last);
+  auto size = static_cast<std::size_t>(last - first);
+  return LogFloatingPoint<T, ulp, C, M>::from_log(
+      detail::log_reduce<T, M>(pool, detail::raw_data(first), size));
+}
+
+/*----------------------------------------------------------------------------*/
+
+/**
+ * Sums a contiguous range of LogFloatingPoint with a standard execution
+ * policy: sequenced policies use sum(first, last) in the calling thread,
+ * while parallel policies use the default thread pool.
+ */
+template<typename ExecutionPolicy, typename T, std::size_t ulp,
+  typename C, typename M,
+  typename std::enable_if_t<std::is_execution_policy_v<
+    std::decay_t<ExecutionPolicy>>, void>* = nullptr>
+LogFloatingPoint<T, ulp, C, M> reduce(
+    ExecutionPolicy&& /* policy */,
+    const LogFloatingPoint<T, ulp, C, M>* first,
+    const LogFloatingPoint<T, ulp, C, M>* last) {
+  using Policy = std::decay_t<ExecutionPolicy>;
+  if constexpr (std::is_same_v<Policy, std::execution::sequenced_policy>) {
+    return sum(first, last);
+  } else {
+    return reduce(default_thread_pool(), first, last);
+  }
+}
+
+/*----------------------------------------------------------------------------*/
+
+template<typename Executor, typename Container,
+  typename VT = typename Container::value_type,
+  typename std::enable_if_t<is_log_floating_point_v<VT>, void>* = nullptr>
+VT reduce(Executor&& executor, const Container& container) {
+  const VT* first = std::data(container);
+  return reduce(std::forward<Executor>(executor),
+                first, first + std::size(container));
+}
+
+/*----------------------------------------------------------------------------*/
+
+/**
+ * Sums a LogVector (which stores raw logarithms) with a thread pool or
+ * a standard execution policy, like the reductions of ranges above.
+ */
+template<typename Executor, typename T, std::size_t ulp,
+  typename C, typename M>
+LogFloatingPoint<T, ulp, C, M> reduce(
+    Executor&& executor, const LogVector<T, ulp, C, M>& vector) {
+  using Policy = std::decay_t<Executor>;
+  if constexpr (std::is_same_v<Policy, std::execution::sequenced_policy>) {
+    return sum(vector);
+  } else if constexpr (std::is_execution_policy_v<Policy>) {
+    return reduce(default_thread_pool(), vector);
+  } else {
+    return LogFloatingPoint<T, ulp, C, M>::from_log(
+        detail::log_reduce<T, M>(executor, vector.data(), vector.size()));
+  }
+}
+
+/*----------------------------------------------------------------------------*/
+
+}  // namespace probability
+
+#endif  // PROBABILITY_PARALLEL_
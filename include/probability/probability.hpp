@@ -20,9 +20,14 @@
 #define PROBABILITY_PROBABILITY_
 
 // Standard headers
+#include <array>
+#include <atomic>
 #include <cmath>
+#include <cstdint>
+#include <cstring>
 #include <functional>
 #include <limits>
+#include <mutex>
 #include <cassert>
 #include <algorithm>
 #include <type_traits>
@@ -39,8 +44,18 @@ namespace probability {
 
 template<typename T> class EmptyChecker;
 template<typename T, std::size_t ulp> class ProbabilityChecker;
+template<typename T, std::size_t ulp> class CountingChecker;
 
-template<typename T, std::size_t ulp = 0, typename C = EmptyChecker<T>>
+template<typename T> class StandardMath;
+template<typename T> class BranchFreeMath;
+template<typename T> class FastMath;
+template<typename T, std::size_t degree = 1> class TableMath;
+template<typename T> class MaxMath;
+
+template<typename T> class LogThreshold;
+
+template<typename T, std::size_t ulp = 0, typename C = EmptyChecker<T>,
+         typename M = StandardMath<T>>
 class LogFloatingPoint;
 
 /*----------------------------------------------------------------------------*/
@@ -50,8 +65,9 @@ class LogFloatingPoint;
 template<typename, typename = std::void_t<>>
 struct is_log_floating_point : std::false_type {};
 
-template<typename T, std::size_t ulp, typename C>
-struct is_log_floating_point<LogFloatingPoint<T, ulp, C>> : std::true_type {};
+template<typename T, std::size_t ulp, typename C, typename M>
+struct is_log_floating_point<LogFloatingPoint<T, ulp, C, M>>
+  : std::true_type {};
 
 template<typename Container>
 struct is_log_floating_point<
@@ -65,12 +81,663 @@ struct is_log_floating_point<
       Container,
       LogFloatingPoint<typename Container::value_type::value_type,
                        Container::value_type::ULP,
-                       typename Container::value_type::checker_type>
+                       typename Container::value_type::checker_type,
+                       typename Container::value_type::math_type>
     > {};
 
 template<typename... Args>
 constexpr bool is_log_floating_point_v = is_log_floating_point<Args...>::value;
 
+/*----------------------------------------------------------------------------*/
+
+template<typename M>
+struct is_max_math : std::false_type {};
+
+template<typename T>
+struct is_max_math<MaxMath<T>> : std::true_type {};
+
+template<typename M>
+constexpr bool is_max_math_v = is_max_math<M>::value;
+
+/*----------------------------------------------------------------------------*/
+
+template<typename Value, typename T>
+struct is_raw_comparable
+  : std::bool_constant<std::is_convertible_v<Value, T>
+                       || std::is_same_v<Value, LogThreshold<T>>> {};
+
+template<typename Value, typename T>
+constexpr bool is_raw_comparable_v = is_raw_comparable<Value, T>::value;
+
+/*----------------------------------------------------------------------------*/
+
+namespace detail {
+
+template<typename T>
+constexpr T pow2(std::size_t exponent) {
+  T result = 1;
+  for (std::size_t i = 0; i < exponent; i++) result *= 2;
+  return result;
+}
+
+/**
+ * Minimum units in the last place such that epsilon * 2^ulp >= error.
+ */
+template<typename T>
+constexpr std::size_t required_ulp(T error) {
+  std::size_t ulp = 0;
+  while (std::numeric_limits<T>::epsilon() * pow2<T>(ulp) < error) ulp++;
+  return ulp;
+}
+
+/*----------------------------------------------------------------------------*/
+
+/**
+ * Exponential that can be evaluated at compile time, reducing the argument
+ * to |r| <= ln(2)/2 and summing its Taylor series in long double.
+ */
+constexpr long double constexpr_exp(long double x) {
+  constexpr long double ln2 = 0.693147180559945309417232121458176568L;
+
+  if (x != x) return x;
+  if (x == std::numeric_limits<long double>::infinity()) return x;
+  if (x == -std::numeric_limits<long double>::infinity()) return 0;
+
+  long double n = static_cast<long long>(x / ln2 + (x < 0 ? -0.5L : 0.5L));
+  long double r = x - n * ln2;
+
+  long double sum = 1, term = 1;
+  for (int k = 1; term > std::numeric_limits<long double>::epsilon() * sum
+                  || -term > std::numeric_limits<long double>::epsilon() * sum;
+       k++) {
+    term *= r / k;
+    sum += term;
+  }
+
+  for (; n > 0; n--) sum *= 2;
+  for (; n < 0; n++) sum /= 2;
+  return sum;
+}
+
+/**
+ * Logarithm of 1 + y, for y > -1, that can be evaluated at compile time,
+ * summing the series of 2 * atanh(y / (2 + y)) in long double.
+ */
+constexpr long double constexpr_log1p(long double y) {
+  long double s = y / (2 + y), s2 = s * s;
+
+  long double sum = 0, power = s;
+  for (int k = 1; power * power > std::numeric_limits<long double>::epsilon()
+                                  * std::numeric_limits<long double>::epsilon()
+                                  * sum * sum;
+       k += 2) {
+    sum += power / k;
+    power *= s2;
+  }
+  return 2 * sum;
+}
+
+/**
+ * Natural logarithm that can be evaluated at compile time, reducing the
+ * argument to m * 2^e with m in [1, 2) and using constexpr_log1p(m - 1).
+ */
+constexpr long double constexpr_log(long double x) {
+  constexpr long double ln2 = 0.693147180559945309417232121458176568L;
+  constexpr long double two_64 = 18446744073709551616.0L;
+
+  if (x != x || x < 0) return std::numeric_limits<long double>::quiet_NaN();
+  if (x == 0) return -std::numeric_limits<long double>::infinity();
+  if (x == std::numeric_limits<long double>::infinity()) return x;
+
+  long double e = 0;
+  for (; x >= two_64; e += 64) x /= two_64;
+  for (; x < 1 / two_64; e -= 64) x *= two_64;
+  for (; x >= 2; e++) x /= 2;
+  for (; x < 1; e--) x *= 2;
+
+  return e * ln2 + constexpr_log1p(x - 1);
+}
+
+/**
+ * Whether the call is evaluated at compile time, so that math types can
+ * use the functions above instead of the (not constexpr) standard library.
+ */
+constexpr bool is_constant_evaluated() noexcept {
+#if defined(__has_builtin)
+#  if __has_builtin(__builtin_is_constant_evaluated)
+#    define PROBABILITY_CONSTANT_EVALUATED
+#  endif
+#elif defined(__GNUC__) && __GNUC__ >= 9
+#  define PROBABILITY_CONSTANT_EVALUATED
+#endif
+#ifdef PROBABILITY_CONSTANT_EVALUATED
+#  undef PROBABILITY_CONSTANT_EVALUATED
+  return __builtin_is_constant_evaluated();
+#else
+  return false;
+#endif
+}
+
+/*----------------------------------------------------------------------------*/
+
+template<typename T>
+struct ieee754_traits;
+
+template<>
+struct ieee754_traits<float> {
+  using bits_type = std::uint32_t;
+  static constexpr int mantissa = 23;
+  static constexpr bits_type bias = 127;
+  static constexpr int degree = 7;
+  static constexpr float lowest_exponent = -88.0296919f;  // -127 ln2
+};
+
+template<>
+struct ieee754_traits<double> {
+  using bits_type = std::uint64_t;
+  static constexpr int mantissa = 52;
+  static constexpr bits_type bias = 1023;
+  static constexpr int degree = 13;
+  static constexpr double lowest_exponent = -709.089565712824;  // -1023 ln2
+};
+
+template<typename T, typename = std::void_t<>>
+struct has_ieee754_traits : std::false_type {};
+
+template<typename T>
+struct has_ieee754_traits<T, std::void_t<decltype(ieee754_traits<T>::degree)>>
+  : std::true_type {};
+
+template<typename T>
+constexpr bool has_ieee754_traits_v = has_ieee754_traits<T>::value;
+
+/*----------------------------------------------------------------------------*/
+
+/**
+ * Branch-free exponential for x <= 0 (or NaN, considered -infinity), using
+ * a Taylor polynomial of the given degree (the default is accurate to about
+ * 1 ulp). It is written with plain arithmetic and bit casts only, so that
+ * loops calling it are auto-vectorized by the compiler (unlike std::exp).
+ */
+template<typename T, int degree = ieee754_traits<T>::degree>
+[[gnu::always_inline]] inline T vectorizable_exp(T x) noexcept {
+  using traits = ieee754_traits<T>;
+  using bits_type = typename traits::bits_type;
+
+  static_assert(degree > 0 && degree <= 13, "Unsupported polynomial degree");
+
+  constexpr T log2e = static_cast<T>(1.44269504088896340736);
+  constexpr T ln2_hi = static_cast<T>(0.693145751953125);
+  constexpr T ln2_lo = static_cast<T>(1.42860682030941723212e-6);
+  constexpr T shifter
+    = static_cast<T>(1.5) * static_cast<T>(bits_type(1) << traits::mantissa);
+  constexpr T inverse_factorials[] = {
+    static_cast<T>(1.0),
+    static_cast<T>(1.0),
+    static_cast<T>(1.0 / 2),
+    static_cast<T>(1.0 / 6),
+    static_cast<T>(1.0 / 24),
+    static_cast<T>(1.0 / 120),
+    static_cast<T>(1.0 / 720),
+    static_cast<T>(1.0 / 5040),
+    static_cast<T>(1.0 / 40320),
+    static_cast<T>(1.0 / 362880),
+    static_cast<T>(1.0 / 3628800),
+    static_cast<T>(1.0 / 39916800),
+    static_cast<T>(1.0 / 479001600),
+    static_cast<T>(1.0 / 6227020800),
+  };
+
+  // Clamp: anything below becomes exactly zero (the scale computed at the
+  // lowest exponent has all bits zeroed), and NaN (from -infinity minus
+  // -infinity) is treated as -infinity.
+  // For non-positive values, a bigger bit pattern means a smaller value,
+  // and an integer minimum does not stop vectorization with trapping math
+  // (as a floating point select would)
+  constexpr T lowest = traits::lowest_exponent;
+  constexpr T infinity = std::numeric_limits<T>::infinity();
+  constexpr bits_type sign_bit = bits_type(1) << (sizeof(T) * 8 - 1);
+  bits_type x_bits, lowest_bits, infinity_bits;
+  std::memcpy(&x_bits, &x, sizeof(T));
+  std::memcpy(&lowest_bits, &lowest, sizeof(T));
+  std::memcpy(&infinity_bits, &infinity, sizeof(T));
+  bits_type nan_mask = bits_type(0) - ((x_bits & ~sign_bit) > infinity_bits);
+  x_bits = std::min<bits_type>(x_bits | nan_mask, lowest_bits);
+  std::memcpy(&x, &x_bits, sizeof(T));
+
+  // Range reduction: x = n * ln(2) + r, with |r| <= ln(2)/2
+  T t = x * log2e + shifter;
+  T n = t - shifter;
+  T r = x - n * ln2_hi;
+  r = r - n * ln2_lo;
+
+  // Taylor polynomial for exp(r)
+  T p = inverse_factorials[degree];
+  for (int k = degree - 1; k >= 0; k--)
+    p = p * r + inverse_factorials[k];
+
+  // Scale by 2^n, reading n from the low bits of the shifted value
+  bits_type n_bits;
+  std::memcpy(&n_bits, &t, sizeof(T));
+  bits_type scale_bits = (n_bits + traits::bias) << traits::mantissa;
+  T scale;
+  std::memcpy(&scale, &scale_bits, sizeof(T));
+
+  return p * scale;
+}
+
+/*----------------------------------------------------------------------------*/
+
+/**
+ * Branch-free log1p for 0 <= y <= 1 (the range needed by the log-sum-exp),
+ * accurate to about 3 ulp. It reduces 1 + y to m * 2^e with m in
+ * [sqrt(2)/2, sqrt(2)), evaluates the atanh series of log(m), and corrects
+ * for the rounding of 1 + y, so that it is still exact for tiny values of y.
+ * Like vectorizable_exp, loops calling it are auto-vectorized.
+ */
+template<typename T>
+[[gnu::always_inline]] inline T vectorizable_log1p(T y) noexcept {
+  using traits = ieee754_traits<T>;
+  using bits_type = typename traits::bits_type;
+
+  constexpr T one = 1;
+  constexpr T sqrt2 = static_cast<T>(1.41421356237309504880);
+  constexpr T ln2_hi = static_cast<T>(0.693145751953125);
+  constexpr T ln2_lo = static_cast<T>(1.42860682030941723212e-6);
+  constexpr int terms = std::numeric_limits<T>::digits > 24 ? 10 : 5;
+
+  T u = one + y;
+  T c = (u - one) - y;
+
+  // Halve 1 + y (and set e = 1) when above sqrt(2), with integer operations
+  bits_type u_bits, one_bits, sqrt2_bits;
+  std::memcpy(&u_bits, &u, sizeof(T));
+  std::memcpy(&one_bits, &one, sizeof(T));
+  std::memcpy(&sqrt2_bits, &sqrt2, sizeof(T));
+  bits_type above = u_bits > sqrt2_bits;
+  bits_type m_bits = u_bits - (above << traits::mantissa);
+  bits_type e_bits = (bits_type(0) - above) & one_bits;
+  T m, e;
+  std::memcpy(&m, &m_bits, sizeof(T));
+  std::memcpy(&e, &e_bits, sizeof(T));
+
+  // log(m) = 2 atanh(s) = 2 (s + s^3/3 + s^5/5 + ...), with |s| < 0.172
+  T s = (m - one) / (m + one);
+  T s2 = s * s;
+  T p = one / (2 * terms - 1);
+  for (int k = terms - 2; k >= 0; k--)
+    p = p * s2 + one / (2 * k + 1);
+
+  return e * ln2_hi + (2 * s * p + (e * ln2_lo - c / u));
+}
+
+}  // namespace detail
+
+/*----------------------------------------------------------------------------*/
+/*                                STANDARD MATH                               */
+/*----------------------------------------------------------------------------*/
+
+/**
+ * @class StandardMath
+ * @brief Implements operations in LogFloatingPoint with the standard library
+ */
+template<typename T>
+class StandardMath {
+ public:
+  // Aliases
+  using value_type = T;
+
+  // Static variables
+  static constexpr value_type max_error = 0;
+
+  // Concrete methods
+  static constexpr value_type log(value_type v) noexcept {
+    if (detail::is_constant_evaluated())
+      return static_cast<value_type>(detail::constexpr_log(v));
+    return std::log(v);
+  }
+
+  static constexpr value_type exp(value_type value) noexcept {
+    if (detail::is_constant_evaluated())
+      return static_cast<value_type>(detail::constexpr_exp(value));
+    return std::exp(value);
+  }
+
+  static constexpr value_type add(value_type lhs, value_type rhs) noexcept {
+    if (rhs == -infinity) {
+      return lhs;  // summing with 0
+    } else if (lhs == -infinity) {
+      return rhs;  // probability is 0: just attributes
+    } else if (lhs >= rhs) {
+      return lhs + log1p(exp(rhs - lhs));
+    } else {
+      return rhs + log1p(exp(lhs - rhs));
+    }
+  }
+
+  static constexpr value_type subtract(value_type lhs,
+                                       value_type rhs) noexcept {
+    return lhs + log1p(-exp(rhs - lhs));
+  }
+
+ private:
+  // Static variables
+  static constexpr auto infinity
+    = std::numeric_limits<value_type>::infinity();
+
+  // Concrete methods
+  static constexpr value_type log1p(value_type v) noexcept {
+    if (detail::is_constant_evaluated())
+      return static_cast<value_type>(detail::constexpr_log1p(v));
+    return std::log1p(v);
+  }
+};
+
+/*----------------------------------------------------------------------------*/
+/*                              BRANCH-FREE MATH                              */
+/*----------------------------------------------------------------------------*/
+
+/**
+ * @class BranchFreeMath
+ * @brief Implements sums in LogFloatingPoint without branches
+ *
+ * Sums calculate max + log1p(exp(min - max)) with no special cases for
+ * zeros: if any value is -infinity, the exponential is 0 (and, if both
+ * are, the difference is NaN, which vectorizable_exp also maps to 0), so
+ * the result is max. With no branches to mispredict, mixed data is summed
+ * at a constant cost, and loops of sums are auto-vectorized. The result
+ * has an absolute error of at most max_error in log space (i.e., a
+ * relative error of max_error in linear space).
+ */
+template<typename T>
+class BranchFreeMath {
+ public:
+  // Aliases
+  using value_type = T;
+
+  // Static variables
+  static constexpr value_type max_error
+    = 4 * std::numeric_limits<value_type>::epsilon();
+  static constexpr std::size_t ulp = detail::required_ulp(max_error);
+
+  // Concrete methods
+  static value_type log(value_type v) noexcept {
+    return std::log(v);
+  }
+
+  static value_type exp(value_type value) noexcept {
+    return std::exp(value);
+  }
+
+  static value_type add(value_type lhs, value_type rhs) noexcept {
+    value_type max = lhs > rhs ? lhs : rhs;
+    value_type min = lhs > rhs ? rhs : lhs;
+    return max + detail::vectorizable_log1p(
+        detail::vectorizable_exp(min - max));
+  }
+
+  static value_type subtract(value_type lhs, value_type rhs) noexcept {
+    return lhs + std::log1p(-std::exp(rhs - lhs));
+  }
+
+ private:
+  // Validation
+  static_assert(std::is_same_v<value_type, float>
+                || std::is_same_v<value_type, double>,
+      "BranchFreeMath is only available for float and double");
+};
+
+/*----------------------------------------------------------------------------*/
+/*                                  FAST MATH                                 */
+/*----------------------------------------------------------------------------*/
+
+/**
+ * @class FastMath
+ * @brief Implements sums in LogFloatingPoint with branch-free polynomials
+ *
+ * Sums calculate log1p(exp(-d)) with a Chebyshev approximation of log1p
+ * over a polynomial exponential, avoiding calls to the standard library.
+ * The result has an absolute error of at most max_error in log space
+ * (i.e., a relative error of max_error in linear space), which requires
+ * LogFloatingPoint to have at least FastMath::ulp units in the last place.
+ * Loops of sums are auto-vectorized by the compiler.
+ */
+template<typename T>
+class FastMath {
+ public:
+  // Aliases
+  using value_type = T;
+
+  // Static variables
+  static constexpr value_type max_error
+    = std::is_same_v<value_type, float> ? 5e-7 : 5e-8;
+  static constexpr std::size_t ulp = detail::required_ulp(max_error);
+
+  // Concrete methods
+  static value_type log(value_type v) noexcept {
+    return std::log(v);
+  }
+
+  static value_type exp(value_type value) noexcept {
+    return std::exp(value);
+  }
+
+  static value_type add(value_type lhs, value_type rhs) noexcept {
+    value_type max = lhs > rhs ? lhs : rhs;
+    value_type difference = -std::fabs(lhs - rhs);
+
+    // Chebyshev approximation of log1p(y) for y in [0, 1]
+    constexpr value_type coefficients[] = {
+      static_cast<value_type>(0.9999987830867029),
+      static_cast<value_type>(-0.4999589446840716),
+      static_cast<value_type>(0.3327853379919084),
+      static_cast<value_type>(-0.24618967714116954),
+      static_cast<value_type>(0.18421386340631934),
+      static_cast<value_type>(-0.12447194534794602),
+      static_cast<value_type>(0.06573552528789861),
+      static_cast<value_type>(-0.022628007046219523),
+      static_cast<value_type>(0.0036622421777792627),
+    };
+
+    // If any value is zero (-infinity), the exponential is clamped to
+    // (almost) 0, which keeps max unchanged (even if it is also -infinity)
+    value_type y
+      = detail::vectorizable_exp<value_type, exp_degree>(difference);
+
+    value_type p = coefficients[8];
+    for (int k = 7; k >= 0; k--) p = p * y + coefficients[k];
+
+    return max + p * y;
+  }
+
+  static value_type subtract(value_type lhs, value_type rhs) noexcept {
+    return lhs + std::log1p(-std::exp(rhs - lhs));
+  }
+
+ private:
+  // Validation
+  static_assert(std::is_same_v<value_type, float>
+                || std::is_same_v<value_type, double>,
+      "FastMath is only available for float and double");
+
+  // Static variables
+  static constexpr auto infinity
+    = std::numeric_limits<value_type>::infinity();
+
+  static constexpr int exp_degree
+    = std::is_same_v<value_type, float> ? 6 : 7;
+};
+
+/*----------------------------------------------------------------------------*/
+/*                                 TABLE MATH                                 */
+/*----------------------------------------------------------------------------*/
+
+namespace detail {
+
+/**
+ * Table of log1p(exp(-d)) for d in [0, cutoff), generated at compile time.
+ * Each segment of width 1/resolution stores the coefficients of a polynomial
+ * of the given degree in the local coordinate u in [0, 1): a chord for
+ * degree 1 (linear interpolation) or a Hermite cubic for degree 3.
+ */
+template<typename T, std::size_t degree>
+struct log1p_exp_table {
+  // Validation
+  static_assert(degree == 1 || degree == 3,
+      "Only linear and cubic interpolations are supported");
+
+  // Static variables
+  static constexpr std::size_t cutoff
+    = std::is_same_v<T, float> ? 18 : 38;
+  static constexpr std::size_t resolution = degree == 1 ? 256 : 16;
+  static constexpr std::size_t size = cutoff * resolution;
+
+  // Aliases
+  using segment_type = std::array<T, degree + 1>;
+  using segments_type = std::array<segment_type, size>;
+
+  // Static methods
+  static constexpr segments_type make_segments() {
+    segments_type segments {};
+
+    long double h = 1.0L / resolution;
+    long double step = constexpr_exp(-h);
+
+    long double y0 = 1;  // exp(-d), for d at the start of each segment
+    long double f0 = constexpr_log1p(y0);
+    for (std::size_t i = 0; i < size; i++) {
+      long double y1 = y0 * step;
+      long double f1 = constexpr_log1p(y1);
+
+      if constexpr (degree == 1) {
+        segments[i][0] = static_cast<T>(f0);
+        segments[i][1] = static_cast<T>(f1 - f0);
+      } else {
+        // Derivatives of log1p(exp(-d)), scaled to the local coordinate
+        long double g0 = -h * y0 / (1 + y0);
+        long double g1 = -h * y1 / (1 + y1);
+        segments[i][0] = static_cast<T>(f0);
+        segments[i][1] = static_cast<T>(g0);
+        segments[i][2] = static_cast<T>(3 * (f1 - f0) - 2 * g0 - g1);
+        segments[i][3] = static_cast<T>(2 * (f0 - f1) + g0 + g1);
+      }
+
+      y0 = y1;
+      f0 = f1;
+    }
+
+    return segments;
+  }
+
+  static constexpr segments_type segments = make_segments();
+};
+
+}  // namespace detail
+
+/*----------------------------------------------------------------------------*/
+
+/**
+ * @class TableMath
+ * @brief Implements sums in LogFloatingPoint with a precomputed table
+ *
+ * Sums calculate log1p(exp(-d)) by interpolating a table generated at
+ * compile time: with linear interpolation (degree 1), each sum is one load
+ * and one multiply-add; with cubic interpolation (degree 3), it takes three
+ * multiply-adds but the table is 16 times smaller (fitting in L1 cache).
+ * For d past the cutoff, the term is negligible and the maximum is kept.
+ * The result has an absolute error of at most max_error in log space,
+ * which requires LogFloatingPoint to have at least TableMath::ulp units
+ * in the last place.
+ */
+template<typename T, std::size_t degree>
+class TableMath {
+ public:
+  // Aliases
+  using value_type = T;
+
+  // Static variables
+  static constexpr value_type max_error
+    = degree == 1 ? 6e-7 : (std::is_same_v<value_type, float> ? 3e-7 : 1e-8);
+  static constexpr std::size_t ulp = detail::required_ulp(max_error);
+
+  // Concrete methods
+  static value_type log(value_type v) noexcept {
+    return std::log(v);
+  }
+
+  static value_type exp(value_type value) noexcept {
+    return std::exp(value);
+  }
+
+  static value_type add(value_type lhs, value_type rhs) noexcept {
+    value_type max = lhs > rhs ? lhs : rhs;
+    value_type difference = std::fabs(lhs - rhs);
+
+    // Also true when a value is zero (-infinity), as the difference is
+    // either infinity or NaN (if both are -infinity)
+    if (!(difference < table::cutoff)) return max;
+
+    value_type position = difference * table::resolution;
+    auto index = static_cast<std::size_t>(position);
+    value_type u = position - static_cast<value_type>(index);
+
+    const auto& coefficients = table::segments[index];
+    value_type p = coefficients[degree];
+    for (std::size_t k = degree; k > 0; k--) p = p * u + coefficients[k-1];
+
+    return max + p;
+  }
+
+  static value_type subtract(value_type lhs, value_type rhs) noexcept {
+    return lhs + std::log1p(-std::exp(rhs - lhs));
+  }
+
+ private:
+  // Validation
+  static_assert(std::is_same_v<value_type, float>
+                || std::is_same_v<value_type, double>,
+      "TableMath is only available for float and double");
+
+  // Aliases
+  using table = detail::log1p_exp_table<value_type, degree>;
+};
+
+/*----------------------------------------------------------------------------*/
+/*                                  MAX MATH                                  */
+/*----------------------------------------------------------------------------*/
+
+/**
+ * @class MaxMath
+ * @brief Implements sums in LogFloatingPoint as maximums, turning it into
+ *        the max-product (Viterbi) semiring
+ *
+ * Sums are a single comparison, while products, divisions, comparisons
+ * and checkers are the same as with the other math types. Subtractions
+ * are not defined in this semiring, and do not compile.
+ */
+template<typename T>
+class MaxMath {
+ public:
+  // Aliases
+  using value_type = T;
+
+  // Static variables
+  static constexpr value_type max_error = 0;
+
+  // Concrete methods
+  static constexpr value_type log(value_type v) noexcept {
+    return StandardMath<value_type>::log(v);
+  }
+
+  static constexpr value_type exp(value_type value) noexcept {
+    return StandardMath<value_type>::exp(value);
+  }
+
+  static constexpr value_type add(value_type lhs, value_type rhs) noexcept {
+    return lhs > rhs ? lhs : rhs;
+  }
+};
+
 /*----------------------------------------------------------------------------*/
 /*                                  ALIASES                                   */
 /*----------------------------------------------------------------------------*/
@@ -88,6 +755,81 @@ using probability_long_double_t = Probability<long double>;
 
 using probability_t = probability_double_t;
 
+template<typename T, std::size_t ulp = BranchFreeMath<T>::ulp>
+using BranchFreeLogFloatingPoint
+  = LogFloatingPoint<T, ulp, EmptyChecker<T>, BranchFreeMath<T>>;
+
+using branch_free_log_float_t = BranchFreeLogFloatingPoint<float>;
+using branch_free_log_double_t = BranchFreeLogFloatingPoint<double>;
+
+template<typename T, std::size_t ulp = BranchFreeMath<T>::ulp>
+using BranchFreeProbability
+  = LogFloatingPoint<T, ulp, ProbabilityChecker<T, ulp>, BranchFreeMath<T>>;
+
+using branch_free_probability_float_t = BranchFreeProbability<float>;
+using branch_free_probability_double_t = BranchFreeProbability<double>;
+
+using branch_free_probability_t = branch_free_probability_double_t;
+
+template<typename T, std::size_t ulp = FastMath<T>::ulp>
+using FastLogFloatingPoint
+  = LogFloatingPoint<T, ulp, EmptyChecker<T>, FastMath<T>>;
+
+using fast_log_float_t = FastLogFloatingPoint<float>;
+using fast_log_double_t = FastLogFloatingPoint<double>;
+
+template<typename T, std::size_t ulp = FastMath<T>::ulp>
+using FastProbability
+  = LogFloatingPoint<T, ulp, ProbabilityChecker<T, ulp>, FastMath<T>>;
+
+using fast_probability_float_t = FastProbability<float>;
+using fast_probability_double_t = FastProbability<double>;
+
+using fast_probability_t = fast_probability_double_t;
+
+template<typename T, std::size_t ulp = TableMath<T>::ulp>
+using TableLogFloatingPoint
+  = LogFloatingPoint<T, ulp, EmptyChecker<T>, TableMath<T>>;
+
+using table_log_float_t = TableLogFloatingPoint<float>;
+using table_log_double_t = TableLogFloatingPoint<double>;
+
+template<typename T, std::size_t ulp = TableMath<T>::ulp>
+using TableProbability
+  = LogFloatingPoint<T, ulp, ProbabilityChecker<T, ulp>, TableMath<T>>;
+
+using table_probability_float_t = TableProbability<float>;
+using table_probability_double_t = TableProbability<double>;
+
+using table_probability_t = table_probability_double_t;
+
+template<typename T, std::size_t ulp = 0>
+using MaxLogFloatingPoint
+  = LogFloatingPoint<T, ulp, EmptyChecker<T>, MaxMath<T>>;
+
+using max_log_float_t = MaxLogFloatingPoint<float>;
+using max_log_double_t = MaxLogFloatingPoint<double>;
+using max_log_long_double_t = MaxLogFloatingPoint<long double>;
+
+template<typename T, std::size_t ulp = 0>
+using MaxProbability
+  = LogFloatingPoint<T, ulp, ProbabilityChecker<T, ulp>, MaxMath<T>>;
+
+using max_probability_float_t = MaxProbability<float>;
+using max_probability_double_t = MaxProbability<double>;
+using max_probability_long_double_t = MaxProbability<long double>;
+
+using max_probability_t = max_probability_double_t;
+
+template<typename T, std::size_t ulp = 0>
+using CountingProbability = LogFloatingPoint<T, ulp, CountingChecker<T, ulp>>;
+
+using counting_probability_float_t = CountingProbability<float>;
+using counting_probability_double_t = CountingProbability<double>;
+using counting_probability_long_double_t = CountingProbability<long double>;
+
+using counting_probability_t = counting_probability_double_t;
+
 /*----------------------------------------------------------------------------*/
 /*                             LOG FLOATING POINT                             */
 /*----------------------------------------------------------------------------*/
@@ -97,19 +839,26 @@ using probability_t = probability_double_t;
  * @tparam T Value type, used for internal store
  * @tparam ulp Units in the last place, defining the accuracy
  * @tparam C Checker type, used to inject methods that verify consistency
+ * @tparam M Math type, used to implement logarithms, exponentials and sums
  * @brief Fast implementation of floats using logarithms
+ *
+ * Construction and arithmetic are constexpr with StandardMath and MaxMath
+ * (and the empty and probability checkers), so constants can be defined
+ * at compile time, e.g.:
+ *   constexpr probability_t transition = 0.25;
  */
-template<typename T, std::size_t ulp, typename C>
+template<typename T, std::size_t ulp, typename C, typename M>
 class LogFloatingPoint {
  public:
   using value_type = T;
   using checker_type = C;
+  using math_type = M;
   static constexpr size_t ULP = ulp;
 
   // Constructors
   LogFloatingPoint() = default;
 
-  LogFloatingPoint(value_type v) : value(std::log(v)) {
+  constexpr LogFloatingPoint(value_type v) : value(math_type::log(v)) {
     assert(v >= 0.0);
     check_initial_value(v);
   }
@@ -117,37 +866,53 @@ class LogFloatingPoint {
   template<typename Value,
     typename std::enable_if_t<
       std::is_convertible_v<Value, value_type>, void>* = nullptr>
-  LogFloatingPoint(const Value& v)
+  constexpr LogFloatingPoint(const Value& v)
       : LogFloatingPoint(static_cast<const value_type&>(v)) {
   }
 
-  template<typename RhsT, std::size_t RhsUlp, typename RhsC>
-  LogFloatingPoint(const LogFloatingPoint<RhsT, RhsUlp, RhsC>& v)
-      : value(v.data()) {
+  template<typename RhsT, std::size_t RhsUlp, typename RhsC, typename RhsM>
+  constexpr LogFloatingPoint(
+      const LogFloatingPoint<RhsT, RhsUlp, RhsC, RhsM>& v) : value(v.data()) {
     check_range();
   }
 
+  // Static methods
+
+  /**
+   * Builds a LogFloatingPoint whose logarithm is log_value, checking its
+   * range (but without the exponential and logarithm of the constructor).
+   */
+  static constexpr LogFloatingPoint from_log(value_type log_value) {
+    auto result = from_log_unchecked(log_value);
+    result.check_range();
+    return result;
+  }
+
+  /**
+   * Builds a LogFloatingPoint whose logarithm is log_value, without any
+   * checks (e.g., for values that were already checked when stored).
+   */
+  static constexpr LogFloatingPoint from_log_unchecked(
+      value_type log_value) noexcept {
+    LogFloatingPoint result;
+    result.value = log_value;
+    return result;
+  }
+
   // Operator overloads
-  explicit operator value_type() const noexcept {
-    return std::exp(value);
+  constexpr explicit operator value_type() const noexcept {
+    return math_type::exp(value);
   }
 
-  LogFloatingPoint& operator+=(const LogFloatingPoint& rhs) noexcept {
-    if (rhs.data() == -infinity) {
-      // Do nothing: summing with 0
-    } else if (value == -infinity) {
-      value = rhs.data();  // probability is 0: just attributes
-    } else if (value >= rhs.data()) {
-      value += std::log1p(std::exp(rhs.data() - value));
-      check_range();
-    } else {
-      value = rhs.data() + std::log1p(std::exp(value - rhs.data()));
-      check_range();
-    }
+  constexpr LogFloatingPoint& operator+=(
+      const LogFloatingPoint& rhs) noexcept {
+    value = math_type::add(value, rhs.data());
+    check_range();
     return *this;
   }
 
-  LogFloatingPoint& operator-=(const LogFloatingPoint& rhs) noexcept {
+  constexpr LogFloatingPoint& operator-=(
+      const LogFloatingPoint& rhs) noexcept {
     if (rhs.data() == -infinity) {
       // Do nothing: subtracting by 0
     } else if (value == -infinity) {
@@ -155,30 +920,32 @@ class LogFloatingPoint {
       assert(false);  // LCOV_EXCL_LINE (not counted due to fork() in GTest)
     } else {
       assert(value >= rhs.data());
-      value += std::log1p(-std::exp(rhs.data() - value));
+      value = math_type::subtract(value, rhs.data());
       check_range();
     }
     return *this;
   }
 
-  LogFloatingPoint& operator*=(const LogFloatingPoint& rhs) noexcept {
+  constexpr LogFloatingPoint& operator*=(
+      const LogFloatingPoint& rhs) noexcept {
     value += rhs.data();
     check_range();
     return *this;
   }
 
-  LogFloatingPoint& operator/=(const LogFloatingPoint& rhs) noexcept {
+  constexpr LogFloatingPoint& operator/=(
+      const LogFloatingPoint& rhs) noexcept {
     value -= rhs.data();
     check_range();
     return *this;
   }
 
   // Concrete methods
-  value_type& data() noexcept {
+  constexpr value_type& data() noexcept {
     return value;
   }
 
-  const value_type& data() const noexcept {
+  constexpr const value_type& data() const noexcept {
     return value;
   }
 
@@ -188,6 +955,11 @@ class LogFloatingPoint {
       "Units in the last place cannot be bigger than the maximum "
       "number of digits in the mantissa");
 
+  static_assert(math_type::max_error
+                  <= std::numeric_limits<value_type>::epsilon()
+                     * detail::pow2<value_type>(ulp),
+      "Math type is not accurate enough for the units in the last place");
+
   // Static variables
   static constexpr auto infinity
     = std::numeric_limits<value_type>::infinity();
@@ -196,22 +968,98 @@ class LogFloatingPoint {
   value_type value = -infinity;
 
   // Concrete methods
-  void check_initial_value(value_type v) {
+  constexpr void check_initial_value(value_type v) {
     checker_type::check_initial_value(v);
   }
 
-  void check_range() {
+  constexpr void check_range() {
     checker_type::check_range(value);
   }
 };
 
+/*----------------------------------------------------------------------------*/
+/*                               LOG THRESHOLD                                */
+/*----------------------------------------------------------------------------*/
+
+/**
+ * @class LogThreshold
+ * @tparam T Value type, used for internal store
+ * @brief Constant to be compared with LogFloatingPoint, whose logarithm
+ *        is calculated only once (at compile time, if it is constexpr)
+ *
+ * Comparisons between LogFloatingPoint and raw values call M::log on the
+ * raw value every time, while comparisons with a LogThreshold are a single
+ * floating point comparison, e.g.:
+ *   constexpr LogThreshold<double> threshold(1e-9);
+ *   if (p < threshold) ...
+ */
+template<typename T>
+class LogThreshold {
+ public:
+  // Aliases
+  using value_type = T;
+
+  // Constructors
+  constexpr explicit LogThreshold(value_type v)
+      : value(detail::is_constant_evaluated()
+                ? static_cast<value_type>(detail::constexpr_log(v))
+                : std::log(v)) {
+  }
+
+  // Concrete methods
+  constexpr value_type data() const noexcept {
+    return value;
+  }
+
+ private:
+  // Instance variables
+  value_type value;
+};
+
+/*----------------------------------------------------------------------------*/
+
+namespace detail {
+
+/**
+ * Logarithm of a raw value compared with a LogFloatingPoint (calculated
+ * with the math type, unless the value is a LogThreshold).
+ */
+template<typename T, typename M, typename Value>
+constexpr T log_of(const Value& value) noexcept {
+  return M::log(static_cast<const T&>(value));
+}
+
+template<typename T, typename M>
+constexpr T log_of(const LogThreshold<T>& threshold) noexcept {
+  return threshold.data();
+}
+
+/*----------------------------------------------------------------------------*/
+
+/**
+ * Raw value compared with a reference to a LogFloatingPoint (converted to
+ * its value type, unless the value is a LogThreshold).
+ */
+template<typename T, typename Value>
+constexpr T raw_operand(const Value& value) noexcept {
+  return static_cast<T>(value);
+}
+
+template<typename T>
+constexpr const LogThreshold<T>& raw_operand(
+    const LogThreshold<T>& threshold) noexcept {
+  return threshold;
+}
+
+}  // namespace detail
+
 /*----------------------------------------------------------------------------*/
 /*                                OPERATOR==                                  */
 /*----------------------------------------------------------------------------*/
 
-template<typename T, std::size_t ulp, typename C>
-inline bool operator==(const LogFloatingPoint<T, ulp, C>& lhs,
-                       const LogFloatingPoint<T, ulp, C>& rhs) noexcept {
+template<typename T, std::size_t ulp, typename C, typename M>
+constexpr bool operator==(const LogFloatingPoint<T, ulp, C, M>& lhs,
+                          const LogFloatingPoint<T, ulp, C, M>& rhs) noexcept {
   return lhs.data() == rhs.data();
 }
 
@@ -221,28 +1069,30 @@ template<typename Lhs, typename Rhs,
   typename VTLhs = typename Lhs::value_type,
   typename VTRhs = typename Rhs::value_type,
   typename std::enable_if_t<
-    is_log_floating_point_v<VTLhs> && is_log_floating_point_v<VTRhs>,
+    is_log_floating_point_v<VTLhs> && is_log_floating_point_v<VTRhs>
+      && std::is_convertible_v<Lhs, VTLhs>
+      && std::is_convertible_v<Rhs, VTRhs>,
   void>* = nullptr>
-inline bool operator==(const Lhs& lhs, const Rhs& rhs) noexcept {
+constexpr bool operator==(const Lhs& lhs, const Rhs& rhs) noexcept {
   return static_cast<const VTLhs&>(lhs) == static_cast<const VTRhs&>(rhs);
 }
 
 /*----------------------------------------------------------------------------*/
 
-template<typename Rhs, typename T, std::size_t ulp, typename C,
+template<typename Rhs, typename T, std::size_t ulp, typename C, typename M,
   typename std::enable_if_t<is_log_floating_point_v<Rhs>, void>* = nullptr>
-inline bool operator==(const LogFloatingPoint<T, ulp, C>& lhs,
-                       const Rhs& rhs) noexcept {
-  return lhs == static_cast<const LogFloatingPoint<T, ulp, C>&>(rhs);
+constexpr bool operator==(const LogFloatingPoint<T, ulp, C, M>& lhs,
+                          const Rhs& rhs) noexcept {
+  return lhs == static_cast<const LogFloatingPoint<T, ulp, C, M>&>(rhs);
 }
 
 /*----------------------------------------------------------------------------*/
 
-template<typename Rhs, typename T, std::size_t ulp, typename C,
+template<typename Rhs, typename T, std::size_t ulp, typename C, typename M,
   typename std::enable_if_t<!is_log_floating_point_v<Rhs>, void>* = nullptr>
-inline bool operator==(const LogFloatingPoint<T, ulp, C>& lhs,
-                       const Rhs& rhs) noexcept {
-  return lhs.data() == std::log(static_cast<const T&>(rhs));
+constexpr bool operator==(const LogFloatingPoint<T, ulp, C, M>& lhs,
+                          const Rhs& rhs) noexcept {
+  return lhs.data() == detail::log_of<T, M>(rhs);
 }
 
 /*----------------------------------------------------------------------------*/
@@ -251,28 +1101,29 @@ template<typename Lhs, typename Rhs,
   typename VTLhs = typename Lhs::value_type,
   typename VTVTLhs = typename VTLhs::value_type,
   typename std::enable_if_t<
-    is_log_floating_point_v<VTLhs> && std::is_convertible_v<Rhs, VTVTLhs>,
+    is_log_floating_point_v<VTLhs> && is_raw_comparable_v<Rhs, VTVTLhs>
+      && std::is_convertible_v<Lhs, VTLhs>,
   void>* = nullptr>
-inline bool operator==(const Lhs& lhs, const Rhs& rhs) noexcept {
-  return static_cast<const VTLhs&>(lhs) == static_cast<const VTVTLhs&>(rhs);
+constexpr bool operator==(const Lhs& lhs, const Rhs& rhs) noexcept {
+  return static_cast<const VTLhs&>(lhs) == detail::raw_operand<VTVTLhs>(rhs);
 }
 
 /*----------------------------------------------------------------------------*/
 
-template<typename Lhs, typename T, std::size_t ulp, typename C,
+template<typename Lhs, typename T, std::size_t ulp, typename C, typename M,
   typename std::enable_if_t<is_log_floating_point_v<Lhs>, void>* = nullptr>
-inline bool operator==(const Lhs& lhs,
-                       const LogFloatingPoint<T, ulp, C>& rhs) noexcept {
-  return static_cast<const LogFloatingPoint<T, ulp, C>&>(lhs) == rhs;
+constexpr bool operator==(const Lhs& lhs,
+                          const LogFloatingPoint<T, ulp, C, M>& rhs) noexcept {
+  return static_cast<const LogFloatingPoint<T, ulp, C, M>&>(lhs) == rhs;
 }
 
 /*----------------------------------------------------------------------------*/
 
-template<typename Lhs, typename T, std::size_t ulp, typename C,
+template<typename Lhs, typename T, std::size_t ulp, typename C, typename M,
   typename std::enable_if_t<!is_log_floating_point_v<Lhs>, void>* = nullptr>
-inline bool operator==(const Lhs& lhs,
-                       const LogFloatingPoint<T, ulp, C>& rhs) noexcept {
-  return std::log(static_cast<const T&>(lhs)) == rhs.data();
+constexpr bool operator==(const Lhs& lhs,
+                          const LogFloatingPoint<T, ulp, C, M>& rhs) noexcept {
+  return detail::log_of<T, M>(lhs) == rhs.data();
 }
 
 /*----------------------------------------------------------------------------*/
@@ -281,19 +1132,20 @@ template<typename Lhs, typename Rhs,
   typename VTRhs = typename Rhs::value_type,
   typename VTVTRhs = typename VTRhs::value_type,
   typename std::enable_if_t<
-    is_log_floating_point_v<VTRhs> && std::is_convertible_v<Lhs, VTVTRhs>,
+    is_log_floating_point_v<VTRhs> && is_raw_comparable_v<Lhs, VTVTRhs>
+      && std::is_convertible_v<Rhs, VTRhs>,
   void>* = nullptr>
-inline bool operator==(const Lhs& lhs, const Rhs& rhs) noexcept {
-  return static_cast<const VTVTRhs&>(lhs) == static_cast<const VTRhs&>(rhs);
+constexpr bool operator==(const Lhs& lhs, const Rhs& rhs) noexcept {
+  return detail::raw_operand<VTVTRhs>(lhs) == static_cast<const VTRhs&>(rhs);
 }
 
 /*----------------------------------------------------------------------------*/
 /*                                OPERATOR!=                                  */
 /*----------------------------------------------------------------------------*/
 
-template<typename T, std::size_t ulp, typename C>
-inline bool operator!=(const LogFloatingPoint<T, ulp, C>& lhs,
-                       const LogFloatingPoint<T, ulp, C>& rhs) noexcept {
+template<typename T, std::size_t ulp, typename C, typename M>
+constexpr bool operator!=(const LogFloatingPoint<T, ulp, C, M>& lhs,
+                          const LogFloatingPoint<T, ulp, C, M>& rhs) noexcept {
   return lhs.data() != rhs.data();
 }
 
@@ -303,28 +1155,30 @@ template<typename Lhs, typename Rhs,
   typename VTLhs = typename Lhs::value_type,
   typename VTRhs = typename Rhs::value_type,
   typename std::enable_if_t<
-    is_log_floating_point_v<VTLhs> && is_log_floating_point_v<VTRhs>,
+    is_log_floating_point_v<VTLhs> && is_log_floating_point_v<VTRhs>
+      && std::is_convertible_v<Lhs, VTLhs>
+      && std::is_convertible_v<Rhs, VTRhs>,
   void>* = nullptr>
-inline bool operator!=(const Lhs& lhs, const Rhs& rhs) noexcept {
+constexpr bool operator!=(const Lhs& lhs, const Rhs& rhs) noexcept {
   return static_cast<const VTLhs&>(lhs) != static_cast<const VTRhs&>(rhs);
 }
 
 /*----------------------------------------------------------------------------*/
 
-template<typename Rhs, typename T, std::size_t ulp, typename C,
+template<typename Rhs, typename T, std::size_t ulp, typename C, typename M,
   typename std::enable_if_t<is_log_floating_point_v<Rhs>, void>* = nullptr>
-inline bool operator!=(const LogFloatingPoint<T, ulp, C>& lhs,
-                       const Rhs& rhs) noexcept {
-  return lhs != static_cast<const LogFloatingPoint<T, ulp, C>&>(rhs);
+constexpr bool operator!=(const LogFloatingPoint<T, ulp, C, M>& lhs,
+                          const Rhs& rhs) noexcept {
+  return lhs != static_cast<const LogFloatingPoint<T, ulp, C, M>&>(rhs);
 }
 
 /*----------------------------------------------------------------------------*/
 
-template<typename Rhs, typename T, std::size_t ulp, typename C,
+template<typename Rhs, typename T, std::size_t ulp, typename C, typename M,
   typename std::enable_if_t<!is_log_floating_point_v<Rhs>, void>* = nullptr>
-inline bool operator!=(const LogFloatingPoint<T, ulp, C>& lhs,
-                       const Rhs& rhs) noexcept {
-  return lhs.data() != std::log(static_cast<const T&>(rhs));
+constexpr bool operator!=(const LogFloatingPoint<T, ulp, C, M>& lhs,
+                          const Rhs& rhs) noexcept {
+  return lhs.data() != detail::log_of<T, M>(rhs);
 }
 
 /*----------------------------------------------------------------------------*/
@@ -333,28 +1187,29 @@ template<typename Lhs, typename Rhs,
   typename VTLhs = typename Lhs::value_type,
   typename VTVTLhs = typename VTLhs::value_type,
   typename std::enable_if_t<
-    is_log_floating_point_v<VTLhs> && std::is_convertible_v<Rhs, VTVTLhs>,
+    is_log_floating_point_v<VTLhs> && is_raw_comparable_v<Rhs, VTVTLhs>
+      && std::is_convertible_v<Lhs, VTLhs>,
   void>* = nullptr>
-inline bool operator!=(const Lhs& lhs, const Rhs& rhs) noexcept {
-  return static_cast<const VTLhs&>(lhs) != static_cast<const VTVTLhs&>(rhs);
+constexpr bool operator!=(const Lhs& lhs, const Rhs& rhs) noexcept {
+  return static_cast<const VTLhs&>(lhs) != detail::raw_operand<VTVTLhs>(rhs);
 }
 
 /*----------------------------------------------------------------------------*/
 
-template<typename Lhs, typename T, std::size_t ulp, typename C,
+template<typename Lhs, typename T, std::size_t ulp, typename C, typename M,
   typename std::enable_if_t<is_log_floating_point_v<Lhs>, void>* = nullptr>
-inline bool operator!=(const Lhs& lhs,
-                       const LogFloatingPoint<T, ulp, C>& rhs) noexcept {
-  return static_cast<const LogFloatingPoint<T, ulp, C>&>(lhs) != rhs;
+constexpr bool operator!=(const Lhs& lhs,
+                          const LogFloatingPoint<T, ulp, C, M>& rhs) noexcept {
+  return static_cast<const LogFloatingPoint<T, ulp, C, M>&>(lhs) != rhs;
 }
 
 /*----------------------------------------------------------------------------*/
 
-template<typename Lhs, typename T, std::size_t ulp, typename C,
+template<typename Lhs, typename T, std::size_t ulp, typename C, typename M,
   typename std::enable_if_t<!is_log_floating_point_v<Lhs>, void>* = nullptr>
-inline bool operator!=(const Lhs& lhs,
-                       const LogFloatingPoint<T, ulp, C>& rhs) noexcept {
-  return std::log(static_cast<const T&>(lhs)) != rhs.data();
+constexpr bool operator!=(const Lhs& lhs,
+                          const LogFloatingPoint<T, ulp, C, M>& rhs) noexcept {
+  return detail::log_of<T, M>(lhs) != rhs.data();
 }
 
 /*----------------------------------------------------------------------------*/
@@ -363,19 +1218,20 @@ template<typename Lhs, typename Rhs,
   typename VTRhs = typename Rhs::value_type,
   typename VTVTRhs = typename VTRhs::value_type,
   typename std::enable_if_t<
-    is_log_floating_point_v<VTRhs> && std::is_convertible_v<Lhs, VTVTRhs>,
+    is_log_floating_point_v<VTRhs> && is_raw_comparable_v<Lhs, VTVTRhs>
+      && std::is_convertible_v<Rhs, VTRhs>,
   void>* = nullptr>
-inline bool operator!=(const Lhs& lhs, const Rhs& rhs) noexcept {
-  return static_cast<const VTVTRhs&>(lhs) != static_cast<const VTRhs&>(rhs);
+constexpr bool operator!=(const Lhs& lhs, const Rhs& rhs) noexcept {
+  return detail::raw_operand<VTVTRhs>(lhs) != static_cast<const VTRhs&>(rhs);
 }
 
 /*----------------------------------------------------------------------------*/
 /*                                OPERATOR<                                   */
 /*----------------------------------------------------------------------------*/
 
-template<typename T, std::size_t ulp, typename C>
-inline bool operator<(const LogFloatingPoint<T, ulp, C>& lhs,
-                      const LogFloatingPoint<T, ulp, C>& rhs) noexcept {
+template<typename T, std::size_t ulp, typename C, typename M>
+constexpr bool operator<(const LogFloatingPoint<T, ulp, C, M>& lhs,
+                         const LogFloatingPoint<T, ulp, C, M>& rhs) noexcept {
   return lhs.data() < rhs.data();
 }
 
@@ -385,28 +1241,30 @@ template<typename Lhs, typename Rhs,
   typename VTLhs = typename Lhs::value_type,
   typename VTRhs = typename Rhs::value_type,
   typename std::enable_if_t<
-    is_log_floating_point_v<VTLhs> && is_log_floating_point_v<VTRhs>,
+    is_log_floating_point_v<VTLhs> && is_log_floating_point_v<VTRhs>
+      && std::is_convertible_v<Lhs, VTLhs>
+      && std::is_convertible_v<Rhs, VTRhs>,
   void>* = nullptr>
-inline bool operator<(const Lhs& lhs, const Rhs& rhs) noexcept {
+constexpr bool operator<(const Lhs& lhs, const Rhs& rhs) noexcept {
   return static_cast<const VTLhs&>(lhs) < static_cast<const VTRhs&>(rhs);
 }
 
 /*----------------------------------------------------------------------------*/
 
-template<typename Rhs, typename T, std::size_t ulp, typename C,
+template<typename Rhs, typename T, std::size_t ulp, typename C, typename M,
   typename std::enable_if_t<is_log_floating_point_v<Rhs>, void>* = nullptr>
-inline bool operator<(const LogFloatingPoint<T, ulp, C>& lhs,
-                      const Rhs& rhs) noexcept {
-  return lhs < static_cast<const LogFloatingPoint<T, ulp, C>&>(rhs);
+constexpr bool operator<(const LogFloatingPoint<T, ulp, C, M>& lhs,
+                         const Rhs& rhs) noexcept {
+  return lhs < static_cast<const LogFloatingPoint<T, ulp, C, M>&>(rhs);
 }
 
 /*----------------------------------------------------------------------------*/
 
-template<typename Rhs, typename T, std::size_t ulp, typename C,
+template<typename Rhs, typename T, std::size_t ulp, typename C, typename M,
   typename std::enable_if_t<!is_log_floating_point_v<Rhs>, void>* = nullptr>
-inline bool operator<(const LogFloatingPoint<T, ulp, C>& lhs,
-                      const Rhs& rhs) noexcept {
-  return lhs.data() < std::log(static_cast<const T&>(rhs));
+constexpr bool operator<(const LogFloatingPoint<T, ulp, C, M>& lhs,
+                         const Rhs& rhs) noexcept {
+  return lhs.data() < detail::log_of<T, M>(rhs);
 }
 
 /*----------------------------------------------------------------------------*/
@@ -415,28 +1273,29 @@ template<typename Lhs, typename Rhs,
   typename VTLhs = typename Lhs::value_type,
   typename VTVTLhs = typename VTLhs::value_type,
   typename std::enable_if_t<
-    is_log_floating_point_v<VTLhs> && std::is_convertible_v<Rhs, VTVTLhs>,
+    is_log_floating_point_v<VTLhs> && is_raw_comparable_v<Rhs, VTVTLhs>
+      && std::is_convertible_v<Lhs, VTLhs>,
   void>* = nullptr>
-inline bool operator<(const Lhs& lhs, const Rhs& rhs) noexcept {
-  return static_cast<const VTLhs&>(lhs) < static_cast<const VTVTLhs&>(rhs);
+constexpr bool operator<(const Lhs& lhs, const Rhs& rhs) noexcept {
+  return static_cast<const VTLhs&>(lhs) < detail::raw_operand<VTVTLhs>(rhs);
 }
 
 /*----------------------------------------------------------------------------*/
 
-template<typename Lhs, typename T, std::size_t ulp, typename C,
+template<typename Lhs, typename T, std::size_t ulp, typename C, typename M,
   typename std::enable_if_t<is_log_floating_point_v<Lhs>, void>* = nullptr>
-inline bool operator<(const Lhs& lhs,
-                      const LogFloatingPoint<T, ulp, C>& rhs) noexcept {
-  return static_cast<const LogFloatingPoint<T, ulp, C>&>(lhs) < rhs;
+constexpr bool operator<(const Lhs& lhs,
+                         const LogFloatingPoint<T, ulp, C, M>& rhs) noexcept {
+  return static_cast<const LogFloatingPoint<T, ulp, C, M>&>(lhs) < rhs;
 }
 
 /*----------------------------------------------------------------------------*/
 
-template<typename Lhs, typename T, std::size_t ulp, typename C,
+template<typename Lhs, typename T, std::size_t ulp, typename C, typename M,
   typename std::enable_if_t<!is_log_floating_point_v<Lhs>, void>* = nullptr>
-inline bool operator<(const Lhs& lhs,
-                      const LogFloatingPoint<T, ulp, C>& rhs) noexcept {
-  return std::log(static_cast<const T&>(lhs)) < rhs.data();
+constexpr bool operator<(const Lhs& lhs,
+                         const LogFloatingPoint<T, ulp, C, M>& rhs) noexcept {
+  return detail::log_of<T, M>(lhs) < rhs.data();
 }
 
 /*----------------------------------------------------------------------------*/
@@ -445,19 +1304,20 @@ template<typename Lhs, typename Rhs,
   typename VTRhs = typename Rhs::value_type,
   typename VTVTRhs = typename VTRhs::value_type,
   typename std::enable_if_t<
-    is_log_floating_point_v<VTRhs> && std::is_convertible_v<Lhs, VTVTRhs>,
+    is_log_floating_point_v<VTRhs> && is_raw_comparable_v<Lhs, VTVTRhs>
+      && std::is_convertible_v<Rhs, VTRhs>,
   void>* = nullptr>
-inline bool operator<(const Lhs& lhs, const Rhs& rhs) noexcept {
-  return static_cast<const VTVTRhs&>(lhs) < static_cast<const VTRhs&>(rhs);
+constexpr bool operator<(const Lhs& lhs, const Rhs& rhs) noexcept {
+  return detail::raw_operand<VTVTRhs>(lhs) < static_cast<const VTRhs&>(rhs);
 }
 
 /*----------------------------------------------------------------------------*/
 /*                                OPERATOR<=                                  */
 /*----------------------------------------------------------------------------*/
 
-template<typename T, std::size_t ulp, typename C>
-inline bool operator<=(const LogFloatingPoint<T, ulp, C>& lhs,
-                       const LogFloatingPoint<T, ulp, C>& rhs) noexcept {
+template<typename T, std::size_t ulp, typename C, typename M>
+constexpr bool operator<=(const LogFloatingPoint<T, ulp, C, M>& lhs,
+                          const LogFloatingPoint<T, ulp, C, M>& rhs) noexcept {
   return lhs.data() <= rhs.data();
 }
 
@@ -467,28 +1327,30 @@ template<typename Lhs, typename Rhs,
   typename VTLhs = typename Lhs::value_type,
   typename VTRhs = typename Rhs::value_type,
   typename std::enable_if_t<
-    is_log_floating_point_v<VTLhs> && is_log_floating_point_v<VTRhs>,
+    is_log_floating_point_v<VTLhs> && is_log_floating_point_v<VTRhs>
+      && std::is_convertible_v<Lhs, VTLhs>
+      && std::is_convertible_v<Rhs, VTRhs>,
   void>* = nullptr>
-inline bool operator<=(const Lhs& lhs, const Rhs& rhs) noexcept {
+constexpr bool operator<=(const Lhs& lhs, const Rhs& rhs) noexcept {
   return static_cast<const VTLhs&>(lhs) <= static_cast<const VTRhs&>(rhs);
 }
 
 /*----------------------------------------------------------------------------*/
 
-template<typename Rhs, typename T, std::size_t ulp, typename C,
+template<typename Rhs, typename T, std::size_t ulp, typename C, typename M,
   typename std::enable_if_t<is_log_floating_point_v<Rhs>, void>* = nullptr>
-inline bool operator<=(const LogFloatingPoint<T, ulp, C>& lhs,
-                       const Rhs& rhs) noexcept {
-  return lhs <= static_cast<const LogFloatingPoint<T, ulp, C>&>(rhs);
+constexpr bool operator<=(const LogFloatingPoint<T, ulp, C, M>& lhs,
+                          const Rhs& rhs) noexcept {
+  return lhs <= static_cast<const LogFloatingPoint<T, ulp, C, M>&>(rhs);
 }
 
 /*----------------------------------------------------------------------------*/
 
-template<typename Rhs, typename T, std::size_t ulp, typename C,
+template<typename Rhs, typename T, std::size_t ulp, typename C, typename M,
   typename std::enable_if_t<!is_log_floating_point_v<Rhs>, void>* = nullptr>
-inline bool operator<=(const LogFloatingPoint<T, ulp, C>& lhs,
-                       const Rhs& rhs) noexcept {
-  return lhs.data() <= std::log(static_cast<const T&>(rhs));
+constexpr bool operator<=(const LogFloatingPoint<T, ulp, C, M>& lhs,
+                          const Rhs& rhs) noexcept {
+  return lhs.data() <= detail::log_of<T, M>(rhs);
 }
 
 /*----------------------------------------------------------------------------*/
@@ -497,28 +1359,29 @@ template<typename Lhs, typename Rhs,
   typename VTLhs = typename Lhs::value_type,
   typename VTVTLhs = typename VTLhs::value_type,
   typename std::enable_if_t<
-    is_log_floating_point_v<VTLhs> && std::is_convertible_v<Rhs, VTVTLhs>,
+    is_log_floating_point_v<VTLhs> && is_raw_comparable_v<Rhs, VTVTLhs>
+      && std::is_convertible_v<Lhs, VTLhs>,
   void>* = nullptr>
-inline bool operator<=(const Lhs& lhs, const Rhs& rhs) noexcept {
-  return static_cast<const VTLhs&>(lhs) <= static_cast<const VTVTLhs&>(rhs);
+constexpr bool operator<=(const Lhs& lhs, const Rhs& rhs) noexcept {
+  return static_cast<const VTLhs&>(lhs) <= detail::raw_operand<VTVTLhs>(rhs);
 }
 
 /*----------------------------------------------------------------------------*/
 
-template<typename Lhs, typename T, std::size_t ulp, typename C,
+template<typename Lhs, typename T, std::size_t ulp, typename C, typename M,
   typename std::enable_if_t<is_log_floating_point_v<Lhs>, void>* = nullptr>
-inline bool operator<=(const Lhs& lhs,
-                       const LogFloatingPoint<T, ulp, C>& rhs) noexcept {
-  return static_cast<const LogFloatingPoint<T, ulp, C>&>(lhs) <= rhs;
+constexpr bool operator<=(const Lhs& lhs,
+                          const LogFloatingPoint<T, ulp, C, M>& rhs) noexcept {
+  return static_cast<const LogFloatingPoint<T, ulp, C, M>&>(lhs) <= rhs;
 }
 
 /*----------------------------------------------------------------------------*/
 
-template<typename Lhs, typename T, std::size_t ulp, typename C,
+template<typename Lhs, typename T, std::size_t ulp, typename C, typename M,
   typename std::enable_if_t<!is_log_floating_point_v<Lhs>, void>* = nullptr>
-inline bool operator<=(const Lhs& lhs,
-                       const LogFloatingPoint<T, ulp, C>& rhs) noexcept {
-  return std::log(static_cast<const T&>(lhs)) <= rhs.data();
+constexpr bool operator<=(const Lhs& lhs,
+                          const LogFloatingPoint<T, ulp, C, M>& rhs) noexcept {
+  return detail::log_of<T, M>(lhs) <= rhs.data();
 }
 
 /*----------------------------------------------------------------------------*/
@@ -527,19 +1390,20 @@ template<typename Lhs, typename Rhs,
   typename VTRhs = typename Rhs::value_type,
   typename VTVTRhs = typename VTRhs::value_type,
   typename std::enable_if_t<
-    is_log_floating_point_v<VTRhs> && std::is_convertible_v<Lhs, VTVTRhs>,
+    is_log_floating_point_v<VTRhs> && is_raw_comparable_v<Lhs, VTVTRhs>
+      && std::is_convertible_v<Rhs, VTRhs>,
   void>* = nullptr>
-inline bool operator<=(const Lhs& lhs, const Rhs& rhs) noexcept {
-  return static_cast<const VTVTRhs&>(lhs) <= static_cast<const VTRhs&>(rhs);
+constexpr bool operator<=(const Lhs& lhs, const Rhs& rhs) noexcept {
+  return detail::raw_operand<VTVTRhs>(lhs) <= static_cast<const VTRhs&>(rhs);
 }
 
 /*----------------------------------------------------------------------------*/
 /*                                OPERATOR>                                   */
 /*----------------------------------------------------------------------------*/
 
-template<typename T, std::size_t ulp, typename C>
-inline bool operator>(const LogFloatingPoint<T, ulp, C>& lhs,
-                      const LogFloatingPoint<T, ulp, C>& rhs) noexcept {
+template<typename T, std::size_t ulp, typename C, typename M>
+constexpr bool operator>(const LogFloatingPoint<T, ulp, C, M>& lhs,
+                         const LogFloatingPoint<T, ulp, C, M>& rhs) noexcept {
   return lhs.data() > rhs.data();
 }
 
@@ -549,28 +1413,30 @@ template<typename Lhs, typename Rhs,
   typename VTLhs = typename Lhs::value_type,
   typename VTRhs = typename Rhs::value_type,
   typename std::enable_if_t<
-    is_log_floating_point_v<VTLhs> && is_log_floating_point_v<VTRhs>,
+    is_log_floating_point_v<VTLhs> && is_log_floating_point_v<VTRhs>
+      && std::is_convertible_v<Lhs, VTLhs>
+      && std::is_convertible_v<Rhs, VTRhs>,
   void>* = nullptr>
-inline bool operator>(const Lhs& lhs, const Rhs& rhs) noexcept {
+constexpr bool operator>(const Lhs& lhs, const Rhs& rhs) noexcept {
   return static_cast<const VTLhs&>(lhs) > static_cast<const VTRhs&>(rhs);
 }
 
 /*----------------------------------------------------------------------------*/
 
-template<typename Rhs, typename T, std::size_t ulp, typename C,
+template<typename Rhs, typename T, std::size_t ulp, typename C, typename M,
   typename std::enable_if_t<is_log_floating_point_v<Rhs>, void>* = nullptr>
-inline bool operator>(const LogFloatingPoint<T, ulp, C>& lhs,
-                      const Rhs& rhs) noexcept {
-  return lhs > static_cast<const LogFloatingPoint<T, ulp, C>&>(rhs);
+constexpr bool operator>(const LogFloatingPoint<T, ulp, C, M>& lhs,
+                         const Rhs& rhs) noexcept {
+  return lhs > static_cast<const LogFloatingPoint<T, ulp, C, M>&>(rhs);
 }
 
 /*----------------------------------------------------------------------------*/
 
-template<typename Rhs, typename T, std::size_t ulp, typename C,
+template<typename Rhs, typename T, std::size_t ulp, typename C, typename M,
   typename std::enable_if_t<!is_log_floating_point_v<Rhs>, void>* = nullptr>
-inline bool operator>(const LogFloatingPoint<T, ulp, C>& lhs,
-                      const Rhs& rhs) noexcept {
-  return lhs.data() > std::log(static_cast<const T&>(rhs));
+constexpr bool operator>(const LogFloatingPoint<T, ulp, C, M>& lhs,
+                         const Rhs& rhs) noexcept {
+  return lhs.data() > detail::log_of<T, M>(rhs);
 }
 
 /*----------------------------------------------------------------------------*/
@@ -579,28 +1445,29 @@ template<typename Lhs, typename Rhs,
   typename VTLhs = typename Lhs::value_type,
   typename VTVTLhs = typename VTLhs::value_type,
   typename std::enable_if_t<
-    is_log_floating_point_v<VTLhs> && std::is_convertible_v<Rhs, VTVTLhs>,
+    is_log_floating_point_v<VTLhs> && is_raw_comparable_v<Rhs, VTVTLhs>
+      && std::is_convertible_v<Lhs, VTLhs>,
   void>* = nullptr>
-inline bool operator>(const Lhs& lhs, const Rhs& rhs) noexcept {
-  return static_cast<const VTLhs&>(lhs) > static_cast<const VTVTLhs&>(rhs);
+constexpr bool operator>(const Lhs& lhs, const Rhs& rhs) noexcept {
+  return static_cast<const VTLhs&>(lhs) > detail::raw_operand<VTVTLhs>(rhs);
 }
 
 /*----------------------------------------------------------------------------*/
 
-template<typename Lhs, typename T, std::size_t ulp, typename C,
+template<typename Lhs, typename T, std::size_t ulp, typename C, typename M,
   typename std::enable_if_t<is_log_floating_point_v<Lhs>, void>* = nullptr>
-inline bool operator>(const Lhs& lhs,
-                      const LogFloatingPoint<T, ulp, C>& rhs) noexcept {
-  return static_cast<const LogFloatingPoint<T, ulp, C>&>(lhs) > rhs;
+constexpr bool operator>(const Lhs& lhs,
+                         const LogFloatingPoint<T, ulp, C, M>& rhs) noexcept {
+  return static_cast<const LogFloatingPoint<T, ulp, C, M>&>(lhs) > rhs;
 }
 
 /*----------------------------------------------------------------------------*/
 
-template<typename Lhs, typename T, std::size_t ulp, typename C,
+template<typename Lhs, typename T, std::size_t ulp, typename C, typename M,
   typename std::enable_if_t<!is_log_floating_point_v<Lhs>, void>* = nullptr>
-inline bool operator>(const Lhs& lhs,
-                      const LogFloatingPoint<T, ulp, C>& rhs) noexcept {
-  return std::log(static_cast<const T&>(lhs)) > rhs.data();
+constexpr bool operator>(const Lhs& lhs,
+                         const LogFloatingPoint<T, ulp, C, M>& rhs) noexcept {
+  return detail::log_of<T, M>(lhs) > rhs.data();
 }
 
 /*----------------------------------------------------------------------------*/
@@ -609,19 +1476,20 @@ template<typename Lhs, typename Rhs,
   typename VTRhs = typename Rhs::value_type,
   typename VTVTRhs = typename VTRhs::value_type,
   typename std::enable_if_t<
-    is_log_floating_point_v<VTRhs> && std::is_convertible_v<Lhs, VTVTRhs>,
+    is_log_floating_point_v<VTRhs> && is_raw_comparable_v<Lhs, VTVTRhs>
+      && std::is_convertible_v<Rhs, VTRhs>,
   void>* = nullptr>
-inline bool operator>(const Lhs& lhs, const Rhs& rhs) noexcept {
-  return static_cast<const VTVTRhs&>(lhs) > static_cast<const VTRhs&>(rhs);
+constexpr bool operator>(const Lhs& lhs, const Rhs& rhs) noexcept {
+  return detail::raw_operand<VTVTRhs>(lhs) > static_cast<const VTRhs&>(rhs);
 }
 
 /*----------------------------------------------------------------------------*/
 /*                                OPERATOR>=                                  */
 /*----------------------------------------------------------------------------*/
 
-template<typename T, std::size_t ulp, typename C>
-inline bool operator>=(const LogFloatingPoint<T, ulp, C>& lhs,
-                       const LogFloatingPoint<T, ulp, C>& rhs) noexcept {
+template<typename T, std::size_t ulp, typename C, typename M>
+constexpr bool operator>=(const LogFloatingPoint<T, ulp, C, M>& lhs,
+                          const LogFloatingPoint<T, ulp, C, M>& rhs) noexcept {
   return lhs.data() >= rhs.data();
 }
 
@@ -631,28 +1499,30 @@ template<typename Lhs, typename Rhs,
   typename VTLhs = typename Lhs::value_type,
   typename VTRhs = typename Rhs::value_type,
   typename std::enable_if_t<
-    is_log_floating_point_v<VTLhs> && is_log_floating_point_v<VTRhs>,
+    is_log_floating_point_v<VTLhs> && is_log_floating_point_v<VTRhs>
+      && std::is_convertible_v<Lhs, VTLhs>
+      && std::is_convertible_v<Rhs, VTRhs>,
   void>* = nullptr>
-inline bool operator>=(const Lhs& lhs, const Rhs& rhs) noexcept {
+constexpr bool operator>=(const Lhs& lhs, const Rhs& rhs) noexcept {
   return static_cast<const VTLhs&>(lhs) >= static_cast<const VTRhs&>(rhs);
 }
 
 /*----------------------------------------------------------------------------*/
 
-template<typename Rhs, typename T, std::size_t ulp, typename C,
+template<typename Rhs, typename T, std::size_t ulp, typename C, typename M,
   typename std::enable_if_t<is_log_floating_point_v<Rhs>, void>* = nullptr>
-inline bool operator>=(const LogFloatingPoint<T, ulp, C>& lhs,
-                       const Rhs& rhs) noexcept {
-  return lhs >= static_cast<const LogFloatingPoint<T, ulp, C>&>(rhs);
+constexpr bool operator>=(const LogFloatingPoint<T, ulp, C, M>& lhs,
+                          const Rhs& rhs) noexcept {
+  return lhs >= static_cast<const LogFloatingPoint<T, ulp, C, M>&>(rhs);
 }
 
 /*----------------------------------------------------------------------------*/
 
-template<typename Rhs, typename T, std::size_t ulp, typename C,
+template<typename Rhs, typename T, std::size_t ulp, typename C, typename M,
   typename std::enable_if_t<!is_log_floating_point_v<Rhs>, void>* = nullptr>
-inline bool operator>=(const LogFloatingPoint<T, ulp, C>& lhs,
-                       const Rhs& rhs) noexcept {
-  return lhs.data() >= std::log(static_cast<const T&>(rhs));
+constexpr bool operator>=(const LogFloatingPoint<T, ulp, C, M>& lhs,
+                          const Rhs& rhs) noexcept {
+  return lhs.data() >= detail::log_of<T, M>(rhs);
 }
 
 /*----------------------------------------------------------------------------*/
@@ -661,28 +1531,29 @@ template<typename Lhs, typename Rhs,
   typename VTLhs = typename Lhs::value_type,
   typename VTVTLhs = typename VTLhs::value_type,
   typename std::enable_if_t<
-    is_log_floating_point_v<VTLhs> && std::is_convertible_v<Rhs, VTVTLhs>,
+    is_log_floating_point_v<VTLhs> && is_raw_comparable_v<Rhs, VTVTLhs>
+      && std::is_convertible_v<Lhs, VTLhs>,
   void>* = nullptr>
-inline bool operator>=(const Lhs& lhs, const Rhs& rhs) noexcept {
-  return static_cast<const VTLhs&>(lhs) >= static_cast<const VTVTLhs&>(rhs);
+constexpr bool operator>=(const Lhs& lhs, const Rhs& rhs) noexcept {
+  return static_cast<const VTLhs&>(lhs) >= detail::raw_operand<VTVTLhs>(rhs);
 }
 
 /*----------------------------------------------------------------------------*/
 
-template<typename Lhs, typename T, std::size_t ulp, typename C,
+template<typename Lhs, typename T, std::size_t ulp, typename C, typename M,
   typename std::enable_if_t<is_log_floating_point_v<Lhs>, void>* = nullptr>
-inline bool operator>=(const Lhs& lhs,
-                       const LogFloatingPoint<T, ulp, C>& rhs) noexcept {
-  return static_cast<const LogFloatingPoint<T, ulp, C>&>(lhs) >= rhs;
+constexpr bool operator>=(const Lhs& lhs,
+                          const LogFloatingPoint<T, ulp, C, M>& rhs) noexcept {
+  return static_cast<const LogFloatingPoint<T, ulp, C, M>&>(lhs) >= rhs;
 }
 
 /*----------------------------------------------------------------------------*/
 
-template<typename Lhs, typename T, std::size_t ulp, typename C,
+template<typename Lhs, typename T, std::size_t ulp, typename C, typename M,
   typename std::enable_if_t<!is_log_floating_point_v<Lhs>, void>* = nullptr>
-inline bool operator>=(const Lhs& lhs,
-                       const LogFloatingPoint<T, ulp, C>& rhs) noexcept {
-  return std::log(static_cast<const T&>(lhs)) >= rhs.data();
+constexpr bool operator>=(const Lhs& lhs,
+                          const LogFloatingPoint<T, ulp, C, M>& rhs) noexcept {
+  return detail::log_of<T, M>(lhs) >= rhs.data();
 }
 
 /*----------------------------------------------------------------------------*/
@@ -691,20 +1562,21 @@ template<typename Lhs, typename Rhs,
   typename VTRhs = typename Rhs::value_type,
   typename VTVTRhs = typename VTRhs::value_type,
   typename std::enable_if_t<
-    is_log_floating_point_v<VTRhs> && std::is_convertible_v<Lhs, VTVTRhs>,
+    is_log_floating_point_v<VTRhs> && is_raw_comparable_v<Lhs, VTVTRhs>
+      && std::is_convertible_v<Rhs, VTRhs>,
   void>* = nullptr>
-inline bool operator>=(const Lhs& lhs, const Rhs& rhs) noexcept {
-  return static_cast<const VTVTRhs&>(lhs) >= static_cast<const VTRhs&>(rhs);
+constexpr bool operator>=(const Lhs& lhs, const Rhs& rhs) noexcept {
+  return detail::raw_operand<VTVTRhs>(lhs) >= static_cast<const VTRhs&>(rhs);
 }
 
 /*----------------------------------------------------------------------------*/
 /*                                OPERATOR*                                   */
 /*----------------------------------------------------------------------------*/
 
-template<typename T, std::size_t ulp, typename C>
-inline LogFloatingPoint<T, ulp, C>
-operator*(LogFloatingPoint<T, ulp, C> lhs,
-          const LogFloatingPoint<T, ulp, C>& rhs) noexcept {
+template<typename T, std::size_t ulp, typename C, typename M>
+constexpr LogFloatingPoint<T, ulp, C, M>
+operator*(LogFloatingPoint<T, ulp, C, M> lhs,
+          const LogFloatingPoint<T, ulp, C, M>& rhs) noexcept {
   lhs *= rhs;
   return lhs;
 }
@@ -715,28 +1587,30 @@ template<typename Lhs, typename Rhs,
   typename VTLhs = typename Lhs::value_type,
   typename VTRhs = typename Rhs::value_type,
   typename std::enable_if_t<
-    is_log_floating_point_v<VTLhs> && is_log_floating_point_v<VTRhs>,
+    is_log_floating_point_v<VTLhs> && is_log_floating_point_v<VTRhs>
+      && std::is_convertible_v<Lhs, VTLhs>
+      && std::is_convertible_v<Rhs, VTRhs>,
   void>* = nullptr>
-inline VTLhs operator*(const Lhs& lhs, const Rhs& rhs) noexcept {
+constexpr VTLhs operator*(const Lhs& lhs, const Rhs& rhs) noexcept {
   return static_cast<const VTLhs&>(lhs) * static_cast<const VTRhs&>(rhs);
 }
 
 /*----------------------------------------------------------------------------*/
 
-template<typename Rhs, typename T, std::size_t ulp, typename C,
+template<typename Rhs, typename T, std::size_t ulp, typename C, typename M,
   typename std::enable_if_t<is_log_floating_point_v<Rhs>, void>* = nullptr>
-inline LogFloatingPoint<T, ulp, C>
-operator*(const LogFloatingPoint<T, ulp, C>& lhs, const Rhs& rhs) noexcept {
-  return lhs * static_cast<const LogFloatingPoint<T, ulp, C>&>(rhs);
+constexpr LogFloatingPoint<T, ulp, C, M>
+operator*(const LogFloatingPoint<T, ulp, C, M>& lhs, const Rhs& rhs) noexcept {
+  return lhs * static_cast<const LogFloatingPoint<T, ulp, C, M>&>(rhs);
 }
 
 /*----------------------------------------------------------------------------*/
 
-template<typename Rhs, typename T, std::size_t ulp, typename C,
+template<typename Rhs, typename T, std::size_t ulp, typename C, typename M,
   typename std::enable_if_t<!is_log_floating_point_v<Rhs>, void>* = nullptr>
-inline LogFloatingPoint<T, ulp, C>
-operator*(const LogFloatingPoint<T, ulp, C>& lhs, const Rhs& rhs) noexcept {
-  return lhs * LogFloatingPoint<T, ulp, C>(static_cast<const T&>(rhs));
+constexpr LogFloatingPoint<T, ulp, C, M>
+operator*(const LogFloatingPoint<T, ulp, C, M>& lhs, const Rhs& rhs) noexcept {
+  return lhs * LogFloatingPoint<T, ulp, C, M>(static_cast<const T&>(rhs));
 }
 
 /*----------------------------------------------------------------------------*/
@@ -745,28 +1619,29 @@ template<typename Lhs, typename Rhs,
   typename VTLhs = typename Lhs::value_type,
   typename VTVTLhs = typename VTLhs::value_type,
   typename std::enable_if_t<
-    is_log_floating_point_v<VTLhs> && std::is_convertible_v<Rhs, VTVTLhs>,
+    is_log_floating_point_v<VTLhs> && std::is_convertible_v<Rhs, VTVTLhs>
+      && std::is_convertible_v<Lhs, VTLhs>,
   void>* = nullptr>
-inline VTLhs operator*(const Lhs& lhs, const Rhs& rhs) noexcept {
+constexpr VTLhs operator*(const Lhs& lhs, const Rhs& rhs) noexcept {
   return static_cast<const VTLhs&>(lhs) * static_cast<const VTVTLhs&>(rhs);
 }
 
 /*----------------------------------------------------------------------------*/
 
-template<typename Lhs, typename T, std::size_t ulp, typename C,
+template<typename Lhs, typename T, std::size_t ulp, typename C, typename M,
   typename std::enable_if_t<is_log_floating_point_v<Lhs>, void>* = nullptr>
-inline LogFloatingPoint<T, ulp, C>
-operator*(const Lhs& lhs, const LogFloatingPoint<T, ulp, C>& rhs) noexcept {
-  return static_cast<const LogFloatingPoint<T, ulp, C>&>(lhs) * rhs;
+constexpr LogFloatingPoint<T, ulp, C, M>
+operator*(const Lhs& lhs, const LogFloatingPoint<T, ulp, C, M>& rhs) noexcept {
+  return static_cast<const LogFloatingPoint<T, ulp, C, M>&>(lhs) * rhs;
 }
 
 /*----------------------------------------------------------------------------*/
 
-template<typename Lhs, typename T, std::size_t ulp, typename C,
+template<typename Lhs, typename T, std::size_t ulp, typename C, typename M,
   typename std::enable_if_t<!is_log_floating_point_v<Lhs>, void>* = nullptr>
-inline LogFloatingPoint<T, ulp, C>
-operator*(const Lhs& lhs, const LogFloatingPoint<T, ulp, C>& rhs) noexcept {
-  LogFloatingPoint<T, ulp, C> result(static_cast<const T&>(lhs));
+constexpr LogFloatingPoint<T, ulp, C, M>
+operator*(const Lhs& lhs, const LogFloatingPoint<T, ulp, C, M>& rhs) noexcept {
+  LogFloatingPoint<T, ulp, C, M> result(static_cast<const T&>(lhs));
   result *= rhs;
   return result;
 }
@@ -777,9 +1652,10 @@ template<typename Lhs, typename Rhs,
   typename VTRhs = typename Rhs::value_type,
   typename VTVTRhs = typename VTRhs::value_type,
   typename std::enable_if_t<
-    is_log_floating_point_v<VTRhs> && std::is_convertible_v<Lhs, VTVTRhs>,
+    is_log_floating_point_v<VTRhs> && std::is_convertible_v<Lhs, VTVTRhs>
+      && std::is_convertible_v<Rhs, VTRhs>,
   void>* = nullptr>
-inline VTRhs operator*(const Lhs& lhs, const Rhs& rhs) noexcept {
+constexpr VTRhs operator*(const Lhs& lhs, const Rhs& rhs) noexcept {
   return static_cast<const VTVTRhs&>(lhs) * static_cast<const VTRhs&>(rhs);
 }
 
@@ -787,10 +1663,10 @@ inline VTRhs operator*(const Lhs& lhs, const Rhs& rhs) noexcept {
 /*                                OPERATOR/                                   */
 /*----------------------------------------------------------------------------*/
 
-template<typename T, std::size_t ulp, typename C>
-inline LogFloatingPoint<T, ulp, C>
-operator/(LogFloatingPoint<T, ulp, C> lhs,
-          const LogFloatingPoint<T, ulp, C>& rhs) noexcept {
+template<typename T, std::size_t ulp, typename C, typename M>
+constexpr LogFloatingPoint<T, ulp, C, M>
+operator/(LogFloatingPoint<T, ulp, C, M> lhs,
+          const LogFloatingPoint<T, ulp, C, M>& rhs) noexcept {
   lhs /= rhs;
   return lhs;
 }
@@ -801,28 +1677,30 @@ template<typename Lhs, typename Rhs,
   typename VTLhs = typename Lhs::value_type,
   typename VTRhs = typename Rhs::value_type,
   typename std::enable_if_t<
-    is_log_floating_point_v<VTLhs> && is_log_floating_point_v<VTRhs>,
+    is_log_floating_point_v<VTLhs> && is_log_floating_point_v<VTRhs>
+      && std::is_convertible_v<Lhs, VTLhs>
+      && std::is_convertible_v<Rhs, VTRhs>,
   void>* = nullptr>
-inline VTLhs operator/(const Lhs& lhs, const Rhs& rhs) noexcept {
+constexpr VTLhs operator/(const Lhs& lhs, const Rhs& rhs) noexcept {
   return static_cast<const VTLhs&>(lhs) / static_cast<const VTRhs&>(rhs);
 }
 
 /*----------------------------------------------------------------------------*/
 
-template<typename Rhs, typename T, std::size_t ulp, typename C,
+template<typename Rhs, typename T, std::size_t ulp, typename C, typename M,
   typename std::enable_if_t<is_log_floating_point_v<Rhs>, void>* = nullptr>
-inline LogFloatingPoint<T, ulp, C>
-operator/(const LogFloatingPoint<T, ulp, C>& lhs, const Rhs& rhs) noexcept {
-  return lhs / static_cast<const LogFloatingPoint<T, ulp, C>&>(rhs);
+constexpr LogFloatingPoint<T, ulp, C, M>
+operator/(const LogFloatingPoint<T, ulp, C, M>& lhs, const Rhs& rhs) noexcept {
+  return lhs / static_cast<const LogFloatingPoint<T, ulp, C, M>&>(rhs);
 }
 
 /*----------------------------------------------------------------------------*/
 
-template<typename Rhs, typename T, std::size_t ulp, typename C,
+template<typename Rhs, typename T, std::size_t ulp, typename C, typename M,
   typename std::enable_if_t<!is_log_floating_point_v<Rhs>, void>* = nullptr>
-inline LogFloatingPoint<T, ulp, C>
-operator/(const LogFloatingPoint<T, ulp, C>& lhs, const Rhs& rhs) noexcept {
-  return lhs / LogFloatingPoint<T, ulp, C>(static_cast<const T&>(rhs));
+constexpr LogFloatingPoint<T, ulp, C, M>
+operator/(const LogFloatingPoint<T, ulp, C, M>& lhs, const Rhs& rhs) noexcept {
+  return lhs / LogFloatingPoint<T, ulp, C, M>(static_cast<const T&>(rhs));
 }
 
 /*----------------------------------------------------------------------------*/
@@ -831,28 +1709,29 @@ template<typename Lhs, typename Rhs,
   typename VTLhs = typename Lhs::value_type,
   typename VTVTLhs = typename VTLhs::value_type,
   typename std::enable_if_t<
-    is_log_floating_point_v<VTLhs> && std::is_convertible_v<Rhs, VTVTLhs>,
+    is_log_floating_point_v<VTLhs> && std::is_convertible_v<Rhs, VTVTLhs>
+      && std::is_convertible_v<Lhs, VTLhs>,
   void>* = nullptr>
-inline VTLhs operator/(const Lhs& lhs, const Rhs& rhs) noexcept {
+constexpr VTLhs operator/(const Lhs& lhs, const Rhs& rhs) noexcept {
   return static_cast<const VTLhs&>(lhs) / static_cast<const VTVTLhs&>(rhs);
 }
 
 /*----------------------------------------------------------------------------*/
 
-template<typename Lhs, typename T, std::size_t ulp, typename C,
+template<typename Lhs, typename T, std::size_t ulp, typename C, typename M,
   typename std::enable_if_t<is_log_floating_point_v<Lhs>, void>* = nullptr>
-inline LogFloatingPoint<T, ulp, C>
-operator/(const Lhs& lhs, const LogFloatingPoint<T, ulp, C>& rhs) noexcept {
-  return static_cast<const LogFloatingPoint<T, ulp, C>&>(lhs) / rhs;
+constexpr LogFloatingPoint<T, ulp, C, M>
+operator/(const Lhs& lhs, const LogFloatingPoint<T, ulp, C, M>& rhs) noexcept {
+  return static_cast<const LogFloatingPoint<T, ulp, C, M>&>(lhs) / rhs;
 }
 
 /*----------------------------------------------------------------------------*/
 
-template<typename Lhs, typename T, std::size_t ulp, typename C,
+template<typename Lhs, typename T, std::size_t ulp, typename C, typename M,
   typename std::enable_if_t<!is_log_floating_point_v<Lhs>, void>* = nullptr>
-inline LogFloatingPoint<T, ulp, C>
-operator/(const Lhs& lhs, const LogFloatingPoint<T, ulp, C>& rhs) noexcept {
-  LogFloatingPoint<T, ulp, C> result(static_cast<const T&>(lhs));
+constexpr LogFloatingPoint<T, ulp, C, M>
+operator/(const Lhs& lhs, const LogFloatingPoint<T, ulp, C, M>& rhs) noexcept {
+  LogFloatingPoint<T, ulp, C, M> result(static_cast<const T&>(lhs));
   result /= rhs;
   return result;
 }
@@ -863,9 +1742,10 @@ template<typename Lhs, typename Rhs,
   typename VTRhs = typename Rhs::value_type,
   typename VTVTRhs = typename VTRhs::value_type,
   typename std::enable_if_t<
-    is_log_floating_point_v<VTRhs> && std::is_convertible_v<Lhs, VTVTRhs>,
+    is_log_floating_point_v<VTRhs> && std::is_convertible_v<Lhs, VTVTRhs>
+      && std::is_convertible_v<Rhs, VTRhs>,
   void>* = nullptr>
-inline VTRhs operator/(const Lhs& lhs, const Rhs& rhs) noexcept {
+constexpr VTRhs operator/(const Lhs& lhs, const Rhs& rhs) noexcept {
   return static_cast<const VTVTRhs&>(lhs) / static_cast<const VTRhs&>(rhs);
 }
 
@@ -873,10 +1753,10 @@ inline VTRhs operator/(const Lhs& lhs, const Rhs& rhs) noexcept {
 /*                                OPERATOR+                                   */
 /*----------------------------------------------------------------------------*/
 
-template<typename T, std::size_t ulp, typename C>
-inline LogFloatingPoint<T, ulp, C>
-operator+(LogFloatingPoint<T, ulp, C> lhs,
-          const LogFloatingPoint<T, ulp, C>& rhs) noexcept {
+template<typename T, std::size_t ulp, typename C, typename M>
+constexpr LogFloatingPoint<T, ulp, C, M>
+operator+(LogFloatingPoint<T, ulp, C, M> lhs,
+          const LogFloatingPoint<T, ulp, C, M>& rhs) noexcept {
   lhs += rhs;
   return lhs;
 }
@@ -887,28 +1767,30 @@ template<typename Lhs, typename Rhs,
   typename VTLhs = typename Lhs::value_type,
   typename VTRhs = typename Rhs::value_type,
   typename std::enable_if_t<
-    is_log_floating_point_v<VTLhs> && is_log_floating_point_v<VTRhs>,
+    is_log_floating_point_v<VTLhs> && is_log_floating_point_v<VTRhs>
+      && std::is_convertible_v<Lhs, VTLhs>
+      && std::is_convertible_v<Rhs, VTRhs>,
   void>* = nullptr>
-inline VTLhs operator+(const Lhs& lhs, const Rhs& rhs) noexcept {
+constexpr VTLhs operator+(const Lhs& lhs, const Rhs& rhs) noexcept {
   return static_cast<const VTLhs&>(lhs) + static_cast<const VTRhs&>(rhs);
 }
 
 /*----------------------------------------------------------------------------*/
 
-template<typename Rhs, typename T, std::size_t ulp, typename C,
+template<typename Rhs, typename T, std::size_t ulp, typename C, typename M,
   typename std::enable_if_t<is_log_floating_point_v<Rhs>, void>* = nullptr>
-inline LogFloatingPoint<T, ulp, C>
-operator+(const LogFloatingPoint<T, ulp, C>& lhs, const Rhs& rhs) noexcept {
-  return lhs + static_cast<const LogFloatingPoint<T, ulp, C>&>(rhs);
+constexpr LogFloatingPoint<T, ulp, C, M>
+operator+(const LogFloatingPoint<T, ulp, C, M>& lhs, const Rhs& rhs) noexcept {
+  return lhs + static_cast<const LogFloatingPoint<T, ulp, C, M>&>(rhs);
 }
 
 /*----------------------------------------------------------------------------*/
 
-template<typename Rhs, typename T, std::size_t ulp, typename C,
+template<typename Rhs, typename T, std::size_t ulp, typename C, typename M,
   typename std::enable_if_t<!is_log_floating_point_v<Rhs>, void>* = nullptr>
-inline LogFloatingPoint<T, ulp, C>
-operator+(const LogFloatingPoint<T, ulp, C>& lhs, const Rhs& rhs) noexcept {
-  return lhs + LogFloatingPoint<T, ulp, C>(static_cast<const T&>(rhs));
+constexpr LogFloatingPoint<T, ulp, C, M>
+operator+(const LogFloatingPoint<T, ulp, C, M>& lhs, const Rhs& rhs) noexcept {
+  return lhs + LogFloatingPoint<T, ulp, C, M>(static_cast<const T&>(rhs));
 }
 
 /*----------------------------------------------------------------------------*/
@@ -917,28 +1799,29 @@ template<typename Lhs, typename Rhs,
   typename VTLhs = typename Lhs::value_type,
   typename VTVTLhs = typename VTLhs::value_type,
   typename std::enable_if_t<
-    is_log_floating_point_v<VTLhs> && std::is_convertible_v<Rhs, VTVTLhs>,
+    is_log_floating_point_v<VTLhs> && std::is_convertible_v<Rhs, VTVTLhs>
+      && std::is_convertible_v<Lhs, VTLhs>,
   void>* = nullptr>
-inline VTLhs operator+(const Lhs& lhs, const Rhs& rhs) noexcept {
+constexpr VTLhs operator+(const Lhs& lhs, const Rhs& rhs) noexcept {
   return static_cast<const VTLhs&>(lhs) + static_cast<const VTVTLhs&>(rhs);
 }
 
 /*----------------------------------------------------------------------------*/
 
-template<typename Lhs, typename T, std::size_t ulp, typename C,
+template<typename Lhs, typename T, std::size_t ulp, typename C, typename M,
   typename std::enable_if_t<is_log_floating_point_v<Lhs>, void>* = nullptr>
-inline LogFloatingPoint<T, ulp, C>
-operator+(const Lhs& lhs, const LogFloatingPoint<T, ulp, C>& rhs) noexcept {
-  return static_cast<const LogFloatingPoint<T, ulp, C>&>(lhs) + rhs;
+constexpr LogFloatingPoint<T, ulp, C, M>
+operator+(const Lhs& lhs, const LogFloatingPoint<T, ulp, C, M>& rhs) noexcept {
+  return static_cast<const LogFloatingPoint<T, ulp, C, M>&>(lhs) + rhs;
 }
 
 /*----------------------------------------------------------------------------*/
 
-template<typename Lhs, typename T, std::size_t ulp, typename C,
+template<typename Lhs, typename T, std::size_t ulp, typename C, typename M,
   typename std::enable_if_t<!is_log_floating_point_v<Lhs>, void>* = nullptr>
-inline LogFloatingPoint<T, ulp, C>
-operator+(const Lhs& lhs, const LogFloatingPoint<T, ulp, C>& rhs) noexcept {
-  LogFloatingPoint<T, ulp, C> result(static_cast<const T&>(lhs));
+constexpr LogFloatingPoint<T, ulp, C, M>
+operator+(const Lhs& lhs, const LogFloatingPoint<T, ulp, C, M>& rhs) noexcept {
+  LogFloatingPoint<T, ulp, C, M> result(static_cast<const T&>(lhs));
   result += rhs;
   return result;
 }
@@ -949,9 +1832,10 @@ template<typename Lhs, typename Rhs,
   typename VTRhs = typename Rhs::value_type,
   typename VTVTRhs = typename VTRhs::value_type,
   typename std::enable_if_t<
-    is_log_floating_point_v<VTRhs> && std::is_convertible_v<Lhs, VTVTRhs>,
+    is_log_floating_point_v<VTRhs> && std::is_convertible_v<Lhs, VTVTRhs>
+      && std::is_convertible_v<Rhs, VTRhs>,
   void>* = nullptr>
-inline VTRhs operator+(const Lhs& lhs, const Rhs& rhs) noexcept {
+constexpr VTRhs operator+(const Lhs& lhs, const Rhs& rhs) noexcept {
   return static_cast<const VTVTRhs&>(lhs) + static_cast<const VTRhs&>(rhs);
 }
 
@@ -959,10 +1843,10 @@ inline VTRhs operator+(const Lhs& lhs, const Rhs& rhs) noexcept {
 /*                                OPERATOR-                                   */
 /*----------------------------------------------------------------------------*/
 
-template<typename T, std::size_t ulp, typename C>
-inline LogFloatingPoint<T, ulp, C>
-operator-(LogFloatingPoint<T, ulp, C> lhs,
-          const LogFloatingPoint<T, ulp, C>& rhs) noexcept {
+template<typename T, std::size_t ulp, typename C, typename M>
+constexpr LogFloatingPoint<T, ulp, C, M>
+operator-(LogFloatingPoint<T, ulp, C, M> lhs,
+          const LogFloatingPoint<T, ulp, C, M>& rhs) noexcept {
   lhs -= rhs;
   return lhs;
 }
@@ -973,28 +1857,30 @@ template<typename Lhs, typename Rhs,
   typename VTLhs = typename Lhs::value_type,
   typename VTRhs = typename Rhs::value_type,
   typename std::enable_if_t<
-    is_log_floating_point_v<VTLhs> && is_log_floating_point_v<VTRhs>,
+    is_log_floating_point_v<VTLhs> && is_log_floating_point_v<VTRhs>
+      && std::is_convertible_v<Lhs, VTLhs>
+      && std::is_convertible_v<Rhs, VTRhs>,
   void>* = nullptr>
-inline VTLhs operator-(const Lhs& lhs, const Rhs& rhs) noexcept {
+constexpr VTLhs operator-(const Lhs& lhs, const Rhs& rhs) noexcept {
   return static_cast<const VTLhs&>(lhs) - static_cast<const VTRhs&>(rhs);
 }
 
 /*----------------------------------------------------------------------------*/
 
-template<typename Rhs, typename T, std::size_t ulp, typename C,
+template<typename Rhs, typename T, std::size_t ulp, typename C, typename M,
   typename std::enable_if_t<is_log_floating_point_v<Rhs>, void>* = nullptr>
-inline LogFloatingPoint<T, ulp, C>
-operator-(const LogFloatingPoint<T, ulp, C>& lhs, const Rhs& rhs) noexcept {
-  return lhs - static_cast<const LogFloatingPoint<T, ulp, C>&>(rhs);
+constexpr LogFloatingPoint<T, ulp, C, M>
+operator-(const LogFloatingPoint<T, ulp, C, M>& lhs, const Rhs& rhs) noexcept {
+  return lhs - static_cast<const LogFloatingPoint<T, ulp, C, M>&>(rhs);
 }
 
 /*----------------------------------------------------------------------------*/
 
-template<typename Rhs, typename T, std::size_t ulp, typename C,
+template<typename Rhs, typename T, std::size_t ulp, typename C, typename M,
   typename std::enable_if_t<!is_log_floating_point_v<Rhs>, void>* = nullptr>
-inline LogFloatingPoint<T, ulp, C>
-operator-(const LogFloatingPoint<T, ulp, C>& lhs, const Rhs& rhs) noexcept {
-  return lhs - LogFloatingPoint<T, ulp, C>(static_cast<const T&>(rhs));
+constexpr LogFloatingPoint<T, ulp, C, M>
+operator-(const LogFloatingPoint<T, ulp, C, M>& lhs, const Rhs& rhs) noexcept {
+  return lhs - LogFloatingPoint<T, ulp, C, M>(static_cast<const T&>(rhs));
 }
 
 /*----------------------------------------------------------------------------*/
@@ -1003,28 +1889,29 @@ template<typename Lhs, typename Rhs,
   typename VTLhs = typename Lhs::value_type,
   typename VTVTLhs = typename VTLhs::value_type,
   typename std::enable_if_t<
-    is_log_floating_point_v<VTLhs> && std::is_convertible_v<Rhs, VTVTLhs>,
+    is_log_floating_point_v<VTLhs> && std::is_convertible_v<Rhs, VTVTLhs>
+      && std::is_convertible_v<Lhs, VTLhs>,
   void>* = nullptr>
-inline VTLhs operator-(const Lhs& lhs, const Rhs& rhs) noexcept {
+constexpr VTLhs operator-(const Lhs& lhs, const Rhs& rhs) noexcept {
   return static_cast<const VTLhs&>(lhs) - static_cast<const VTVTLhs&>(rhs);
 }
 
 /*----------------------------------------------------------------------------*/
 
-template<typename Lhs, typename T, std::size_t ulp, typename C,
+template<typename Lhs, typename T, std::size_t ulp, typename C, typename M,
   typename std::enable_if_t<is_log_floating_point_v<Lhs>, void>* = nullptr>
-inline LogFloatingPoint<T, ulp, C>
-operator-(const Lhs& lhs, const LogFloatingPoint<T, ulp, C>& rhs) noexcept {
-  return static_cast<const LogFloatingPoint<T, ulp, C>&>(lhs) - rhs;
+constexpr LogFloatingPoint<T, ulp, C, M>
+operator-(const Lhs& lhs, const LogFloatingPoint<T, ulp, C, M>& rhs) noexcept {
+  return static_cast<const LogFloatingPoint<T, ulp, C, M>&>(lhs) - rhs;
 }
 
 /*----------------------------------------------------------------------------*/
 
-template<typename Lhs, typename T, std::size_t ulp, typename C,
+template<typename Lhs, typename T, std::size_t ulp, typename C, typename M,
   typename std::enable_if_t<!is_log_floating_point_v<Lhs>, void>* = nullptr>
-inline LogFloatingPoint<T, ulp, C>
-operator-(const Lhs& lhs, const LogFloatingPoint<T, ulp, C>& rhs) noexcept {
-  LogFloatingPoint<T, ulp, C> result(static_cast<const T&>(lhs));
+constexpr LogFloatingPoint<T, ulp, C, M>
+operator-(const Lhs& lhs, const LogFloatingPoint<T, ulp, C, M>& rhs) noexcept {
+  LogFloatingPoint<T, ulp, C, M> result(static_cast<const T&>(lhs));
   result -= rhs;
   return result;
 }
@@ -1035,12 +1922,32 @@ template<typename Lhs, typename Rhs,
   typename VTRhs = typename Rhs::value_type,
   typename VTVTRhs = typename VTRhs::value_type,
   typename std::enable_if_t<
-    is_log_floating_point_v<VTRhs> && std::is_convertible_v<Lhs, VTVTRhs>,
+    is_log_floating_point_v<VTRhs> && std::is_convertible_v<Lhs, VTVTRhs>
+      && std::is_convertible_v<Rhs, VTRhs>,
   void>* = nullptr>
-inline VTRhs operator-(const Lhs& lhs, const Rhs& rhs) noexcept {
+constexpr VTRhs operator-(const Lhs& lhs, const Rhs& rhs) noexcept {
   return static_cast<const VTVTRhs&>(lhs) - static_cast<const VTRhs&>(rhs);
 }
 
+/*----------------------------------------------------------------------------*/
+/*                                MULTIPLY-ADD                                */
+/*----------------------------------------------------------------------------*/
+
+/**
+ * Fused multiply-add in log space: accumulates the product of a and b in
+ * acc (i.e., acc += a * b) without a temporary LogFloatingPoint, checking
+ * the range of the result only once.
+ */
+template<typename T, std::size_t ulp, typename C, typename M>
+constexpr LogFloatingPoint<T, ulp, C, M>&
+fma(LogFloatingPoint<T, ulp, C, M>& acc,
+    const LogFloatingPoint<T, ulp, C, M>& a,
+    const LogFloatingPoint<T, ulp, C, M>& b) noexcept {
+  acc.data() = M::add(acc.data(), a.data() + b.data());
+  C::check_range(acc.data());
+  return acc;
+}
+
 /*----------------------------------------------------------------------------*/
 /*                               EMPTY CHECKER                                */
 /*----------------------------------------------------------------------------*/
@@ -1056,10 +1963,10 @@ class EmptyChecker {
   using value_type = T;
 
   // Concrete methods
-  static void check_initial_value(value_type /* v */) {
+  static constexpr void check_initial_value(value_type /* v */) {
   }
 
-  static void check_range(value_type /* value */) {
+  static constexpr void check_range(value_type /* value */) {
   }
 };
 
@@ -1078,12 +1985,12 @@ class ProbabilityChecker {
   using value_type = T;
 
   // Concrete methods
-  static void check_initial_value(value_type v) {
+  static constexpr void check_initial_value(value_type v) {
     assert(v <= 1.0);
     UNUSED(v);  // Avoid 'unused variable' warning when 'assert' is disabled
   }
 
-  static void check_range(value_type value) {
+  static constexpr void check_range(value_type value) {
     assert(value <= limit);
     UNUSED(value);  // Avoid 'unused variable' warning when 'assert' is disabled
   }
@@ -1091,7 +1998,159 @@ class ProbabilityChecker {
  private:
   // Static variables
   static constexpr auto limit
-    = std::numeric_limits<value_type>::epsilon() * (1 << ulp);
+    = std::numeric_limits<value_type>::epsilon()
+      * detail::pow2<value_type>(ulp);
+};
+
+/*----------------------------------------------------------------------------*/
+/*                              COUNTING CHECKER                              */
+/*----------------------------------------------------------------------------*/
+
+/**
+ * @class CheckerCounts
+ * @brief Number of values verified by a CountingChecker, and how many of
+ *        them were not valid probabilities
+ */
+struct CheckerCounts {
+  std::uint64_t checks = 0;        ///< Values verified
+  std::uint64_t out_of_range = 0;  ///< Probabilities above 1 (or below 0)
+  std::uint64_t overflows = 0;     ///< Infinite probabilities
+  std::uint64_t underflows = 0;    ///< Initial values below the smallest normal
+  std::uint64_t nans = 0;          ///< Not a number
+
+  std::uint64_t violations() const noexcept {
+    return out_of_range + overflows + underflows + nans;
+  }
+};
+
+/*----------------------------------------------------------------------------*/
+
+/**
+ * @class CountingChecker
+ * @brief Counts values in LogFloatingPoint that are not probabilities,
+ *        instead of asserting (so that it also works in release builds)
+ *
+ * Counters are kept per thread, without synchronization, and flushed
+ * to process-wide counters (guarded by a mutex) every flush_period checks
+ * (and when the thread exits). snapshot() gives the counts flushed so far,
+ * plus the ones of the calling thread. reset() starts a new generation of
+ * counts: those that other threads collected before it are discarded
+ * instead of flushed. The generation is only changed with the mutex held,
+ * so a flush cannot add counts of an old generation after a reset.
+ *
+ * Underflows are only counted for initial values (positive, but below
+ * the smallest normal), as a logarithm below the one of the smallest
+ * normal is a valid (and representable) probability.
+ */
+template<typename T, std::size_t ulp>
+class CountingChecker {
+ public:
+  // Aliases
+  using value_type = T;
+
+  // Static variables
+  static constexpr std::uint64_t flush_period = 1024;
+
+  // Concrete methods
+  static void check_initial_value(value_type v) {
+    if (v >= 0 && v <= 1) {
+      count(v > 0 && v < std::numeric_limits<value_type>::min()
+              ? &CheckerCounts::underflows : nullptr);
+    } else {
+      count(std::isnan(v) ? &CheckerCounts::nans
+                          : v == infinity ? &CheckerCounts::overflows
+                                          : &CheckerCounts::out_of_range);
+    }
+  }
+
+  static void check_range(value_type value) {
+    if (value <= limit) {
+      count(nullptr);
+    } else {
+      count(std::isnan(value) ? &CheckerCounts::nans
+            : value == infinity ? &CheckerCounts::overflows
+                                : &CheckerCounts::out_of_range);
+    }
+  }
+
+  static CheckerCounts snapshot() {
+    std::lock_guard<std::mutex> lock(shared_mutex);
+    local.flush_locked();
+    return shared;
+  }
+
+  static void flush() {
+    local.flush();
+  }
+
+  /**
+   * Clears the shared counts and the local counts of the calling thread.
+   * Local counts of other threads are discarded in their next check or
+   * flush, so counts they collected before the reset are never reported.
+   */
+  static void reset() {
+    std::lock_guard<std::mutex> lock(shared_mutex);
+    shared = CheckerCounts();
+    local.counts = CheckerCounts();
+    local.generation
+      = shared_generation.fetch_add(1, std::memory_order_relaxed) + 1;
+  }
+
+ private:
+  // Inner structs
+  struct LocalCounts {
+    CheckerCounts counts;
+    std::uint64_t generation
+      = shared_generation.load(std::memory_order_relaxed);
+
+    ~LocalCounts() {
+      flush();
+    }
+
+    void discard_if_stale() {
+      auto current = shared_generation.load(std::memory_order_relaxed);
+      if (generation != current) {
+        counts = CheckerCounts();
+        generation = current;
+      }
+    }
+
+    void flush() {
+      std::lock_guard<std::mutex> lock(shared_mutex);
+      flush_locked();
+    }
+
+    // Requires shared_mutex, which also guards changes of the generation
+    void flush_locked() {
+      discard_if_stale();
+      shared.checks += counts.checks;
+      shared.out_of_range += counts.out_of_range;
+      shared.overflows += counts.overflows;
+      shared.underflows += counts.underflows;
+      shared.nans += counts.nans;
+      counts = CheckerCounts();
+    }
+  };
+
+  // Static variables
+  static constexpr auto infinity = std::numeric_limits<value_type>::infinity();
+
+  static constexpr auto limit
+    = std::numeric_limits<value_type>::epsilon()
+      * detail::pow2<value_type>(ulp);
+
+  static inline std::mutex shared_mutex;
+  static inline CheckerCounts shared;
+  static inline std::atomic<std::uint64_t> shared_generation { 0 };
+  static inline thread_local LocalCounts local;
+
+  // Concrete methods
+  static void count(std::uint64_t CheckerCounts::* violation) {
+    local.discard_if_stale();
+    auto& counts = local.counts;
+    if (violation) (counts.*violation)++;
+    if (++counts.checks % flush_period == 0) local.flush();
+  }
 };
 
 /*----------------------------------------------------------------------------*/
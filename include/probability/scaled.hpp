@@ -0,0 +1,199 @@
+/******************************************************************************/
+/*  Probability - A fast implementation of probabilities using logarithms     */
+/*  Copyright (C) 2016 Renato Cordeiro Ferreira                               */
+/*                                                                            */
+/*  This program is free software: you can redistribute it and/or modify      */
+/*  it under the terms of the GNU General Public License as published by      */
+/*  the Free Software Foundation, either version 3 of the License, or         */
+/*  (at your option) any later version.                                       */
+/*                                                                            */
+/*  This program is distributed in the hope that it will be useful,           */
+/*  but WITHOUT ANY WARRANTY; without even the implied warranty of            */
+/*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             */
+/*  GNU General Public License for more details.                              */
+/*                                                                            */
+/*  You should have received a copy of the GNU General Public License         */
+/*  along with this program.  If not, see <www.gnu.org/licenses>.             */
+/******************************************************************************/
+
+#ifndef PROBABILITY_SCALED_
+#define PROBABILITY_SCALED_
+
+// Standard headers
+#include <cmath>
+#include <limits>
+#include <vector>
+#include <cassert>
+#include <cstddef>
+
+// Internal headers
+#include "probability/numeric.hpp"
+#include "probability/vector.hpp"
+#include "probability/probability.hpp"
+
+namespace probability {
+
+/*----------------------------------------------------------------------------*/
+/*                            FORWARD DECLARATIONS                            */
+/*----------------------------------------------------------------------------*/
+
+template<typename T, std::size_t ulp = 0,
+         typename C = ProbabilityChecker<T, ulp>,
+         typename M = StandardMath<T>>
+class ScaledProbabilityColumn;
+
+/*----------------------------------------------------------------------------*/
+/*                         SCALED PROBABILITY COLUMN                          */
+/*----------------------------------------------------------------------------*/
+
+/**
+ * @class ScaledProbabilityColumn
+ * @tparam T Value type, used for internal store
+ * @tparam ulp Units in the last place, defining the accuracy
+ * @tparam C Checker type, used to inject methods that verify consistency
+ * @tparam M Math type, used to implement logarithms, exponentials and sums
+ * @brief Column of probabilities stored in linear space, scaled by a
+ *        common factor kept as a logarithm
+ *
+ * The probability in position i is data()[i] * exp(log_scale()). Columns
+ * are combined with plain multiplications and additions (one operation
+ * per term, instead of an exponential and a logarithm), and rescale()
+ * divides the column by its sum (or by its maximum, with MaxMath) to keep
+ * values away from underflows. Values smaller than the biggest one of the
+ * column by a factor beyond the range of T (e.g., 10^-308 for double) are
+ * rounded to zero, which LogFloatingPoint would represent.
+ */
+template<typename T, std::size_t ulp, typename C, typename M>
+class ScaledProbabilityColumn {
+ public:
+  // Aliases
+  using value_type = LogFloatingPoint<T, ulp, C, M>;
+  using raw_type = T;
+  using checker_type = C;
+  using math_type = M;
+  using allocator_type = AlignedAllocator<T>;
+  using size_type = std::size_t;
+
+  // Constructors
+  ScaledProbabilityColumn() = default;
+
+  explicit ScaledProbabilityColumn(size_type size) : values(size, T(0)) {
+  }
+
+  explicit ScaledProbabilityColumn(const LogVector<T, ulp, C, M>& logs)
+      : values(logs.size()) {
+    assign(logs.data(), logs.size());
+  }
+
+  // Concrete methods
+  size_type size() const noexcept {
+    return values.size();
+  }
+
+  bool empty() const noexcept {
+    return values.empty();
+  }
+
+  T* data() noexcept {
+    return values.data();
+  }
+
+  const T* data() const noexcept {
+    return values.data();
+  }
+
+  T& log_scale() noexcept {
+    return scale;
+  }
+
+  const T& log_scale() const noexcept {
+    return scale;
+  }
+
+  /**
+   * Probability in position i, converted to log space.
+   */
+  value_type operator[](size_type i) const {
+    assert(i < size());
+    return value_type::from_log(std::log(values[i]) + scale);
+  }
+
+  /**
+   * Sum of the column (its maximum, with MaxMath), in log space.
+   */
+  value_type sum() const {
+    return value_type::from_log(std::log(total()) + scale);
+  }
+
+  /**
+   * Divides the column by its sum (or maximum, with MaxMath), moving the
+   * factor to the scale. Columns of zeros are kept as they are.
+   */
+  void rescale() noexcept {
+    T factor = total();
+    if (factor == T(0)) return;
+
+    T inverse = T(1) / factor;
+    for (auto& value : values) value *= inverse;
+    scale += std::log(factor);
+  }
+
+  /**
+   * Replaces the column by raw logarithms (with the same size), scaled by
+   * their maximum.
+   */
+  void assign(const T* logs, size_type size) noexcept {
+    assert(size == this->size());
+
+    T max = detail::log_max(logs, size);
+    if (max == -std::numeric_limits<T>::infinity()) max = 0;
+
+    for (size_type i = 0; i < size; i++) values[i] = std::exp(logs[i] - max);
+    scale = max;
+  }
+
+  /**
+   * Converts the column back to log space.
+   */
+  LogVector<T, ulp, C, M> to_log_vector() const {
+    LogVector<T, ulp, C, M> logs(size());
+    for (size_type i = 0; i < size(); i++)
+      logs.data()[i] = (*this)[i].data();
+    return logs;
+  }
+
+ private:
+  // Instance variables
+  std::vector<T, allocator_type> values;
+  T scale = 0;
+
+  // Concrete methods
+  T total() const noexcept {
+    T result = 0;
+    for (const auto& value : values) {
+      if constexpr (is_max_math_v<M>) {
+        result = value > result ? value : result;
+      } else {
+        result += value;
+      }
+    }
+    return result;
+  }
+};
+
+/*----------------------------------------------------------------------------*/
+/*                                  ALIASES                                   */
+/*----------------------------------------------------------------------------*/
+
+using scaled_probability_column_float_t = ScaledProbabilityColumn<float>;
+using scaled_probability_column_double_t = ScaledProbabilityColumn<double>;
+using scaled_probability_column_long_double_t
+  = ScaledProbabilityColumn<long double>;
+
+using scaled_probability_column_t = scaled_probability_column_double_t;
+
+/*----------------------------------------------------------------------------*/
+
+}  // namespace probability
+
+#endif  // PROBABILITY_SCALED_
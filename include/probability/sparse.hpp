@@ -0,0 +1,597 @@
+/******************************************************************************/
+/*  Probability - A fast implementation of probabilities using logarithms     */
+/*  Copyright (C) 2016 Renato Cordeiro Ferreira                               */
+/*                                                                            */
+/*  This program is free software: you can redistribute it and/or modify      */
+/*  it under the terms of the GNU General Public License as published by      */
+/*  the Free Software Foundation, either version 3 of the License, or         */
+/*  (at your option) any later version.                                       */
+/*                                                                            */
+/*  This program is distributed in the hope that it will be useful,           */
+/*  but WITHOUT ANY WARRANTY; without even the implied warranty of            */
+/*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             */
+/*  GNU General Public License for more details.                              */
+/*                                                                            */
+/*  You should have received a copy of the GNU General Public License         */
+/*  along with this program.  If not, see <www.gnu.org/licenses>.             */
+/******************************************************************************/
+
+#ifndef PROBABILITY_SPARSE_
+#define PROBABILITY_SPARSE_
+
+// Standard headers
+#include <cmath>
+#include <tuple>
+#include <limits>
+#include <vector>
+#include <cassert>
+#include <cstddef>
+#include <algorithm>
+
+// Internal headers
+#include "probability/matrix.hpp"
+#include "probability/numeric.hpp"
+#include "probability/vector.hpp"
+#include "probability/probability.hpp"
+
+namespace probability {
+
+/*----------------------------------------------------------------------------*/
+/*                            FORWARD DECLARATIONS                            */
+/*----------------------------------------------------------------------------*/
+
+template<typename T, std::size_t ulp = 0, typename C = EmptyChecker<T>,
+         typename M = StandardMath<T>>
+class LogSparseMatrix;
+
+template<typename T, std::size_t ulp = 0, typename C = EmptyChecker<T>,
+         typename M = StandardMath<T>>
+class LogBandedMatrix;
+
+/*----------------------------------------------------------------------------*/
+/*                             LOG SPARSE MATRIX                              */
+/*----------------------------------------------------------------------------*/
+
+/**
+ * @class LogSparseMatrix
+ * @tparam T Value type, used for internal store
+ * @tparam ulp Units in the last place, defining the accuracy
+ * @tparam C Checker type, used to inject methods that verify consistency
+ * @tparam M Math type, used to implement logarithms, exponentials and sums
+ * @brief Sparse matrix of LogFloatingPoint in compressed sparse row (CSR)
+ *        layout, storing only the raw logarithms of nonzero entries
+ *
+ * The compressed sparse column (CSC) layout of a matrix is the CSR layout
+ * of its transpose: as products with a CSR matrix gather the entries of
+ * the vector (see gemv), the forward step of an HMM (a vector-matrix
+ * product) is fastest as the product of the transposed transitions with
+ * the vector.
+ */
+template<typename T, std::size_t ulp, typename C, typename M>
+class LogSparseMatrix {
+ public:
+  // Aliases
+  using value_type = LogFloatingPoint<T, ulp, C, M>;
+  using raw_type = T;
+  using checker_type = C;
+  using math_type = M;
+  using allocator_type = AlignedAllocator<T>;
+  using size_type = std::size_t;
+  using const_reference = value_type;
+  using entry_type = std::tuple<size_type, size_type, value_type>;
+  using dense_type = LogMatrix<T, ulp, C, M>;
+
+  // Constructors
+  LogSparseMatrix() = default;
+
+  LogSparseMatrix(size_type rows, size_type cols)
+      : n_rows(rows), n_cols(cols), offsets(rows + 1) {
+  }
+
+  /**
+   * Matrix with the given (row, column, value) entries, in any order
+   * (each entry must be given only once).
+   */
+  LogSparseMatrix(size_type rows, size_type cols,
+                  std::vector<entry_type> entries)
+      : LogSparseMatrix(rows, cols) {
+    std::sort(entries.begin(), entries.end(),
+              [](const entry_type& lhs, const entry_type& rhs) {
+                return std::get<0>(lhs) < std::get<0>(rhs)
+                    || (std::get<0>(lhs) == std::get<0>(rhs)
+                        && std::get<1>(lhs) < std::get<1>(rhs));
+              });
+
+    indices.reserve(entries.size());
+    values.reserve(entries.size());
+    for (const auto& [i, j, v] : entries) {
+      assert(i < n_rows && j < n_cols);
+      assert(values.empty() || offsets[i+1] == 0 || indices.back() < j);
+      indices.push_back(j);
+      values.push_back(v.data());
+      offsets[i+1]++;
+    }
+
+    for (size_type i = 0; i < n_rows; i++) offsets[i+1] += offsets[i];
+  }
+
+  /**
+   * Matrix with the nonzero entries of a dense matrix.
+   */
+  explicit LogSparseMatrix(const dense_type& dense)
+      : LogSparseMatrix(dense.rows(), dense.cols()) {
+    constexpr T zero = -std::numeric_limits<T>::infinity();
+    for (size_type i = 0; i < n_rows; i++) {
+      for (size_type j = 0; j < n_cols; j++) {
+        T value = dense.data()[i * n_cols + j];
+        if (value == zero) continue;
+        indices.push_back(j);
+        values.push_back(value);
+      }
+      offsets[i+1] = values.size();
+    }
+  }
+
+  // Operator overloads
+  /**
+   * Entry (i, j), found with a binary search in the row i (zero if the
+   * entry is not stored).
+   */
+  const_reference operator()(size_type i, size_type j) const noexcept {
+    assert(i < n_rows && j < n_cols);
+    auto first = indices.begin() + offsets[i];
+    auto last = indices.begin() + offsets[i+1];
+    auto it = std::lower_bound(first, last, j);
+    if (it == last || *it != j) return value_type();
+    return value_type::from_log_unchecked(values[it - indices.begin()]);
+  }
+
+  // Concrete methods
+  size_type rows() const noexcept {
+    return n_rows;
+  }
+
+  size_type cols() const noexcept {
+    return n_cols;
+  }
+
+  size_type nonzeros() const noexcept {
+    return values.size();
+  }
+
+  /**
+   * Transposed matrix (i.e., this matrix in CSC layout).
+   */
+  LogSparseMatrix transpose() const {
+    LogSparseMatrix result(n_cols, n_rows);
+    result.indices.resize(nonzeros());
+    result.values.resize(nonzeros());
+
+    for (auto j : indices) result.offsets[j+1]++;
+    for (size_type j = 0; j < n_cols; j++)
+      result.offsets[j+1] += result.offsets[j];
+
+    // Rows are visited in order, so each row of the result is sorted
+    std::vector<size_type> next(result.offsets.begin(),
+                                result.offsets.end() - 1);
+    for (size_type i = 0; i < n_rows; i++) {
+      for (size_type k = offsets[i]; k < offsets[i+1]; k++) {
+        size_type position = next[indices[k]]++;
+        result.indices[position] = i;
+        result.values[position] = values[k];
+      }
+    }
+
+    return result;
+  }
+
+  dense_type to_dense() const {
+    dense_type result(n_rows, n_cols);
+    for (size_type i = 0; i < n_rows; i++)
+      for (size_type k = offsets[i]; k < offsets[i+1]; k++)
+        result.data()[i * n_cols + indices[k]] = values[k];
+    return result;
+  }
+
+  /**
+   * Positions in column_indices() and data() where each row starts,
+   * followed by nonzeros().
+   */
+  const size_type* row_offsets() const noexcept {
+    return offsets.data();
+  }
+
+  const size_type* column_indices() const noexcept {
+    return indices.data();
+  }
+
+  T* data() noexcept {
+    return values.data();
+  }
+
+  const T* data() const noexcept {
+    return values.data();
+  }
+
+ private:
+  // Instance variables
+  size_type n_rows = 0;
+  size_type n_cols = 0;
+  std::vector<size_type> offsets;
+  std::vector<size_type> indices;
+  std::vector<T, allocator_type> values;
+};
+
+/*----------------------------------------------------------------------------*/
+/*                             LOG BANDED MATRIX                              */
+/*----------------------------------------------------------------------------*/
+
+/**
+ * @class LogBandedMatrix
+ * @tparam T Value type, used for internal store
+ * @tparam ulp Units in the last place, defining the accuracy
+ * @tparam C Checker type, used to inject methods that verify consistency
+ * @tparam M Math type, used to implement logarithms, exponentials and sums
+ * @brief Banded matrix of LogFloatingPoint, storing only the entries
+ *        (i, j) with -lower <= j - i <= upper, by diagonal
+ *
+ * Diagonals are contiguous and indexed by row, so products run along
+ * each diagonal with unit strides, in vectorized loops (as left-to-right
+ * models, where states only go to the next few states, have banded
+ * transitions).
+ */
+template<typename T, std::size_t ulp, typename C, typename M>
+class LogBandedMatrix {
+ public:
+  // Aliases
+  using value_type = LogFloatingPoint<T, ulp, C, M>;
+  using raw_type = T;
+  using checker_type = C;
+  using math_type = M;
+  using allocator_type = AlignedAllocator<T>;
+  using size_type = std::size_t;
+  using offset_type = std::ptrdiff_t;
+  using reference = LogReference<T, ulp, C, M>;
+  using const_reference = value_type;
+  using dense_type = LogMatrix<T, ulp, C, M>;
+
+  // Constructors
+  LogBandedMatrix() = default;
+
+  /**
+   * @param rows Number of rows
+   * @param cols Number of columns
+   * @param lower Number of diagonals below the main diagonal
+   * @param upper Number of diagonals above the main diagonal
+   * @param v Initial value of the entries in the band
+   */
+  LogBandedMatrix(size_type rows, size_type cols,
+                  size_type lower, size_type upper,
+                  const value_type& v = value_type())
+      : n_rows(rows), n_cols(cols), n_lower(lower), n_upper(upper),
+        values(rows * (lower + upper + 1), v.data()) {
+  }
+
+  // Operator overloads
+  reference operator()(size_type i, size_type j) noexcept {
+    assert(i < n_rows && j < n_cols && in_band(i, j));
+    return reference(diagonal(offset(i, j))[i]);
+  }
+
+  /**
+   * Entry (i, j) (zero if it is outside the band).
+   */
+  const_reference operator()(size_type i, size_type j) const noexcept {
+    assert(i < n_rows && j < n_cols);
+    if (!in_band(i, j)) return value_type();
+    return value_type::from_log_unchecked(diagonal(offset(i, j))[i]);
+  }
+
+  // Concrete methods
+  size_type rows() const noexcept {
+    return n_rows;
+  }
+
+  size_type cols() const noexcept {
+    return n_cols;
+  }
+
+  size_type lower() const noexcept {
+    return n_lower;
+  }
+
+  size_type upper() const noexcept {
+    return n_upper;
+  }
+
+  /**
+   * First row with an entry in the diagonal o (entries (i, i + o)).
+   */
+  size_type first_row(offset_type o) const noexcept {
+    return o < 0 ? std::min(static_cast<size_type>(-o), n_rows) : 0;
+  }
+
+  /**
+   * One past the last row with an entry in the diagonal o.
+   */
+  size_type last_row(offset_type o) const noexcept {
+    if (o >= 0 && static_cast<size_type>(o) >= n_cols) return 0;
+    return std::min(n_rows, static_cast<size_type>(
+        static_cast<offset_type>(n_cols) - o));
+  }
+
+  /**
+   * Raw logarithms of the diagonal o, between -lower() and upper(),
+   * indexed by row (valid only between first_row(o) and last_row(o)).
+   */
+  T* diagonal(offset_type o) noexcept {
+    assert(-o <= static_cast<offset_type>(n_lower));
+    assert(o <= static_cast<offset_type>(n_upper));
+    return values.data() + (o + static_cast<offset_type>(n_lower)) * n_rows;
+  }
+
+  const T* diagonal(offset_type o) const noexcept {
+    assert(-o <= static_cast<offset_type>(n_lower));
+    assert(o <= static_cast<offset_type>(n_upper));
+    return values.data() + (o + static_cast<offset_type>(n_lower)) * n_rows;
+  }
+
+  dense_type to_dense() const {
+    dense_type result(n_rows, n_cols);
+    for (auto o = -static_cast<offset_type>(n_lower);
+         o <= static_cast<offset_type>(n_upper); o++)
+      for (size_type i = first_row(o); i < last_row(o); i++)
+        result.data()[i * n_cols + (i + o)] = diagonal(o)[i];
+    return result;
+  }
+
+  T* data() noexcept {
+    return values.data();
+  }
+
+  const T* data() const noexcept {
+    return values.data();
+  }
+
+ private:
+  static offset_type offset(size_type i, size_type j) noexcept {
+    return static_cast<offset_type>(j) - static_cast<offset_type>(i);
+  }
+
+  bool in_band(size_type i, size_type j) const noexcept {
+    return j + n_lower >= i && j <= i + n_upper;
+  }
+
+  // Instance variables
+  size_type n_rows = 0;
+  size_type n_cols = 0;
+  size_type n_lower = 0;
+  size_type n_upper = 0;
+  std::vector<T, allocator_type> values;
+};
+
+/*----------------------------------------------------------------------------*/
+/*                                  ALIASES                                   */
+/*----------------------------------------------------------------------------*/
+
+using log_float_sparse_matrix_t = LogSparseMatrix<float>;
+using log_double_sparse_matrix_t = LogSparseMatrix<double>;
+using log_long_double_sparse_matrix_t = LogSparseMatrix<long double>;
+
+template<typename T, std::size_t ulp = 0>
+using ProbabilitySparseMatrix
+  = LogSparseMatrix<T, ulp, ProbabilityChecker<T, ulp>>;
+
+using probability_float_sparse_matrix_t = ProbabilitySparseMatrix<float>;
+using probability_double_sparse_matrix_t = ProbabilitySparseMatrix<double>;
+using probability_long_double_sparse_matrix_t
+  = ProbabilitySparseMatrix<long double>;
+
+using probability_sparse_matrix_t = probability_double_sparse_matrix_t;
+
+/*----------------------------------------------------------------------------*/
+
+using log_float_banded_matrix_t = LogBandedMatrix<float>;
+using log_double_banded_matrix_t = LogBandedMatrix<double>;
+using log_long_double_banded_matrix_t = LogBandedMatrix<long double>;
+
+template<typename T, std::size_t ulp = 0>
+using ProbabilityBandedMatrix
+  = LogBandedMatrix<T, ulp, ProbabilityChecker<T, ulp>>;
+
+using probability_float_banded_matrix_t = ProbabilityBandedMatrix<float>;
+using probability_double_banded_matrix_t = ProbabilityBandedMatrix<double>;
+using probability_long_double_banded_matrix_t
+  = ProbabilityBandedMatrix<long double>;
+
+using probability_banded_matrix_t = probability_double_banded_matrix_t;
+
+/*----------------------------------------------------------------------------*/
+/*                                  PRODUCTS                                  */
+/*----------------------------------------------------------------------------*/
+
+namespace detail {
+
+/**
+ * Sum of values[k] * vector[indices[k]] for k in [first, last), in the
+ * semiring of the math type: a maximum with MaxMath, and otherwise a
+ * log-sum-exp shifted by the maximum (one exponential per entry, and a
+ * single logarithm).
+ */
+template<typename T, typename M>
+T log_sparse_dot(const T* values, const std::size_t* indices,
+                 std::size_t first, std::size_t last,
+                 const T* vector) noexcept {
+  constexpr T zero = -std::numeric_limits<T>::infinity();
+
+  T max = zero;
+  for (std::size_t k = first; k < last; k++) {
+    T term = values[k] + vector[indices[k]];
+    max = term > max ? term : max;
+  }
+
+  if constexpr (is_max_math_v<M>) {
+    return max;
+  } else {
+    if (max == zero) return zero;
+    T sum = 0;
+    for (std::size_t k = first; k < last; k++)
+      sum += shifted_exp(values[k] + vector[indices[k]] - max);
+    return max + std::log(sum);
+  }
+}
+
+}  // namespace detail
+
+/*----------------------------------------------------------------------------*/
+
+/**
+ * Sparse matrix-vector product (result[i] = sum_j matrix(i, j) * vector[j]
+ * over the nonzero entries of the row i), written to a preallocated
+ * vector, which must not be the input vector.
+ */
+template<typename T, std::size_t ulp, typename C, typename M>
+void gemv(const LogSparseMatrix<T, ulp, C, M>& matrix,
+          const LogVector<T, ulp, C, M>& vector,
+          LogVector<T, ulp, C, M>& result) {
+  assert(matrix.cols() == vector.size());
+  assert(&result != &vector);
+
+  result.resize(matrix.rows());
+  const auto* offsets = matrix.row_offsets();
+  for (std::size_t i = 0; i < matrix.rows(); i++) {
+    result.data()[i] = detail::log_sparse_dot<T, M>(
+        matrix.data(), matrix.column_indices(), offsets[i], offsets[i+1],
+        vector.data());
+    C::check_range(result.data()[i]);
+  }
+}
+
+/*----------------------------------------------------------------------------*/
+
+/**
+ * Sparse vector-matrix product (result[j] = sum_i vector[i] * matrix(i, j)
+ * over the nonzero entries of the column j), written to a preallocated
+ * vector, which must not be the input vector. Each entry is scattered
+ * into the result with a log-add: products with the transpose (see gemv)
+ * are faster, when it can be precomputed.
+ */
+template<typename T, std::size_t ulp, typename C, typename M>
+void gevm(const LogVector<T, ulp, C, M>& vector,
+          const LogSparseMatrix<T, ulp, C, M>& matrix,
+          LogVector<T, ulp, C, M>& result) {
+  assert(matrix.rows() == vector.size());
+  assert(&result != &vector);
+
+  result.resize(matrix.cols());
+  result.fill(LogFloatingPoint<T, ulp, C, M>());
+
+  const auto* offsets = matrix.row_offsets();
+  const auto* indices = matrix.column_indices();
+  const T* values = matrix.data();
+  T* output = result.data();
+
+  for (std::size_t i = 0; i < matrix.rows(); i++) {
+    T x = vector.data()[i];
+    for (std::size_t k = offsets[i]; k < offsets[i+1]; k++)
+      output[indices[k]]
+        = detail::log_add_value<T, M>(output[indices[k]], x + values[k]);
+  }
+
+  for (std::size_t j = 0; j < result.size(); j++)
+    C::check_range(result.data()[j]);
+}
+
+/*----------------------------------------------------------------------------*/
+
+/**
+ * Banded matrix-vector product (result[i] = sum_j matrix(i, j) * vector[j]
+ * over the band), with a log-sum-exp shifted by the maximum of each output
+ * (see log_gbmv), written to a preallocated vector, which must not be the
+ * input vector.
+ */
+template<typename T, std::size_t ulp, typename C, typename M>
+void gemv(const LogBandedMatrix<T, ulp, C, M>& matrix,
+          const LogVector<T, ulp, C, M>& vector,
+          LogVector<T, ulp, C, M>& result) {
+  assert(matrix.cols() == vector.size());
+  assert(&result != &vector);
+
+  result.resize(matrix.rows());
+  detail::log_gbmv<T, M>(matrix.data(), matrix.rows(), matrix.cols(),
+                         matrix.lower(), matrix.upper(),
+                         vector.data(), result.data());
+
+  for (std::size_t i = 0; i < result.size(); i++)
+    C::check_range(result.data()[i]);
+}
+
+/*----------------------------------------------------------------------------*/
+
+/**
+ * Banded vector-matrix product (result[j] = sum_i vector[i] * matrix(i, j)
+ * over the band), with a log-sum-exp shifted by the maximum of each output
+ * (see log_gbvm), written to a preallocated vector, which must not be the
+ * input vector.
+ */
+template<typename T, std::size_t ulp, typename C, typename M>
+void gevm(const LogVector<T, ulp, C, M>& vector,
+          const LogBandedMatrix<T, ulp, C, M>& matrix,
+          LogVector<T, ulp, C, M>& result) {
+  assert(matrix.rows() == vector.size());
+  assert(&result != &vector);
+
+  result.resize(matrix.cols());
+  detail::log_gbvm<T, M>(vector.data(), matrix.data(), matrix.rows(),
+                         matrix.cols(), matrix.lower(), matrix.upper(),
+                         result.data());
+
+  for (std::size_t j = 0; j < result.size(); j++)
+    C::check_range(result.data()[j]);
+}
+
+/*----------------------------------------------------------------------------*/
+/*                                 OPERATOR*                                  */
+/*----------------------------------------------------------------------------*/
+
+template<typename T, std::size_t ulp, typename C, typename M>
+inline LogVector<T, ulp, C, M>
+operator*(const LogSparseMatrix<T, ulp, C, M>& lhs,
+          const LogVector<T, ulp, C, M>& rhs) {
+  LogVector<T, ulp, C, M> result(lhs.rows());
+  gemv(lhs, rhs, result);
+  return result;
+}
+
+template<typename T, std::size_t ulp, typename C, typename M>
+inline LogVector<T, ulp, C, M>
+operator*(const LogVector<T, ulp, C, M>& lhs,
+          const LogSparseMatrix<T, ulp, C, M>& rhs) {
+  LogVector<T, ulp, C, M> result(rhs.cols());
+  gevm(lhs, rhs, result);
+  return result;
+}
+
+template<typename T, std::size_t ulp, typename C, typename M>
+inline LogVector<T, ulp, C, M>
+operator*(const LogBandedMatrix<T, ulp, C, M>& lhs,
+          const LogVector<T, ulp, C, M>& rhs) {
+  LogVector<T, ulp, C, M> result(lhs.rows());
+  gemv(lhs, rhs, result);
+  return result;
+}
+
+template<typename T, std::size_t ulp, typename C, typename M>
+inline LogVector<T, ulp, C, M>
+operator*(const LogVector<T, ulp, C, M>& lhs,
+          const LogBandedMatrix<T, ulp, C, M>& rhs) {
+  LogVector<T, ulp, C, M> result(rhs.cols());
+  gevm(lhs, rhs, result);
+  return result;
+}
+
+/*----------------------------------------------------------------------------*/
+
+}  // namespace probability
+
+#endif  // PROBABILITY_SPARSE_
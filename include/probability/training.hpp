@@ -0,0 +1,475 @@
+/******************************************************************************/
+/*  Probability - A fast implementation of probabilities using logarithms     */
+/*  Copyright (C) 2016 Renato Cordeiro Ferreira                               */
+/*                                                                            */
+/*  This program is free software: you can redistribute it and/or modify      */
+/*  it under the terms of the GNU General Public License as published by      */
+/*  the Free Software Foundation, either version 3 of the License, or         */
+/*  (at your option) any later version.                                       */
+/*                                                                            */
+/*  This program is distributed in the hope that it will be useful,           */
+/*  but WITHOUT ANY WARRANTY; without even the implied warranty of            */
+/*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             */
+/*  GNU General Public License for more details.                              */
+/*                                                                            */
+/*  You should have received a copy of the GNU General Public License         */
+/*  along with this program.  If not, see <www.gnu.org/licenses>.             */
+/******************************************************************************/
+
+#ifndef PROBABILITY_TRAINING_
+#define PROBABILITY_TRAINING_
+
+// Standard headers
+#include <cmath>
+#include <chrono>
+#include <limits>
+#include <vector>
+#include <utility>
+#include <optional>
+#include <cassert>
+#include <cstddef>
+#include <algorithm>
+#include <type_traits>
+
+// Internal headers
+#include "probability/hmm.hpp"
+#include "probability/numeric.hpp"
+#include "probability/parallel.hpp"
+#include "probability/probability.hpp"
+
+namespace probability {
+
+/*----------------------------------------------------------------------------*/
+/*                            FORWARD DECLARATIONS                            */
+/*----------------------------------------------------------------------------*/
+
+template<typename T, std::size_t ulp = 0,
+         typename C = ProbabilityChecker<T, ulp>,
+         typename M = StandardMath<T>>
+class ExpectedCounts;
+
+template<typename T, std::size_t ulp = 0,
+         typename C = ProbabilityChecker<T, ulp>,
+         typename M = StandardMath<T>>
+class BaumWelch;
+
+/*----------------------------------------------------------------------------*/
+/*                              EXPECTED COUNTS                               */
+/*----------------------------------------------------------------------------*/
+
+/**
+ * @class ExpectedCounts
+ * @tparam T Value type, used for internal store
+ * @tparam ulp Units in the last place, defining the accuracy
+ * @tparam C Checker type, used to inject methods that verify consistency
+ * @tparam M Math type, used to implement logarithms, exponentials and sums
+ * @brief Expected number of starts, transitions and emissions of a hidden
+ *        Markov model, summed over a set of sequences (the E-step of
+ *        Baum-Welch), with a LogAccumulator per count
+ */
+template<typename T, std::size_t ulp, typename C, typename M>
+class ExpectedCounts {
+ public:
+  // Aliases
+  using accumulator_type = LogAccumulator<T>;
+  using size_type = std::size_t;
+
+  // Constructors
+  ExpectedCounts(size_type states, size_type symbols)
+      : n_states(states), n_symbols(symbols),
+        initial(states), transitions(states * states),
+        emissions(states * symbols) {
+  }
+
+  // Operator overloads
+  ExpectedCounts& operator+=(const ExpectedCounts& rhs) noexcept {
+    assert(states() == rhs.states() && symbols() == rhs.symbols());
+    merge(initial, rhs.initial);
+    merge(transitions, rhs.transitions);
+    merge(emissions, rhs.emissions);
+    total_log_likelihood += rhs.total_log_likelihood;
+    n_sequences += rhs.n_sequences;
+    return *this;
+  }
+
+  // Concrete methods
+  size_type states() const noexcept {
+    return n_states;
+  }
+
+  size_type symbols() const noexcept {
+    return n_symbols;
+  }
+
+  /**
+   * Number of sequences counted (sequences with probability zero are not).
+   */
+  size_type sequences() const noexcept {
+    return n_sequences;
+  }
+
+  /**
+   * Sum of the log-likelihoods of the sequences counted.
+   */
+  T log_likelihood() const noexcept {
+    return total_log_likelihood;
+  }
+
+  const accumulator_type& initial_count(size_type i) const noexcept {
+    assert(i < states());
+    return initial[i];
+  }
+
+  const accumulator_type& transition_count(size_type i,
+                                           size_type j) const noexcept {
+    assert(i < states() && j < states());
+    return transitions[i * states() + j];
+  }
+
+  const accumulator_type& emission_count(size_type i,
+                                         size_type k) const noexcept {
+    assert(i < states() && k < symbols());
+    return emissions[i * symbols() + k];
+  }
+
+ private:
+  // Instance variables
+  size_type n_states;
+  size_type n_symbols;
+  std::vector<accumulator_type> initial;
+  std::vector<accumulator_type> transitions;  // states x states
+  std::vector<accumulator_type> emissions;    // states x symbols
+  T total_log_likelihood = 0;
+  size_type n_sequences = 0;
+
+  // Concrete methods
+  void add(const T* initial_counts, const T* transition_counts,
+           const T* emission_counts, T log_likelihood) noexcept {
+    add(initial, initial_counts);
+    add(transitions, transition_counts);
+    add(emissions, emission_counts);
+    total_log_likelihood += log_likelihood;
+    n_sequences++;
+  }
+
+  // Static methods
+  static void add(std::vector<accumulator_type>& accumulators,
+                  const T* counts) noexcept {
+    for (size_type i = 0; i < accumulators.size(); i++)
+      if (counts[i] > 0) accumulators[i].add(std::log(counts[i]));
+  }
+
+  static void merge(std::vector<accumulator_type>& lhs,
+                    const std::vector<accumulator_type>& rhs) noexcept {
+    for (size_type i = 0; i < lhs.size(); i++) lhs[i] += rhs[i];
+  }
+
+  // Friendships
+  friend class BaumWelch<T, ulp, C, M>;
+};
+
+/*----------------------------------------------------------------------------*/
+/*                              TRAINING REPORT                               */
+/*----------------------------------------------------------------------------*/
+
+/**
+ * @class TrainingReport
+ * @brief Log-likelihood and throughput of iterations of Baum-Welch
+ */
+struct TrainingReport {
+  // Instance variables
+  std::size_t iterations = 0;
+  std::size_t sequences = 0;
+  double log_likelihood = -std::numeric_limits<double>::infinity();
+  double seconds = 0;
+
+  // Concrete methods
+  double sequences_per_second() const noexcept {
+    return seconds > 0 ? static_cast<double>(sequences) / seconds : 0;
+  }
+};
+
+/*----------------------------------------------------------------------------*/
+/*                                 BAUM WELCH                                 */
+/*----------------------------------------------------------------------------*/
+
+/**
+ * @class BaumWelch
+ * @tparam T Value type, used for internal store
+ * @tparam ulp Units in the last place, defining the accuracy
+ * @tparam C Checker type, used to inject methods that verify consistency
+ * @tparam M Math type, used to implement logarithms, exponentials and sums
+ * @brief Expectation-maximization training of a HiddenMarkovModel
+ *
+ * The E-step runs one task per group of sequences in a ThreadPool. Each
+ * task calculates the scaled forward and backward columns of a sequence
+ * (see ScaledProbabilityColumn), sums its posteriors in linear space
+ * (where they are between 0 and 1, with no logarithms or exponentials),
+ * and adds their logarithms to the ExpectedCounts of the thread running
+ * it. There are several tasks per thread, to balance the load, but only
+ * one table of counts per thread, and the tables are merged in pairs in
+ * parallel at the end. The M-step normalizes the counts in log space.
+ * Rows of states that were never visited keep their probabilities.
+ */
+template<typename T, std::size_t ulp, typename C, typename M>
+class BaumWelch {
+ public:
+  // Aliases
+  using model_type = HiddenMarkovModel<T, ulp, C, M>;
+  using counts_type = ExpectedCounts<T, ulp, C, M>;
+  using vector_type = typename model_type::vector_type;
+  using matrix_type = typename model_type::matrix_type;
+  using sequence_type = typename model_type::sequence_type;
+  using batch_type = std::vector<sequence_type>;
+  using size_type = std::size_t;
+
+  // Constructors
+  explicit BaumWelch(ThreadPool& thread_pool = default_thread_pool())
+      : pool(thread_pool) {
+  }
+
+  // Concrete methods
+  /**
+   * Expected counts of a model in a batch of sequences (E-step).
+   */
+  counts_type expectation(const model_type& model,
+                          const batch_type& batch) const {
+    size_type tasks = std::min(batch.size(), pool.size() * tasks_per_thread);
+
+    // Allocated by the first task of each thread
+    std::vector<std::optional<counts_type>> partials(pool.size());
+    std::vector<std::optional<Workspace>> workspaces(pool.size());
+
+    pool.for_each_in_worker(tasks, [&](size_type task, size_type worker) {
+      auto& partial = partials[worker];
+      auto& workspace = workspaces[worker];
+      if (!partial) partial.emplace(model.states(), model.symbols());
+      if (!workspace) workspace.emplace(model.states(), model.symbols());
+
+      for (size_type b = task; b < batch.size(); b += tasks)
+        count(model, batch[b], *workspace, *partial);
+    });
+    workspaces.clear();
+
+    partials.erase(std::remove(partials.begin(), partials.end(), std::nullopt),
+                   partials.end());
+    if (partials.empty()) return counts_type(model.states(), model.symbols());
+
+    // Tree reduction: each round merges pairs of tables in parallel
+    for (size_type stride = 1; stride < partials.size(); stride *= 2) {
+      size_type pairs = (partials.size() + 2 * stride - 1) / (2 * stride);
+      pool.for_each(pairs, [&](size_type pair) {
+        size_type i = 2 * stride * pair;
+        if (i + stride < partials.size()) *partials[i] += *partials[i + stride];
+      });
+    }
+    return std::move(*partials.front());
+  }
+
+  /**
+   * Model with the probabilities that maximize the expected counts
+   * (M-step), keeping the rows of the previous model with no counts.
+   */
+  static model_type maximization(const counts_type& counts,
+                                 const model_type& previous) {
+    assert(counts.states() == previous.states());
+    assert(counts.symbols() == previous.symbols());
+
+    size_type states = counts.states(), symbols = counts.symbols();
+
+    vector_type initial = previous.initial_probabilities();
+    normalize(initial.data(), 1, states,
+              [&](size_type, size_type i) -> const auto& {
+                return counts.initial_count(i);
+              });
+
+    matrix_type transitions = previous.transition_probabilities();
+    normalize(transitions.data(), states, states,
+              [&](size_type i, size_type j) -> const auto& {
+                return counts.transition_count(i, j);
+              });
+
+    matrix_type emissions = previous.emission_probabilities();
+    normalize(emissions.data(), states, symbols,
+              [&](size_type i, size_type k) -> const auto& {
+                return counts.emission_count(i, k);
+              });
+
+    return model_type(std::move(initial), std::move(transitions), emissions);
+  }
+
+  /**
+   * Replaces the model by the result of one iteration of Baum-Welch,
+   * reporting the log-likelihood of the batch in the previous model.
+   */
+  TrainingReport iterate(model_type& model, const batch_type& batch) const {
+    auto start = std::chrono::steady_clock::now();
+
+    counts_type counts = expectation(model, batch);
+    model = maximization(counts, model);
+
+    std::chrono::duration<double> elapsed
+      = std::chrono::steady_clock::now() - start;
+
+    TrainingReport report;
+    report.iterations = 1;
+    report.sequences = batch.size();
+    report.log_likelihood = static_cast<double>(counts.log_likelihood());
+    report.seconds = elapsed.count();
+    return report;
+  }
+
+  /**
+   * Iterates Baum-Welch until the log-likelihood of the batch improves
+   * less than the tolerance, or for at most the given iterations. The
+   * report accumulates the sequences and time of all iterations.
+   */
+  TrainingReport train(model_type& model, const batch_type& batch,
+                       size_type max_iterations, double tolerance) const {
+    TrainingReport report;
+    for (size_type i = 0; i < max_iterations; i++) {
+      TrainingReport step = iterate(model, batch);
+      double improvement = step.log_likelihood - report.log_likelihood;
+
+      report.iterations++;
+      report.sequences += step.sequences;
+      report.seconds += step.seconds;
+      report.log_likelihood = step.log_likelihood;
+
+      if (improvement < tolerance) break;
+    }
+    return report;
+  }
+
+ private:
+  // Validation
+  static_assert(!is_max_math_v<M>,
+      "Baum-Welch requires sums (use StandardMath or similar)");
+
+  // Inner classes
+  /**
+   * Linear counts of a single sequence.
+   */
+  struct Workspace {
+    std::vector<T> initial;
+    std::vector<T> transitions;  // states x states
+    std::vector<T> emissions;    // states x symbols
+    std::vector<T> next;
+
+    Workspace(size_type states, size_type symbols)
+        : initial(states), transitions(states * states),
+          emissions(states * symbols), next(states) {
+    }
+  };
+
+  // Static variables
+  static constexpr size_type tasks_per_thread = 4;  // Only for load balance
+
+  // Instance variables
+  ThreadPool& pool;
+
+  // Static methods
+  static void count(const model_type& model, const sequence_type& sequence,
+                    Workspace& workspace, counts_type& counts) {
+    if (sequence.empty()) return;
+
+    auto alpha = model.scaled_forward(sequence);
+    auto beta = model.scaled_backward(sequence);
+
+    T log_likelihood = alpha.back().sum().data();
+    if (log_likelihood == -std::numeric_limits<T>::infinity()) return;
+
+    size_type states = model.states();
+    const T* transitions = model.linear_transition_probabilities().data();
+    const T* emissions = model.linear_emission_probabilities().data();
+    std::fill(workspace.initial.begin(), workspace.initial.end(), 0);
+    std::fill(workspace.transitions.begin(), workspace.transitions.end(), 0);
+    std::fill(workspace.emissions.begin(), workspace.emissions.end(), 0);
+
+    // Posteriors of states, normalized in each position
+    for (size_type t = 0; t < sequence.size(); t++) {
+      const T* a = alpha[t].data();
+      const T* b = beta[t].data();
+
+      T total = 0;
+      for (size_type i = 0; i < states; i++) total += a[i] * b[i];
+      if (total == 0) continue;  // Underflow in linear space
+
+      T inverse = T(1) / total;
+      for (size_type i = 0; i < states; i++) {
+        T posterior = a[i] * b[i] * inverse;
+        if (t == 0) workspace.initial[i] = posterior;
+        workspace.emissions[i * model.symbols() + sequence[t]] += posterior;
+      }
+    }
+
+    // Posteriors of transitions, normalized in each position
+    for (size_type t = 0; t + 1 < sequence.size(); t++) {
+      const T* a = alpha[t].data();
+      const T* b = beta[t+1].data();
+      const T* emission = emissions + sequence[t+1] * states;
+
+      T* next = workspace.next.data();
+      for (size_type j = 0; j < states; j++) next[j] = emission[j] * b[j];
+
+      T total = 0;
+      for (size_type i = 0; i < states; i++) {
+        const T* transition = transitions + i * states;
+        T row = 0;
+        for (size_type j = 0; j < states; j++) row += transition[j] * next[j];
+        total += a[i] * row;
+      }
+      if (total == 0) continue;  // Underflow in linear space
+
+      T inverse = T(1) / total;
+      for (size_type i = 0; i < states; i++) {
+        const T* transition = transitions + i * states;
+        T* result = workspace.transitions.data() + i * states;
+        T weight = a[i] * inverse;
+        for (size_type j = 0; j < states; j++)
+          result[j] += weight * transition[j] * next[j];
+      }
+    }
+
+    counts.add(workspace.initial.data(), workspace.transitions.data(),
+               workspace.emissions.data(), log_likelihood);
+  }
+
+  /**
+   * Replaces each row of logarithms with counts by the counts divided by
+   * their sum, in log space.
+   */
+  template<typename Count>
+  static void normalize(T* logs, size_type rows, size_type cols,
+                        Count count) {
+    for (size_type i = 0; i < rows; i++) {
+      LogAccumulator<T> total;
+      for (size_type j = 0; j < cols; j++) total += count(i, j);
+
+      T log_total = total.data();
+      if (log_total == -std::numeric_limits<T>::infinity()) continue;
+
+      for (size_type j = 0; j < cols; j++) {
+        // Rounding may take the biggest probabilities slightly above 1
+        T value = count(i, j).data() - log_total;
+        logs[i * cols + j] = value < 0 ? value : 0;
+      }
+    }
+  }
+};
+
+/*----------------------------------------------------------------------------*/
+/*                                  ALIASES                                   */
+/*----------------------------------------------------------------------------*/
+
+using baum_welch_float_t = BaumWelch<float>;
+using baum_welch_double_t = BaumWelch<double>;
+using baum_welch_long_double_t = BaumWelch<long double>;
+
+using baum_welch_t = baum_welch_double_t;
+
+/*----------------------------------------------------------------------------*/
+
+}  // namespace probability
+
+#endif  // PROBABILITY_TRAINING_
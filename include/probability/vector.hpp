@@ -0,0 +1,600 @@
+/******************************************************************************/
+/*  Probability - A fast implementation of probabilities using logarithms     */
+/*  Copyright (C) 2016 Renato Cordeiro Ferreira                               */
+/*                                                                            */
+/*  This program is free software: you can redistribute it and/or modify      */
+/*  it under the terms of the GNU General Public License as published by      */
+/*  the Free Software Foundation, either version 3 of the License, or         */
+/*  (at your option) any later version.                                       */
+/*                                                                            */
+/*  This program is distributed in the hope that it will be useful,           */
+/*  but WITHOUT ANY WARRANTY; without even the implied warranty of            */
+/*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             */
+/*  GNU General Public License for more details.                              */
+/*                                                                            */
+/*  You should have received a copy of the GNU General Public License         */
+/*  along with this program.  If not, see <www.gnu.org/licenses>.             */
+/******************************************************************************/
+
+#ifndef PROBABILITY_VECTOR_
+#define PROBABILITY_VECTOR_
+
+// Standard headers
+#include <new>
+#include <vector>
+#include <cassert>
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+#include <initializer_list>
+
+// Internal headers
+#include "probability/numeric.hpp"
+#include "probability/probability.hpp"
+
+namespace probability {
+
+/*----------------------------------------------------------------------------*/
+/*                            FORWARD DECLARATIONS                            */
+/*----------------------------------------------------------------------------*/
+
+template<typename T, std::size_t ulp = 0, typename C = EmptyChecker<T>,
+         typename M = StandardMath<T>>
+class LogVector;
+
+/*----------------------------------------------------------------------------*/
+/*                             ALIGNED ALLOCATOR                              */
+/*----------------------------------------------------------------------------*/
+
+/**
+ * @class AlignedAllocator
+ * @tparam T Value type
+ * @tparam alignment Alignment (in bytes) of the allocated memory
+ * @brief Allocator for memory aligned to cache lines (and SIMD registers)
+ */
+template<typename T, std::size_t alignment = 64>
+class AlignedAllocator {
+ public:
+  // Aliases
+  using value_type = T;
+
+  template<typename U>
+  struct rebind {
+    using other = AlignedAllocator<U, alignment>;
+  };
+
+  // Constructors
+  AlignedAllocator() noexcept = default;
+
+  template<typename U>
+  AlignedAllocator(const AlignedAllocator<U, alignment>& /* other */) noexcept {
+  }
+
+  // Concrete methods
+  T* allocate(std::size_t size) {
+    return static_cast<T*>(
+        ::operator new(size * sizeof(T), std::align_val_t(alignment)));
+  }
+
+  void deallocate(T* pointer, std::size_t /* size */) noexcept {
+    ::operator delete(pointer, std::align_val_t(alignment));
+  }
+
+ private:
+  // Validation
+  static_assert(alignment >= alignof(T) && (alignment & (alignment - 1)) == 0,
+      "Alignment must be a power of 2 compatible with the value type");
+};
+
+/*----------------------------------------------------------------------------*/
+
+template<typename T, typename U, std::size_t alignment>
+inline bool operator==(const AlignedAllocator<T, alignment>& /* lhs */,
+                       const AlignedAllocator<U, alignment>& /* rhs */) {
+  return true;
+}
+
+template<typename T, typename U, std::size_t alignment>
+inline bool operator!=(const AlignedAllocator<T, alignment>& /* lhs */,
+                       const AlignedAllocator<U, alignment>& /* rhs */) {
+  return false;
+}
+
+/*----------------------------------------------------------------------------*/
+/*                               LOG REFERENCE                                */
+/*----------------------------------------------------------------------------*/
+
+/**
+ * @class LogReference
+ * @tparam T Value type, used for internal store
+ * @tparam ulp Units in the last place, defining the accuracy
+ * @tparam C Checker type, used to inject methods that verify consistency
+ * @tparam M Math type, used to implement logarithms, exponentials and sums
+ * @brief Proxy to a raw logarithm stored in a LogVector, which behaves
+ *        as the LogFloatingPoint it represents
+ */
+template<typename T, std::size_t ulp, typename C, typename M>
+class LogReference {
+ public:
+  // Aliases
+  using value_type = LogFloatingPoint<T, ulp, C, M>;
+
+  // Constructors
+  explicit LogReference(T& v) noexcept : value(v) {
+  }
+
+  LogReference(const LogReference&) noexcept = default;
+
+  // Operator overloads
+  LogReference& operator=(const LogReference& rhs) noexcept {
+    value = rhs.value;
+    return *this;
+  }
+
+  LogReference& operator=(const value_type& rhs) noexcept {
+    value = rhs.data();
+    return *this;
+  }
+
+  operator value_type() const noexcept {
+    return value_type::from_log_unchecked(value);
+  }
+
+  explicit operator T() const noexcept {
+    return M::exp(value);
+  }
+
+  LogReference& operator+=(const value_type& rhs) noexcept {
+    return *this = static_cast<value_type>(*this) += rhs;
+  }
+
+  LogReference& operator-=(const value_type& rhs) noexcept {
+    return *this = static_cast<value_type>(*this) -= rhs;
+  }
+
+  LogReference& operator*=(const value_type& rhs) noexcept {
+    return *this = static_cast<value_type>(*this) *= rhs;
+  }
+
+  LogReference& operator/=(const value_type& rhs) noexcept {
+    return *this = static_cast<value_type>(*this) /= rhs;
+  }
+
+  // Concrete methods
+  T& data() noexcept {
+    return value;
+  }
+
+  const T& data() const noexcept {
+    return value;
+  }
+
+ private:
+  // Instance variables
+  T& value;
+};
+
+/*----------------------------------------------------------------------------*/
+/*                                  ITERATOR                                  */
+/*----------------------------------------------------------------------------*/
+
+namespace detail {
+
+/**
+ * @class LogIterator
+ * @tparam Raw Type of the raw logarithms (const for constant iterators)
+ * @tparam Value LogFloatingPoint represented by the raw logarithms
+ * @tparam Reference Type returned when the iterator is dereferenced
+ * @brief Random access iterator over raw logarithms of a LogVector
+ */
+template<typename Raw, typename Value, typename Reference>
+class LogIterator {
+ public:
+  // Aliases
+  using iterator_category = std::random_access_iterator_tag;
+  using value_type = Value;
+  using difference_type = std::ptrdiff_t;
+  using reference = Reference;
+  using pointer = void;
+
+  // Constructors
+  LogIterator() noexcept = default;
+
+  explicit LogIterator(Raw* p) noexcept : position(p) {
+  }
+
+  template<typename OtherRaw, typename OtherReference,
+    typename std::enable_if_t<
+      std::is_convertible_v<OtherRaw*, Raw*>, void>* = nullptr>
+  LogIterator(const LogIterator<OtherRaw, Value, OtherReference>& other)
+      noexcept : position(other.base()) {
+  }
+
+  // Operator overloads
+  reference operator*() const noexcept {
+    if constexpr (std::is_const_v<Raw>) {
+      return value_type::from_log_unchecked(*position);
+    } else {
+      return reference(*position);
+    }
+  }
+
+  reference operator[](difference_type n) const noexcept {
+    return *(*this + n);
+  }
+
+  LogIterator& operator++() noexcept { ++position; return *this; }
+  LogIterator& operator--() noexcept { --position; return *this; }
+  LogIterator operator++(int) noexcept { return LogIterator(position++); }
+  LogIterator operator--(int) noexcept { return LogIterator(position--); }
+
+  LogIterator& operator+=(difference_type n) noexcept {
+    position += n;
+    return *this;
+  }
+
+  LogIterator& operator-=(difference_type n) noexcept {
+    position -= n;
+    return *this;
+  }
+
+  friend LogIterator operator+(LogIterator it, difference_type n) noexcept {
+    return it += n;
+  }
+
+  friend LogIterator operator+(difference_type n, LogIterator it) noexcept {
+    return it += n;
+  }
+
+  friend LogIterator operator-(LogIterator it, difference_type n) noexcept {
+    return it -= n;
+  }
+
+  friend difference_type operator-(const LogIterator& lhs,
+                                   const LogIterator& rhs) noexcept {
+    return lhs.position - rhs.position;
+  }
+
+  friend bool operator==(const LogIterator& lhs,
+                         const LogIterator& rhs) noexcept {
+    return lhs.position == rhs.position;
+  }
+
+  friend bool operator!=(const LogIterator& lhs,
+                         const LogIterator& rhs) noexcept {
+    return lhs.position != rhs.position;
+  }
+
+  friend bool operator<(const LogIterator& lhs,
+                        const LogIterator& rhs) noexcept {
+    return lhs.position < rhs.position;
+  }
+
+  friend bool operator<=(const LogIterator& lhs,
+                         const LogIterator& rhs) noexcept {
+    return lhs.position <= rhs.position;
+  }
+
+  friend bool operator>(const LogIterator& lhs,
+                        const LogIterator& rhs) noexcept {
+    return lhs.position > rhs.position;
+  }
+
+  friend bool operator>=(const LogIterator& lhs,
+                         const LogIterator& rhs) noexcept {
+    return lhs.position >= rhs.position;
+  }
+
+  // Concrete methods
+  Raw* base() const noexcept {
+    return position;
+  }
+
+ private:
+  // Instance variables
+  Raw* position = nullptr;
+};
+
+}  // namespace detail
+
+/*----------------------------------------------------------------------------*/
+/*                                 LOG VECTOR                                 */
+/*----------------------------------------------------------------------------*/
+
+/**
+ * @class LogVector
+ * @tparam T Value type, used for internal store
+ * @tparam ulp Units in the last place, defining the accuracy
+ * @tparam C Checker type, used to inject methods that verify consistency
+ * @tparam M Math type, used to implement logarithms, exponentials and sums
+ * @brief Contiguous sequence of LogFloatingPoint, stored as raw logarithms
+ *        in cache-aligned memory, with whole-vector operations that are
+ *        vectorized by the compiler
+ */
+template<typename T, std::size_t ulp, typename C, typename M>
+class LogVector {
+ public:
+  // Aliases
+  using value_type = LogFloatingPoint<T, ulp, C, M>;
+  using raw_type = T;
+  using checker_type = C;
+  using math_type = M;
+  using allocator_type = AlignedAllocator<T>;
+  using size_type = std::size_t;
+  using difference_type = std::ptrdiff_t;
+  using reference = LogReference<T, ulp, C, M>;
+  using const_reference = value_type;
+  using iterator = detail::LogIterator<T, value_type, reference>;
+  using const_iterator
+    = detail::LogIterator<const T, value_type, const_reference>;
+
+  // Constructors
+  LogVector() = default;
+
+  explicit LogVector(size_type size, const value_type& v = value_type())
+      : values(size, v.data()) {
+  }
+
+  LogVector(std::initializer_list<value_type> list)
+      : LogVector(list.begin(), list.end()) {
+  }
+
+  template<typename InputIt,
+    typename std::enable_if_t<
+      std::is_constructible_v<
+        value_type,
+        typename std::iterator_traits<InputIt>::reference>, void>* = nullptr>
+  LogVector(InputIt first, InputIt last) {
+    for (; first != last; ++first)
+      values.push_back(static_cast<value_type>(*first).data());
+  }
+
+  // Operator overloads
+  reference operator[](size_type i) noexcept {
+    return reference(values[i]);
+  }
+
+  const_reference operator[](size_type i) const noexcept {
+    return cbegin()[static_cast<difference_type>(i)];
+  }
+
+  LogVector& operator*=(const LogVector& rhs) noexcept {
+    assert(size() == rhs.size());
+    T* lhs_data = data();
+    const T* rhs_data = rhs.data();
+    for (size_type i = 0; i < size(); i++) lhs_data[i] += rhs_data[i];
+    check_range();
+    return *this;
+  }
+
+  LogVector& operator*=(const value_type& rhs) noexcept {
+    T* lhs_data = data();
+    const T rhs_value = rhs.data();
+    for (size_type i = 0; i < size(); i++) lhs_data[i] += rhs_value;
+    check_range();
+    return *this;
+  }
+
+  LogVector& operator/=(const LogVector& rhs) noexcept {
+    assert(size() == rhs.size());
+    T* lhs_data = data();
+    const T* rhs_data = rhs.data();
+    for (size_type i = 0; i < size(); i++) lhs_data[i] -= rhs_data[i];
+    check_range();
+    return *this;
+  }
+
+  LogVector& operator/=(const value_type& rhs) noexcept {
+    T* lhs_data = data();
+    const T rhs_value = rhs.data();
+    for (size_type i = 0; i < size(); i++) lhs_data[i] -= rhs_value;
+    check_range();
+    return *this;
+  }
+
+  LogVector& operator+=(const LogVector& rhs) noexcept {
+    assert(size() == rhs.size());
+    detail::log_add<T, M>(data(), rhs.data(), data(), size());
+    check_range();
+    return *this;
+  }
+
+  // Concrete methods
+  iterator begin() noexcept { return iterator(data()); }
+  iterator end() noexcept { return iterator(data() + size()); }
+
+  const_iterator begin() const noexcept { return cbegin(); }
+  const_iterator end() const noexcept { return cend(); }
+
+  const_iterator cbegin() const noexcept { return const_iterator(data()); }
+  const_iterator cend() const noexcept {
+    return const_iterator(data() + size());
+  }
+
+  size_type size() const noexcept {
+    return values.size();
+  }
+
+  bool empty() const noexcept {
+    return values.empty();
+  }
+
+  void resize(size_type size, const value_type& v = value_type()) {
+    values.resize(size, v.data());
+  }
+
+  void push_back(const value_type& v) {
+    values.push_back(v.data());
+  }
+
+  void fill(const value_type& v) noexcept {
+    for (auto& value : values) value = v.data();
+  }
+
+  T* data() noexcept {
+    return values.data();
+  }
+
+  const T* data() const noexcept {
+    return values.data();
+  }
+
+ private:
+  // Instance variables
+  std::vector<T, allocator_type> values;
+
+  // Concrete methods
+  void check_range() const {
+    for (const auto& value : values) checker_type::check_range(value);
+  }
+};
+
+/*----------------------------------------------------------------------------*/
+/*                                  ALIASES                                   */
+/*----------------------------------------------------------------------------*/
+
+using log_float_vector_t = LogVector<float>;
+using log_double_vector_t = LogVector<double>;
+using log_long_double_vector_t = LogVector<long double>;
+
+template<typename T, std::size_t ulp = 0>
+using ProbabilityVector = LogVector<T, ulp, ProbabilityChecker<T, ulp>>;
+
+using probability_float_vector_t = ProbabilityVector<float>;
+using probability_double_vector_t = ProbabilityVector<double>;
+using probability_long_double_vector_t = ProbabilityVector<long double>;
+
+using probability_vector_t = probability_double_vector_t;
+
+/*----------------------------------------------------------------------------*/
+/*                                 OPERATOR*                                  */
+/*----------------------------------------------------------------------------*/
+
+template<typename T, std::size_t ulp, typename C, typename M>
+inline LogVector<T, ulp, C, M>
+operator*(LogVector<T, ulp, C, M> lhs,
+          const LogVector<T, ulp, C, M>& rhs) noexcept {
+  lhs *= rhs;
+  return lhs;
+}
+
+template<typename T, std::size_t ulp, typename C, typename M>
+inline LogVector<T, ulp, C, M>
+operator*(LogVector<T, ulp, C, M> lhs,
+          const LogFloatingPoint<T, ulp, C, M>& rhs) noexcept {
+  lhs *= rhs;
+  return lhs;
+}
+
+template<typename T, std::size_t ulp, typename C, typename M>
+inline LogVector<T, ulp, C, M>
+operator*(const LogFloatingPoint<T, ulp, C, M>& lhs,
+          const LogVector<T, ulp, C, M>& rhs) noexcept {
+  LogVector<T, ulp, C, M> result(rhs);
+  result *= lhs;
+  return result;
+}
+
+/*----------------------------------------------------------------------------*/
+/*                                 OPERATOR/                                  */
+/*----------------------------------------------------------------------------*/
+
+template<typename T, std::size_t ulp, typename C, typename M>
+inline LogVector<T, ulp, C, M>
+operator/(LogVector<T, ulp, C, M> lhs,
+          const LogVector<T, ulp, C, M>& rhs) noexcept {
+  lhs /= rhs;
+  return lhs;
+}
+
+template<typename T, std::size_t ulp, typename C, typename M>
+inline LogVector<T, ulp, C, M>
+operator/(LogVector<T, ulp, C, M> lhs,
+          const LogFloatingPoint<T, ulp, C, M>& rhs) noexcept {
+  lhs /= rhs;
+  return lhs;
+}
+
+/*----------------------------------------------------------------------------*/
+/*                                 OPERATOR+                                  */
+/*----------------------------------------------------------------------------*/
+
+template<typename T, std::size_t ulp, typename C, typename M>
+inline LogVector<T, ulp, C, M>
+operator+(LogVector<T, ulp, C, M> lhs,
+          const LogVector<T, ulp, C, M>& rhs) noexcept {
+  lhs += rhs;
+  return lhs;
+}
+
+/*----------------------------------------------------------------------------*/
+/*                                MULTIPLY-ADD                                */
+/*----------------------------------------------------------------------------*/
+
+/**
+ * Element-wise fused multiply-add (acc += a * b), in one vectorized pass.
+ */
+template<typename T, std::size_t ulp, typename C, typename M>
+void fma(LogVector<T, ulp, C, M>& acc,
+         const LogVector<T, ulp, C, M>& a,
+         const LogVector<T, ulp, C, M>& b) {
+  assert(a.size() == acc.size() && b.size() == acc.size());
+  detail::log_fma<T, M>(acc.data(), a.data(), b.data(), acc.size());
+  for (std::size_t i = 0; i < acc.size(); i++) C::check_range(acc.data()[i]);
+}
+
+/*----------------------------------------------------------------------------*/
+
+/**
+ * Scaled fused multiply-add (acc += a * b, for a single value b), in one
+ * vectorized pass.
+ */
+template<typename T, std::size_t ulp, typename C, typename M>
+void fma(LogVector<T, ulp, C, M>& acc,
+         const LogVector<T, ulp, C, M>& a,
+         const LogFloatingPoint<T, ulp, C, M>& b) {
+  assert(a.size() == acc.size());
+  detail::log_fma<T, M, true>(acc.data(), a.data(), &b.data(), acc.size());
+  for (std::size_t i = 0; i < acc.size(); i++) C::check_range(acc.data()[i]);
+}
+
+/*----------------------------------------------------------------------------*/
+/*                                 REDUCTIONS                                 */
+/*----------------------------------------------------------------------------*/
+
+/**
+ * Sum of all elements, with a single log-sum-exp (or maximum, for MaxMath).
+ */
+template<typename T, std::size_t ulp, typename C, typename M>
+LogFloatingPoint<T, ulp, C, M> sum(const LogVector<T, ulp, C, M>& vector) {
+  return LogFloatingPoint<T, ulp, C, M>::from_log(
+      detail::log_sum<T, M>(vector.data(), vector.size()));
+}
+
+/*----------------------------------------------------------------------------*/
+
+/**
+ * Product of all elements, as a sum of their logarithms.
+ */
+template<typename T, std::size_t ulp, typename C, typename M>
+LogFloatingPoint<T, ulp, C, M> product(const LogVector<T, ulp, C, M>& vector) {
+  return LogFloatingPoint<T, ulp, C, M>::from_log(
+      detail::log_product(vector.data(), vector.size()));
+}
+
+/*----------------------------------------------------------------------------*/
+
+/**
+ * Biggest element (or zero, if the vector is empty).
+ */
+template<typename T, std::size_t ulp, typename C, typename M>
+LogFloatingPoint<T, ulp, C, M> max(const LogVector<T, ulp, C, M>& vector) {
+  return LogFloatingPoint<T, ulp, C, M>::from_log(
+      detail::log_max(vector.data(), vector.size()));
+}
+
+/*----------------------------------------------------------------------------*/
+
+}  // namespace probability
+
+#endif  // PROBABILITY_VECTOR_
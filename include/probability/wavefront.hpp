@@ -0,0 +1,239 @@
+/******************************************************************************/
+/*  Probability - A fast implementation of probabilities using logarithms     */
+/*  Copyright (C) 2016 Renato Cordeiro Ferreira                               */
+/*                                                                            */
+/*  This program is free software: you can redistribute it and/or modify      */
+/*  it under the terms of the GNU General Public License as published by      */
+/*  the Free Software Foundation, either version 3 of the License, or         */
+/*  (at your option) any later version.                                       */
+/*                                                                            */
+/*  This program is distributed in the hope that it will be useful,           */
+/*  but WITHOUT ANY WARRANTY; without even the implied warranty of            */
+/*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             */
+/*  GNU General Public License for more details.                              */
+/*                                                                            */
+/*  You should have received a copy of the GNU General Public License         */
+/*  along with this program.  If not, see <www.gnu.org/licenses>.             */
+/******************************************************************************/
+
+#ifndef PROBABILITY_WAVEFRONT_
+#define PROBABILITY_WAVEFRONT_
+
+// Standard headers
+#include <vector>
+#include <cassert>
+#include <cstddef>
+#include <algorithm>
+
+// Internal headers
+#include "probability/vector.hpp"
+#include "probability/parallel.hpp"
+#include "probability/probability.hpp"
+
+namespace probability {
+
+/*----------------------------------------------------------------------------*/
+/*                            FORWARD DECLARATIONS                            */
+/*----------------------------------------------------------------------------*/
+
+template<typename T, std::size_t ulp = 0, typename C = EmptyChecker<T>,
+         typename M = StandardMath<T>>
+class AntiDiagonalTable;
+
+/*----------------------------------------------------------------------------*/
+/*                            ANTI-DIAGONAL TABLE                             */
+/*----------------------------------------------------------------------------*/
+
+/**
+ * @class AntiDiagonalTable
+ * @tparam T Value type, used for internal store
+ * @tparam ulp Units in the last place, defining the accuracy
+ * @tparam C Checker type, used to inject methods that verify consistency
+ * @tparam M Math type, used to implement logarithms, exponentials and sums
+ * @brief Table of LogFloatingPoint stored by anti-diagonals (cells with
+ *        the same i + j), for dynamic programming in wavefronts
+ *
+ * Cells of an anti-diagonal are contiguous, and diagonal(d)[i] is the
+ * raw logarithm of cell (i, d - i): neighbors (i - 1, j), (i, j - 1) and
+ * (i - 1, j - 1) of all cells of a diagonal are read with unit strides
+ * from diagonal(d - 1) and diagonal(d - 2), so loops over a diagonal
+ * are vectorized with one cell per SIMD lane.
+ */
+template<typename T, std::size_t ulp, typename C, typename M>
+class AntiDiagonalTable {
+ public:
+  // Aliases
+  using value_type = LogFloatingPoint<T, ulp, C, M>;
+  using raw_type = T;
+  using allocator_type = AlignedAllocator<T>;
+  using size_type = std::size_t;
+  using reference = LogReference<T, ulp, C, M>;
+  using const_reference = value_type;
+
+  // Constructors
+  AntiDiagonalTable() = default;
+
+  AntiDiagonalTable(size_type rows, size_type cols,
+                    const value_type& v = value_type())
+      : n_rows(rows), n_cols(cols), offsets(rows + cols),
+        values(rows * cols, v.data()) {
+    for (size_type d = 1; d < diagonals(); d++)
+      offsets[d] = offsets[d-1] + (last_row(d-1) - first_row(d-1));
+  }
+
+  // Operator overloads
+  reference operator()(size_type i, size_type j) noexcept {
+    assert(i < n_rows && j < n_cols);
+    return reference(diagonal(i + j)[i]);
+  }
+
+  const_reference operator()(size_type i, size_type j) const noexcept {
+    assert(i < n_rows && j < n_cols);
+    return value_type::from_log_unchecked(diagonal(i + j)[i]);
+  }
+
+  // Concrete methods
+  size_type rows() const noexcept {
+    return n_rows;
+  }
+
+  size_type cols() const noexcept {
+    return n_cols;
+  }
+
+  size_type diagonals() const noexcept {
+    return n_rows == 0 || n_cols == 0 ? 0 : n_rows + n_cols - 1;
+  }
+
+  /**
+   * First row with a cell in the anti-diagonal d.
+   */
+  size_type first_row(size_type d) const noexcept {
+    return d < n_cols ? 0 : d - n_cols + 1;
+  }
+
+  /**
+   * One past the last row with a cell in the anti-diagonal d.
+   */
+  size_type last_row(size_type d) const noexcept {
+    return std::min(d + 1, n_rows);
+  }
+
+  /**
+   * Raw logarithms of the anti-diagonal d, indexed by row (valid only
+   * between first_row(d) and last_row(d)).
+   */
+  T* diagonal(size_type d) noexcept {
+    assert(d < diagonals());
+    return values.data() + offsets[d] - first_row(d);
+  }
+
+  const T* diagonal(size_type d) const noexcept {
+    assert(d < diagonals());
+    return values.data() + offsets[d] - first_row(d);
+  }
+
+  void fill(const value_type& v) noexcept {
+    for (auto& value : values) value = v.data();
+  }
+
+  T* data() noexcept {
+    return values.data();
+  }
+
+  const T* data() const noexcept {
+    return values.data();
+  }
+
+ private:
+  // Instance variables
+  size_type n_rows = 0;
+  size_type n_cols = 0;
+  std::vector<size_type> offsets;
+  std::vector<T, allocator_type> values;
+};
+
+/*----------------------------------------------------------------------------*/
+/*                                 WAVEFRONT                                  */
+/*----------------------------------------------------------------------------*/
+
+namespace detail {
+
+/**
+ * Calls kernel(d, first, last) for the anti-diagonals of the tile with
+ * rows [row_begin, row_end) and columns [col_begin, col_end), in order,
+ * where [first, last) are the rows of the cells of d inside the tile.
+ */
+template<typename Kernel>
+void wavefront_tile(std::size_t row_begin, std::size_t row_end,
+                    std::size_t col_begin, std::size_t col_end,
+                    Kernel& kernel) {
+  for (std::size_t d = row_begin + col_begin;
+       d + 1 < row_end + col_end; d++) {
+    std::size_t first = d + 1 > col_end ? d + 1 - col_end : 0;
+    first = std::max(first, row_begin);
+    std::size_t last = std::min(d - col_begin + 1, row_end);
+    if (first < last) kernel(d, first, last);
+  }
+}
+
+}  // namespace detail
+
+/*----------------------------------------------------------------------------*/
+
+/**
+ * Runs a dynamic programming over a rows x cols grid, where each cell
+ * (i, j) depends only on cells (i', j') with i' <= i and j' <= j, by
+ * calling kernel(d, first, last) for each anti-diagonal d = i + j, in
+ * order, with the range [first, last) of the rows of its cells. Cells of
+ * an anti-diagonal are independent, and may be calculated in SIMD lanes.
+ */
+template<typename Kernel>
+void wavefront(std::size_t rows, std::size_t cols, Kernel kernel) {
+  detail::wavefront_tile(0, rows, 0, cols, kernel);
+}
+
+/*----------------------------------------------------------------------------*/
+
+/**
+ * Same as above, dividing the grid in tiles of tile x tile cells: tiles
+ * in the same anti-diagonal of tiles are independent, and are run in
+ * parallel in the thread pool, calling the kernel for the parts of the
+ * anti-diagonals inside them (so a kernel may be called many times for
+ * the same anti-diagonal, with disjoint ranges of rows).
+ */
+template<typename Kernel>
+void wavefront(ThreadPool& pool, std::size_t rows, std::size_t cols,
+               Kernel kernel, std::size_t tile = 256) {
+  assert(tile > 0);
+  if (rows == 0 || cols == 0) return;
+
+  std::size_t tile_rows = (rows + tile - 1) / tile;
+  std::size_t tile_cols = (cols + tile - 1) / tile;
+
+  for (std::size_t td = 0; td + 1 < tile_rows + tile_cols; td++) {
+    std::size_t first = td + 1 > tile_cols ? td + 1 - tile_cols : 0;
+    std::size_t last = std::min(td + 1, tile_rows);
+
+    pool.for_each(last - first, [&](std::size_t t) {
+      std::size_t ti = first + t, tj = td - ti;
+      detail::wavefront_tile(ti * tile, std::min((ti + 1) * tile, rows),
+                             tj * tile, std::min((tj + 1) * tile, cols),
+                             kernel);
+    });
+  }
+}
+
+/*----------------------------------------------------------------------------*/
+/*                                  ALIASES                                   */
+/*----------------------------------------------------------------------------*/
+
+using log_float_anti_diagonal_table_t = AntiDiagonalTable<float>;
+using log_double_anti_diagonal_table_t = AntiDiagonalTable<double>;
+using log_long_double_anti_diagonal_table_t = AntiDiagonalTable<long double>;
+
+/*----------------------------------------------------------------------------*/
+
+}  // namespace probability
+
+#endif  // PROBABILITY_WAVEFRONT_
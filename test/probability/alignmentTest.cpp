@@ -0,0 +1,204 @@
+/******************************************************************************/
+/*  Probability - A fast implementation of probabilities using logarithms     */
+/*  Copyright (C) 2016 Renato Cordeiro Ferreira                               */
+/*                                                                            */
+/*  This program is free software: you can redistribute it and/or modify      */
+/*  it under the terms of the GNU General Public License as published by      */
+/*  the Free Software Foundation, either version 3 of the License, or         */
+/*  (at your option) any later version.                                       */
+/*                                                                            */
+/*  This program is distributed in the hope that it will be useful,           */
+/*  but WITHOUT ANY WARRANTY; without even the implied warranty of            */
+/*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             */
+/*  GNU General Public License for more details.                              */
+/*                                                                            */
+/*  You should have received a copy of the GNU General Public License         */
+/*  along with this program.  If not, see <www.gnu.org/licenses>.             */
+/******************************************************************************/
+
+// Standard headers
+#include <cmath>
+#include <tuple>
+#include <random>
+#include <string>
+#include <vector>
+#include <cstddef>
+
+// External headers
+#include "gmock/gmock.h"
+
+// Tested header
+#include "probability/alignment.hpp"
+
+
+/*\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+/*----------------------------------------------------------------------------*/
+/*                             USING DECLARATIONS                             */
+/*----------------------------------------------------------------------------*/
+/*////////////////////////////////////////////////////////////////////////////*/
+
+using ::testing::Eq;
+using ::testing::Gt;
+using ::testing::DoubleNear;
+
+using probability::pair_hmm_t;
+using probability::ThreadPool;
+using probability::probability_t;
+
+#define DOUBLE(X) static_cast<double>(X)
+
+/*\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+/*----------------------------------------------------------------------------*/
+/*                                  FIXTURES                                  */
+/*----------------------------------------------------------------------------*/
+/*////////////////////////////////////////////////////////////////////////////*/
+
+using max_checker_t = probability::ProbabilityChecker<double, 0>;
+using max_math_t = probability::MaxMath<double>;
+using max_pair_hmm_t
+  = probability::PairHMM<double, 0, max_checker_t, max_math_t>;
+
+/*----------------------------------------------------------------------------*/
+
+static const double error_rate = 0.01;
+static const double open_rate = 0.001;
+static const double extension_rate = 0.1;
+
+/*----------------------------------------------------------------------------*/
+
+/**
+ * Forward algorithm of the pair-HMM in linear space, row by row.
+ */
+static double naive_likelihood(const std::string& read,
+                               const std::string& haplotype) {
+  std::size_t rows = read.size() + 1, cols = haplotype.size() + 1;
+  std::vector<double> m(rows * cols), x(rows * cols), y(rows * cols);
+  for (std::size_t j = 0; j < cols; j++)
+    y[j] = 1.0 / haplotype.size();
+
+  double mm = 1 - 2 * open_rate, gm = 1 - extension_rate;
+  for (std::size_t i = 1; i < rows; i++) {
+    for (std::size_t j = 1; j < cols; j++) {
+      std::size_t c = i * cols + j;
+      double prior = read[i-1] == haplotype[j-1]
+                   ? 1 - error_rate : error_rate / 3;
+      std::size_t diagonal = c - cols - 1, up = c - cols, left = c - 1;
+      m[c] = prior * (mm * m[diagonal] + gm * (x[diagonal] + y[diagonal]));
+      x[c] = open_rate * m[up] + extension_rate * x[up];
+      y[c] = open_rate * m[left] + extension_rate * y[left];
+    }
+  }
+
+  double result = 0;
+  for (std::size_t j = 1; j < cols; j++)
+    result += m[read.size() * cols + j] + x[read.size() * cols + j];
+  return result;
+}
+
+/*----------------------------------------------------------------------------*/
+
+static std::string random_bases(std::size_t size, std::mt19937& generator) {
+  std::uniform_int_distribution<int> base(0, 3);
+  std::string result;
+  for (std::size_t i = 0; i < size; i++) result += "ACGT"[base(generator)];
+  return result;
+}
+
+/*----------------------------------------------------------------------------*/
+
+struct AReadAndHaplotype
+    : public testing::TestWithParam<std::tuple<std::size_t, std::size_t>> {
+  pair_hmm_t hmm { error_rate, open_rate, extension_rate };
+  std::string read, haplotype;
+
+  void SetUp() override {
+    std::mt19937 generator(std::get<0>(GetParam()));
+    haplotype = random_bases(std::get<1>(GetParam()), generator);
+
+    // A part of the haplotype, with a mismatch, a deletion and an insertion
+    read = haplotype.substr(haplotype.size() / 4, haplotype.size() / 2);
+    if (read.size() > 8) {
+      read[1] = read[1] == 'A' ? 'C' : 'A';
+      read.erase(4, 1);
+      read.insert(6, "GG");
+    }
+  }
+};
+
+/*\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+/*----------------------------------------------------------------------------*/
+/*                                SIMPLE TESTS                                */
+/*----------------------------------------------------------------------------*/
+/*////////////////////////////////////////////////////////////////////////////*/
+
+TEST(PairHMM, MultipliesPriorAndTransitionOfASingleMatch) {
+  pair_hmm_t hmm(error_rate, open_rate, extension_rate);
+  auto start = 1 - extension_rate;
+  ASSERT_THAT(DOUBLE(hmm.likelihood("A", "A")),
+              DoubleNear((1 - error_rate) * start, 1e-12));
+  ASSERT_THAT(DOUBLE(hmm.likelihood("A", "C")),
+              DoubleNear(error_rate / 3 * start, 1e-12));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST(PairHMM, PrefersMatchesToMismatches) {
+  pair_hmm_t hmm(error_rate, open_rate, extension_rate);
+  ASSERT_THAT(hmm.likelihood("ACGT", "TTACGTTT"),
+              Gt(hmm.likelihood("ACCT", "TTACGTTT")));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST(PairHMM, CalculatesTheMostProbableAlignmentWithMaxMath) {
+  max_pair_hmm_t hmm(error_rate, open_rate, extension_rate);
+  std::string sequence = "ACGTTGCA";
+  double n = sequence.size();
+
+  auto expected = std::log(1 / n) + std::log(1 - extension_rate)
+                + n * std::log(1 - error_rate)
+                + (n - 1) * std::log(1 - 2 * open_rate);
+  ASSERT_THAT(hmm.likelihood(sequence, sequence).data(),
+              DoubleNear(expected, 1e-9));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST(PairHMM, KeepsProbabilitiesBelowTheRangeOfDouble) {
+  pair_hmm_t hmm(error_rate, open_rate, extension_rate);
+  std::string read(1000, 'A'), haplotype(1000, 'C');
+  auto likelihood = hmm.likelihood(read, haplotype);
+  ASSERT_THAT(DOUBLE(likelihood), Eq(0.0));
+  ASSERT_THAT(likelihood.data(), Gt(-10000.0));
+}
+
+/*\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+/*----------------------------------------------------------------------------*/
+/*                             TESTS WITH FIXTURE                             */
+/*----------------------------------------------------------------------------*/
+/*////////////////////////////////////////////////////////////////////////////*/
+
+TEST_P(AReadAndHaplotype, SumsAllAlignments) {
+  auto expected = std::log(naive_likelihood(read, haplotype));
+  ASSERT_THAT(hmm.likelihood(read, haplotype).data(),
+              DoubleNear(expected, 1e-9));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST_P(AReadAndHaplotype, SumsAllAlignmentsInTiles) {
+  ThreadPool pool(3);
+  auto expected = hmm.likelihood(read, haplotype).data();
+  for (std::size_t tile : { 1, 3, 16, 256 })
+    ASSERT_THAT(hmm.likelihood(pool, read, haplotype, tile).data(),
+                Eq(expected));
+}
+
+/*----------------------------------------------------------------------------*/
+
+INSTANTIATE_TEST_SUITE_P(Sizes, AReadAndHaplotype,
+    testing::Values(std::make_tuple(1, 4),
+                    std::make_tuple(2, 17),
+                    std::make_tuple(3, 64),
+                    std::make_tuple(4, 101),
+                    std::make_tuple(5, 300)));
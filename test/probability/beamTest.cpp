@@ -0,0 +1,247 @@
+/******************************************************************************/
+/*  Probability - A fast implementation of probabilities using logarithms     */
+/*  Copyright (C) 2016 Renato Cordeiro Ferreira                               */
+/*                                                                            */
+/*  This program is free software: you can redistribute it and/or modify      */
+/*  it under the terms of the GNU General Public License as published by      */
+/*  the Free Software Foundation, either version 3 of the License, or         */
+/*  (at your option) any later version.                                       */
+/*                                                                            */
+/*  This program is distributed in the hope that it will be useful,           */
+/*  but WITHOUT ANY WARRANTY; without even the implied warranty of            */
+/*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             */
+/*  GNU General Public License for more details.                              */
+/*                                                                            */
+/*  You should have received a copy of the GNU General Public License         */
+/*  along with this program.  If not, see <www.gnu.org/licenses>.             */
+/******************************************************************************/
+
+// Standard headers
+#include <cmath>
+#include <limits>
+#include <vector>
+#include <cstddef>
+
+// External headers
+#include "gmock/gmock.h"
+
+// Tested header
+#include "probability/beam.hpp"
+
+
+/*\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+/*----------------------------------------------------------------------------*/
+/*                             USING DECLARATIONS                             */
+/*----------------------------------------------------------------------------*/
+/*////////////////////////////////////////////////////////////////////////////*/
+
+using ::testing::Eq;
+using ::testing::Le;
+using ::testing::Lt;
+using ::testing::Gt;
+using ::testing::DoubleEq;
+using ::testing::DoubleNear;
+
+using probability::Beam;
+using probability::hmm_t;
+using probability::BeamReport;
+using probability::LogThreshold;
+using probability::beam_search_t;
+using probability::probability_matrix_t;
+using probability::probability_vector_t;
+
+#define DOUBLE(X) static_cast<double>(X)
+
+/*\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+/*----------------------------------------------------------------------------*/
+/*                                  FIXTURES                                  */
+/*----------------------------------------------------------------------------*/
+/*////////////////////////////////////////////////////////////////////////////*/
+
+static const auto infinity = std::numeric_limits<double>::infinity();
+
+/*----------------------------------------------------------------------------*/
+
+struct AnHMMWithABeam : public testing::Test {
+  static constexpr std::size_t states = 6;
+  static constexpr std::size_t symbols = 3;
+
+  probability_vector_t initial
+    = probability_vector_t { 0.5, 0.2, 0.1, 0.1, 0.1, 0.0 };
+  probability_matrix_t transitions
+    = probability_matrix_t(states, states);
+  probability_matrix_t emissions
+    = probability_matrix_t(states, symbols);
+
+  hmm_t::sequence_type sequence;
+
+  void SetUp() override {
+    // Each state goes to itself and to the next two (wrapping around)
+    for (std::size_t i = 0; i < states; i++) {
+      transitions(i, i) = 0.5;
+      transitions(i, (i + 1) % states) = 0.3;
+      transitions(i, (i + 2) % states) = 0.2;
+      for (std::size_t k = 0; k < symbols; k++)
+        emissions(i, k) = i % symbols == k ? 0.8 : 0.1;
+    }
+
+    for (std::size_t t = 0; t < 40; t++)
+      sequence.push_back((t * t + 3 * t) / 5 % symbols);
+  }
+
+  hmm_t hmm() const {
+    return hmm_t(initial, transitions, emissions);
+  }
+
+  // Log-probability of a path of states emitting the first symbols
+  double log_probability(const hmm_t::path_type& path) const {
+    double result = std::log(DOUBLE(initial[path[0]]))
+                  + std::log(DOUBLE(emissions(path[0], sequence[0])));
+    for (std::size_t t = 1; t < path.size(); t++)
+      result += std::log(DOUBLE(transitions(path[t-1], path[t])))
+              + std::log(DOUBLE(emissions(path[t], sequence[t])));
+    return result;
+  }
+
+  // Most probable path of the first symbols, by enumerating all paths
+  hmm_t::path_type brute_force_viterbi(std::size_t size) const {
+    std::size_t paths = 1;
+    for (std::size_t t = 0; t < size; t++) paths *= states;
+
+    hmm_t::path_type path(size), best;
+    double best_log = -infinity;
+    for (std::size_t p = 0; p < paths; p++) {
+      for (std::size_t t = 0, rest = p; t < size; t++, rest /= states)
+        path[t] = rest % states;
+      double log = log_probability(path);
+      if (log > best_log) {
+        best_log = log;
+        best = path;
+      }
+    }
+    return best;
+  }
+};
+
+/*\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+/*----------------------------------------------------------------------------*/
+/*                                SIMPLE TESTS                                */
+/*----------------------------------------------------------------------------*/
+/*////////////////////////////////////////////////////////////////////////////*/
+
+TEST(Beam, StoresTheLogarithmOfTheRatio) {
+  Beam<double> beam(LogThreshold<double>(1e-4), 16);
+  ASSERT_THAT(beam.log_ratio(), DoubleEq(std::log(1e-4)));
+  ASSERT_THAT(beam.max_states(), Eq(16u));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST(Beam, KeepsAllStatesWithinTheRatioByDefault) {
+  Beam<double> ratio(LogThreshold<double>(1e-4));
+  Beam<double> top(4);
+  ASSERT_THAT(ratio.max_states(), Eq(Beam<double>::unlimited));
+  ASSERT_THAT(top.log_ratio(), Eq(-infinity));
+}
+
+/*\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+/*----------------------------------------------------------------------------*/
+/*                             TESTS WITH FIXTURE                             */
+/*----------------------------------------------------------------------------*/
+/*////////////////////////////////////////////////////////////////////////////*/
+
+TEST_F(AnHMMWithABeam, IsExactWithAnUnlimitedBeam) {
+  auto model = hmm();
+  beam_search_t search(model, Beam<double>(Beam<double>::unlimited));
+
+  BeamReport report;
+  auto likelihood = search.likelihood(sequence, report);
+
+  ASSERT_THAT(likelihood.data(),
+              DoubleNear(model.likelihood(sequence).data(), 1e-9));
+  ASSERT_THAT(report.log_likelihood, Eq(likelihood.data()));
+  ASSERT_THAT(report.columns, Eq(sequence.size()));
+  ASSERT_THAT(report.pruned_states, Eq(0u));
+  ASSERT_THAT(report.pruned_mass, Eq(0.0));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST_F(AnHMMWithABeam, KeepsOnlyTheMostProbableStates) {
+  auto model = hmm();
+  beam_search_t search(model, Beam<double>(2));
+
+  BeamReport report;
+  auto likelihood = search.likelihood(sequence, report);
+
+  // All columns but the last one keep 2 states, which reach at most 6
+  ASSERT_THAT(report.active_states, Le(2 * (sequence.size() - 1) + 6));
+  ASSERT_THAT(report.pruned_states, Gt(0u));
+  ASSERT_THAT(report.pruned_mass, Gt(0.0));
+  ASSERT_THAT(likelihood, Lt(model.likelihood(sequence)));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST_F(AnHMMWithABeam, ApproachesTheLikelihoodAsTheBeamWidens) {
+  auto model = hmm();
+  auto exact = model.likelihood(sequence).data();
+
+  double previous_error = infinity, previous_mass = infinity;
+  for (double ratio : { 0.5, 0.1, 0.05, 1e-2, 1e-4 }) {
+    beam_search_t search(model, Beam<double>(LogThreshold<double>(ratio)));
+    BeamReport report;
+    auto error = exact - search.likelihood(sequence, report).data();
+
+    ASSERT_THAT(error, Le(previous_error));
+    ASSERT_THAT(report.pruned_mass, Le(previous_mass));
+    previous_error = error;
+    previous_mass = report.pruned_mass;
+  }
+  ASSERT_THAT(previous_error, DoubleNear(0.0, 1e-12));
+  ASSERT_THAT(previous_mass, Eq(0.0));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST_F(AnHMMWithABeam, FindsTheViterbiPath) {
+  sequence.resize(6);
+  auto model = hmm();
+  beam_search_t search(model, Beam<double>(Beam<double>::unlimited));
+
+  BeamReport report;
+  auto path = search.viterbi(sequence, report);
+
+  ASSERT_THAT(path, Eq(brute_force_viterbi(sequence.size())));
+  ASSERT_THAT(report.log_likelihood,
+              DoubleNear(log_probability(path), 1e-12));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST_F(AnHMMWithABeam, FindsAPathThroughTheKeptStates) {
+  auto model = hmm();
+  beam_search_t search(model, Beam<double>(LogThreshold<double>(1e-2), 2));
+
+  BeamReport report;
+  auto path = search.viterbi(sequence, report);
+
+  ASSERT_THAT(path.size(), Eq(sequence.size()));
+  ASSERT_THAT(report.log_likelihood,
+              DoubleNear(log_probability(path), 1e-9));
+  ASSERT_THAT(report.log_likelihood, Le(search.likelihood(sequence).data()));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST_F(AnHMMWithABeam, HasNoPathForImpossibleSequences) {
+  for (std::size_t i = 0; i < states; i++) emissions(i, 2) = 0.0;
+  for (std::size_t i = 0; i < states; i++) emissions(i, 0) = 0.9;
+  sequence = { 0, 1, 2, 0 };
+
+  auto model = hmm();
+  beam_search_t search(model, Beam<double>(4));
+
+  ASSERT_THAT(DOUBLE(search.likelihood(sequence)), Eq(0.0));
+  ASSERT_THAT(search.viterbi(sequence).empty(), Eq(true));
+}
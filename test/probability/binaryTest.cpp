@@ -0,0 +1,278 @@
+/******************************************************************************/
+/*  Probability - A fast implementation of probabilities using logarithms     */
+/*  Copyright (C) 2016 Renato Cordeiro Ferreira                               */
+/*                                                                            */
+/*  This program is free software: you can redistribute it and/or modify      */
+/*  it under the terms of the GNU General Public License as published by      */
+/*  the Free Software Foundation, either version 3 of the License, or         */
+/*  (at your option) any later version.                                       */
+/*                                                                            */
+/*  This program is distributed in the hope that it will be useful,           */
+/*  but WITHOUT ANY WARRANTY; without even the implied warranty of            */
+/*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             */
+/*  GNU General Public License for more details.                              */
+/*                                                                            */
+/*  You should have received a copy of the GNU General Public License         */
+/*  along with this program.  If not, see <www.gnu.org/licenses>.             */
+/******************************************************************************/
+
+// Standard headers
+#include <cmath>
+#include <cstdio>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <utility>
+
+// External headers
+#include "gmock/gmock.h"
+
+// Tested header
+#include "probability/binary.hpp"
+
+
+/*\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+/*----------------------------------------------------------------------------*/
+/*                             USING DECLARATIONS                             */
+/*----------------------------------------------------------------------------*/
+/*////////////////////////////////////////////////////////////////////////////*/
+
+using ::testing::Eq;
+using ::testing::DoubleEq;
+using ::testing::HasSubstr;
+
+using probability::LogSpanView;
+using probability::BinaryFormatError;
+using probability::log_float_t;
+using probability::log_double_t;
+using probability::probability_t;
+using probability::counting_probability_t;
+using probability::log_double_span_view_t;
+using probability::probability_span_view_t;
+
+using CountingChecker = counting_probability_t::checker_type;
+
+#define DOUBLE(X) static_cast<double>(X)
+
+/*\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+/*----------------------------------------------------------------------------*/
+/*                                  FIXTURES                                  */
+/*----------------------------------------------------------------------------*/
+/*////////////////////////////////////////////////////////////////////////////*/
+
+class ABinaryFile : public testing::Test {
+ protected:
+  std::string path = testing::TempDir() + "probability_binary_"
+    + testing::UnitTest::GetInstance()->current_test_info()->name();
+
+  std::vector<probability_t> probabilities { 0.0, 0.125, 0.25, 0.5 };
+
+  void SetUp() override {
+    probability::write_binary(path, probabilities);
+  }
+
+  void TearDown() override {
+    std::remove(path.c_str());
+  }
+};
+
+/*\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+/*----------------------------------------------------------------------------*/
+/*                                SIMPLE TESTS                                */
+/*----------------------------------------------------------------------------*/
+/*////////////////////////////////////////////////////////////////////////////*/
+
+TEST(LogSpanView, ThrowsIfTheFileDoesNotExist) {
+  ASSERT_THROW(probability_span_view_t("/nonexistent/probabilities.bin"),
+               BinaryFormatError);
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST(BinaryHeader, HasTheTypeOfTheValues) {
+  auto header = probability::make_binary_header<
+    double, 0, probability_t::checker_type, probability_t::math_type>(3);
+
+  ASSERT_THAT(header.version, Eq(1u));
+  ASSERT_THAT(header.value_type, Eq(2u));
+  ASSERT_THAT(header.value_size, Eq(sizeof(double)));
+  ASSERT_THAT(header.ulp, Eq(0u));
+  ASSERT_THAT(header.checker, Eq(1u));
+  ASSERT_THAT(header.size, Eq(3u));
+}
+
+/*\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+/*----------------------------------------------------------------------------*/
+/*                             TESTS WITH FIXTURE                             */
+/*----------------------------------------------------------------------------*/
+/*////////////////////////////////////////////////////////////////////////////*/
+
+TEST_F(ABinaryFile, CanBeReadInPlace) {
+  probability_span_view_t view(path);
+
+  ASSERT_THAT(view.size(), Eq(probabilities.size()));
+  for (std::size_t i = 0; i < view.size(); i++)
+    ASSERT_THAT(view[i].data(), Eq(probabilities[i].data()));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST_F(ABinaryFile, CanBeIterated) {
+  probability_span_view_t view(path);
+
+  probability_t sum;
+  for (const auto& p : view) sum += p * probability_t(0.5);
+
+  ASSERT_THAT(DOUBLE(sum), DoubleEq(0.4375));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST_F(ABinaryFile, CanBeSummedAsARange) {
+  probability_span_view_t view(path);
+  auto sum = probability::sum(view.begin(), view.end());
+  ASSERT_THAT(DOUBLE(sum), DoubleEq(0.875));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST_F(ABinaryFile, CanBeEmpty) {
+  probability::write_binary(path, std::vector<probability_t>());
+  probability_span_view_t view(path);
+  ASSERT_THAT(view.empty(), Eq(true));
+  ASSERT_THAT(view.begin(), Eq(view.end()));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST_F(ABinaryFile, HasAViewThatCanBeMoved) {
+  probability_span_view_t view(path);
+  auto other = std::move(view);
+  ASSERT_THAT(other.size(), Eq(probabilities.size()));
+  ASSERT_THAT(DOUBLE(other[2]), DoubleEq(0.25));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST_F(ABinaryFile, CannotBeReadWithADifferentChecker) {
+  ASSERT_THROW(log_double_span_view_t { path }, BinaryFormatError);
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST_F(ABinaryFile, CannotBeReadWithADifferentValueType) {
+  ASSERT_THROW(probability::ProbabilitySpanView<float> { path },
+               BinaryFormatError);
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST_F(ABinaryFile, CannotBeReadWithDifferentUnitsInTheLastPlace) {
+  using View = probability::ProbabilitySpanView<double, 2>;
+  ASSERT_THROW(View { path }, BinaryFormatError);
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST_F(ABinaryFile, CannotBeReadIfTruncated) {
+  std::ofstream(path, std::ios::binary | std::ios::app) << 'x';
+  ASSERT_THROW(probability_span_view_t { path }, BinaryFormatError);
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST_F(ABinaryFile, CannotBeReadIfItsHeaderSizeOverflows) {
+  // 2^61 + 4 values of 8 bytes wrap around to the 32 bytes of the file
+  std::uint64_t size = (std::uint64_t { 1 } << 61) + 4;
+  std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+  file.seekp(offsetof(probability::BinaryHeader, size));
+  file.write(reinterpret_cast<const char*>(&size), sizeof(size));
+  file.close();
+
+  ASSERT_THROW(probability_span_view_t { path }, BinaryFormatError);
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST_F(ABinaryFile, CannotBeReadIfItIsNotBinary) {
+  std::ofstream(path) << "0.0 0.125 0.5 1.0\n";
+  ASSERT_THROW(probability_span_view_t { path }, BinaryFormatError);
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST_F(ABinaryFile, CanBeReadWithLogFloats) {
+  std::vector<log_float_t> values { 1.0f, 2.0f, 3.0f };
+  probability::write_binary(path, values);
+
+  LogSpanView<float> view(path);
+
+  ASSERT_THAT(view.size(), Eq(3u));
+  ASSERT_THAT(view[1].data(), Eq(values[1].data()));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST_F(ABinaryFile, IsValid) {
+  probability::validate_binary<probability_t>(path);
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST_F(ABinaryFile, IsNotValidForADifferentType) {
+  ASSERT_THROW(probability::validate_binary<log_double_t>(path),
+               BinaryFormatError);
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST_F(ABinaryFile, IsNotValidIfAValueIsNotAProbability) {
+  probabilities.push_back(probability_t::from_log_unchecked(std::log(2.0)));
+  probability::write_binary(path, probabilities);
+  ASSERT_THROW(probability::validate_binary<probability_t>(path),
+               BinaryFormatError);
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST_F(ABinaryFile, IsNotValidIfAValueIsNaN) {
+  std::vector<log_double_t> values {
+    0.5, log_double_t::from_log_unchecked(std::nan(""))
+  };
+  probability::write_binary(path, values);
+  ASSERT_THROW(probability::validate_binary<log_double_t>(path),
+               BinaryFormatError);
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST_F(ABinaryFile, HasTheIndexOfTheInvalidValueInTheError) {
+  probabilities.push_back(probability_t::from_log_unchecked(std::log(2.0)));
+  probability::write_binary(path, probabilities);
+  try {
+    probability::validate_binary<probability_t>(path);
+    FAIL();
+  } catch (const BinaryFormatError& error) {
+    ASSERT_THAT(error.what(), HasSubstr(
+        "index " + std::to_string(probabilities.size() - 1)));
+  }
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST_F(ABinaryFile, HasValidValuesCountedByCountingCheckers) {
+  std::vector<counting_probability_t> values {
+    0.5, counting_probability_t::from_log_unchecked(std::log(2.0))
+  };
+  probability::write_binary(path, values);
+
+  CountingChecker::reset();
+  ASSERT_THROW(probability::validate_binary<counting_probability_t>(path),
+               BinaryFormatError);
+
+  auto counts = CountingChecker::snapshot();
+  ASSERT_THAT(counts.checks, Eq(1u));
+  ASSERT_THAT(counts.violations(), Eq(0u));
+}
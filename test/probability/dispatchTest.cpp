@@ -0,0 +1,335 @@
+/******************************************************************************/
+/*  Probability - A fast implementation of probabilities using logarithms     */
+/*  Copyright (C) 2016 Renato Cordeiro Ferreira                               */
+/*                                                                            */
+/*  This program is free software: you can redistribute it and/or modify      */
+/*  it under the terms of the GNU General Public License as published by      */
+/*  the Free Software Foundation, either version 3 of the License, or         */
+/*  (at your option) any later version.                                       */
+/*                                                                            */
+/*  This program is distributed in the hope that it will be useful,           */
+/*  but WITHOUT ANY WARRANTY; without even the implied warranty of            */
+/*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             */
+/*  GNU General Public License for more details.                              */
+/*                                                                            */
+/*  You should have received a copy of the GNU General Public License         */
+/*  along with this program.  If not, see <www.gnu.org/licenses>.             */
+/******************************************************************************/
+
+// Standard headers
+#include <cmath>
+#include <limits>
+#include <vector>
+#include <cstddef>
+#include <string>
+#include <cstdint>
+#include <algorithm>
+
+// External headers
+#include "gmock/gmock.h"
+
+// Tested header
+#include "probability/dispatch.hpp"
+
+// Internal headers
+#include "probability/half.hpp"
+#include "probability/numeric.hpp"
+
+
+/*\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+/*----------------------------------------------------------------------------*/
+/*                             USING DECLARATIONS                             */
+/*----------------------------------------------------------------------------*/
+/*////////////////////////////////////////////////////////////////////////////*/
+
+using ::testing::Eq;
+using ::testing::Le;
+using ::testing::IsTrue;
+using ::testing::IsFalse;
+using ::testing::DoubleNear;
+
+using probability::MaxMath;
+using probability::StandardMath;
+using probability::InstructionSet;
+
+namespace detail = probability::detail;
+
+/*\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+/*----------------------------------------------------------------------------*/
+/*                                  FIXTURES                                  */
+/*----------------------------------------------------------------------------*/
+/*////////////////////////////////////////////////////////////////////////////*/
+
+static const auto infinity = std::numeric_limits<double>::infinity();
+
+/*----------------------------------------------------------------------------*/
+
+// Exact log-sum-exp, computed one value at a time
+static double reference_log_sum_exp(const std::vector<double>& values) {
+  double max = -infinity;
+  for (double value : values) max = value > max ? value : max;
+  if (max == -infinity) return max;
+
+  double sum = 0.0;
+  for (double value : values) sum += std::exp(value - max);
+  return max + std::log(sum);
+}
+
+/*----------------------------------------------------------------------------*/
+
+// Logarithms of probabilities, with zeros, in sizes that exercise both the
+// vectorized and the scalar parts of the kernels
+struct AnInstructionSet : public testing::TestWithParam<InstructionSet> {
+  std::vector<double> lhs, rhs;
+  std::vector<float> floats;
+
+  void SetUp() override {
+    if (GetParam() > probability::supported_instruction_set())
+      GTEST_SKIP() << "CPU does not support " << to_string(GetParam());
+
+    for (std::size_t i = 0; i < 103; i++) {
+      lhs.push_back(i % 11 == 0 ? -infinity : -0.37 * i);
+      rhs.push_back(i % 13 == 0 ? -infinity : -1.0 - std::sin(i) * 0.5);
+      floats.push_back(i % 7 == 0 ? -static_cast<float>(infinity)
+                                  : -0.123f * static_cast<float>(i * i));
+    }
+  }
+};
+
+/*----------------------------------------------------------------------------*/
+
+static std::string name_of(
+    const testing::TestParamInfo<InstructionSet>& info) {
+  return to_string(info.param);
+}
+
+/*\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+/*----------------------------------------------------------------------------*/
+/*                                SIMPLE TESTS                                */
+/*----------------------------------------------------------------------------*/
+/*////////////////////////////////////////////////////////////////////////////*/
+
+TEST(InstructionSet, HasNames) {
+  ASSERT_THAT(std::string(to_string(InstructionSet::generic)), Eq("generic"));
+  ASSERT_THAT(std::string(to_string(InstructionSet::avx2)), Eq("avx2"));
+  ASSERT_THAT(std::string(to_string(InstructionSet::avx512)), Eq("avx512"));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST(InstructionSet, IsParsedFromItsName) {
+  InstructionSet set = InstructionSet::generic;
+  ASSERT_THAT(detail::parse_instruction_set("avx512", &set), IsTrue());
+  ASSERT_THAT(set, Eq(InstructionSet::avx512));
+  ASSERT_THAT(detail::parse_instruction_set("sse9", &set), IsFalse());
+  ASSERT_THAT(set, Eq(InstructionSet::avx512));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST(InstructionSet, CanBeNarrowedByName) {
+  ASSERT_THAT(detail::select_instruction_set(InstructionSet::avx512, "avx2"),
+              Eq(InstructionSet::avx2));
+  ASSERT_THAT(detail::select_instruction_set(InstructionSet::avx2, "generic"),
+              Eq(InstructionSet::generic));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST(InstructionSet, CannotBeWidenedByName) {
+  ASSERT_THAT(detail::select_instruction_set(InstructionSet::avx2, "avx512"),
+              Eq(InstructionSet::avx2));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST(InstructionSet, IgnoresMissingOrUnknownNames) {
+  ASSERT_THAT(detail::select_instruction_set(InstructionSet::avx2, nullptr),
+              Eq(InstructionSet::avx2));
+  ASSERT_THAT(detail::select_instruction_set(InstructionSet::avx2, "AVX2"),
+              Eq(InstructionSet::avx2));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST(InstructionSet, UsedIsSupported) {
+  ASSERT_THAT(probability::instruction_set(),
+              Le(probability::supported_instruction_set()));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST(InstructionSet, SelectsOnlyGenericKernelsWithoutIEEE754Traits) {
+  auto kernel = detail::log_sum_exp_kernel<long double>(InstructionSet::avx2);
+  ASSERT_THAT(kernel, Eq(detail::log_sum_exp_kernel<long double>(
+      InstructionSet::generic)));
+}
+
+/*\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+/*----------------------------------------------------------------------------*/
+/*                             TESTS WITH FIXTURE                             */
+/*----------------------------------------------------------------------------*/
+/*////////////////////////////////////////////////////////////////////////////*/
+
+TEST_P(AnInstructionSet, SumsLikeTheReference) {
+  auto kernel = detail::log_sum_exp_kernel<double>(GetParam());
+  for (std::size_t size : { 0, 1, 7, 8, 17, 103 }) {
+    auto values = std::vector<double>(lhs.begin(), lhs.begin() + size);
+    ASSERT_THAT(kernel(values.data(), size),
+                DoubleNear(reference_log_sum_exp(values), 1e-12));
+  }
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST_P(AnInstructionSet, AddsLikeTheReference) {
+  auto kernel = detail::log_add_kernel<double, StandardMath<double>>(
+      GetParam());
+
+  auto result = std::vector<double>(lhs.size());
+  kernel(lhs.data(), rhs.data(), result.data(), lhs.size());
+
+  for (std::size_t i = 0; i < lhs.size(); i++)
+    ASSERT_THAT(result[i],
+                DoubleNear(reference_log_sum_exp({ lhs[i], rhs[i] }), 1e-12));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST_P(AnInstructionSet, MultipliesAndAddsLikeTheReference) {
+  auto kernel = detail::log_fma_kernel<double, StandardMath<double>, false>(
+      GetParam());
+
+  auto acc = rhs;
+  kernel(acc.data(), lhs.data(), rhs.data(), lhs.size());
+
+  for (std::size_t i = 0; i < lhs.size(); i++)
+    ASSERT_THAT(acc[i], DoubleNear(
+        reference_log_sum_exp({ rhs[i], lhs[i] + rhs[i] }), 1e-12));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST_P(AnInstructionSet, MultipliesMatricesLikeTheReference) {
+  std::size_t rows = 9, cols = 11;
+  auto gemv = detail::log_gemv_kernel<double, StandardMath<double>>(
+      GetParam());
+  auto gevm = detail::log_gevm_kernel<double, MaxMath<double>>(GetParam());
+
+  auto by_column = std::vector<double>(rows);
+  auto by_row = std::vector<double>(cols);
+  gemv(lhs.data(), rows, cols, rhs.data(), by_column.data());
+  gevm(rhs.data(), lhs.data(), rows, cols, by_row.data());
+
+  for (std::size_t i = 0; i < rows; i++) {
+    std::vector<double> terms;
+    for (std::size_t j = 0; j < cols; j++)
+      terms.push_back(lhs[i * cols + j] + rhs[j]);
+    ASSERT_THAT(by_column[i],
+                DoubleNear(reference_log_sum_exp(terms), 1e-12));
+  }
+
+  for (std::size_t j = 0; j < cols; j++) {
+    double max = -infinity;
+    for (std::size_t i = 0; i < rows; i++)
+      max = std::max(max, rhs[i] + lhs[i * cols + j]);
+    ASSERT_THAT(by_row[j], Eq(max));
+  }
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST_P(AnInstructionSet, MultipliesBandedMatricesLikeTheReference) {
+  std::size_t rows = 9, cols = 11, lower = 2, upper = 3;
+  auto gbmv = detail::log_banded_product_kernel<
+    double, StandardMath<double>, false>(GetParam());
+  auto gbvm = detail::log_banded_product_kernel<
+    double, StandardMath<double>, true>(GetParam());
+
+  // Diagonal o of the matrix starts at lhs.data() + (o + lower) * rows
+  auto entry = [&](std::size_t i, std::size_t j) {
+    return lhs[(j + lower - i) * rows + i];
+  };
+  auto in_band = [&](std::size_t i, std::size_t j) {
+    return j + lower >= i && j <= i + upper;
+  };
+
+  auto by_column = std::vector<double>(rows);
+  auto by_row = std::vector<double>(cols);
+  gbmv(lhs.data(), rows, cols, lower, upper, rhs.data(), by_column.data());
+  gbvm(lhs.data(), rows, cols, lower, upper, rhs.data(), by_row.data());
+
+  for (std::size_t i = 0; i < rows; i++) {
+    std::vector<double> terms;
+    for (std::size_t j = 0; j < cols; j++)
+      if (in_band(i, j)) terms.push_back(entry(i, j) + rhs[j]);
+    ASSERT_THAT(by_column[i],
+                DoubleNear(reference_log_sum_exp(terms), 1e-12));
+  }
+
+  for (std::size_t j = 0; j < cols; j++) {
+    std::vector<double> terms;
+    for (std::size_t i = 0; i < rows; i++)
+      if (in_band(i, j)) terms.push_back(rhs[i] + entry(i, j));
+    ASSERT_THAT(by_row[j], DoubleNear(reference_log_sum_exp(terms), 1e-12));
+  }
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST_P(AnInstructionSet, AccumulatesLikeTheGenericVersion) {
+  auto kernel = detail::accumulate_shifted_exp_kernel<double, true>(
+      GetParam());
+  auto generic = detail::accumulate_shifted_exp_kernel<double, true>(
+      InstructionSet::generic);
+
+  double sum = 0.0, compensation = 0.0;
+  double generic_sum = 0.0, generic_compensation = 0.0;
+  kernel(lhs.data(), lhs.size(), -1.0, &sum, &compensation);
+  generic(lhs.data(), lhs.size(), -1.0, &generic_sum, &generic_compensation);
+
+  ASSERT_THAT(sum + compensation,
+              DoubleNear(generic_sum + generic_compensation, 1e-12));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST_P(AnInstructionSet, ConvertsHalvesLikeTheScalarVersion) {
+  auto narrow = detail::narrow_half_kernel(GetParam());
+  auto widen = detail::widen_half_kernel(GetParam());
+
+  auto halves = std::vector<std::uint16_t>(floats.size());
+  auto widened = std::vector<float>(floats.size());
+  narrow(floats.data(), halves.data(), floats.size());
+  widen(halves.data(), widened.data(), halves.size());
+
+  for (std::size_t i = 0; i < floats.size(); i++) {
+    ASSERT_THAT(halves[i], Eq(probability::Half::narrow(floats[i])));
+    ASSERT_THAT(widened[i], Eq(probability::Half::widen(halves[i])));
+  }
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST_P(AnInstructionSet, ConvertsBFloat16sLikeTheScalarVersion) {
+  auto narrow = detail::narrow_bfloat16_kernel(GetParam());
+  auto widen = detail::widen_bfloat16_kernel(GetParam());
+
+  auto bfloat16s = std::vector<std::uint16_t>(floats.size());
+  auto widened = std::vector<float>(floats.size());
+  narrow(floats.data(), bfloat16s.data(), floats.size());
+  widen(bfloat16s.data(), widened.data(), bfloat16s.size());
+
+  for (std::size_t i = 0; i < floats.size(); i++) {
+    ASSERT_THAT(bfloat16s[i], Eq(probability::BFloat16::narrow(floats[i])));
+    ASSERT_THAT(widened[i], Eq(probability::BFloat16::widen(bfloat16s[i])));
+  }
+}
+
+/*----------------------------------------------------------------------------*/
+
+INSTANTIATE_TEST_SUITE_P(EveryVersion, AnInstructionSet,
+                         testing::Values(InstructionSet::generic,
+                                         InstructionSet::avx2,
+                                         InstructionSet::avx512),
+                         name_of);
@@ -0,0 +1,214 @@
+/******************************************************************************/
+/*  Probability - A fast implementation of probabilities using logarithms     */
+/*  Copyright (C) 2016 Renato Cordeiro Ferreira                               */
+/*                                                                            */
+/*  This program is free software: you can redistribute it and/or modify      */
+/*  it under the terms of the GNU General Public License as published by      */
+/*  the Free Software Foundation, either version 3 of the License, or         */
+/*  (at your option) any later version.                                       */
+/*                                                                            */
+/*  This program is distributed in the hope that it will be useful,           */
+/*  but WITHOUT ANY WARRANTY; without even the implied warranty of            */
+/*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             */
+/*  GNU General Public License for more details.                              */
+/*                                                                            */
+/*  You should have received a copy of the GNU General Public License         */
+/*  along with this program.  If not, see <www.gnu.org/licenses>.             */
+/******************************************************************************/
+
+// Standard headers
+#include <limits>
+#include <type_traits>
+
+// External headers
+#include "gmock/gmock.h"
+
+// Tested header
+#include "probability/expression.hpp"
+
+
+/*\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+/*----------------------------------------------------------------------------*/
+/*                             USING DECLARATIONS                             */
+/*----------------------------------------------------------------------------*/
+/*////////////////////////////////////////////////////////////////////////////*/
+
+using ::testing::Eq;
+using ::testing::DoubleEq;
+using ::testing::DoubleNear;
+
+using probability::lazy;
+using probability::evaluate;
+using probability::log_double_t;
+using probability::probability_t;
+using probability::fast_probability_t;
+using probability::table_probability_t;
+using probability::max_probability_t;
+using probability::counting_probability_t;
+
+using CountingChecker = counting_probability_t::checker_type;
+
+#define DOUBLE(X) static_cast<double>(X)
+
+/*\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+/*----------------------------------------------------------------------------*/
+/*                                  FIXTURES                                  */
+/*----------------------------------------------------------------------------*/
+/*////////////////////////////////////////////////////////////////////////////*/
+
+static const auto infinity
+  = std::numeric_limits<probability_t::value_type>::infinity();
+
+/*----------------------------------------------------------------------------*/
+
+struct SomeProbabilities : public testing::Test {
+  probability_t a = 0.5, b = 0.25, c = 0.125, d = 0.75, e = 0.5, zero = 0.0;
+};
+
+/*\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+/*----------------------------------------------------------------------------*/
+/*                                SIMPLE TESTS                                */
+/*----------------------------------------------------------------------------*/
+/*////////////////////////////////////////////////////////////////////////////*/
+
+TEST(LazyExpression, IsTheValueItselfWhenEvaluatedDirectly) {
+  probability_t half = 0.5;
+  ASSERT_THAT(evaluate(lazy(half)), Eq(half));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST(LazyExpression, ChecksTheRangeOnlyWhenEvaluated) {
+  counting_probability_t a = 0.5, b = 0.25, c = 0.125, d = 0.75, e = 0.5;
+  CountingChecker::reset();
+
+  auto expression = lazy(a) * b * c + lazy(d) * e;
+  ASSERT_THAT(CountingChecker::snapshot().checks, Eq(0u));
+
+  counting_probability_t result = expression;
+  ASSERT_THAT(CountingChecker::snapshot().checks, Eq(1u));
+  ASSERT_THAT(DOUBLE(result), DoubleEq(0.390625));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST(LazyExpression, IsTheMaximumForMaxProbabilities) {
+  max_probability_t a = 0.5, b = 0.25, c = 0.75;
+  max_probability_t result = lazy(a) * b + c + lazy(b) * c;
+  ASSERT_THAT(DOUBLE(result), DoubleEq(0.75));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST(LazyExpression, HasTheSameSumAsEagerOperatorsForFastProbabilities) {
+  fast_probability_t a = 0.5, b = 0.25, c = 0.125, d = 0.75, e = 0.5;
+  fast_probability_t lazy_result = lazy(a) * b + lazy(c) * d + e * b;
+  fast_probability_t eager_result = a * b + c * d + e * b;
+  ASSERT_THAT(lazy_result.data(), Eq(eager_result.data()));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST(LazyExpression, HasTheSameSumAsEagerOperatorsForTableProbabilities) {
+  table_probability_t a = 0.5, b = 0.25, c = 0.125, d = 0.75, e = 0.5;
+  table_probability_t lazy_result = lazy(a) * b + lazy(c) * d + e * b;
+  table_probability_t eager_result = a * b + c * d + e * b;
+  ASSERT_THAT(lazy_result.data(), Eq(eager_result.data()));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST(LazyExpression, KeepsPrecisionForTermsWithVeryDifferentMagnitudes) {
+  log_double_t tiny = 1e-300, huge = 1e300;
+  log_double_t result = lazy(tiny) * tiny + lazy(huge) + lazy(tiny);
+  ASSERT_THAT(result.data(), DoubleEq(huge.data()));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST(LazyExpression, DiesIfTheResultIsNotAProbability) {
+  probability_t half = 0.5, three_quarters = 0.75;
+  ASSERT_DEATH(evaluate(lazy(half) + three_quarters), "");
+}
+
+/*\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+/*----------------------------------------------------------------------------*/
+/*                             TESTS WITH FIXTURE                             */
+/*----------------------------------------------------------------------------*/
+/*////////////////////////////////////////////////////////////////////////////*/
+
+TEST_F(SomeProbabilities, CollapseProductsIntoASumOfLogarithms) {
+  auto expression = lazy(a) * b * c / e;
+  ASSERT_TRUE((std::is_same_v<decltype(expression),
+                              probability::LogProduct<double, 0,
+                                  probability_t::checker_type,
+                                  probability_t::math_type>>));
+  ASSERT_THAT(expression.data(), DoubleEq(a.data() + b.data() + c.data()
+                                          - e.data()));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST_F(SomeProbabilities, CollapseSumsIntoASingleSumOfTerms) {
+  auto expression = lazy(a) * b * c + lazy(d) * e + c + lazy(b) * b;
+  ASSERT_THAT(expression.log_terms().size(), Eq(4u));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST_F(SomeProbabilities, HaveTheSameSumOfProductsAsEagerOperators) {
+  probability_t result = lazy(a) * b * c + lazy(d) * e;
+  ASSERT_THAT(result.data(), DoubleNear((a * b * c + d * e).data(), 1e-15));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST_F(SomeProbabilities, DistributeProductsOverSums) {
+  probability_t result = (lazy(a) + b) * c * (lazy(d) + e) / d;
+  ASSERT_THAT(DOUBLE(result), DoubleNear(0.75 * 0.125 * 1.25 / 0.75, 1e-15));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST_F(SomeProbabilities, CanBeAddedInAnyOrder) {
+  probability_t result = a + lazy(b) * c + (c + lazy(b) * c);
+  ASSERT_THAT(DOUBLE(result), DoubleEq(0.5 + 0.03125 + 0.125 + 0.03125));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST_F(SomeProbabilities, IgnoreZeros) {
+  probability_t result = lazy(zero) * a + lazy(zero) + b * zero + c;
+  ASSERT_THAT(DOUBLE(result), DoubleEq(0.125));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST_F(SomeProbabilities, AreZeroIfAllTermsAreZero) {
+  probability_t result = lazy(zero) * a + zero;
+  ASSERT_THAT(result.data(), Eq(-infinity));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST_F(SomeProbabilities, AccumulateAProductAsAMultiplyAdd) {
+  probability_t acc = c, expected = c;
+  acc += lazy(a) * b;
+  ASSERT_THAT(acc, Eq(probability::fma(expected, a, b)));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST_F(SomeProbabilities, AccumulateASum) {
+  probability_t acc = c;
+  acc += lazy(a) * b + lazy(c) * d;
+  ASSERT_THAT(DOUBLE(acc), DoubleEq(0.125 + 0.125 + 0.09375));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST_F(SomeProbabilities, CanBeComparedAfterEvaluation) {
+  ASSERT_THAT(evaluate(lazy(a) * b), Eq(b * a));
+}
+
+/*----------------------------------------------------------------------------*/
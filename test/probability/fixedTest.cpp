@@ -0,0 +1,230 @@
+/******************************************************************************/
+/*  Probability - A fast implementation of probabilities using logarithms     */
+/*  Copyright (C) 2016 Renato Cordeiro Ferreira                               */
+/*                                                                            */
+/*  This program is free software: you can redistribute it and/or modify      */
+/*  it under the terms of the GNU General Public License as published by      */
+/*  the Free Software Foundation, either version 3 of the License, or         */
+/*  (at your option) any later version.                                       */
+/*                                                                            */
+/*  This program is distributed in the hope that it will be useful,           */
+/*  but WITHOUT ANY WARRANTY; without even the implied warranty of            */
+/*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             */
+/*  GNU General Public License for more details.                              */
+/*                                                                            */
+/*  You should have received a copy of the GNU General Public License         */
+/*  along with this program.  If not, see <www.gnu.org/licenses>.             */
+/******************************************************************************/
+
+// Standard headers
+#include <cmath>
+#include <limits>
+#include <random>
+#include <vector>
+#include <cstdint>
+
+// External headers
+#include "gmock/gmock.h"
+
+// Tested header
+#include "probability/fixed.hpp"
+
+
+/*\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+/*----------------------------------------------------------------------------*/
+/*                             USING DECLARATIONS                             */
+/*----------------------------------------------------------------------------*/
+/*////////////////////////////////////////////////////////////////////////////*/
+
+using ::testing::Eq;
+using ::testing::Le;
+using ::testing::Ne;
+using ::testing::IsTrue;
+using ::testing::DoubleEq;
+using ::testing::DoubleNear;
+
+using probability::log_double_t;
+using probability::log_fixed16_t;
+using probability::log_fixed32_t;
+
+/*\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+/*----------------------------------------------------------------------------*/
+/*                                  FIXTURES                                  */
+/*----------------------------------------------------------------------------*/
+/*////////////////////////////////////////////////////////////////////////////*/
+
+static const auto infinity = std::numeric_limits<double>::infinity();
+
+/*----------------------------------------------------------------------------*/
+
+// Exact sum of two logarithms, to compare against the table
+static double log_sum(double lhs, double rhs) {
+  if (lhs == -infinity) return rhs;
+  if (rhs == -infinity) return lhs;
+  return std::max(lhs, rhs) + std::log1p(std::exp(-std::fabs(lhs - rhs)));
+}
+
+/*----------------------------------------------------------------------------*/
+
+// Pairs of logarithms of probabilities, generated from a seed
+struct PairsOfLogarithms : public testing::TestWithParam<unsigned> {
+  std::vector<double> lhs, rhs;
+
+  void SetUp() override {
+    std::mt19937 generator(GetParam());
+    std::uniform_real_distribution<double> distribution(-40.0, 0.0);
+    for (std::size_t i = 0; i < 10000; i++) {
+      lhs.push_back(distribution(generator));
+      rhs.push_back(i % 2 ? lhs.back() - i / 1000.0 : distribution(generator));
+    }
+  }
+};
+
+/*\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+/*----------------------------------------------------------------------------*/
+/*                                SIMPLE TESTS                                */
+/*----------------------------------------------------------------------------*/
+/*////////////////////////////////////////////////////////////////////////////*/
+
+TEST(LogFixedPoint, IsZeroByDefault) {
+  ASSERT_THAT(log_fixed16_t().data(), Eq(std::numeric_limits<int16_t>::min()));
+  ASSERT_THAT(log_fixed16_t().to_log(), Eq(-infinity));
+  ASSERT_THAT(static_cast<double>(log_fixed32_t()), Eq(0.0));
+  ASSERT_THAT(log_fixed32_t(), Eq(log_fixed32_t(0.0)));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST(LogFixedPoint, StoresRoundedLogarithm) {
+  ASSERT_THAT(log_fixed16_t(1.0).data(), Eq(0));
+  ASSERT_THAT(log_fixed16_t(0.5).data(), Eq(-44));  // -0.693 * 64 = -44.36
+  ASSERT_THAT(log_fixed32_t::from_log(-1.5).data(), Eq(-98304));
+  ASSERT_THAT(log_fixed32_t::from_log(-1.5).to_log(), DoubleEq(-1.5));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST(LogFixedPoint, SaturatesAtTheLimitsOfTheInteger) {
+  ASSERT_THAT(log_fixed16_t::from_log(-600.0), Eq(log_fixed16_t()));
+  ASSERT_THAT(log_fixed16_t::from_log(600.0).data(),
+              Eq(std::numeric_limits<int16_t>::max()));
+  ASSERT_THAT(log_fixed16_t(std::exp(-300.0)) * log_fixed16_t(std::exp(-300.0)),
+              Eq(log_fixed16_t()));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST(LogFixedPoint, MultipliesWithIntegerSums) {
+  auto a = log_fixed32_t::from_log(-1.25), b = log_fixed32_t::from_log(-2.5);
+  ASSERT_THAT((a * b).data(), Eq(a.data() + b.data()));
+  ASSERT_THAT((a / b).data(), Eq(a.data() - b.data()));
+  ASSERT_THAT(a * 1.0, Eq(a));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST(LogFixedPoint, KeepsZeroInProducts) {
+  log_fixed16_t zero, half(0.5);
+  ASSERT_THAT(zero * half, Eq(zero));
+  ASSERT_THAT(half * zero, Eq(zero));
+  ASSERT_THAT(zero / half, Eq(zero));
+  ASSERT_THAT(half * 0.0, Eq(zero));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST(LogFixedPoint, SumsWithZero) {
+  log_fixed32_t zero, half(0.5);
+  ASSERT_THAT(zero + half, Eq(half));
+  ASSERT_THAT(half + zero, Eq(half));
+  ASSERT_THAT(zero + zero, Eq(zero));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST(LogFixedPoint, SumsHalves) {
+  ASSERT_THAT(static_cast<double>(log_fixed16_t(0.5) + log_fixed16_t(0.5)),
+              DoubleNear(1.0, 1.0 / 64));
+  ASSERT_THAT(static_cast<double>(log_fixed32_t(0.5) + log_fixed32_t(0.5)),
+              DoubleNear(1.0, 1.0 / 65536));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST(LogFixedPoint, SubtractsInFloatingPoint) {
+  ASSERT_THAT(static_cast<double>(log_fixed32_t(0.7) - log_fixed32_t(0.2)),
+              DoubleNear(0.5, 1e-4));
+  ASSERT_THAT(log_fixed32_t(0.7) - log_fixed32_t(), Eq(log_fixed32_t(0.7)));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST(LogFixedPoint, ComparesLogarithms) {
+  log_fixed16_t small(0.25), big(0.75);
+  ASSERT_THAT(small < big, IsTrue());
+  ASSERT_THAT(big >= small, IsTrue());
+  ASSERT_THAT(small != big, IsTrue());
+  ASSERT_THAT(small <= 0.25, IsTrue());
+  ASSERT_THAT(0.5 > small, IsTrue());
+  ASSERT_THAT(log_fixed16_t() < small, IsTrue());
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST(LogFixedPoint, ConvertsFromLogFloatingPoint) {
+  ASSERT_THAT(log_fixed32_t(log_double_t(0.5)), Eq(log_fixed32_t(0.5)));
+  ASSERT_THAT(log_fixed32_t(log_double_t(0.0)), Eq(log_fixed32_t()));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST(LogFixedPoint, IsConstexpr) {
+  constexpr log_fixed32_t half(0.5);
+  constexpr auto product = half * half;
+  constexpr auto sum = half + half;
+  static_assert(product == log_fixed32_t(0.25));
+  static_assert(sum.data() >= -1 && sum.data() <= 1);
+  ASSERT_THAT(product, Ne(sum));
+}
+
+/*\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+/*----------------------------------------------------------------------------*/
+/*                             TESTS WITH FIXTURE                             */
+/*----------------------------------------------------------------------------*/
+/*////////////////////////////////////////////////////////////////////////////*/
+
+TEST_P(PairsOfLogarithms, SumWithinTwoUnitsInTheLastPlace) {
+  for (std::size_t i = 0; i < lhs.size(); i++) {
+    ASSERT_THAT((log_fixed16_t::from_log(lhs[i])
+                 + log_fixed16_t::from_log(rhs[i])).to_log(),
+                DoubleNear(log_sum(lhs[i], rhs[i]), 2.0 / 64));
+    ASSERT_THAT((log_fixed32_t::from_log(lhs[i])
+                 + log_fixed32_t::from_log(rhs[i])).to_log(),
+                DoubleNear(log_sum(lhs[i], rhs[i]), 2.0 / 65536));
+  }
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST_P(PairsOfLogarithms, SumIsCommutative) {
+  for (std::size_t i = 0; i < lhs.size(); i++) {
+    auto a = log_fixed32_t::from_log(lhs[i]);
+    auto b = log_fixed32_t::from_log(rhs[i]);
+    ASSERT_THAT(a + b, Eq(b + a));
+  }
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST_P(PairsOfLogarithms, SumIsMonotonic) {
+  for (std::size_t i = 0; i < lhs.size(); i++) {
+    auto a = log_fixed16_t::from_log(lhs[i]);
+    auto b = log_fixed16_t::from_log(rhs[i]);
+    ASSERT_THAT(a + b, Le(a + log_fixed16_t::from_raw(b.data() + 1)));
+  }
+}
+
+/*----------------------------------------------------------------------------*/
+
+INSTANTIATE_TEST_SUITE_P(SeveralSeeds, PairsOfLogarithms,
+                         testing::Values(1u, 42u, 2016u));
@@ -0,0 +1,324 @@
+/******************************************************************************/
+/*  Probability - A fast implementation of probabilities using logarithms     */
+/*  Copyright (C) 2016 Renato Cordeiro Ferreira                               */
+/*                                                                            */
+/*  This program is free software: you can redistribute it and/or modify      */
+/*  it under the terms of the GNU General Public License as published by      */
+/*  the Free Software Foundation, either version 3 of the License, or         */
+/*  (at your option) any later version.                                       */
+/*                                                                            */
+/*  This program is distributed in the hope that it will be useful,           */
+/*  but WITHOUT ANY WARRANTY; without even the implied warranty of            */
+/*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             */
+/*  GNU General Public License for more details.                              */
+/*                                                                            */
+/*  You should have received a copy of the GNU General Public License         */
+/*  along with this program.  If not, see <www.gnu.org/licenses>.             */
+/******************************************************************************/
+
+// Standard headers
+#include <cmath>
+#include <limits>
+#include <vector>
+#include <cstdint>
+#include <cstring>
+
+// External headers
+#include "gmock/gmock.h"
+
+// Tested header
+#include "probability/half.hpp"
+
+
+/*\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+/*----------------------------------------------------------------------------*/
+/*                             USING DECLARATIONS                             */
+/*----------------------------------------------------------------------------*/
+/*////////////////////////////////////////////////////////////////////////////*/
+
+using ::testing::Eq;
+using ::testing::Le;
+using ::testing::FloatEq;
+using ::testing::FloatNear;
+using ::testing::DoubleNear;
+
+using probability::Half;
+using probability::BFloat16;
+using probability::log_half_t;
+using probability::log_float_t;
+using probability::log_double_t;
+using probability::log_bfloat16_t;
+using probability::probability_half_t;
+using probability::probability_float_t;
+
+#define FLOAT(X) static_cast<float>(X)
+
+/*\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+/*----------------------------------------------------------------------------*/
+/*                                  FIXTURES                                  */
+/*----------------------------------------------------------------------------*/
+/*////////////////////////////////////////////////////////////////////////////*/
+
+static const auto infinity = std::numeric_limits<float>::infinity();
+
+/*----------------------------------------------------------------------------*/
+
+static std::uint32_t bits_of(float value) {
+  std::uint32_t bits;
+  std::memcpy(&bits, &value, sizeof(bits));
+  return bits;
+}
+
+/*----------------------------------------------------------------------------*/
+
+// Logarithms of probabilities, special values and values near the limits
+// of halves, in an order that exercises the vectorized and scalar parts
+struct ARangeOfLogarithms : public testing::TestWithParam<std::size_t> {
+  std::vector<float> logarithms;
+
+  void SetUp() override {
+    for (std::size_t i = 0; i < GetParam(); i++) {
+      switch (i % 8) {
+        case 0: logarithms.push_back(-static_cast<float>(i) / 7.0f); break;
+        case 1: logarithms.push_back(-infinity); break;
+        case 2: logarithms.push_back(-std::ldexp(1.0f, -20 - int(i % 9)));
+                break;
+        case 3: logarithms.push_back(-65519.0f - static_cast<float>(i));
+                break;
+        case 4: logarithms.push_back(std::nanf("")); break;
+        case 5: logarithms.push_back(1.0f + std::ldexp(1.0f, -11)); break;
+        case 6: logarithms.push_back(-0.0f); break;
+        default: logarithms.push_back(std::log(1.0f / (i + 1.0f))); break;
+      }
+    }
+  }
+};
+
+/*\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+/*----------------------------------------------------------------------------*/
+/*                                SIMPLE TESTS                                */
+/*----------------------------------------------------------------------------*/
+/*////////////////////////////////////////////////////////////////////////////*/
+
+TEST(Half, KeepsExactValues) {
+  for (float value : { 0.0f, -1.0f, -0.5f, -1024.0f, 65504.0f, -infinity })
+    ASSERT_THAT(Half::widen(Half::narrow(value)), Eq(value));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST(Half, RoundsTiesToEven) {
+  ASSERT_THAT(Half::narrow(1.0f + std::ldexp(1.0f, -11)), Eq(0x3C00));
+  ASSERT_THAT(Half::narrow(1.0f + 3 * std::ldexp(1.0f, -11)), Eq(0x3C02));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST(Half, HasSubnormals) {
+  ASSERT_THAT(Half::narrow(std::ldexp(1.0f, -24)), Eq(0x0001));
+  ASSERT_THAT(Half::widen(0x0001), Eq(std::ldexp(1.0f, -24)));
+  ASSERT_THAT(Half::narrow(std::ldexp(1.0f, -25)), Eq(0x0000));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST(Half, OverflowsToInfinity) {
+  ASSERT_THAT(Half::narrow(-65520.0f), Eq(Half::negative_infinity));
+  ASSERT_THAT(Half::narrow(-1e10f), Eq(Half::negative_infinity));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST(Half, KeepsNaNs) {
+  ASSERT_THAT(std::isnan(Half::widen(Half::narrow(std::nanf("")))),
+              Eq(true));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST(Half, KeepsTheSignAndPayloadOfNaNs) {
+  auto nan = std::numeric_limits<float>::quiet_NaN();
+  std::uint32_t bits = 0x7FFFFFFF;
+  float payload;
+  std::memcpy(&payload, &bits, sizeof(payload));
+
+  ASSERT_THAT(Half::narrow(nan), Eq(0x7E00));
+  ASSERT_THAT(Half::narrow(-nan), Eq(0xFE00));
+  ASSERT_THAT(Half::narrow(payload), Eq(0x7FFF));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST(Half, HasARelativeErrorOfAtMostTwoToTheMinusEleven) {
+  for (float value = -1000.0f; value < -1e-3f; value *= 0.9993f) {
+    float error = std::fabs(Half::widen(Half::narrow(value)) - value);
+    ASSERT_THAT(error, Le(std::fabs(value) * std::ldexp(1.0f, -11)));
+  }
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST(BFloat16, KeepsExactValues) {
+  for (float value : { 0.0f, -1.0f, -0.5f, -1024.0f, -1e38f, -infinity }) {
+    float exact = BFloat16::widen(BFloat16::narrow(value));
+    ASSERT_THAT(exact, FloatEq(BFloat16::widen(BFloat16::narrow(exact))));
+  }
+  ASSERT_THAT(BFloat16::widen(BFloat16::narrow(-0.5f)), Eq(-0.5f));
+  ASSERT_THAT(BFloat16::widen(BFloat16::narrow(-infinity)), Eq(-infinity));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST(BFloat16, RoundsTiesToEven) {
+  ASSERT_THAT(BFloat16::narrow(1.0f + std::ldexp(1.0f, -8)), Eq(0x3F80));
+  ASSERT_THAT(BFloat16::narrow(1.0f + 3 * std::ldexp(1.0f, -8)), Eq(0x3F82));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST(BFloat16, KeepsNaNs) {
+  ASSERT_THAT(std::isnan(BFloat16::widen(BFloat16::narrow(std::nanf("")))),
+              Eq(true));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST(BFloat16, HasARelativeErrorOfAtMostTwoToTheMinusEight) {
+  for (float value = -1e30f; value < -1e-30f; value *= 0.9993f) {
+    float error = std::fabs(BFloat16::widen(BFloat16::narrow(value)) - value);
+    ASSERT_THAT(error, Le(std::fabs(value) * std::ldexp(1.0f, -8)));
+  }
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST(LogStorage, HasSixteenBits) {
+  ASSERT_THAT(sizeof(log_half_t), Eq(2u));
+  ASSERT_THAT(sizeof(log_bfloat16_t), Eq(2u));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST(LogStorage, IsZeroByDefault) {
+  log_half_t half;
+  log_bfloat16_t bfloat16;
+  ASSERT_THAT(FLOAT(log_float_t(half)), Eq(0.0f));
+  ASSERT_THAT(FLOAT(log_float_t(bfloat16)), Eq(0.0f));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST(LogStorage, StoresAndLoadsProbabilities) {
+  probability_half_t p = probability_float_t(0.25f);
+  probability_float_t q = p;
+  ASSERT_THAT(q.data(), Eq(Half::widen(Half::narrow(std::log(0.25f)))));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST(LogStorage, CanBeBuiltFromRawValues) {
+  log_bfloat16_t value = 0.5f;
+  ASSERT_THAT(FLOAT(log_float_t(value)), FloatNear(0.5f, 1e-2f));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST(LogStorage, IsOperatedAsItsNumberType) {
+  log_half_t lhs = 0.5f, rhs = 0.25f;
+  log_float_t product = lhs * rhs, sum = lhs + rhs;
+  ASSERT_THAT(FLOAT(product), FloatNear(0.125f, 1e-3f));
+  ASSERT_THAT(FLOAT(sum), FloatNear(0.75f, 1e-3f));
+  ASSERT_THAT(lhs > rhs, Eq(true));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST(LogStorage, IsAccurateToTheRelativeErrorOfItsFormat) {
+  for (double p = 1.0; p > 1e-30; p *= 0.7) {
+    log_double_t exact = p;
+    log_half_t half = log_float_t(static_cast<float>(p));
+    log_bfloat16_t bfloat16 = log_float_t(static_cast<float>(p));
+
+    double tolerance = std::fabs(exact.data()) + 1e-6;
+    ASSERT_THAT(static_cast<double>(log_float_t(half).data()),
+                DoubleNear(exact.data(), tolerance * std::ldexp(1.0, -11)));
+    ASSERT_THAT(static_cast<double>(log_float_t(bfloat16).data()),
+                DoubleNear(exact.data(), tolerance * std::ldexp(1.0, -8)));
+  }
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST(LogStorage, ConvertsRanges) {
+  std::vector<log_float_t> values { 0.0f, 0.125f, 0.5f, 1.0f };
+  std::vector<log_half_t> stored(values.size());
+  std::vector<log_float_t> loaded(values.size());
+
+  probability::narrow(values, stored);
+  probability::widen(stored, loaded);
+
+  for (std::size_t i = 0; i < values.size(); i++)
+    ASSERT_THAT(loaded[i].data(), Eq(log_float_t(stored[i]).data()));
+  ASSERT_THAT(FLOAT(loaded[2]), FloatNear(0.5f, 1e-3f));
+}
+
+/*\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+/*----------------------------------------------------------------------------*/
+/*                             TESTS WITH FIXTURE                             */
+/*----------------------------------------------------------------------------*/
+/*////////////////////////////////////////////////////////////////////////////*/
+
+TEST_P(ARangeOfLogarithms, IsNarrowedToHalvesAsValueByValue) {
+  std::vector<std::uint16_t> bulk(logarithms.size());
+  Half::narrow(logarithms.data(), bulk.data(), logarithms.size());
+
+  for (std::size_t i = 0; i < logarithms.size(); i++) {
+    if (std::isnan(logarithms[i])) continue;  // Any NaN is accepted
+    ASSERT_THAT(bulk[i], Eq(Half::narrow(logarithms[i])));
+  }
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST_P(ARangeOfLogarithms, IsWidenedFromHalvesAsValueByValue) {
+  std::vector<std::uint16_t> halves(logarithms.size());
+  for (std::size_t i = 0; i < logarithms.size(); i++)
+    halves[i] = Half::narrow(logarithms[i]);
+
+  std::vector<float> bulk(halves.size());
+  Half::widen(halves.data(), bulk.data(), halves.size());
+
+  for (std::size_t i = 0; i < halves.size(); i++) {
+    if (std::isnan(logarithms[i])) continue;  // Any NaN is accepted
+    ASSERT_THAT(bits_of(bulk[i]), Eq(bits_of(Half::widen(halves[i]))));
+  }
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST_P(ARangeOfLogarithms, IsNarrowedToBFloat16AsValueByValue) {
+  std::vector<std::uint16_t> bulk(logarithms.size());
+  BFloat16::narrow(logarithms.data(), bulk.data(), logarithms.size());
+
+  for (std::size_t i = 0; i < logarithms.size(); i++)
+    ASSERT_THAT(bulk[i], Eq(BFloat16::narrow(logarithms[i])));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST_P(ARangeOfLogarithms, IsWidenedFromBFloat16AsValueByValue) {
+  std::vector<std::uint16_t> bfloat16s(logarithms.size());
+  for (std::size_t i = 0; i < logarithms.size(); i++)
+    bfloat16s[i] = BFloat16::narrow(logarithms[i]);
+
+  std::vector<float> bulk(bfloat16s.size());
+  BFloat16::widen(bfloat16s.data(), bulk.data(), bfloat16s.size());
+
+  for (std::size_t i = 0; i < bfloat16s.size(); i++)
+    ASSERT_THAT(bits_of(bulk[i]), Eq(bits_of(BFloat16::widen(bfloat16s[i]))));
+}
+
+/*----------------------------------------------------------------------------*/
+
+INSTANTIATE_TEST_SUITE_P(Sizes, ARangeOfLogarithms,
+                        testing::Values(0, 1, 7, 8, 15, 16, 17, 100, 1027));
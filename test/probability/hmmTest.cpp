@@ -0,0 +1,344 @@
+/******************************************************************************/
+/*  Probability - A fast implementation of probabilities using logarithms     */
+/*  Copyright (C) 2016 Renato Cordeiro Ferreira                               */
+/*                                                                            */
+/*  This program is free software: you can redistribute it and/or modify      */
+/*  it under the terms of the GNU General Public License as published by      */
+/*  the Free Software Foundation, either version 3 of the License, or         */
+/*  (at your option) any later version.                                       */
+/*                                                                            */
+/*  This program is distributed in the hope that it will be useful,           */
+/*  but WITHOUT ANY WARRANTY; without even the implied warranty of            */
+/*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             */
+/*  GNU General Public License for more details.                              */
+/*                                                                            */
+/*  You should have received a copy of the GNU General Public License         */
+/*  along with this program.  If not, see <www.gnu.org/licenses>.             */
+/******************************************************************************/
+
+// Standard headers
+#include <cmath>
+#include <vector>
+#include <limits>
+
+// External headers
+#include "gmock/gmock.h"
+
+// Tested header
+#include "probability/hmm.hpp"
+
+
+/*\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+/*----------------------------------------------------------------------------*/
+/*                             USING DECLARATIONS                             */
+/*----------------------------------------------------------------------------*/
+/*////////////////////////////////////////////////////////////////////////////*/
+
+using ::testing::Eq;
+using ::testing::ElementsAre;
+using ::testing::DoubleEq;
+using ::testing::DoubleNear;
+
+using probability::hmm_t;
+using probability::probability_t;
+using probability::probability_matrix_t;
+using probability::probability_vector_t;
+
+#define DOUBLE(X) static_cast<double>(X)
+
+/*\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+/*----------------------------------------------------------------------------*/
+/*                                  FIXTURES                                  */
+/*----------------------------------------------------------------------------*/
+/*////////////////////////////////////////////////////////////////////////////*/
+
+probability_t naive_likelihood(const probability_vector_t& initial,
+                               const probability_matrix_t& transitions,
+                               const probability_matrix_t& emissions,
+                               const hmm_t::sequence_type& sequence) {
+  auto states = initial.size();
+
+  std::vector<probability_t> alpha(states), next(states);
+  for (std::size_t i = 0; i < states; i++)
+    alpha[i] = initial[i] * emissions(i, sequence[0]);
+
+  for (std::size_t t = 1; t < sequence.size(); t++) {
+    for (std::size_t j = 0; j < states; j++) {
+      next[j] = 0.0;
+      for (std::size_t i = 0; i < states; i++)
+        next[j] += alpha[i] * transitions(i, j);
+      next[j] *= emissions(j, sequence[t]);
+    }
+    alpha.swap(next);
+  }
+
+  probability_t sum;
+  for (const auto& value : alpha) sum += value;
+  return sum;
+}
+
+/*----------------------------------------------------------------------------*/
+
+struct AnHMM : public testing::Test {
+  // States: healthy (0), fever (1)
+  // Symbols: normal (0), cold (1), dizzy (2)
+  probability_vector_t initial { 0.6, 0.4 };
+  probability_matrix_t transitions { { 0.7, 0.3 }, { 0.4, 0.6 } };
+  probability_matrix_t emissions { { 0.5, 0.4, 0.1 }, { 0.1, 0.3, 0.6 } };
+
+  hmm_t hmm { initial, transitions, emissions };
+
+  hmm_t::sequence_type sequence { 0, 1, 2 };
+};
+
+/*----------------------------------------------------------------------------*/
+
+struct ABigHMM : public testing::Test {
+  static constexpr std::size_t states = 40;
+  static constexpr std::size_t symbols = 7;
+
+  probability_vector_t initial;
+  probability_matrix_t transitions, emissions;
+  hmm_t::sequence_type sequence;
+
+  void SetUp() override {
+    initial = probability_vector_t(states, 1.0 / states);
+
+    transitions = probability_matrix_t(states, states);
+    for (std::size_t i = 0; i < states; i++)
+      for (std::size_t j = 0; j < states; j++)
+        transitions(i, j) = i == j ? 0.5 : 0.5 / (states - 1);
+
+    emissions = probability_matrix_t(states, symbols);
+    for (std::size_t i = 0; i < states; i++)
+      for (std::size_t k = 0; k < symbols; k++)
+        emissions(i, k) = (i + k) % symbols == 0 ? 0.4 : 0.1;
+
+    for (std::size_t t = 0; t < 500; t++)
+      sequence.push_back((t * t + 3 * t) % symbols);
+  }
+};
+
+/*\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+/*----------------------------------------------------------------------------*/
+/*                             TESTS WITH FIXTURE                             */
+/*----------------------------------------------------------------------------*/
+/*////////////////////////////////////////////////////////////////////////////*/
+
+TEST_F(AnHMM, HasStatesAndSymbols) {
+  ASSERT_THAT(hmm.states(), Eq(2u));
+  ASSERT_THAT(hmm.symbols(), Eq(3u));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST_F(AnHMM, HasLinearProbabilitiesWithEmissionsBySymbol) {
+  const auto& linear_transitions = hmm.linear_transition_probabilities();
+  const auto& linear_emissions = hmm.linear_emission_probabilities();
+  ASSERT_THAT(linear_transitions.size(), Eq(4u));
+  ASSERT_THAT(linear_emissions.size(), Eq(6u));
+  ASSERT_THAT(linear_transitions[1], DoubleEq(0.3));
+  ASSERT_THAT(linear_emissions[2 * 2 + 1], DoubleEq(0.6));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST_F(AnHMM, CalculatesTheLikelihoodOfASequence) {
+  ASSERT_THAT(DOUBLE(hmm.likelihood(sequence)), DoubleEq(0.03628));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST_F(AnHMM, HasLikelihoodOneForAnEmptySequence) {
+  ASSERT_THAT(DOUBLE(hmm.likelihood(hmm_t::sequence_type{})),
+              DoubleNear(1.0, 1e-15));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST_F(AnHMM, HasForwardProbabilitiesForEachPosition) {
+  auto alpha = hmm.forward(sequence);
+  ASSERT_THAT(alpha.rows(), Eq(3u));
+  ASSERT_THAT(alpha.cols(), Eq(2u));
+  ASSERT_THAT(DOUBLE(alpha(0, 0)), DoubleEq(0.3));
+  ASSERT_THAT(DOUBLE(alpha(0, 1)), DoubleEq(0.04));
+  ASSERT_THAT(DOUBLE(alpha(1, 0)), DoubleEq(0.0904));
+  ASSERT_THAT(DOUBLE(alpha(1, 1)), DoubleEq(0.0342));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST_F(AnHMM, HasBackwardProbabilitiesForEachPosition) {
+  auto beta = hmm.backward(sequence);
+  ASSERT_THAT(beta.rows(), Eq(3u));
+  ASSERT_THAT(DOUBLE(beta(2, 0)), DoubleEq(1.0));
+  ASSERT_THAT(DOUBLE(beta(1, 0)), DoubleEq(0.25));
+  ASSERT_THAT(DOUBLE(beta(1, 1)), DoubleEq(0.4));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST_F(AnHMM, HasBackwardProbabilitiesConsistentWithTheLikelihood) {
+  auto beta = hmm.backward(sequence);
+
+  probability_t likelihood;
+  for (std::size_t i = 0; i < hmm.states(); i++)
+    likelihood += initial[i] * emissions(i, sequence[0]) * beta(0, i);
+
+  ASSERT_THAT(DOUBLE(likelihood), DoubleEq(0.03628));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST_F(AnHMM, HasPosteriorProbabilitiesThatSumToOne) {
+  auto gamma = hmm.posterior(sequence);
+  for (std::size_t t = 0; t < sequence.size(); t++)
+    ASSERT_THAT(DOUBLE(gamma(t, 0) + gamma(t, 1)), DoubleNear(1.0, 1e-15));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST_F(AnHMM, HasPosteriorProbabilitiesZeroForAnImpossibleSequence) {
+  hmm_t impossible { probability_vector_t { 0.5, 0.5 },
+              probability_matrix_t { { 0.5, 0.5 }, { 0.5, 0.5 } },
+              probability_matrix_t { { 1.0, 0.0 }, { 1.0, 0.0 } } };
+
+  auto gamma = impossible.posterior({ 0, 1 });
+  for (std::size_t t = 0; t < 2; t++)
+    for (std::size_t i = 0; i < impossible.states(); i++)
+      ASSERT_THAT(DOUBLE(gamma(t, i)), DoubleEq(0.0));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST_F(AnHMM, DecodesTheMostProbableStateInEachPosition) {
+  ASSERT_THAT(hmm.posterior_decoding(sequence), ElementsAre(0, 0, 1));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST_F(AnHMM, CalculatesTheLikelihoodOfABatchOfSequences) {
+  std::vector<hmm_t::sequence_type> batch {
+    { 0, 1 }, {}, sequence, { 2 }, { 2, 2, 2, 2, 1, 0 }, { 1, 1 },
+  };
+
+  auto likelihoods = hmm.likelihood(batch);
+  ASSERT_THAT(likelihoods.size(), Eq(batch.size()));
+  for (std::size_t b = 0; b < batch.size(); b++)
+    ASSERT_THAT(likelihoods[b].data(),
+                DoubleNear(hmm.likelihood(batch[b]).data(), 1e-14));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST_F(AnHMM, DiesIfASymbolIsNotInTheAlphabet) {
+  ASSERT_DEATH(hmm.likelihood(hmm_t::sequence_type{ 0, 3 }), "");
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST_F(AnHMM, CalculatesTheViterbiProbabilityWithMaxMath) {
+  using viterbi_t = probability::HiddenMarkovModel<
+    double, 0, probability::ProbabilityChecker<double, 0>,
+    probability::MaxMath<double>>;
+
+  viterbi_t viterbi(viterbi_t::vector_type { 0.6, 0.4 },
+                    viterbi_t::matrix_type { { 0.7, 0.3 }, { 0.4, 0.6 } },
+                    viterbi_t::matrix_type { { 0.5, 0.4, 0.1 },
+                                             { 0.1, 0.3, 0.6 } });
+
+  ASSERT_THAT(DOUBLE(viterbi.likelihood(sequence)), DoubleEq(0.01512));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST_F(AnHMM, CalculatesTheScaledLikelihoodOfASequence) {
+  ASSERT_THAT(DOUBLE(hmm.scaled_likelihood(sequence)), DoubleEq(0.03628));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST_F(AnHMM, HasScaledForwardProbabilitiesForEachPosition) {
+  auto alpha = hmm.scaled_forward(sequence);
+  ASSERT_THAT(alpha.size(), Eq(3u));
+  ASSERT_THAT(DOUBLE(alpha[0][0]), DoubleEq(0.3));
+  ASSERT_THAT(DOUBLE(alpha[1][1]), DoubleEq(0.0342));
+  ASSERT_THAT(alpha[1].data()[0] + alpha[1].data()[1], DoubleEq(1.0));
+  ASSERT_THAT(std::exp(alpha[2].log_scale()), DoubleEq(0.03628));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST_F(AnHMM, HasScaledBackwardProbabilitiesForEachPosition) {
+  auto beta = hmm.scaled_backward(sequence);
+  ASSERT_THAT(beta.size(), Eq(3u));
+  ASSERT_THAT(DOUBLE(beta[2][0]), DoubleEq(1.0));
+  ASSERT_THAT(DOUBLE(beta[1][0]), DoubleEq(0.25));
+  ASSERT_THAT(DOUBLE(beta[1][1]), DoubleEq(0.4));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST_F(AnHMM, CalculatesTheScaledViterbiProbabilityWithMaxMath) {
+  using viterbi_t = probability::HiddenMarkovModel<
+    double, 0, probability::ProbabilityChecker<double, 0>,
+    probability::MaxMath<double>>;
+
+  viterbi_t viterbi(viterbi_t::vector_type { 0.6, 0.4 },
+                    viterbi_t::matrix_type { { 0.7, 0.3 }, { 0.4, 0.6 } },
+                    viterbi_t::matrix_type { { 0.5, 0.4, 0.1 },
+                                             { 0.1, 0.3, 0.6 } });
+
+  ASSERT_THAT(DOUBLE(viterbi.scaled_likelihood(sequence)), DoubleEq(0.01512));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST_F(ABigHMM, HasTheSameLikelihoodAsTheNaiveForwardAlgorithm) {
+  hmm_t hmm(initial, transitions, emissions);
+  auto expected = naive_likelihood(initial, transitions, emissions, sequence);
+  ASSERT_THAT(hmm.likelihood(sequence).data(),
+              DoubleNear(expected.data(), 1e-10));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST_F(ABigHMM, HasTheSameLikelihoodInTheForwardAndBackwardAlgorithms) {
+  hmm_t hmm(initial, transitions, emissions);
+  auto alpha = hmm.forward(sequence);
+  auto beta = hmm.backward(sequence);
+
+  for (std::size_t t : { 0, 100, 499 }) {
+    probability_t likelihood;
+    for (std::size_t i = 0; i < states; i++)
+      likelihood += alpha(t, i) * beta(t, i);
+    ASSERT_THAT(likelihood.data(),
+                DoubleNear(hmm.likelihood(sequence).data(), 1e-10));
+  }
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST_F(ABigHMM, HasTheSameLikelihoodInLogAndLinearSpace) {
+  hmm_t hmm(initial, transitions, emissions);
+  ASSERT_THAT(hmm.scaled_likelihood(sequence).data(),
+              DoubleNear(hmm.likelihood(sequence).data(), 1e-10));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST_F(ABigHMM, HasTheSameForwardAndBackwardInLogAndLinearSpace) {
+  hmm_t hmm(initial, transitions, emissions);
+  auto alpha = hmm.forward(sequence);
+  auto beta = hmm.backward(sequence);
+  auto scaled_alpha = hmm.scaled_forward(sequence);
+  auto scaled_beta = hmm.scaled_backward(sequence);
+  for (std::size_t t : { 0, 100, 499 }) {
+    for (std::size_t i = 0; i < states; i++) {
+      ASSERT_THAT(scaled_alpha[t][i].data(),
+                  DoubleNear(alpha(t, i).data(), 1e-10));
+      ASSERT_THAT(scaled_beta[t][i].data(),
+                  DoubleNear(beta(t, i).data(), 1e-10));
+    }
+  }
+}
@@ -0,0 +1,284 @@
+/******************************************************************************/
+/*  Probability - A fast implementation of probabilities using logarithms     */
+/*  Copyright (C) 2016 Renato Cordeiro Ferreira                               */
+/*                                                                            */
+/*  This program is free software: you can redistribute it and/or modify      */
+/*  it under the terms of the GNU General Public License as published by      */
+/*  the Free Software Foundation, either version 3 of the License, or         */
+/*  (at your option) any later version.                                       */
+/*                                                                            */
+/*  This program is distributed in the hope that it will be useful,           */
+/*  but WITHOUT ANY WARRANTY; without even the implied warranty of            */
+/*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             */
+/*  GNU General Public License for more details.                              */
+/*                                                                            */
+/*  You should have received a copy of the GNU General Public License         */
+/*  along with this program.  If not, see <www.gnu.org/licenses>.             */
+/******************************************************************************/
+
+// Standard headers
+#include <cmath>
+#include <tuple>
+#include <limits>
+#include <cstdint>
+
+// External headers
+#include "gmock/gmock.h"
+
+// Tested header
+#include "probability/matrix.hpp"
+
+
+/*\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+/*----------------------------------------------------------------------------*/
+/*                             USING DECLARATIONS                             */
+/*----------------------------------------------------------------------------*/
+/*////////////////////////////////////////////////////////////////////////////*/
+
+using ::testing::Eq;
+using ::testing::DoubleEq;
+using ::testing::DoubleNear;
+using ::testing::FloatNear;
+
+using probability::log_double_t;
+using probability::probability_t;
+using probability::log_float_matrix_t;
+using probability::log_double_matrix_t;
+using probability::log_float_vector_t;
+using probability::log_double_vector_t;
+using probability::probability_matrix_t;
+using probability::probability_vector_t;
+
+#define DOUBLE(X) static_cast<double>(X)
+
+/*\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+/*----------------------------------------------------------------------------*/
+/*                                  FIXTURES                                  */
+/*----------------------------------------------------------------------------*/
+/*////////////////////////////////////////////////////////////////////////////*/
+
+static const auto infinity
+  = std::numeric_limits<probability_t::value_type>::infinity();
+
+/*----------------------------------------------------------------------------*/
+
+struct AStochasticMatrix : public testing::Test {
+  probability_matrix_t transitions {
+    { 0.9, 0.1, 0.0 },
+    { 0.2, 0.5, 0.3 },
+    { 0.0, 0.0, 1.0 },
+  };
+};
+
+/*----------------------------------------------------------------------------*/
+
+struct MatricesOfSizes
+    : public testing::TestWithParam<std::tuple<std::size_t, std::size_t>> {
+  log_double_matrix_t matrix;
+  log_double_vector_t vector;
+
+  void SetUp() override {
+    auto [rows, cols] = GetParam();
+    matrix = log_double_matrix_t(rows, cols);
+    for (std::size_t i = 0; i < rows; i++)
+      for (std::size_t j = 0; j < cols; j++)
+        matrix(i, j) = (i + 2 * j) % 11 == 0
+                     ? 0.0 : std::exp(-0.1 * static_cast<double>(i + j));
+
+    vector = log_double_vector_t(std::max(rows, cols));
+    for (std::size_t i = 0; i < vector.size(); i++)
+      vector[i] = i % 5 == 0 ? 0.0 : 1e-3 * static_cast<double>(i + 1);
+  }
+
+  log_double_t naive_gemv(std::size_t i) const {
+    log_double_t result;
+    for (std::size_t j = 0; j < matrix.cols(); j++)
+      result += matrix(i, j) * vector[j];
+    return result;
+  }
+
+  log_double_t naive_gevm(std::size_t j) const {
+    log_double_t result;
+    for (std::size_t i = 0; i < matrix.rows(); i++)
+      result += vector[i] * matrix(i, j);
+    return result;
+  }
+};
+
+/*\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+/*----------------------------------------------------------------------------*/
+/*                                SIMPLE TESTS                                */
+/*----------------------------------------------------------------------------*/
+/*////////////////////////////////////////////////////////////////////////////*/
+
+TEST(LogMatrix, IsEmptyByDefault) {
+  log_double_matrix_t matrix;
+  ASSERT_THAT(matrix.rows(), Eq(0u));
+  ASSERT_THAT(matrix.cols(), Eq(0u));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST(LogMatrix, IsFilledWithZerosWhenConstructedWithASize) {
+  log_double_matrix_t matrix(3, 4);
+  ASSERT_THAT(matrix.rows(), Eq(3u));
+  ASSERT_THAT(matrix.cols(), Eq(4u));
+  for (std::size_t i = 0; i < 12; i++)
+    ASSERT_THAT(matrix.data()[i], Eq(-infinity));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST(LogMatrix, StoresRawLogarithmsInRowMajorOrder) {
+  log_double_matrix_t matrix { { 0.5, 0.25 }, { 0.125, 1.0 } };
+  ASSERT_THAT(matrix.data()[1], DoubleEq(std::log(0.25)));
+  ASSERT_THAT(matrix.data()[2], DoubleEq(std::log(0.125)));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST(LogMatrix, HasStorageAlignedToCacheLines) {
+  log_float_matrix_t matrix(7, 3);
+  auto address = reinterpret_cast<std::uintptr_t>(matrix.data());
+  ASSERT_THAT(address % 64, Eq(0u));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST(LogMatrix, CanBeModifiedThroughReferences) {
+  log_double_matrix_t matrix(2, 2);
+  matrix(0, 1) = 0.5;
+  matrix(0, 1) *= 0.5;
+  matrix(1, 0) = matrix(0, 1);
+  ASSERT_THAT(DOUBLE(matrix(0, 1)), DoubleEq(0.25));
+  ASSERT_THAT(DOUBLE(matrix(1, 0)), DoubleEq(0.25));
+  ASSERT_THAT(matrix(1, 1).data(), Eq(-infinity));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST(LogMatrix, MultipliesFloatMatrices) {
+  log_float_matrix_t matrix(300, 300, 0.5f);
+  log_float_vector_t vector(300, 0.25f);
+  auto result = vector * matrix;
+  for (std::size_t j = 0; j < result.size(); j++)
+    ASSERT_THAT(result.data()[j], FloatNear(std::log(37.5f), 1e-5f));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST(LogMatrix, MultipliesMatrices) {
+  log_double_matrix_t lhs { { 0.5, 0.25, 0.0 }, { 1.0, 0.0, 2.0 } };
+  log_double_matrix_t rhs { { 1.0, 2.0 }, { 4.0, 0.0 }, { 0.5, 0.25 } };
+  auto result = lhs * rhs;
+  ASSERT_THAT(result.rows(), Eq(2u));
+  ASSERT_THAT(result.cols(), Eq(2u));
+  ASSERT_THAT(DOUBLE(result(0, 0)), DoubleEq(1.5));
+  ASSERT_THAT(DOUBLE(result(0, 1)), DoubleEq(1.0));
+  ASSERT_THAT(DOUBLE(result(1, 0)), DoubleEq(2.0));
+  ASSERT_THAT(DOUBLE(result(1, 1)), DoubleEq(2.5));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST(LogMatrix, DiesIfDimensionsDoNotMatch) {
+  log_double_matrix_t matrix(3, 4);
+  log_double_vector_t vector(3);
+  ASSERT_DEATH(matrix * vector, "");
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST(LogMatrix, MultipliesInTheMaxPlusSemiringWithMaxMath) {
+  using max_vector_t = probability::LogVector<
+    double, 0, probability::ProbabilityChecker<double, 0>,
+    probability::MaxMath<double>>;
+  using max_matrix_t = probability::LogMatrix<
+    double, 0, probability::ProbabilityChecker<double, 0>,
+    probability::MaxMath<double>>;
+
+  max_matrix_t matrix { { 0.9, 0.1 }, { 0.2, 0.8 } };
+  max_vector_t vector { 0.4, 0.6 };
+
+  auto forward = vector * matrix;
+  ASSERT_THAT(DOUBLE(forward[0]), DoubleEq(0.36));
+  ASSERT_THAT(DOUBLE(forward[1]), DoubleEq(0.48));
+
+  auto backward = matrix * vector;
+  ASSERT_THAT(DOUBLE(backward[0]), DoubleEq(0.36));
+  ASSERT_THAT(DOUBLE(backward[1]), DoubleEq(0.48));
+}
+
+/*\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+/*----------------------------------------------------------------------------*/
+/*                             TESTS WITH FIXTURE                             */
+/*----------------------------------------------------------------------------*/
+/*////////////////////////////////////////////////////////////////////////////*/
+
+TEST_F(AStochasticMatrix, KeepsADistributionInTheForwardStep) {
+  probability_vector_t distribution { 0.25, 0.25, 0.5 };
+  auto next = distribution * transitions;
+  ASSERT_THAT(DOUBLE(next[0]), DoubleEq(0.275));
+  ASSERT_THAT(DOUBLE(next[1]), DoubleEq(0.15));
+  ASSERT_THAT(DOUBLE(next[2]), DoubleEq(0.575));
+  ASSERT_THAT(DOUBLE(sum(next)), DoubleNear(1.0, 1e-15));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST_F(AStochasticMatrix, SumsEachRowWithAVectorOfOnes) {
+  probability_vector_t ones(3, 1.0);
+  auto sums = transitions * ones;
+  for (std::size_t i = 0; i < sums.size(); i++)
+    ASSERT_THAT(DOUBLE(sums[i]), DoubleNear(1.0, 1e-15));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST_F(AStochasticMatrix, IsKeptStochasticWhenSquared) {
+  auto squared = transitions * transitions;
+  ASSERT_THAT(DOUBLE(squared(0, 0)), DoubleEq(0.83));
+  ASSERT_THAT(DOUBLE(squared(1, 2)), DoubleEq(0.45));
+  ASSERT_THAT(squared(2, 0).data(), Eq(-infinity));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST_F(AStochasticMatrix, DiesIfTheResultIsNotAProbability) {
+  probability_vector_t ones(3, 1.0);
+  ASSERT_DEATH(ones * transitions, "");
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST_P(MatricesOfSizes, HaveTheSameMatrixVectorProductAsRepeatedAdditions) {
+  log_double_vector_t input(matrix.cols()), result;
+  for (std::size_t j = 0; j < input.size(); j++) input[j] = vector[j];
+  probability::gemv(matrix, input, result);
+
+  ASSERT_THAT(result.size(), Eq(matrix.rows()));
+  for (std::size_t i = 0; i < result.size(); i++)
+    ASSERT_THAT(result.data()[i], DoubleNear(naive_gemv(i).data(), 1e-12));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST_P(MatricesOfSizes, HaveTheSameVectorMatrixProductAsRepeatedAdditions) {
+  log_double_vector_t input(matrix.rows()), result;
+  for (std::size_t i = 0; i < input.size(); i++) input[i] = vector[i];
+  probability::gevm(input, matrix, result);
+
+  ASSERT_THAT(result.size(), Eq(matrix.cols()));
+  for (std::size_t j = 0; j < result.size(); j++)
+    ASSERT_THAT(result.data()[j], DoubleNear(naive_gevm(j).data(), 1e-12));
+}
+
+/*----------------------------------------------------------------------------*/
+
+INSTANTIATE_TEST_SUITE_P(Sizes, MatricesOfSizes,
+    testing::Values(std::make_tuple(1, 1),
+                    std::make_tuple(3, 17),
+                    std::make_tuple(17, 3),
+                    std::make_tuple(9, 300),
+                    std::make_tuple(300, 9),
+                    std::make_tuple(513, 257)));
@@ -0,0 +1,424 @@
+/******************************************************************************/
+/*  Probability - A fast implementation of probabilities using logarithms     */
+/*  Copyright (C) 2016 Renato Cordeiro Ferreira                               */
+/*                                                                            */
+/*  This program is free software: you can redistribute it and/or modify      */
+/*  it under the terms of the GNU General Public License as published by      */
+/*  the Free Software Foundation, either version 3 of the License, or         */
+/*  (at your option) any later version.                                       */
+/*                                                                            */
+/*  This program is distributed in the hope that it will be useful,           */
+/*  but WITHOUT ANY WARRANTY; without even the implied warranty of            */
+/*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             */
+/*  GNU General Public License for more details.                              */
+/*                                                                            */
+/*  You should have received a copy of the GNU General Public License         */
+/*  along with this program.  If not, see <www.gnu.org/licenses>.             */
+/******************************************************************************/
+
+// Standard headers
+#include <array>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+// External headers
+#include "gmock/gmock.h"
+
+// Tested header
+#include "probability/numeric.hpp"
+
+
+/*\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+/*----------------------------------------------------------------------------*/
+/*                             USING DECLARATIONS                             */
+/*----------------------------------------------------------------------------*/
+/*////////////////////////////////////////////////////////////////////////////*/
+
+using ::testing::Eq;
+using ::testing::DoubleEq;
+using ::testing::FloatEq;
+using ::testing::DoubleNear;
+using ::testing::FloatNear;
+
+using probability::log_float_t;
+using probability::log_double_t;
+using probability::log_long_double_t;
+using probability::probability_t;
+
+#define DOUBLE(X) static_cast<double>(X)
+
+/*\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+/*----------------------------------------------------------------------------*/
+/*                                  FIXTURES                                  */
+/*----------------------------------------------------------------------------*/
+/*////////////////////////////////////////////////////////////////////////////*/
+
+static const auto infinity
+  = std::numeric_limits<probability_t::value_type>::infinity();
+
+/*----------------------------------------------------------------------------*/
+
+template<typename Number>
+Number serial_sum(const std::vector<Number>& values) {
+  Number sum;
+  for (const auto& value : values) sum += value;
+  return sum;
+}
+
+/*----------------------------------------------------------------------------*/
+
+struct ARangeOfProbabilities : public testing::TestWithParam<std::size_t> {
+  std::vector<probability_t> probabilities;
+
+  void SetUp() override {
+    for (std::size_t i = 0; i < GetParam(); i++)
+      probabilities.emplace_back(1.0 / (3.0 * GetParam() + i));
+  }
+};
+
+/*\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+/*----------------------------------------------------------------------------*/
+/*                                SIMPLE TESTS                                */
+/*----------------------------------------------------------------------------*/
+/*////////////////////////////////////////////////////////////////////////////*/
+
+TEST(Sum, IsZeroForAnEmptyRange) {
+  std::vector<probability_t> probabilities;
+  ASSERT_THAT(probability::sum(probabilities).data(), Eq(-infinity));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST(Sum, IsZeroForARangeOfZeros) {
+  std::vector<probability_t> probabilities(20, 0.0);
+  ASSERT_THAT(probability::sum(probabilities).data(), Eq(-infinity));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST(Sum, IsTheValueItselfForASingleValue) {
+  std::vector<probability_t> probabilities { 0.25 };
+  ASSERT_THAT(probability::sum(probabilities), Eq(probabilities[0]));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST(Sum, IgnoresZerosInTheRange) {
+  std::vector<probability_t> probabilities(33, 0.0);
+  probabilities[5] = 0.25;
+  probabilities[17] = 0.5;
+  probabilities[32] = 0.125;
+  ASSERT_THAT(DOUBLE(probability::sum(probabilities)), DoubleEq(0.875));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST(Sum, CanBeCalculatedForAPointerRange) {
+  std::array<probability_t, 3> probabilities { 0.25, 0.25, 0.5 };
+  ASSERT_THAT(DOUBLE(probability::sum(probabilities.data(),
+                                      probabilities.data() + 2)),
+              DoubleEq(0.5));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST(Sum, CanBeCalculatedForLogFloats) {
+  std::vector<log_float_t> values(100, 0.5f);
+  ASSERT_THAT(static_cast<float>(probability::sum(values)), FloatEq(50.0f));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST(Sum, CanBeCalculatedForLogLongDoubles) {
+  std::vector<log_long_double_t> values(100, 0.5L);
+  ASSERT_THAT(DOUBLE(static_cast<long double>(probability::sum(values))),
+              DoubleEq(50.0));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST(Sum, KeepsPrecisionForValuesWithVeryDifferentMagnitudes) {
+  std::vector<log_double_t> values { 1e-300, 1.0, 1e-300, 1e300 };
+  ASSERT_THAT(probability::sum(values).data(), DoubleEq(values[3].data()));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST(Sum, DiesIfTheResultIsNotAProbability) {
+  std::vector<probability_t> probabilities(3, 0.5);
+  ASSERT_DEATH(probability::sum(probabilities), "");
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST(Sum, IsTheMaximumForMaxProbabilities) {
+  std::vector<probability::max_probability_t> values { 0.25, 0.5, 0.0 };
+  ASSERT_THAT(probability::sum(values), Eq(values[1]));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST(LogAccumulator, IsZeroWhenEmpty) {
+  probability::LogAccumulator<double> accumulator;
+  ASSERT_THAT(accumulator.data(), Eq(-infinity));
+  ASSERT_THAT(accumulator.value<probability_t>(), Eq(probability_t(0.0)));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST(LogAccumulator, IsTheValueItselfForASingleValue) {
+  probability::LogAccumulator<double> accumulator;
+  accumulator += probability_t(0.25);
+  ASSERT_THAT(accumulator.data(), DoubleEq(probability_t(0.25).data()));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST(LogAccumulator, IgnoresZeros) {
+  probability::LogAccumulator<double> accumulator;
+  accumulator += probability_t(0.0);
+  accumulator += probability_t(0.5);
+  accumulator += probability_t(0.0);
+  ASSERT_THAT(DOUBLE(accumulator.value<probability_t>()), DoubleEq(0.5));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST(LogAccumulator, RescalesWhenANewMaximumAppears) {
+  probability::LogAccumulator<double> accumulator;
+  accumulator += log_double_t(1e-300);
+  accumulator += log_double_t(1.0);
+  accumulator += log_double_t(1e300);
+  ASSERT_THAT(accumulator.data(), DoubleEq(log_double_t(1e300).data()));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST(LogAccumulator, IsInfinityIfAValueIsInfinity) {
+  probability::LogAccumulator<double> accumulator;
+  accumulator += log_double_t(1.0);
+  accumulator += log_double_t(infinity);
+  accumulator += log_double_t(2.0);
+  ASSERT_THAT(accumulator.data(), Eq(infinity));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST(LogAccumulator, CanBeConvertedToAProbability) {
+  probability::LogAccumulator<double> accumulator;
+  accumulator += probability_t(0.25);
+  accumulator += probability_t(0.5);
+  probability_t sum = accumulator;
+  ASSERT_THAT(DOUBLE(sum), DoubleEq(0.75));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST(LogAccumulator, DiesIfTheResultIsNotAProbability) {
+  probability::LogAccumulator<double> accumulator;
+  accumulator += probability_t(0.5);
+  accumulator += probability_t(0.75);
+  ASSERT_DEATH(accumulator.value<probability_t>(), "");
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST(LogAccumulator, CanAccumulateAPointerRange) {
+  std::vector<probability_t> probabilities(33, 0.0);
+  probabilities[5] = 0.25;
+  probabilities[17] = 0.5;
+  probabilities[32] = 0.125;
+
+  probability::LogAccumulator<double> accumulator;
+  accumulator += probability_t(0.0625);
+  accumulator.add(probabilities.data(),
+                  probabilities.data() + probabilities.size());
+  ASSERT_THAT(DOUBLE(accumulator.value<probability_t>()), DoubleEq(0.9375));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST(LogAccumulator, CanBeMerged) {
+  probability::LogAccumulator<double> lhs, rhs, empty;
+  lhs += probability_t(0.25);
+  rhs += probability_t(0.125);
+  rhs += probability_t(0.5);
+  lhs += rhs;
+  lhs += empty;
+  ASSERT_THAT(DOUBLE(lhs.value<probability_t>()), DoubleEq(0.875));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST(LogAccumulator, IsZeroAfterBeingCleared) {
+  probability::LogAccumulator<double> accumulator;
+  accumulator += probability_t(0.25);
+  accumulator.clear();
+  ASSERT_THAT(accumulator.data(), Eq(-infinity));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST(LogAccumulator, CanAccumulateLogFloats) {
+  probability::LogAccumulator<float> accumulator;
+  for (int i = 0; i < 100; i++) accumulator += log_float_t(0.5f);
+  ASSERT_THAT(static_cast<float>(accumulator.value()), FloatEq(50.0f));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST(CompensatedLogAccumulator, IsMoreAccurateThanTheUncompensatedOne) {
+  probability::LogAccumulator<float> uncompensated;
+  probability::CompensatedLogAccumulator<float> compensated;
+
+  compensated += log_float_t(1.0f);
+  uncompensated += log_float_t(1.0f);
+  for (int i = 0; i < 1000000; i++) {
+    compensated += log_float_t(1e-8f);
+    uncompensated += log_float_t(1e-8f);
+  }
+
+  ASSERT_THAT(static_cast<float>(compensated.value()),
+              FloatNear(1.01f, 1e-4f));
+  ASSERT_THAT(static_cast<float>(uncompensated.value()), Eq(1.0f));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST(CompensatedLogAccumulator, IsMoreAccurateForRanges) {
+  std::vector<log_float_t> values(1 << 16, 1e-8f);
+  values[0] = 1.0f;
+
+  probability::CompensatedLogAccumulator<float> accumulator;
+  for (int i = 0; i < 16; i++)
+    accumulator.add(values.data(), values.data() + values.size());
+
+  ASSERT_THAT(static_cast<float>(accumulator.value()),
+              FloatEq(16.0f + 16 * 65535 * 1e-8f));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST(MultiplyAdd, AccumulatesElementWiseProductsOfRanges) {
+  std::vector<probability_t> acc { 0.0, 0.25, 0.5 };
+  std::vector<probability_t> a { 0.5, 0.0, 0.5 };
+  std::vector<probability_t> b { 0.5, 0.5, 1.0 };
+
+  probability::fma(acc, a, b);
+
+  ASSERT_THAT(DOUBLE(acc[0]), DoubleEq(0.25));
+  ASSERT_THAT(DOUBLE(acc[1]), DoubleEq(0.25));
+  ASSERT_THAT(DOUBLE(acc[2]), DoubleEq(1.0));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST(MultiplyAdd, AccumulatesScaledRanges) {
+  std::vector<probability_t> acc { 0.0, 0.25, 0.5 };
+  std::vector<probability_t> a { 0.5, 0.0, 1.0 };
+
+  probability::fma(acc, a, probability_t(0.5));
+
+  ASSERT_THAT(DOUBLE(acc[0]), DoubleEq(0.25));
+  ASSERT_THAT(DOUBLE(acc[1]), DoubleEq(0.25));
+  ASSERT_THAT(DOUBLE(acc[2]), DoubleEq(1.0));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST(MultiplyAdd, CanBeCalculatedForAPointerRange) {
+  std::array<log_double_t, 3> acc { 1.0, 1.0, 1.0 };
+  std::array<log_double_t, 3> a { 2.0, 3.0, 4.0 };
+
+  probability::fma(acc.data(), acc.data() + 2, a.data(), log_double_t(2.0));
+
+  ASSERT_THAT(DOUBLE(acc[0]), DoubleEq(5.0));
+  ASSERT_THAT(DOUBLE(acc[1]), DoubleEq(7.0));
+  ASSERT_THAT(DOUBLE(acc[2]), DoubleEq(1.0));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST(MultiplyAdd, DiesIfAResultIsNotAProbability) {
+  std::vector<probability_t> acc { 0.5, 0.75 };
+  std::vector<probability_t> a { 0.5, 0.5 };
+  ASSERT_DEATH(probability::fma(acc, a, probability_t(1.0)), "");
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST(Conversions, BuildRangesFromLogarithms) {
+  std::vector<double> logs { -infinity, std::log(0.25), 0.0 };
+  std::vector<probability_t> values(3);
+
+  probability::from_log(logs, values);
+
+  ASSERT_THAT(DOUBLE(values[0]), Eq(0.0));
+  ASSERT_THAT(values[1].data(), Eq(std::log(0.25)));
+  ASSERT_THAT(values[2].data(), Eq(0.0));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST(Conversions, BuildRangesFromLogarithmsWithoutChecks) {
+  std::vector<double> logs { std::log(2.0), std::log(0.5) };
+  std::vector<probability_t> values(2);
+
+  probability::from_log_unchecked(logs, values);
+
+  ASSERT_THAT(values[0].data(), Eq(std::log(2.0)));
+  ASSERT_THAT(values[1].data(), Eq(std::log(0.5)));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST(Conversions, CanBuildAPointerRange) {
+  std::array<double, 3> logs { 1.0, 2.0, 3.0 };
+  std::array<log_double_t, 3> values { 0.0, 0.0, 0.0 };
+
+  auto last = probability::from_log(logs.data(), logs.data() + 2,
+                                    values.data());
+
+  ASSERT_THAT(last, Eq(values.data() + 2));
+  ASSERT_THAT(values[0].data(), Eq(1.0));
+  ASSERT_THAT(values[1].data(), Eq(2.0));
+  ASSERT_THAT(DOUBLE(values[2]), Eq(0.0));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST(Conversions, CopyTheLogarithmsOfRanges) {
+  std::vector<probability_t> values { 0.0, 0.25, 1.0 };
+  std::vector<double> logs(3);
+
+  probability::to_log(values, logs);
+
+  ASSERT_THAT(logs[0], Eq(-infinity));
+  ASSERT_THAT(logs[1], Eq(values[1].data()));
+  ASSERT_THAT(logs[2], Eq(0.0));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST(Conversions, DieIfAValueIsNotAProbability) {
+  std::vector<double> logs { std::log(0.5), std::log(2.0) };
+  std::vector<probability_t> values(2);
+  ASSERT_DEATH(probability::from_log(logs, values), "");
+}
+
+/*\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+/*----------------------------------------------------------------------------*/
+/*                             TESTS WITH FIXTURE                             */
+/*----------------------------------------------------------------------------*/
+/*////////////////////////////////////////////////////////////////////////////*/
+
+TEST_P(ARangeOfProbabilities, HasTheSameSumAsRepeatedAdditions) {
+  auto sum = probability::sum(probabilities);
+  ASSERT_THAT(sum.data(), DoubleNear(serial_sum(probabilities).data(), 1e-13));
+}
+
+/*----------------------------------------------------------------------------*/
+
+INSTANTIATE_TEST_SUITE_P(Sizes, ARangeOfProbabilities,
+    testing::Values(1, 2, 7, 8, 9, 15, 16, 17, 100, 1000));
@@ -0,0 +1,240 @@
+/******************************************************************************/
+/*  Probability - A fast implementation of probabilities using logarithms     */
+/*  Copyright (C) 2016 Renato Cordeiro Ferreira                               */
+/*                                                                            */
+/*  This program is free software: you can redistribute it and/or modify      */
+/*  it under the terms of the GNU General Public License as published by      */
+/*  the Free Software Foundation, either version 3 of the License, or         */
+/*  (at your option) any later version.                                       */
+/*                                                                            */
+/*  This program is distributed in the hope that it will be useful,           */
+/*  but WITHOUT ANY WARRANTY; without even the implied warranty of            */
+/*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             */
+/*  GNU General Public License for more details.                              */
+/*                                                                            */
+/*  You should have received a copy of the GNU General Public License         */
+/*  along with this program.  If not, see <www.gnu.org/licenses>.             */
+/******************************************************************************/
+
+// Standard headers
+#include <atomic>
+#include <limits>
+#include <thread>
+#include <vector>
+#include <execution>
+#include <stdexcept>
+
+// External headers
+#include "gmock/gmock.h"
+
+// Tested header
+#include "probability/parallel.hpp"
+
+
+/*\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+/*----------------------------------------------------------------------------*/
+/*                             USING DECLARATIONS                             */
+/*----------------------------------------------------------------------------*/
+/*////////////////////////////////////////////////////////////////////////////*/
+
+using ::testing::Eq;
+using ::testing::DoubleEq;
+using ::testing::DoubleNear;
+
+using probability::ThreadPool;
+using probability::log_double_t;
+using probability::log_double_vector_t;
+using probability::probability_t;
+
+#define DOUBLE(X) static_cast<double>(X)
+
+/*\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+/*----------------------------------------------------------------------------*/
+/*                                  FIXTURES                                  */
+/*----------------------------------------------------------------------------*/
+/*////////////////////////////////////////////////////////////////////////////*/
+
+static const auto infinity
+  = std::numeric_limits<probability_t::value_type>::infinity();
+
+/*----------------------------------------------------------------------------*/
+
+struct ALargeRangeOfProbabilities : public testing::TestWithParam<std::size_t> {
+  ThreadPool pool { GetParam() };
+  std::vector<probability_t> probabilities;
+
+  void SetUp() override {
+    std::size_t size = 1 << 20;
+    for (std::size_t i = 0; i < size; i++)
+      probabilities.emplace_back(1.0 / (3.0 * size + i));
+  }
+};
+
+/*\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+/*----------------------------------------------------------------------------*/
+/*                                SIMPLE TESTS                                */
+/*----------------------------------------------------------------------------*/
+/*////////////////////////////////////////////////////////////////////////////*/
+
+TEST(ThreadPool, HasAtLeastTheCallingThread) {
+  ASSERT_THAT(ThreadPool(1).size(), Eq(1u));
+  ASSERT_THAT(ThreadPool(4).size(), Eq(4u));
+  ASSERT_THAT(probability::default_thread_pool().size(), testing::Ge(1u));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST(ThreadPool, RunsEachTaskExactlyOnce) {
+  ThreadPool pool(4);
+  std::vector<std::atomic<int>> calls(1000);
+
+  for (int round = 0; round < 3; round++)
+    pool.for_each(calls.size(), [&](std::size_t i) { calls[i]++; });
+
+  for (const auto& count : calls) ASSERT_THAT(count.load(), Eq(3));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST(ThreadPool, RethrowsTheFirstExceptionOfATaskInTheCallingThread) {
+  ThreadPool pool(4);
+  std::atomic<int> calls { 0 };
+
+  ASSERT_THROW(pool.for_each(1000, [&](std::size_t i) {
+    calls++;
+    if (i % 10 == 0) throw std::runtime_error("task failed");
+  }), std::runtime_error);
+  ASSERT_THAT(calls.load(), testing::Lt(1000));
+
+  calls = 0;
+  pool.for_each(1000, [&](std::size_t) { calls++; });
+  ASSERT_THAT(calls.load(), Eq(1000));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST(ThreadPool, IdentifiesTheThreadRunningEachTask) {
+  ThreadPool pool(4);
+  std::vector<std::thread::id> threads(pool.size());
+  std::atomic<int> mismatches { 0 };
+  auto caller = std::this_thread::get_id();
+
+  pool.for_each_in_worker(1000, [&](std::size_t, std::size_t worker) {
+    if (worker >= threads.size()) { mismatches++; return; }
+    auto id = std::this_thread::get_id();
+    if (threads[worker] == std::thread::id()) threads[worker] = id;
+    if (threads[worker] != id || (worker == 0) != (id == caller))
+      mismatches++;
+  });
+
+  ASSERT_THAT(mismatches.load(), Eq(0));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST(ThreadPool, DoesNothingWithoutTasks) {
+  ThreadPool pool(2);
+  int calls = 0;
+  pool.for_each(0, [&](std::size_t) { calls++; });
+  ASSERT_THAT(calls, Eq(0));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST(Reduce, IsZeroForAnEmptyRange) {
+  std::vector<probability_t> probabilities;
+  ASSERT_THAT(probability::reduce(std::execution::par, probabilities).data(),
+              Eq(-infinity));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST(Reduce, IsTheSumForASmallRange) {
+  std::vector<probability_t> probabilities { 0.25, 0.0, 0.5 };
+  ASSERT_THAT(DOUBLE(probability::reduce(std::execution::par, probabilities)),
+              DoubleEq(0.75));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST(Reduce, IsTheSumForSequencedExecution) {
+  std::vector<probability_t> probabilities { 0.25, 0.0, 0.5 };
+  ASSERT_THAT(DOUBLE(probability::reduce(std::execution::seq, probabilities)),
+              DoubleEq(0.75));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST(Reduce, CanBeCalculatedForAPointerRange) {
+  std::vector<probability_t> probabilities { 0.25, 0.25, 0.5 };
+  ThreadPool pool(2);
+  ASSERT_THAT(DOUBLE(probability::reduce(pool, probabilities.data(),
+                                         probabilities.data() + 2)),
+              DoubleEq(0.5));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST(Reduce, CanBeCalculatedForALogVector) {
+  log_double_vector_t values { 0.25, 0.0, 0.5 };
+  ThreadPool pool(2);
+  ASSERT_THAT(DOUBLE(probability::reduce(std::execution::par, values)),
+              DoubleEq(0.75));
+  ASSERT_THAT(DOUBLE(probability::reduce(std::execution::seq, values)),
+              DoubleEq(0.75));
+  ASSERT_THAT(DOUBLE(probability::reduce(pool, values)), DoubleEq(0.75));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST(Reduce, KeepsPrecisionForValuesWithVeryDifferentMagnitudes) {
+  std::vector<log_double_t> values(1 << 18, 1e-300);
+  values[1 << 17] = 1e300;
+  ThreadPool pool(4);
+  ASSERT_THAT(probability::reduce(pool, values).data(),
+              DoubleEq(log_double_t(1e300).data()));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST(Reduce, IsTheMaximumForMaxProbabilities) {
+  std::vector<probability::max_probability_t> values(1 << 18, 0.25);
+  values[3 << 16] = 0.5;
+  ThreadPool pool(4);
+  ASSERT_THAT(probability::reduce(pool, values), Eq(values[3 << 16]));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST(Reduce, DiesIfTheResultIsNotAProbability) {
+  std::vector<probability_t> probabilities(1 << 18, 1e-5);
+  ASSERT_DEATH({
+    ThreadPool pool(4);
+    probability::reduce(pool, probabilities);
+  }, "");
+}
+
+/*\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+/*----------------------------------------------------------------------------*/
+/*                             TESTS WITH FIXTURE                             */
+/*----------------------------------------------------------------------------*/
+/*////////////////////////////////////////////////////////////////////////////*/
+
+TEST_P(ALargeRangeOfProbabilities, HasTheSameReduceAsSum) {
+  ASSERT_THAT(DOUBLE(probability::reduce(pool, probabilities)),
+              DoubleNear(DOUBLE(probability::sum(probabilities)), 1e-12));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST_P(ALargeRangeOfProbabilities, HasTheSameReduceInALogVector) {
+  probability::probability_vector_t vector(probabilities.begin(),
+                                           probabilities.end());
+  ASSERT_THAT(DOUBLE(probability::reduce(pool, vector)),
+              DoubleNear(DOUBLE(probability::sum(probabilities)), 1e-12));
+}
+
+INSTANTIATE_TEST_SUITE_P(Threads, ALargeRangeOfProbabilities,
+                         testing::Values(1, 2, 3, 8));
+
+/*----------------------------------------------------------------------------*/
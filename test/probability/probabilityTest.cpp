@@ -17,7 +17,13 @@
 /******************************************************************************/
 
 // Standard headers
+#include <cmath>
 #include <limits>
+#include <iterator>
+#include <thread>
+#include <future>
+#include <vector>
+#include <cstdint>
 
 // External headers
 #include "gmock/gmock.h"
@@ -41,9 +47,23 @@ using ::testing::Gt;
 using ::testing::Ge;
 
 using ::testing::DoubleEq;
+using ::testing::DoubleNear;
+using ::testing::FloatNear;
 
 using probability::log_double_t;
 using probability::probability_t;
+using probability::fast_log_float_t;
+using probability::fast_log_double_t;
+using probability::fast_probability_t;
+using probability::table_probability_t;
+using probability::max_probability_t;
+using probability::counting_probability_t;
+using probability::branch_free_log_float_t;
+using probability::branch_free_log_double_t;
+using probability::branch_free_probability_t;
+using probability::LogThreshold;
+
+using CountingChecker = counting_probability_t::checker_type;
 
 #define DOUBLE(X) static_cast<double>(X)
 
@@ -85,6 +105,14 @@ struct AConvertibleToProbabilityHalf : public testing::Test {
   Number<probability_t> convertible_to_half { 0.5 };
 };
 
+struct ABranchFreeProbabilityZero : public testing::Test {
+  branch_free_probability_t zero = 0.0;
+};
+
+struct ABranchFreeProbabilityOne : public testing::Test {
+  branch_free_probability_t one = 1.0;
+};
+
 /*\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
 /*----------------------------------------------------------------------------*/
 /*                                SIMPLE TESTS                                */
@@ -143,6 +171,651 @@ TEST(Probability, DiesIfInitializedWithValueBiggerThan1) {
   ASSERT_DEATH(probability_t probability(2.0), "");
 }
 
+/*----------------------------------------------------------------------------*/
+
+TEST(Probability, CanBeStoredInAGrowingVector) {
+  std::vector<probability_t> probabilities;
+  for (int i = 0; i < 10; i++) probabilities.emplace_back(0.5);
+  ASSERT_THAT(DOUBLE(probabilities.back()), DoubleEq(0.5));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST(FastProbability, UsesFastMath) {
+  ASSERT_TRUE((std::is_same_v<fast_probability_t::math_type,
+                              probability::FastMath<double>>));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST(FastProbability, KeepsZeroWhenAddedToZero) {
+  fast_probability_t zero = 0.0;
+  ASSERT_THAT((zero + zero).data(), Eq(-infinity));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST(FastProbability, KeepsItsValueWhenAddedToZero) {
+  fast_probability_t zero = 0.0, half = 0.5;
+  ASSERT_THAT((zero + half).data(), Eq(half.data()));
+  ASSERT_THAT((half + zero).data(), Eq(half.data()));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST(FastProbability, CanBeAddedUpToOneWithinItsUlp) {
+  fast_probability_t sum;
+  for (int i = 0; i < 10; i++) sum += 0.1;
+  ASSERT_THAT(DOUBLE(sum), DoubleNear(1.0, 1e-6));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST(FastProbability, AddsWithinMaxErrorOfStandardMath) {
+  auto max_error = probability::FastMath<double>::max_error;
+  for (double d = 0.0; d < 50.0; d += 0.01) {
+    log_double_t lhs = 0.25, rhs = 0.25;
+    rhs.data() -= d;
+    fast_log_double_t fast_lhs = lhs, fast_rhs = rhs;
+    ASSERT_THAT((fast_lhs + fast_rhs).data(),
+                DoubleNear((lhs + rhs).data(), max_error));
+  }
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST(FastProbability, AddsFloatsWithinMaxErrorOfStandardMath) {
+  auto max_error = probability::FastMath<float>::max_error;
+  for (float d = 0.0f; d < 20.0f; d += 0.01f) {
+    fast_log_float_t lhs = 0.25f, rhs = 0.25f;
+    rhs.data() -= d;
+    float expected = lhs.data() + std::log1p(std::exp(-d));
+    ASSERT_THAT((lhs + rhs).data(), FloatNear(expected, max_error));
+  }
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST(FastProbability, CanBeConvertedFromAndToAProbability) {
+  probability_t half = 0.5;
+  fast_probability_t fast_half = half;
+  ASSERT_THAT(probability_t(fast_half), Eq(half));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST(TableProbability, UsesTableMath) {
+  ASSERT_TRUE((std::is_same_v<table_probability_t::math_type,
+                              probability::TableMath<double>>));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST(TableProbability, IsGeneratedAtCompileTime) {
+  constexpr auto& segments
+    = probability::detail::log1p_exp_table<double, 1>::segments;
+  static_assert(segments[0][0] > 0.6931 && segments[0][0] < 0.6932);
+  ASSERT_THAT(segments[0][0], DoubleEq(std::log(2.0)));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST(TableProbability, KeepsZeroWhenAddedToZero) {
+  table_probability_t zero = 0.0;
+  ASSERT_THAT((zero + zero).data(), Eq(-infinity));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST(TableProbability, KeepsItsValueWhenAddedToZero) {
+  table_probability_t zero = 0.0, half = 0.5;
+  ASSERT_THAT((zero + half).data(), Eq(half.data()));
+  ASSERT_THAT((half + zero).data(), Eq(half.data()));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST(TableProbability, KeepsTheMaximumPastTheCutoff) {
+  table_probability_t half = 0.5, tiny = 1e-30;
+  ASSERT_THAT((half + tiny).data(), Eq(half.data()));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST(TableProbability, CanBeAddedUpToOneWithinItsUlp) {
+  table_probability_t sum;
+  for (int i = 0; i < 10; i++) sum += 0.1;
+  ASSERT_THAT(DOUBLE(sum), DoubleNear(1.0, 1e-5));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST(TableProbability, AddsWithinMaxErrorWithLinearInterpolation) {
+  using math = probability::TableMath<double, 1>;
+  for (double d = 0.0; d < 50.0; d += 0.001) {
+    double expected = std::log1p(std::exp(-d));
+    ASSERT_THAT(math::add(0.0, -d), DoubleNear(expected, math::max_error));
+  }
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST(TableProbability, AddsWithinMaxErrorWithCubicInterpolation) {
+  using math = probability::TableMath<double, 3>;
+  for (double d = 0.0; d < 50.0; d += 0.001) {
+    double expected = std::log1p(std::exp(-d));
+    ASSERT_THAT(math::add(-d, 0.0), DoubleNear(expected, math::max_error));
+  }
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST(TableProbability, AddsFloatsWithinMaxError) {
+  using math = probability::TableMath<float, 1>;
+  for (float d = 0.0f; d < 25.0f; d += 0.001f) {
+    float expected = std::log1p(std::exp(-d));
+    ASSERT_THAT(math::add(0.0f, -d), FloatNear(expected, math::max_error));
+  }
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST(MaxProbability, UsesMaxMath) {
+  ASSERT_TRUE((std::is_same_v<max_probability_t::math_type,
+                              probability::MaxMath<double>>));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST(MaxProbability, AddsAsTheMaximum) {
+  max_probability_t quarter = 0.25, half = 0.5;
+  ASSERT_THAT(quarter + half, Eq(half));
+  ASSERT_THAT(half + quarter, Eq(half));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST(MaxProbability, KeepsItsValueWhenAddedToZero) {
+  max_probability_t zero = 0.0, half = 0.5;
+  ASSERT_THAT((zero + half).data(), Eq(half.data()));
+  ASSERT_THAT((zero + zero).data(), Eq(-infinity));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST(MaxProbability, MultipliesAsAProbability) {
+  max_probability_t quarter = 0.25, half = 0.5;
+  ASSERT_THAT(DOUBLE(quarter * half), DoubleEq(0.125));
+  ASSERT_THAT(DOUBLE(quarter / half), DoubleEq(0.5));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST(MaxProbability, CalculatesTheBestPathInsteadOfTheSumOfPaths) {
+  max_probability_t best;
+  for (double p : { 0.1, 0.3, 0.2 }) best += max_probability_t(p) * p;
+  ASSERT_THAT(DOUBLE(best), DoubleEq(0.09));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST(MaxProbability, DiesIfItIsNotAProbability) {
+  ASSERT_DEATH(max_probability_t(1.5), "");
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST(MaxProbability, CanBeConvertedFromAndToAProbability) {
+  probability_t half = 0.5;
+  max_probability_t max_half = half;
+  ASSERT_THAT(probability_t(max_half), Eq(half));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST(CountingProbability, CountsChecksWithoutViolationsForProbabilities) {
+  CountingChecker::reset();
+  counting_probability_t half(0.5), quarter(0.25);
+  auto sum = half + quarter;
+  auto product = half * quarter;
+
+  auto counts = CountingChecker::snapshot();
+  ASSERT_THAT(counts.checks, Eq(4u));
+  ASSERT_THAT(counts.violations(), Eq(0u));
+  ASSERT_THAT(DOUBLE(sum + product), DoubleEq(0.875));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST(CountingProbability, CountsZerosAsProbabilities) {
+  CountingChecker::reset();
+  counting_probability_t zero(0.0);
+  auto product = zero * counting_probability_t(0.5);
+
+  ASSERT_THAT(CountingChecker::snapshot().violations(), Eq(0u));
+  ASSERT_THAT(DOUBLE(product), DoubleEq(0.0));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST(CountingProbability, CountsValuesOutOfRangeInsteadOfDying) {
+  CountingChecker::reset();
+  counting_probability_t three_quarters(0.75);
+  auto sum = three_quarters + three_quarters;
+  [[maybe_unused]] counting_probability_t three_halves(1.5);
+
+  auto counts = CountingChecker::snapshot();
+  ASSERT_THAT(counts.out_of_range, Eq(2u));
+  ASSERT_THAT(counts.violations(), Eq(2u));
+  ASSERT_THAT(DOUBLE(sum), DoubleEq(1.5));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST(CountingProbability, CountsOverflows) {
+  CountingChecker::reset();
+  [[maybe_unused]] counting_probability_t overflow(infinity);
+
+  ASSERT_THAT(CountingChecker::snapshot().overflows, Eq(1u));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST(CountingProbability, CountsSubnormalInitialValuesAsUnderflows) {
+  CountingChecker::reset();
+  [[maybe_unused]] counting_probability_t subnormal(1e-310);
+
+  ASSERT_THAT(CountingChecker::snapshot().underflows, Eq(1u));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST(CountingProbability, CountsTinyLogarithmsAsProbabilities) {
+  CountingChecker::reset();
+  auto tiny = counting_probability_t::from_log(-800.0);
+  auto product = tiny * tiny;
+
+  ASSERT_THAT(CountingChecker::snapshot().violations(), Eq(0u));
+  ASSERT_THAT(product.data(), DoubleEq(-1600.0));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST(CountingProbability, CountsNaNs) {
+  CountingChecker::reset();
+  [[maybe_unused]] auto product
+    = counting_probability_t(infinity) * counting_probability_t(0.0);
+
+  ASSERT_THAT(CountingChecker::snapshot().nans, Eq(1u));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST(CountingProbability, IncludesCountsOfFinishedThreads) {
+  CountingChecker::reset();
+  std::thread thread([] {
+    for (int i = 0; i < 10; i++)
+      [[maybe_unused]] counting_probability_t three_halves(1.5);
+  });
+  thread.join();
+
+  auto counts = CountingChecker::snapshot();
+  ASSERT_THAT(counts.checks, Eq(10u));
+  ASSERT_THAT(counts.out_of_range, Eq(10u));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST(CountingProbability, DiscardsCountsOfOtherThreadsWhenReset) {
+  CountingChecker::reset();
+  std::promise<void> counted, released;
+  std::thread thread([&] {
+    [[maybe_unused]] counting_probability_t three_halves(1.5);
+    counted.set_value();
+    released.get_future().wait();
+  });
+  counted.get_future().wait();
+  CountingChecker::reset();
+  released.set_value();
+  thread.join();
+
+  auto counts = CountingChecker::snapshot();
+  ASSERT_THAT(counts.checks, Eq(0u));
+  ASSERT_THAT(counts.out_of_range, Eq(0u));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST(CountingProbability, FlushesCountsPeriodically) {
+  CountingChecker::reset();
+  std::uint64_t flushed = 0;
+  std::thread thread([&] {
+    for (std::uint64_t i = 0; i < CountingChecker::flush_period; i++)
+      [[maybe_unused]] counting_probability_t half(0.5);
+    flushed = CountingChecker::snapshot().checks;
+  });
+  thread.join();
+
+  ASSERT_THAT(flushed, Eq(CountingChecker::flush_period));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST(BranchFreeProbability, UsesBranchFreeMath) {
+  ASSERT_TRUE((std::is_same_v<branch_free_probability_t::math_type,
+                              probability::BranchFreeMath<double>>));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST(BranchFreeProbability, KeepsZeroWhenAddedToZero) {
+  branch_free_probability_t zero = 0.0;
+  ASSERT_THAT((zero + zero).data(), Eq(-infinity));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST(BranchFreeProbability, KeepsItsValueWhenAddedToZero) {
+  branch_free_probability_t zero = 0.0, half = 0.5;
+  ASSERT_THAT((zero + half).data(), Eq(half.data()));
+  ASSERT_THAT((half + zero).data(), Eq(half.data()));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST(BranchFreeProbability, CanBeAddedUpToOneWithinItsUlp) {
+  branch_free_probability_t sum;
+  for (int i = 0; i < 10; i++) sum += 0.1;
+  ASSERT_THAT(DOUBLE(sum), DoubleNear(1.0, 1e-14));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST(BranchFreeProbability, AddsWithinMaxErrorOfStandardMath) {
+  auto max_error = probability::BranchFreeMath<double>::max_error;
+  for (double d = 0.0; d < 50.0; d += 0.01) {
+    log_double_t lhs = 0.25, rhs = 0.25;
+    rhs.data() -= d;
+    branch_free_log_double_t branch_free_lhs = lhs, branch_free_rhs = rhs;
+    ASSERT_THAT((branch_free_lhs + branch_free_rhs).data(),
+                DoubleNear((lhs + rhs).data(), max_error));
+    ASSERT_THAT((branch_free_rhs + branch_free_lhs).data(),
+                DoubleNear((lhs + rhs).data(), max_error));
+  }
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST(BranchFreeProbability, AddsFloatsWithinMaxErrorOfStandardMath) {
+  auto max_error = probability::BranchFreeMath<float>::max_error;
+  for (float d = 0.0f; d < 20.0f; d += 0.01f) {
+    branch_free_log_float_t lhs = 0.25f, rhs = 0.25f;
+    rhs.data() -= d;
+    float expected = lhs.data() + std::log1p(std::exp(-d));
+    ASSERT_THAT((lhs + rhs).data(), FloatNear(expected, max_error));
+  }
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST(MultiplyAdd, AccumulatesTheProduct) {
+  probability_t acc = 0.25, a = 0.5, b = 0.5;
+  probability::fma(acc, a, b);
+  ASSERT_THAT(DOUBLE(acc), DoubleEq(0.5));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST(MultiplyAdd, IsTheSameAsAddingTheProduct) {
+  probability_t acc = 0.125, a = 0.25, b = 0.75;
+  probability_t expected = acc + a * b;
+  ASSERT_THAT(fma(acc, a, b), Eq(expected));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST(MultiplyAdd, IsTheProductForAZeroAccumulator) {
+  probability_t acc = 0.0, a = 0.25, b = 0.5;
+  fma(acc, a, b);
+  ASSERT_THAT(DOUBLE(acc), DoubleEq(0.125));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST(MultiplyAdd, KeepsTheAccumulatorForAZeroProduct) {
+  probability_t acc = 0.25, a = 0.0, b = 0.5;
+  fma(acc, a, b);
+  ASSERT_THAT(acc.data(), Eq(probability_t(0.25).data()));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST(MultiplyAdd, ChecksTheRangeOnlyOnce) {
+  counting_probability_t acc = 0.25, a = 0.5, b = 0.5;
+  CountingChecker::reset();
+  fma(acc, a, b);
+  ASSERT_THAT(CountingChecker::snapshot().checks, Eq(1u));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST(MultiplyAdd, DiesIfTheResultIsNotAProbability) {
+  probability_t acc = 0.75, a = 0.5, b = 1.0;
+  ASSERT_DEATH(fma(acc, a, b), "");
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST(MultiplyAdd, IsTheMaximumForMaxProbabilities) {
+  max_probability_t acc = 0.25, a = 0.5, b = 0.75;
+  fma(acc, a, b);
+  ASSERT_THAT(DOUBLE(acc), DoubleEq(0.375));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST(LogThreshold, IsCalculatedAtCompileTime) {
+  constexpr LogThreshold<double> threshold(0.5);
+  static_assert(threshold.data() < 0.0);
+  ASSERT_THAT(threshold.data(), DoubleNear(std::log(0.5), 1e-15));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST(LogThreshold, IsTheLogarithmOfTheValue) {
+  for (double v : { 1e-300, 1e-9, 0.1, 0.75, 1.0, 3.0, 1e10, 1e300 }) {
+    ASSERT_THAT(LogThreshold<double>(v).data(),
+                DoubleNear(std::log(v), 1e-15 * std::fabs(std::log(v))));
+  }
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST(LogThreshold, IsCalculatedWithTheStandardLibraryAtRunTime) {
+  for (double v : { 1e-300, 1e-9, 0.1, 0.75, 3.0 })
+    ASSERT_THAT(LogThreshold<double>(v).data(), Eq(std::log(v)));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST(LogThreshold, IsMinusInfinityForZero) {
+  constexpr LogThreshold<double> threshold(0.0);
+  ASSERT_THAT(threshold.data(), Eq(-std::numeric_limits<double>::infinity()));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST(LogThreshold, IsZeroForOne) {
+  constexpr LogThreshold<float> threshold(1.0f);
+  ASSERT_THAT(threshold.data(), Eq(0.0f));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST(LogThreshold, ComparesWithProbabilities) {
+  constexpr LogThreshold<double> threshold(1e-9);
+  probability_t small = 1e-12, big = 0.5;
+
+  ASSERT_THAT(small < threshold, Eq(true));
+  ASSERT_THAT(small <= threshold, Eq(true));
+  ASSERT_THAT(small > threshold, Eq(false));
+  ASSERT_THAT(small >= threshold, Eq(false));
+  ASSERT_THAT(big < threshold, Eq(false));
+  ASSERT_THAT(big > threshold, Eq(true));
+
+  ASSERT_THAT(threshold > small, Eq(true));
+  ASSERT_THAT(threshold >= small, Eq(true));
+  ASSERT_THAT(threshold < small, Eq(false));
+  ASSERT_THAT(threshold <= small, Eq(false));
+  ASSERT_THAT(threshold < big, Eq(true));
+  ASSERT_THAT(threshold > big, Eq(false));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST(LogThreshold, ComparesAsTheRawValue) {
+  constexpr LogThreshold<double> threshold(0.25);
+  for (double v : { 0.0, 0.125, 0.25, 0.5, 1.0 }) {
+    probability_t p = v;
+    ASSERT_THAT(p < threshold, Eq(p < 0.25));
+    ASSERT_THAT(p <= threshold, Eq(p <= 0.25));
+    ASSERT_THAT(p > threshold, Eq(p > 0.25));
+    ASSERT_THAT(p >= threshold, Eq(p >= 0.25));
+    ASSERT_THAT(p == threshold, Eq(p == 0.25));
+    ASSERT_THAT(p != threshold, Eq(p != 0.25));
+  }
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST(LogThreshold, ComparesWithOtherMathTypes) {
+  constexpr LogThreshold<double> threshold(0.25);
+  max_probability_t p = 0.125;
+  fast_probability_t q = 0.5;
+  ASSERT_THAT(p < threshold, Eq(true));
+  ASSERT_THAT(q > threshold, Eq(true));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST(ConstexprProbability, IsConstructedAtCompileTime) {
+  constexpr probability_t p = 0.25;
+  static_assert(p.data() < 0.0);
+  ASSERT_THAT(p.data(), DoubleEq(probability_t(0.25).data()));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST(ConstexprProbability, IsTheSameAsAtRunTime) {
+  constexpr double values[] = { 1e-300, 1e-9, 0.1, 0.3, 0.75, 1.0 };
+  constexpr probability_t probabilities[] = {
+    values[0], values[1], values[2], values[3], values[4], values[5]
+  };
+  for (std::size_t i = 0; i < std::size(values); i++) {
+    ASSERT_THAT(probabilities[i].data(),
+                DoubleEq(probability_t(values[i]).data()));
+  }
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST(ConstexprProbability, IsZeroByDefault) {
+  constexpr probability_t zero;
+  static_assert(zero == probability_t(0.0));
+  ASSERT_THAT(DOUBLE(zero), Eq(0.0));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST(ConstexprProbability, MultipliesAndDividesAtCompileTime) {
+  constexpr probability_t half = 0.5, quarter = 0.25;
+  constexpr probability_t product = half * half, quotient = quarter / half;
+  static_assert(product == quarter);
+  static_assert(quotient == half);
+  ASSERT_THAT(DOUBLE(product), DoubleEq(0.25));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST(ConstexprProbability, AddsAndSubtractsAtCompileTime) {
+  constexpr probability_t half = 0.5, quarter = 0.25;
+  constexpr probability_t sum = half + quarter, difference = half - quarter;
+  static_assert(sum > half && difference < half);
+  ASSERT_THAT(DOUBLE(sum), DoubleEq(0.75));
+  ASSERT_THAT(DOUBLE(difference), DoubleEq(0.25));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST(ConstexprProbability, ComparesWithRawValuesAtCompileTime) {
+  constexpr probability_t p = 0.3;
+  static_assert(p > 0.25 && p < 0.5 && 0.25 < p);
+  ASSERT_THAT(p < 0.5, Eq(true));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST(ConstexprProbability, IsConvertedToValueTypeAtCompileTime) {
+  constexpr probability_t p = 0.3;
+  constexpr double value = static_cast<double>(p);
+  ASSERT_THAT(value, DoubleEq(0.3));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST(ConstexprProbability, IsTheMaximumForMaxProbabilities) {
+  constexpr max_probability_t sum
+    = max_probability_t(0.25) + max_probability_t(0.5);
+  static_assert(sum == max_probability_t(0.5));
+  ASSERT_THAT(DOUBLE(sum), DoubleEq(0.5));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST(FromLog, BuildsAProbabilityFromItsLogarithm) {
+  auto p = probability_t::from_log(std::log(0.25));
+  ASSERT_THAT(p.data(), Eq(std::log(0.25)));
+  ASSERT_THAT(DOUBLE(p), DoubleEq(0.25));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST(FromLog, BuildsZeroFromMinusInfinity) {
+  auto p = probability_t::from_log(-std::numeric_limits<double>::infinity());
+  ASSERT_THAT(p, Eq(probability_t(0.0)));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST(FromLog, CanBeCalculatedAtCompileTime) {
+  constexpr auto p = probability_t::from_log(-1.0);
+  static_assert(p.data() == -1.0);
+  ASSERT_THAT(p.data(), Eq(-1.0));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST(FromLog, ChecksTheRange) {
+  CountingChecker::reset();
+  counting_probability_t::from_log(1.0);
+  ASSERT_THAT(CountingChecker::snapshot().out_of_range, Eq(1u));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST(FromLog, DiesIfTheValueIsNotAProbability) {
+  ASSERT_DEATH(probability_t::from_log(1.0), "");
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST(FromLog, DoesNotCheckTheRangeIfUnchecked) {
+  CountingChecker::reset();
+  auto p = counting_probability_t::from_log_unchecked(1.0);
+  ASSERT_THAT(p.data(), Eq(1.0));
+  ASSERT_THAT(CountingChecker::snapshot().checks, Eq(0u));
+}
+
 /*\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
 /*----------------------------------------------------------------------------*/
 /*                             TESTS WITH FIXTURE                             */
@@ -1747,4 +2420,46 @@ TEST_F(AConvertibleToProbabilityHalf,
   ASSERT_THAT(DOUBLE(convertible_to_itself - convertible_to_half),
               DoubleEq(0.0));
 }
+
+/*----------------------------------------------------------------------------*/
+
+TEST_F(ABranchFreeProbabilityZero, CanBeIncreasedByZero) {
+  zero += 0.0;
+  ASSERT_THAT(zero.data(), Eq(-infinity));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST_F(ABranchFreeProbabilityZero, CanBeIncreasedByItself) {
+  zero += zero;
+  ASSERT_THAT(zero.data(), Eq(-infinity));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST_F(ABranchFreeProbabilityZero, CanBeIncreasedByNonZero) {
+  zero += 0.5;
+  ASSERT_THAT(DOUBLE(zero), DoubleEq(0.5));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST_F(ABranchFreeProbabilityZero, CanBeIncreasedByOne) {
+  zero += 1.0;
+  ASSERT_THAT(DOUBLE(zero), DoubleEq(1.0));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST_F(ABranchFreeProbabilityOne, CanBeIncreasedByZero) {
+  one += 0.0;
+  ASSERT_THAT(DOUBLE(one), DoubleEq(1.0));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST_F(ABranchFreeProbabilityOne, DiesIfIncreasedByNonZero) {
+  ASSERT_DEATH(one += 0.5, "");
+}
+
 /*----------------------------------------------------------------------------*/
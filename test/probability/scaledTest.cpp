@@ -0,0 +1,152 @@
+/******************************************************************************/
+/*  Probability - A fast implementation of probabilities using logarithms     */
+/*  Copyright (C) 2016 Renato Cordeiro Ferreira                               */
+/*                                                                            */
+/*  This program is free software: you can redistribute it and/or modify      */
+/*  it under the terms of the GNU General Public License as published by      */
+/*  the Free Software Foundation, either version 3 of the License, or         */
+/*  (at your option) any later version.                                       */
+/*                                                                            */
+/*  This program is distributed in the hope that it will be useful,           */
+/*  but WITHOUT ANY WARRANTY; without even the implied warranty of            */
+/*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             */
+/*  GNU General Public License for more details.                              */
+/*                                                                            */
+/*  You should have received a copy of the GNU General Public License         */
+/*  along with this program.  If not, see <www.gnu.org/licenses>.             */
+/******************************************************************************/
+
+// Standard headers
+#include <cmath>
+
+// External headers
+#include "gmock/gmock.h"
+
+// Tested header
+#include "probability/scaled.hpp"
+
+
+/*\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+/*----------------------------------------------------------------------------*/
+/*                             USING DECLARATIONS                             */
+/*----------------------------------------------------------------------------*/
+/*////////////////////////////////////////////////////////////////////////////*/
+
+using ::testing::Eq;
+using ::testing::DoubleEq;
+
+using probability::probability_vector_t;
+using probability::scaled_probability_column_t;
+
+#define DOUBLE(X) static_cast<double>(X)
+
+/*\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+/*----------------------------------------------------------------------------*/
+/*                                  FIXTURES                                  */
+/*----------------------------------------------------------------------------*/
+/*////////////////////////////////////////////////////////////////////////////*/
+
+using max_checker_t = probability::ProbabilityChecker<double, 0>;
+using max_math_t = probability::MaxMath<double>;
+using max_vector_t
+  = probability::LogVector<double, 0, max_checker_t, max_math_t>;
+using max_column_t
+  = probability::ScaledProbabilityColumn<double, 0, max_checker_t, max_math_t>;
+
+/*----------------------------------------------------------------------------*/
+
+struct AScaledColumn : public testing::Test {
+  probability_vector_t logs { 0.5, 0.25, 0.0, 0.125 };
+  scaled_probability_column_t column { logs };
+};
+
+/*\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+/*----------------------------------------------------------------------------*/
+/*                                SIMPLE TESTS                                */
+/*----------------------------------------------------------------------------*/
+/*////////////////////////////////////////////////////////////////////////////*/
+
+TEST(ScaledProbabilityColumn, IsCreatedWithZeros) {
+  scaled_probability_column_t column(3);
+  ASSERT_THAT(column.size(), Eq(3u));
+  ASSERT_THAT(column.log_scale(), Eq(0.0));
+  ASSERT_THAT(DOUBLE(column.sum()), Eq(0.0));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST(ScaledProbabilityColumn, KeepsColumnsOfZerosWhenRescaled) {
+  scaled_probability_column_t column(probability_vector_t { 0.0, 0.0 });
+  column.rescale();
+  ASSERT_THAT(column.data()[0], Eq(0.0));
+  ASSERT_THAT(DOUBLE(column[1]), Eq(0.0));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST(ScaledProbabilityColumn, KeepsProbabilitiesBelowTheRangeOfDouble) {
+  scaled_probability_column_t column(probability_vector_t { 1e-200, 1e-300 });
+  for (int t = 0; t < 10; t++) {
+    column.data()[0] *= 1e-100;
+    column.data()[1] *= 1e-100;
+    column.rescale();
+  }
+  ASSERT_THAT(column[0].data(), DoubleEq(-1200 * std::log(10.0)));
+  ASSERT_THAT(column[1].data(), DoubleEq(-1300 * std::log(10.0)));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST(ScaledProbabilityColumn, RescalesByTheMaximumWithMaxMath) {
+  max_column_t column(max_vector_t { 0.5, 0.25 });
+  column.data()[1] *= 2;
+  column.rescale();
+  ASSERT_THAT(column.data()[0], DoubleEq(1.0));
+  ASSERT_THAT(column.data()[1], DoubleEq(1.0));
+  ASSERT_THAT(DOUBLE(column.sum()), DoubleEq(0.5));
+}
+
+/*\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+/*----------------------------------------------------------------------------*/
+/*                             TESTS WITH FIXTURE                             */
+/*----------------------------------------------------------------------------*/
+/*////////////////////////////////////////////////////////////////////////////*/
+
+TEST_F(AScaledColumn, IsScaledByTheBiggestProbability) {
+  ASSERT_THAT(column.log_scale(), DoubleEq(std::log(0.5)));
+  ASSERT_THAT(column.data()[0], DoubleEq(1.0));
+  ASSERT_THAT(column.data()[1], DoubleEq(0.5));
+  ASSERT_THAT(column.data()[2], Eq(0.0));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST_F(AScaledColumn, HasProbabilitiesInLogSpace) {
+  for (std::size_t i = 0; i < logs.size(); i++)
+    ASSERT_THAT(DOUBLE(column[i]), DoubleEq(DOUBLE(logs[i])));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST_F(AScaledColumn, SumsInLinearSpace) {
+  ASSERT_THAT(DOUBLE(column.sum()), DoubleEq(0.875));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST_F(AScaledColumn, KeepsProbabilitiesWhenRescaled) {
+  column.rescale();
+  ASSERT_THAT(column.log_scale(), DoubleEq(std::log(0.875)));
+  ASSERT_THAT(column.data()[1], DoubleEq(0.25 / 0.875));
+  for (std::size_t i = 0; i < logs.size(); i++)
+    ASSERT_THAT(DOUBLE(column[i]), DoubleEq(DOUBLE(logs[i])));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST_F(AScaledColumn, ConvertsBackToLogSpace) {
+  auto converted = column.to_log_vector();
+  ASSERT_THAT(converted.size(), Eq(logs.size()));
+  for (std::size_t i = 0; i < logs.size(); i++)
+    ASSERT_THAT(DOUBLE(converted[i]), DoubleEq(DOUBLE(logs[i])));
+}
@@ -0,0 +1,281 @@
+/******************************************************************************/
+/*  Probability - A fast implementation of probabilities using logarithms     */
+/*  Copyright (C) 2016 Renato Cordeiro Ferreira                               */
+/*                                                                            */
+/*  This program is free software: you can redistribute it and/or modify      */
+/*  it under the terms of the GNU General Public License as published by      */
+/*  the Free Software Foundation, either version 3 of the License, or         */
+/*  (at your option) any later version.                                       */
+/*                                                                            */
+/*  This program is distributed in the hope that it will be useful,           */
+/*  but WITHOUT ANY WARRANTY; without even the implied warranty of            */
+/*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             */
+/*  GNU General Public License for more details.                              */
+/*                                                                            */
+/*  You should have received a copy of the GNU General Public License         */
+/*  along with this program.  If not, see <www.gnu.org/licenses>.             */
+/******************************************************************************/
+
+// Standard headers
+#include <cmath>
+#include <tuple>
+#include <limits>
+#include <vector>
+#include <cstddef>
+#include <utility>
+
+// External headers
+#include "gmock/gmock.h"
+
+// Tested header
+#include "probability/sparse.hpp"
+
+
+/*\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+/*----------------------------------------------------------------------------*/
+/*                             USING DECLARATIONS                             */
+/*----------------------------------------------------------------------------*/
+/*////////////////////////////////////////////////////////////////////////////*/
+
+using ::testing::Eq;
+using ::testing::DoubleEq;
+using ::testing::DoubleNear;
+
+using probability::log_double_t;
+using probability::probability_t;
+using probability::log_double_matrix_t;
+using probability::log_double_vector_t;
+using probability::probability_matrix_t;
+using probability::probability_vector_t;
+using probability::log_double_sparse_matrix_t;
+using probability::log_double_banded_matrix_t;
+using probability::probability_sparse_matrix_t;
+
+#define DOUBLE(X) static_cast<double>(X)
+
+/*\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+/*----------------------------------------------------------------------------*/
+/*                                  FIXTURES                                  */
+/*----------------------------------------------------------------------------*/
+/*////////////////////////////////////////////////////////////////////////////*/
+
+static const auto infinity
+  = std::numeric_limits<probability_t::value_type>::infinity();
+
+using max_checker_t = probability::ProbabilityChecker<double, 0>;
+using max_math_t = probability::MaxMath<double>;
+using max_vector_t
+  = probability::LogVector<double, 0, max_checker_t, max_math_t>;
+using max_matrix_t
+  = probability::LogMatrix<double, 0, max_checker_t, max_math_t>;
+using max_sparse_matrix_t
+  = probability::LogSparseMatrix<double, 0, max_checker_t, max_math_t>;
+
+/*----------------------------------------------------------------------------*/
+
+struct ASparseStochasticMatrix : public testing::Test {
+  probability_matrix_t dense {
+    { 0.9, 0.1, 0.0 },
+    { 0.0, 0.5, 0.5 },
+    { 0.0, 0.0, 1.0 },
+  };
+  probability_sparse_matrix_t transitions { dense };
+};
+
+/*----------------------------------------------------------------------------*/
+
+struct SparseMatricesOfSizes : public testing::TestWithParam<
+    std::tuple<std::size_t, std::size_t, std::size_t>> {
+  std::size_t rows = std::get<0>(GetParam());
+  std::size_t cols = std::get<1>(GetParam());
+  std::size_t band = std::get<2>(GetParam());
+
+  log_double_banded_matrix_t banded { rows, cols, band, band / 2 };
+  log_double_matrix_t dense;
+  log_double_sparse_matrix_t sparse;
+  log_double_vector_t vector;
+
+  void SetUp() override {
+    // Entries in the band, with a few zeros
+    for (std::size_t i = 0; i < rows; i++)
+      for (std::size_t j = 0; j < cols; j++)
+        if (j + band >= i && j <= i + band / 2)
+          banded(i, j) = (i + 2 * j) % 7 == 0
+                       ? 0.0 : std::exp(-0.1 * static_cast<double>(i + j));
+
+    dense = banded.to_dense();
+    sparse = log_double_sparse_matrix_t(dense);
+
+    vector = log_double_vector_t(std::max(rows, cols));
+    for (std::size_t i = 0; i < vector.size(); i++)
+      vector[i] = i % 5 == 0 ? 0.0 : 1e-3 * static_cast<double>(i + 1);
+  }
+
+  log_double_vector_t input(std::size_t size) const {
+    log_double_vector_t result(size);
+    for (std::size_t i = 0; i < size; i++) result[i] = vector[i];
+    return result;
+  }
+};
+
+/*\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+/*----------------------------------------------------------------------------*/
+/*                                SIMPLE TESTS                                */
+/*----------------------------------------------------------------------------*/
+/*////////////////////////////////////////////////////////////////////////////*/
+
+TEST(LogSparseMatrix, IsEmptyByDefault) {
+  log_double_sparse_matrix_t matrix;
+  ASSERT_THAT(matrix.rows(), Eq(0u));
+  ASSERT_THAT(matrix.cols(), Eq(0u));
+  ASSERT_THAT(matrix.nonzeros(), Eq(0u));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST(LogSparseMatrix, IsCreatedFromEntriesInAnyOrder) {
+  log_double_sparse_matrix_t matrix(3, 4, {
+    { 2, 1, log_double_t(0.5) },
+    { 0, 3, log_double_t(0.25) },
+    { 0, 0, log_double_t(0.125) },
+  });
+
+  ASSERT_THAT(matrix.nonzeros(), Eq(3u));
+  ASSERT_THAT(matrix.row_offsets()[1], Eq(2u));
+  ASSERT_THAT(matrix.row_offsets()[2], Eq(2u));
+  ASSERT_THAT(matrix.column_indices()[0], Eq(0u));
+  ASSERT_THAT(matrix.column_indices()[1], Eq(3u));
+  ASSERT_THAT(DOUBLE(matrix(0, 3)), DoubleEq(0.25));
+  ASSERT_THAT(DOUBLE(matrix(2, 1)), DoubleEq(0.5));
+  ASSERT_THAT(matrix(1, 1).data(), Eq(-infinity));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST(LogBandedMatrix, HasZerosOutsideTheBand) {
+  const log_double_banded_matrix_t matrix(4, 4, 1, 0, log_double_t(0.5));
+  ASSERT_THAT(DOUBLE(matrix(1, 0)), DoubleEq(0.5));
+  ASSERT_THAT(DOUBLE(matrix(1, 1)), DoubleEq(0.5));
+  ASSERT_THAT(matrix(1, 2).data(), Eq(-infinity));
+  ASSERT_THAT(matrix(3, 0).data(), Eq(-infinity));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST(LogBandedMatrix, StoresDiagonalsByRow) {
+  log_double_banded_matrix_t matrix(3, 5, 1, 2);
+  matrix(2, 4) = log_double_t(0.5);
+  matrix(1, 0) = log_double_t(0.25);
+
+  ASSERT_THAT(matrix.first_row(-1), Eq(1u));
+  ASSERT_THAT(matrix.last_row(2), Eq(3u));
+  ASSERT_THAT(matrix.diagonal(2)[2], DoubleEq(std::log(0.5)));
+  ASSERT_THAT(matrix.diagonal(-1)[1], DoubleEq(std::log(0.25)));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST(LogSparseMatrix, CalculatesViterbiStepsWithMaxMath) {
+  max_matrix_t dense {
+    { 0.6, 0.4, 0.0 },
+    { 0.0, 0.7, 0.3 },
+    { 0.5, 0.0, 0.5 },
+  };
+  max_sparse_matrix_t sparse(dense);
+  max_vector_t alpha { 0.2, 0.5, 0.3 };
+
+  auto expected = alpha * dense;
+  auto scattered = alpha * sparse;
+  auto gathered = sparse.transpose() * alpha;
+  for (std::size_t j = 0; j < 3; j++) {
+    ASSERT_THAT(scattered.data()[j], DoubleEq(expected.data()[j]));
+    ASSERT_THAT(gathered.data()[j], DoubleEq(expected.data()[j]));
+  }
+}
+
+/*\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+/*----------------------------------------------------------------------------*/
+/*                             TESTS WITH FIXTURE                             */
+/*----------------------------------------------------------------------------*/
+/*////////////////////////////////////////////////////////////////////////////*/
+
+TEST_F(ASparseStochasticMatrix, StoresOnlyNonzeroEntries) {
+  ASSERT_THAT(transitions.nonzeros(), Eq(5u));
+  for (std::size_t i = 0; i < 3; i++)
+    for (std::size_t j = 0; j < 3; j++)
+      ASSERT_THAT(transitions(i, j).data(), Eq(dense(i, j).data()));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST_F(ASparseStochasticMatrix, IsTransposedIntoCompressedColumns) {
+  auto transposed = transitions.transpose();
+  ASSERT_THAT(transposed.nonzeros(), Eq(5u));
+  for (std::size_t i = 0; i < 3; i++)
+    for (std::size_t j = 0; j < 3; j++)
+      ASSERT_THAT(transposed(j, i).data(), Eq(dense(i, j).data()));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST_F(ASparseStochasticMatrix, DiesIfTheResultIsNotAProbability) {
+  probability_vector_t ones(3, 1.0);
+  ASSERT_DEATH(ones * transitions, "");
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST_P(SparseMatricesOfSizes, HaveTheSameEntriesAsTheDenseMatrix) {
+  ASSERT_THAT(sparse.to_dense().data()[0], Eq(dense.data()[0]));
+  for (std::size_t i = 0; i < rows; i++) {
+    for (std::size_t j = 0; j < cols; j++) {
+      ASSERT_THAT(sparse(i, j).data(), Eq(dense(i, j).data()));
+      ASSERT_THAT(std::as_const(banded)(i, j).data(),
+                  Eq(dense(i, j).data()));
+    }
+  }
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST_P(SparseMatricesOfSizes, HaveTheSameMatrixVectorProductAsDense) {
+  auto x = input(cols);
+  auto expected = dense * x, from_sparse = sparse * x, from_band = banded * x;
+
+  ASSERT_THAT(from_sparse.size(), Eq(rows));
+  ASSERT_THAT(from_band.size(), Eq(rows));
+  for (std::size_t i = 0; i < rows; i++) {
+    ASSERT_THAT(from_sparse.data()[i],
+                DoubleNear(expected.data()[i], 1e-12));
+    ASSERT_THAT(from_band.data()[i], DoubleNear(expected.data()[i], 1e-12));
+  }
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST_P(SparseMatricesOfSizes, HaveTheSameVectorMatrixProductAsDense) {
+  auto x = input(rows);
+  auto expected = x * dense, from_sparse = x * sparse, from_band = x * banded;
+  auto from_transpose = sparse.transpose() * x;
+
+  ASSERT_THAT(from_sparse.size(), Eq(cols));
+  ASSERT_THAT(from_band.size(), Eq(cols));
+  for (std::size_t j = 0; j < cols; j++) {
+    ASSERT_THAT(from_sparse.data()[j],
+                DoubleNear(expected.data()[j], 1e-12));
+    ASSERT_THAT(from_transpose.data()[j],
+                DoubleNear(expected.data()[j], 1e-12));
+    ASSERT_THAT(from_band.data()[j], DoubleNear(expected.data()[j], 1e-12));
+  }
+}
+
+/*----------------------------------------------------------------------------*/
+
+INSTANTIATE_TEST_SUITE_P(Sizes, SparseMatricesOfSizes,
+    testing::Values(std::make_tuple(1, 1, 0),
+                    std::make_tuple(3, 17, 2),
+                    std::make_tuple(17, 3, 2),
+                    std::make_tuple(9, 300, 5),
+                    std::make_tuple(300, 9, 20),
+                    std::make_tuple(257, 257, 4),
+                    std::make_tuple(64, 64, 100)));
@@ -0,0 +1,234 @@
+/******************************************************************************/
+/*  Probability - A fast implementation of probabilities using logarithms     */
+/*  Copyright (C) 2016 Renato Cordeiro Ferreira                               */
+/*                                                                            */
+/*  This program is free software: you can redistribute it and/or modify      */
+/*  it under the terms of the GNU General Public License as published by      */
+/*  the Free Software Foundation, either version 3 of the License, or         */
+/*  (at your option) any later version.                                       */
+/*                                                                            */
+/*  This program is distributed in the hope that it will be useful,           */
+/*  but WITHOUT ANY WARRANTY; without even the implied warranty of            */
+/*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             */
+/*  GNU General Public License for more details.                              */
+/*                                                                            */
+/*  You should have received a copy of the GNU General Public License         */
+/*  along with this program.  If not, see <www.gnu.org/licenses>.             */
+/******************************************************************************/
+
+// Standard headers
+#include <cmath>
+#include <limits>
+#include <vector>
+#include <cstddef>
+
+// External headers
+#include "gmock/gmock.h"
+
+// Tested header
+#include "probability/training.hpp"
+
+
+/*\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+/*----------------------------------------------------------------------------*/
+/*                             USING DECLARATIONS                             */
+/*----------------------------------------------------------------------------*/
+/*////////////////////////////////////////////////////////////////////////////*/
+
+using ::testing::Eq;
+using ::testing::Ge;
+using ::testing::Gt;
+using ::testing::DoubleNear;
+
+using probability::hmm_t;
+using probability::ThreadPool;
+using probability::baum_welch_t;
+using probability::TrainingReport;
+using probability::probability_matrix_t;
+using probability::probability_vector_t;
+
+#define DOUBLE(X) static_cast<double>(X)
+
+/*\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+/*----------------------------------------------------------------------------*/
+/*                                  FIXTURES                                  */
+/*----------------------------------------------------------------------------*/
+/*////////////////////////////////////////////////////////////////////////////*/
+
+// Expected counts of a sequence, calculated by enumerating all its paths
+struct BruteForceCounts {
+  std::vector<double> initial, transitions, emissions;
+  double likelihood = 0;
+
+  BruteForceCounts(const probability_vector_t& init,
+                   const probability_matrix_t& trans,
+                   const probability_matrix_t& emiss,
+                   const hmm_t::sequence_type& sequence)
+      : initial(init.size()),
+        transitions(trans.rows() * trans.cols()),
+        emissions(emiss.rows() * emiss.cols()) {
+    std::size_t states = init.size(), symbols = emiss.cols();
+
+    std::size_t paths = 1;
+    for (std::size_t t = 0; t < sequence.size(); t++) paths *= states;
+
+    std::vector<std::size_t> path;
+    for (std::size_t p = 0; p < paths; p++) {
+      path.clear();
+      for (std::size_t t = 0, rest = p; t < sequence.size(); t++) {
+        path.push_back(rest % states);
+        rest /= states;
+      }
+
+      double weight = DOUBLE(init[path[0]] * emiss(path[0], sequence[0]));
+      for (std::size_t t = 1; t < sequence.size(); t++)
+        weight *= DOUBLE(trans(path[t-1], path[t])
+                         * emiss(path[t], sequence[t]));
+      likelihood += weight;
+
+      initial[path[0]] += weight;
+      for (std::size_t t = 0; t < sequence.size(); t++) {
+        emissions[path[t] * symbols + sequence[t]] += weight;
+        if (t > 0) transitions[path[t-1] * states + path[t]] += weight;
+      }
+    }
+
+    for (auto& count : initial) count /= likelihood;
+    for (auto& count : transitions) count /= likelihood;
+    for (auto& count : emissions) count /= likelihood;
+  }
+};
+
+/*----------------------------------------------------------------------------*/
+
+struct AnHMMToTrain : public testing::Test {
+  probability_vector_t initial { 0.6, 0.4 };
+  probability_matrix_t transitions { { 0.7, 0.3 }, { 0.4, 0.6 } };
+  probability_matrix_t emissions { { 0.5, 0.4, 0.1 }, { 0.1, 0.3, 0.6 } };
+
+  hmm_t hmm { initial, transitions, emissions };
+
+  std::vector<hmm_t::sequence_type> batch;
+  ThreadPool pool { 3 };
+
+  void SetUp() override {
+    for (std::size_t b = 0; b < 40; b++) {
+      hmm_t::sequence_type sequence;
+      for (std::size_t t = 0; t < 5 + b % 7; t++)
+        sequence.push_back((t * t + b * t + b) % 3);
+      batch.push_back(sequence);
+    }
+  }
+};
+
+/*\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+/*----------------------------------------------------------------------------*/
+/*                             TESTS WITH FIXTURE                             */
+/*----------------------------------------------------------------------------*/
+/*////////////////////////////////////////////////////////////////////////////*/
+
+TEST_F(AnHMMToTrain, HasTheExpectedCountsOfAllPaths) {
+  hmm_t::sequence_type sequence { 0, 1, 2, 2 };
+  BruteForceCounts expected(initial, transitions, emissions, sequence);
+
+  auto counts = baum_welch_t(pool).expectation(hmm, { sequence });
+  ASSERT_THAT(counts.sequences(), Eq(1u));
+  ASSERT_THAT(std::exp(counts.log_likelihood()),
+              DoubleNear(expected.likelihood, 1e-15));
+
+  for (std::size_t i = 0; i < 2; i++) {
+    ASSERT_THAT(std::exp(counts.initial_count(i).data()),
+                DoubleNear(expected.initial[i], 1e-12));
+    for (std::size_t j = 0; j < 2; j++)
+      ASSERT_THAT(std::exp(counts.transition_count(i, j).data()),
+                  DoubleNear(expected.transitions[i * 2 + j], 1e-12));
+    for (std::size_t k = 0; k < 3; k++)
+      ASSERT_THAT(std::exp(counts.emission_count(i, k).data()),
+                  DoubleNear(expected.emissions[i * 3 + k], 1e-12));
+  }
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST_F(AnHMMToTrain, HasTheSameCountsWithAnyNumberOfThreads) {
+  ThreadPool single(1);
+  auto parallel = baum_welch_t(pool).expectation(hmm, batch);
+  auto serial = baum_welch_t(single).expectation(hmm, batch);
+
+  ASSERT_THAT(parallel.sequences(), Eq(serial.sequences()));
+  ASSERT_THAT(parallel.log_likelihood(),
+              DoubleNear(serial.log_likelihood(), 1e-9));
+  for (std::size_t i = 0; i < 2; i++)
+    for (std::size_t j = 0; j < 2; j++)
+      ASSERT_THAT(parallel.transition_count(i, j).data(),
+                  DoubleNear(serial.transition_count(i, j).data(), 1e-12));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST_F(AnHMMToTrain, IgnoresEmptySequences) {
+  auto counts = baum_welch_t(pool).expectation(
+      hmm, { {}, { 0, 1 }, {} });
+  ASSERT_THAT(counts.sequences(), Eq(1u));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST_F(AnHMMToTrain, NormalizesCountsIntoProbabilities) {
+  auto counts = baum_welch_t(pool).expectation(hmm, batch);
+  auto model = baum_welch_t::maximization(counts, hmm);
+
+  ASSERT_THAT(DOUBLE(sum(model.initial_probabilities())),
+              DoubleNear(1.0, 1e-12));
+
+  auto emission_probabilities = model.emission_probabilities();
+  for (std::size_t i = 0; i < 2; i++) {
+    auto transition_total = model.transition_probabilities()(i, 0)
+                          + model.transition_probabilities()(i, 1);
+    ASSERT_THAT(DOUBLE(transition_total), DoubleNear(1.0, 1e-12));
+
+    auto emission_total = emission_probabilities(i, 0)
+                        + emission_probabilities(i, 1)
+                        + emission_probabilities(i, 2);
+    ASSERT_THAT(DOUBLE(emission_total), DoubleNear(1.0, 1e-12));
+  }
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST_F(AnHMMToTrain, KeepsRowsOfStatesThatAreNeverVisited) {
+  hmm_t certain(probability_vector_t { 1.0, 0.0 },
+                probability_matrix_t { { 1.0, 0.0 }, { 0.5, 0.5 } },
+                emissions);
+
+  auto counts = baum_welch_t(pool).expectation(certain, batch);
+  auto model = baum_welch_t::maximization(counts, certain);
+
+  ASSERT_THAT(DOUBLE(model.transition_probabilities()(1, 0)),
+              DoubleNear(0.5, 1e-15));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST_F(AnHMMToTrain, NeverDecreasesTheLikelihood) {
+  baum_welch_t baum_welch(pool);
+  double previous = -std::numeric_limits<double>::infinity();
+  for (std::size_t i = 0; i < 10; i++) {
+    TrainingReport report = baum_welch.iterate(hmm, batch);
+    ASSERT_THAT(report.log_likelihood, Ge(previous - 1e-9));
+    previous = report.log_likelihood;
+  }
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST_F(AnHMMToTrain, TrainsUntilTheLikelihoodConverges) {
+  TrainingReport report = baum_welch_t(pool).train(hmm, batch, 1000, 1e-6);
+
+  ASSERT_THAT(report.iterations, Gt(1u));
+  ASSERT_THAT(report.iterations < 1000, Eq(true));
+  ASSERT_THAT(report.sequences, Eq(report.iterations * batch.size()));
+  ASSERT_THAT(report.sequences_per_second(), Gt(0.0));
+  ASSERT_THAT(baum_welch_t(pool).iterate(hmm, batch).log_likelihood,
+              DoubleNear(report.log_likelihood, 1e-5));
+}
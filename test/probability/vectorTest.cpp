@@ -0,0 +1,408 @@
+/******************************************************************************/
+/*  Probability - A fast implementation of probabilities using logarithms     */
+/*  Copyright (C) 2016 Renato Cordeiro Ferreira                               */
+/*                                                                            */
+/*  This program is free software: you can redistribute it and/or modify      */
+/*  it under the terms of the GNU General Public License as published by      */
+/*  the Free Software Foundation, either version 3 of the License, or         */
+/*  (at your option) any later version.                                       */
+/*                                                                            */
+/*  This program is distributed in the hope that it will be useful,           */
+/*  but WITHOUT ANY WARRANTY; without even the implied warranty of            */
+/*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             */
+/*  GNU General Public License for more details.                              */
+/*                                                                            */
+/*  You should have received a copy of the GNU General Public License         */
+/*  along with this program.  If not, see <www.gnu.org/licenses>.             */
+/******************************************************************************/
+
+// Standard headers
+#include <cmath>
+#include <limits>
+#include <vector>
+#include <cstdint>
+#include <numeric>
+#include <algorithm>
+
+// External headers
+#include "gmock/gmock.h"
+
+// Tested header
+#include "probability/vector.hpp"
+
+
+/*\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+/*----------------------------------------------------------------------------*/
+/*                             USING DECLARATIONS                             */
+/*----------------------------------------------------------------------------*/
+/*////////////////////////////////////////////////////////////////////////////*/
+
+using ::testing::Eq;
+using ::testing::DoubleEq;
+using ::testing::FloatEq;
+using ::testing::DoubleNear;
+
+using probability::LogVector;
+using probability::log_double_t;
+using probability::log_float_t;
+using probability::probability_t;
+using probability::fast_probability_t;
+using probability::log_double_vector_t;
+using probability::log_float_vector_t;
+using probability::probability_vector_t;
+
+#define DOUBLE(X) static_cast<double>(X)
+
+/*\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+/*----------------------------------------------------------------------------*/
+/*                                  FIXTURES                                  */
+/*----------------------------------------------------------------------------*/
+/*////////////////////////////////////////////////////////////////////////////*/
+
+static const auto infinity
+  = std::numeric_limits<probability_t::value_type>::infinity();
+
+/*----------------------------------------------------------------------------*/
+
+struct AProbabilityVector : public testing::Test {
+  probability_vector_t probabilities { 0.5, 0.25, 0.125, 0.0 };
+};
+
+/*----------------------------------------------------------------------------*/
+
+struct APairOfVectors : public testing::TestWithParam<std::size_t> {
+  std::vector<log_double_t> lhs_values, rhs_values;
+  log_double_vector_t lhs, rhs;
+
+  void SetUp() override {
+    for (std::size_t i = 0; i < GetParam(); i++) {
+      lhs_values.emplace_back(std::exp(-0.37 * static_cast<double>(i % 50)));
+      rhs_values.emplace_back(i % 7 == 0 ? 0.0 : 1.0 / (1.0 + i));
+    }
+    lhs = log_double_vector_t(lhs_values.begin(), lhs_values.end());
+    rhs = log_double_vector_t(rhs_values.begin(), rhs_values.end());
+  }
+};
+
+/*\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+/*----------------------------------------------------------------------------*/
+/*                                SIMPLE TESTS                                */
+/*----------------------------------------------------------------------------*/
+/*////////////////////////////////////////////////////////////////////////////*/
+
+TEST(LogVector, IsEmptyByDefault) {
+  log_double_vector_t values;
+  ASSERT_TRUE(values.empty());
+  ASSERT_THAT(values.size(), Eq(0u));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST(LogVector, IsFilledWithZerosWhenConstructedWithASize) {
+  log_double_vector_t values(10);
+  ASSERT_THAT(values.size(), Eq(10u));
+  for (std::size_t i = 0; i < values.size(); i++)
+    ASSERT_THAT(values.data()[i], Eq(-infinity));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST(LogVector, StoresRawLogarithmsContiguously) {
+  log_double_vector_t values { 0.5, 0.25 };
+  ASSERT_THAT(values.data()[0], DoubleEq(std::log(0.5)));
+  ASSERT_THAT(values.data()[1], DoubleEq(std::log(0.25)));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST(LogVector, HasStorageAlignedToCacheLines) {
+  for (std::size_t size : { 1, 3, 17, 100 }) {
+    log_float_vector_t values(size);
+    auto address = reinterpret_cast<std::uintptr_t>(values.data());
+    ASSERT_THAT(address % 64, Eq(0u));
+  }
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST(LogVector, CanBeConstructedFromARangeOfLogFloatingPoints) {
+  std::vector<probability_t> probabilities { 0.5, 0.25 };
+  probability_vector_t values(probabilities.begin(), probabilities.end());
+  ASSERT_THAT(values[0], Eq(probabilities[0]));
+  ASSERT_THAT(values[1], Eq(probabilities[1]));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST(LogVector, CanGrowWithPushBackAndResize) {
+  log_double_vector_t values;
+  values.push_back(0.5);
+  values.resize(3, 0.25);
+  ASSERT_THAT(DOUBLE(values[0]), DoubleEq(0.5));
+  ASSERT_THAT(DOUBLE(values[2]), DoubleEq(0.25));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST(LogVector, CanBeFilledWithAValue) {
+  log_double_vector_t values(5);
+  values.fill(0.75);
+  for (auto value : values) ASSERT_THAT(DOUBLE(value), DoubleEq(0.75));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST(LogVector, DiesIfVectorsWithDifferentSizesAreCombined) {
+  log_double_vector_t lhs(3), rhs(4);
+  ASSERT_DEATH(lhs *= rhs, "");
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST(LogVector, AddsElementsWithOtherMathTypes) {
+  LogVector<double, fast_probability_t::ULP,
+            fast_probability_t::checker_type,
+            fast_probability_t::math_type> lhs { 0.5, 0.0 }, rhs { 0.25, 0.5 };
+  auto result = lhs + rhs;
+  ASSERT_THAT(DOUBLE(result[0]), DoubleNear(0.75, 1e-6));
+  ASSERT_THAT(DOUBLE(result[1]), DoubleNear(0.5, 1e-6));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST(LogVector, AddsLogFloatsElementWise) {
+  std::vector<log_float_t> lhs_values, rhs_values;
+  for (int i = 0; i < 100; i++) {
+    lhs_values.emplace_back(1.0f / static_cast<float>(i + 1));
+    rhs_values.emplace_back(static_cast<float>(i) / 128.0f);
+  }
+
+  log_float_vector_t lhs(lhs_values.begin(), lhs_values.end());
+  log_float_vector_t rhs(rhs_values.begin(), rhs_values.end());
+  lhs += rhs;
+
+  for (std::size_t i = 0; i < lhs.size(); i++) {
+    auto expected = lhs_values[i] + rhs_values[i];
+    ASSERT_THAT(lhs.data()[i], Eq(expected.data()));
+  }
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST(LogVectorReduction, SumsAllElements) {
+  log_double_vector_t values(100, 0.25);
+  ASSERT_THAT(DOUBLE(sum(values)), DoubleEq(25.0));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST(LogVectorReduction, MultipliesAllElements) {
+  log_double_vector_t values(30, 0.5);
+  ASSERT_THAT(product(values).data(), DoubleEq(30 * std::log(0.5)));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST(LogVectorReduction, FindsTheBiggestElement) {
+  log_double_vector_t values(37, 0.25);
+  values[23] = 0.75;
+  ASSERT_THAT(DOUBLE(max(values)), DoubleEq(0.75));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST(LogVectorReduction, IsZeroForAnEmptyVector) {
+  log_double_vector_t values;
+  ASSERT_THAT(sum(values).data(), Eq(-infinity));
+  ASSERT_THAT(max(values).data(), Eq(-infinity));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST(LogVector, AddsMaxProbabilitiesAsTheMaximum) {
+  LogVector<double, 0, probability::ProbabilityChecker<double, 0>,
+            probability::MaxMath<double>> lhs { 0.5, 0.0 }, rhs { 0.25, 0.5 };
+  auto result = lhs + rhs;
+  ASSERT_THAT(DOUBLE(result[0]), DoubleEq(0.5));
+  ASSERT_THAT(DOUBLE(result[1]), DoubleEq(0.5));
+  ASSERT_THAT(DOUBLE(sum(lhs)), DoubleEq(0.5));
+}
+
+/*\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+/*----------------------------------------------------------------------------*/
+/*                             TESTS WITH FIXTURE                             */
+/*----------------------------------------------------------------------------*/
+/*////////////////////////////////////////////////////////////////////////////*/
+
+TEST_F(AProbabilityVector, HandsOutLogFloatingPointsForScalarAccess) {
+  probability_t first = probabilities[0];
+  ASSERT_THAT(first, Eq(probability_t(0.5)));
+  ASSERT_THAT(DOUBLE(probabilities[1]), DoubleEq(0.25));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST_F(AProbabilityVector, HasReferencesThatWorkWithOperators) {
+  ASSERT_THAT(probabilities[0] * probabilities[1], Eq(probability_t(0.125)));
+  ASSERT_THAT(probabilities[0] + probability_t(0.25), Eq(probability_t(0.75)));
+  ASSERT_THAT(probabilities[2] < probabilities[1], Eq(true));
+  ASSERT_THAT(probabilities[3] == 0.0, Eq(true));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST_F(AProbabilityVector, HasReferencesThatCompareWithThresholds) {
+  probability::LogThreshold<double> half(0.5);
+  ASSERT_THAT(probabilities[1] < half, Eq(true));
+  ASSERT_THAT(probabilities[0] <= half, Eq(true));
+  ASSERT_THAT(probabilities[0] == half, Eq(true));
+  ASSERT_THAT(probabilities[1] != half, Eq(true));
+  ASSERT_THAT(half > probabilities[3], Eq(true));
+  ASSERT_THAT(half >= probabilities[0], Eq(true));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST_F(AProbabilityVector, CanBeModifiedThroughReferences) {
+  probabilities[3] = 0.5;
+  probabilities[2] += 0.25;
+  probabilities[1] *= 0.5;
+  probabilities[0] = probabilities[1];
+  ASSERT_THAT(DOUBLE(probabilities[3]), DoubleEq(0.5));
+  ASSERT_THAT(DOUBLE(probabilities[2]), DoubleEq(0.375));
+  ASSERT_THAT(DOUBLE(probabilities[1]), DoubleEq(0.125));
+  ASSERT_THAT(DOUBLE(probabilities[0]), DoubleEq(0.125));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST_F(AProbabilityVector, DiesIfAReferenceLeavesTheRange) {
+  ASSERT_DEATH(probabilities[0] += 0.75, "");
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST_F(AProbabilityVector, CanBeIterated) {
+  probability_t total;
+  for (auto probability : probabilities) total += probability;
+  ASSERT_THAT(DOUBLE(total), DoubleEq(0.875));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST_F(AProbabilityVector, CanBeModifiedThroughIterators) {
+  for (auto probability : probabilities) probability *= 0.5;
+  ASSERT_THAT(DOUBLE(sum(probabilities)), DoubleEq(0.4375));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST_F(AProbabilityVector, WorksWithStandardAlgorithms) {
+  const auto& values = probabilities;
+  auto zeros = std::count(values.begin(), values.end(), probability_t(0.0));
+  auto biggest = std::max_element(values.begin(), values.end());
+  auto total = std::accumulate(values.begin(), values.end(), probability_t());
+  ASSERT_THAT(zeros, Eq(1));
+  ASSERT_THAT(biggest - values.begin(), Eq(0));
+  ASSERT_THAT(DOUBLE(total), DoubleEq(0.875));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST_F(AProbabilityVector, CanBeMultipliedByAScalar) {
+  auto result = probability_t(0.5) * (probabilities * probability_t(0.5));
+  ASSERT_THAT(DOUBLE(result[0]), DoubleEq(0.125));
+  ASSERT_THAT(DOUBLE(result[2]), DoubleEq(0.03125));
+  ASSERT_THAT(result[3].data(), Eq(-infinity));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST_F(AProbabilityVector, CanBeDividedByAScalar) {
+  auto result = (probabilities * probability_t(0.25)) / probability_t(0.5);
+  ASSERT_THAT(DOUBLE(result[0]), DoubleEq(0.25));
+  ASSERT_THAT(DOUBLE(result[1]), DoubleEq(0.125));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST_F(AProbabilityVector, AddsZerosExactly) {
+  probability_vector_t zeros(probabilities.size());
+  auto result = probabilities + zeros;
+  for (std::size_t i = 0; i < result.size(); i++)
+    ASSERT_THAT(result.data()[i], Eq(probabilities.data()[i]));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST_F(AProbabilityVector, DiesIfAnElementWiseOperationLeavesTheRange) {
+  ASSERT_DEATH(probabilities + probabilities + probabilities, "");
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST_F(AProbabilityVector, AccumulatesScaledProductsWithMultiplyAdd) {
+  probability_vector_t acc { 0.25, 0.5, 0.0, 0.125 };
+  fma(acc, probabilities, probability_t(0.5));
+  ASSERT_THAT(DOUBLE(acc[0]), DoubleEq(0.5));
+  ASSERT_THAT(DOUBLE(acc[1]), DoubleEq(0.625));
+  ASSERT_THAT(DOUBLE(acc[2]), DoubleEq(0.0625));
+  ASSERT_THAT(acc.data()[3], Eq(probability_t(0.125).data()));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST_F(AProbabilityVector, DiesIfAMultiplyAddLeavesTheRange) {
+  probability_vector_t acc(probabilities.size(), 0.75);
+  ASSERT_DEATH(fma(acc, probabilities, probability_t(1.0)), "");
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST_P(APairOfVectors, MultipliesElementWise) {
+  auto result = lhs * rhs;
+  for (std::size_t i = 0; i < result.size(); i++)
+    ASSERT_THAT(result[i], Eq(lhs_values[i] * rhs_values[i]));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST_P(APairOfVectors, DividesElementWise) {
+  auto result = rhs / lhs;
+  for (std::size_t i = 0; i < result.size(); i++)
+    ASSERT_THAT(result[i], Eq(rhs_values[i] / lhs_values[i]));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST_P(APairOfVectors, AddsElementWiseLikeLogFloatingPoint) {
+  auto result = lhs + rhs;
+  for (std::size_t i = 0; i < result.size(); i++) {
+    auto expected = lhs_values[i] + rhs_values[i];
+    ASSERT_THAT(result.data()[i], Eq(expected.data()));
+  }
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST_P(APairOfVectors, HasTheSameSumAsItsElements) {
+  log_double_t expected;
+  for (const auto& value : rhs_values) expected += value;
+  ASSERT_THAT(sum(rhs).data(), DoubleNear(expected.data(), 1e-13));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST_P(APairOfVectors, MultipliesAndAddsElementWiseLikeLogFloatingPoint) {
+  auto result = rhs;
+  fma(result, lhs, rhs);
+  for (std::size_t i = 0; i < result.size(); i++) {
+    auto expected = rhs_values[i] + lhs_values[i] * rhs_values[i];
+    ASSERT_THAT(result.data()[i], Eq(expected.data()));
+  }
+}
+
+/*----------------------------------------------------------------------------*/
+
+INSTANTIATE_TEST_SUITE_P(Sizes, APairOfVectors,
+    testing::Values(1, 2, 7, 8, 9, 15, 16, 17, 100, 1000));
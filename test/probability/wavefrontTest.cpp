@@ -0,0 +1,229 @@
+/******************************************************************************/
+/*  Probability - A fast implementation of probabilities using logarithms     */
+/*  Copyright (C) 2016 Renato Cordeiro Ferreira                               */
+/*                                                                            */
+/*  This program is free software: you can redistribute it and/or modify      */
+/*  it under the terms of the GNU General Public License as published by      */
+/*  the Free Software Foundation, either version 3 of the License, or         */
+/*  (at your option) any later version.                                       */
+/*                                                                            */
+/*  This program is distributed in the hope that it will be useful,           */
+/*  but WITHOUT ANY WARRANTY; without even the implied warranty of            */
+/*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             */
+/*  GNU General Public License for more details.                              */
+/*                                                                            */
+/*  You should have received a copy of the GNU General Public License         */
+/*  along with this program.  If not, see <www.gnu.org/licenses>.             */
+/******************************************************************************/
+
+// Standard headers
+#include <cmath>
+#include <tuple>
+#include <vector>
+#include <cstddef>
+
+// External headers
+#include "gmock/gmock.h"
+
+// Tested header
+#include "probability/wavefront.hpp"
+
+
+/*\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+/*----------------------------------------------------------------------------*/
+/*                             USING DECLARATIONS                             */
+/*----------------------------------------------------------------------------*/
+/*////////////////////////////////////////////////////////////////////////////*/
+
+using ::testing::Eq;
+using ::testing::Le;
+using ::testing::Lt;
+using ::testing::DoubleNear;
+
+using probability::ThreadPool;
+using probability::log_double_t;
+using probability::log_double_anti_diagonal_table_t;
+
+#define DOUBLE(X) static_cast<double>(X)
+
+/*\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+/*----------------------------------------------------------------------------*/
+/*                                  FIXTURES                                  */
+/*----------------------------------------------------------------------------*/
+/*////////////////////////////////////////////////////////////////////////////*/
+
+/**
+ * Logarithm of the binomial coefficient (i + j) choose i, which is the
+ * number of monotonic lattice paths from (0, 0) to (i, j).
+ */
+static double log_paths(std::size_t i, std::size_t j) {
+  return std::lgamma(i + j + 1.0) - std::lgamma(i + 1.0)
+       - std::lgamma(j + 1.0);
+}
+
+/*----------------------------------------------------------------------------*/
+
+struct AWavefrontOverTiles
+    : public testing::TestWithParam<
+          std::tuple<std::size_t, std::size_t, std::size_t>> {
+  std::size_t rows = std::get<0>(GetParam());
+  std::size_t cols = std::get<1>(GetParam());
+  std::size_t tile = std::get<2>(GetParam());
+  ThreadPool pool { 3 };
+
+  // Order of the visit of each cell, starting from 1
+  std::vector<std::size_t> order = std::vector<std::size_t>(rows * cols);
+  std::size_t visits = 0;
+
+  void visit(std::size_t d, std::size_t first, std::size_t last) {
+    ASSERT_THAT(first, Lt(last));
+    ASSERT_THAT(last, Le(std::min(d + 1, rows)));
+    for (std::size_t i = first; i < last; i++) {
+      std::size_t j = d - i;
+      ASSERT_THAT(j, Lt(cols));
+      ASSERT_THAT(order[i * cols + j], Eq(0u));
+      if (i > 0) {
+        ASSERT_THAT(order[(i-1) * cols + j], Lt(visits + 1));
+      }
+      if (j > 0) {
+        ASSERT_THAT(order[i * cols + j - 1], Lt(visits + 1));
+      }
+      order[i * cols + j] = ++visits;
+    }
+  }
+
+  /**
+   * Fills a table with the number of lattice paths to each cell, adding
+   * the paths to the cells above and to the left.
+   */
+  template<typename Wavefront>
+  log_double_anti_diagonal_table_t count_paths(Wavefront run) {
+    log_double_anti_diagonal_table_t table(rows, cols);
+    run([&](std::size_t d, std::size_t first, std::size_t last) {
+      double* current = table.diagonal(d);
+      const double* previous = d > 0 ? table.diagonal(d-1) : nullptr;
+      for (std::size_t i = first; i < last; i++) {
+        log_double_t paths = d == 0 ? log_double_t(1) : log_double_t(0);
+        if (i > 0)
+          paths += log_double_t::from_log(previous[i-1]);
+        if (i < d)
+          paths += log_double_t::from_log(previous[i]);
+        current[i] = paths.data();
+      }
+    });
+    return table;
+  }
+};
+
+/*\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+/*----------------------------------------------------------------------------*/
+/*                                SIMPLE TESTS                                */
+/*----------------------------------------------------------------------------*/
+/*////////////////////////////////////////////////////////////////////////////*/
+
+TEST(AntiDiagonalTable, IsCreatedWithTheGivenValue) {
+  log_double_anti_diagonal_table_t table(3, 4, log_double_t(0.5));
+  ASSERT_THAT(table.rows(), Eq(3u));
+  ASSERT_THAT(table.cols(), Eq(4u));
+  ASSERT_THAT(table.diagonals(), Eq(6u));
+  for (std::size_t i = 0; i < table.rows(); i++)
+    for (std::size_t j = 0; j < table.cols(); j++)
+      ASSERT_THAT(DOUBLE(table(i, j)), Eq(0.5));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST(AntiDiagonalTable, IndexesDiagonalsByRow) {
+  log_double_anti_diagonal_table_t table(3, 4);
+  for (std::size_t i = 0; i < table.rows(); i++)
+    for (std::size_t j = 0; j < table.cols(); j++)
+      table(i, j) = log_double_t::from_log(10.0 * i + j);
+
+  for (std::size_t d = 0; d < table.diagonals(); d++)
+    for (std::size_t i = table.first_row(d); i < table.last_row(d); i++)
+      ASSERT_THAT(table.diagonal(d)[i], Eq(10.0 * i + (d - i)));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST(AntiDiagonalTable, StoresDiagonalsContiguously) {
+  log_double_anti_diagonal_table_t table(4, 2);
+  ASSERT_THAT(table.first_row(0), Eq(0u));
+  ASSERT_THAT(table.last_row(0), Eq(1u));
+  ASSERT_THAT(table.first_row(4), Eq(3u));
+  ASSERT_THAT(table.last_row(4), Eq(4u));
+
+  const double* next = table.data();
+  for (std::size_t d = 0; d < table.diagonals(); d++) {
+    ASSERT_THAT(table.diagonal(d) + table.first_row(d), Eq(next));
+    next = table.diagonal(d) + table.last_row(d);
+  }
+  ASSERT_THAT(next, Eq(table.data() + 4 * 2));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST(Wavefront, DoesNothingWithAnEmptyGrid) {
+  ThreadPool pool(2);
+  std::size_t calls = 0;
+  auto count = [&](std::size_t, std::size_t, std::size_t) { calls++; };
+  probability::wavefront(0, 5, count);
+  probability::wavefront(pool, 5, 0, count);
+  ASSERT_THAT(calls, Eq(0u));
+}
+
+/*\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\*/
+/*----------------------------------------------------------------------------*/
+/*                             TESTS WITH FIXTURE                             */
+/*----------------------------------------------------------------------------*/
+/*////////////////////////////////////////////////////////////////////////////*/
+
+TEST_P(AWavefrontOverTiles, VisitsEachCellOnceAfterItsNeighbors) {
+  probability::wavefront(rows, cols,
+      [&](std::size_t d, std::size_t first, std::size_t last) {
+        visit(d, first, last);
+      });
+  ASSERT_THAT(visits, Eq(rows * cols));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST_P(AWavefrontOverTiles, VisitsEachCellOnceAfterItsNeighborsInTiles) {
+  // With a single thread, so that visits are counted in order
+  ThreadPool serial(1);
+  probability::wavefront(serial, rows, cols,
+      [&](std::size_t d, std::size_t first, std::size_t last) {
+        visit(d, first, last);
+      }, tile);
+  ASSERT_THAT(visits, Eq(rows * cols));
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST_P(AWavefrontOverTiles, CountsLatticePathsInParallel) {
+  auto serial = count_paths([&](auto kernel) {
+    probability::wavefront(rows, cols, kernel);
+  });
+  auto parallel = count_paths([&](auto kernel) {
+    probability::wavefront(pool, rows, cols, kernel, tile);
+  });
+
+  for (std::size_t i = 0; i < rows; i++) {
+    for (std::size_t j = 0; j < cols; j++) {
+      ASSERT_THAT(parallel(i, j).data(), Eq(serial(i, j).data()));
+      ASSERT_THAT(serial(i, j).data(), DoubleNear(log_paths(i, j), 1e-9));
+    }
+  }
+}
+
+/*----------------------------------------------------------------------------*/
+
+INSTANTIATE_TEST_SUITE_P(Sizes, AWavefrontOverTiles,
+    testing::Values(std::make_tuple(1, 1, 1),
+                    std::make_tuple(1, 17, 4),
+                    std::make_tuple(17, 1, 4),
+                    std::make_tuple(5, 5, 1),
+                    std::make_tuple(13, 29, 4),
+                    std::make_tuple(29, 13, 5),
+                    std::make_tuple(64, 64, 16),
+                    std::make_tuple(40, 70, 256)));